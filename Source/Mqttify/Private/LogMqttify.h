@@ -74,8 +74,7 @@ namespace Mqttify
 		}
 
 		TArray<uint8> SerializedData;
-		FMemoryWriter Writer(SerializedData);
-		InLogPacket->Encode(Writer);
+		EncodePacket(*InLogPacket, SerializedData);
 		return DataToHexString(SerializedData.GetData(), SerializedData.Num());
 	}
 }
@@ -2,16 +2,15 @@
 
 #include "LogMqttify.h"
 #include "Packets/MqttifyPacketType.h"
-#include "Packets/MqttifyPingReqPacket.h"
 #include "Packets/Interface/IMqttifyControlPacket.h"
 
 namespace Mqttify
 {
-	bool FMqttifyPingReq::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool FMqttifyPingReq::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
-		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket->GetPacketType()));
-		if (InPacket->GetPacketType() != EMqttifyPacketType::PingResp)
+		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket.GetPacketType()));
+		if (InPacket.GetPacketType() != EMqttifyPacketType::PingResp)
 		{
 			LOG_MQTTIFY(
 				Error,
@@ -20,13 +19,15 @@ namespace Mqttify
 				*Settings->GetClientId(),
 				MqttifyPacketType::InvalidPacketType,
 				EnumToTCharString(EMqttifyPacketType::PingResp),
-				EnumToTCharString(InPacket->GetPacketType()));
+				EnumToTCharString(InPacket.GetPacketType()));
 			Abandon();
 			return true;
 		}
 
 		if (!bIsDone)
 		{
+			SampleRoundTrip();
+			RoundTripSeconds = FPlatformTime::Seconds() - LastSendTime;
 			bIsDone = true;
 			SetPromiseValue(TMqttifyResult<void>{true});
 		}
@@ -40,8 +41,8 @@ namespace Mqttify
 			return true;
 		}
 
-		SendPacketInternal(MakeShared<FMqttifyPingReqPacket>());
-		RetryWaitTime = FDateTime::UtcNow() + FTimespan::FromSeconds(Settings->GetKeepAliveIntervalSeconds());
+		SendAckInternal(EMqttifyPacketType::PingReq);
+		RetryWaitTime = FPlatformTime::Seconds() + KeepAliveIntervalSeconds;
 		return false;
 	}
 
@@ -51,16 +52,21 @@ namespace Mqttify
 		if (!bIsDone)
 		{
 			bIsDone = true;
-			LOG_MQTTIFY_PACKET(
+			LOG_MQTTIFY(
 				Warning,
 				TEXT("[PingReq (Connection %s, ClientId %s)] Abandoning"),
-				MakeShared<FMqttifyPingReqPacket>(),
 				*Settings->GetHost(),
 				*Settings->GetClientId());
 			SetPromiseValue(TMqttifyResult<void>{false});
 		}
 	}
 
+	double FMqttifyPingReq::GetRoundTripSeconds() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return RoundTripSeconds;
+	}
+
 	bool FMqttifyPingReq::IsDone() const
 	{
 		FScopeLock Lock{&CriticalSection};
@@ -7,13 +7,22 @@ namespace Mqttify
 	{
 	private:
 		bool bIsDone{false};
+		/// @brief Time to wait for the PINGRESP before sending the PINGREQ again.
+		uint16 KeepAliveIntervalSeconds;
+		/// @brief Seconds from the last PINGREQ to its PINGRESP, negative until the PINGRESP arrives.
+		double RoundTripSeconds{-1.0};
 
 	public:
 		FMqttifyPingReq(const TWeakPtr<FMqttifySocketBase>& InSocket,
-		                const TSharedRef<FMqttifyConnectionSettings>& InConnectionSettings)
-			: TMqttifyAcknowledgeable(0, InSocket, InConnectionSettings) {}
+		                const TSharedRef<FMqttifyConnectionSettings>& InConnectionSettings,
+		                const uint16 InKeepAliveIntervalSeconds)
+			: TMqttifyAcknowledgeable(0, InSocket, InConnectionSettings)
+			, KeepAliveIntervalSeconds{InKeepAliveIntervalSeconds} {}
 
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		/// @return The round trip time of the PINGREQ in seconds, negative if it was not answered.
+		double GetRoundTripSeconds() const;
+
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
 
 		virtual bool NextImpl() override;
 
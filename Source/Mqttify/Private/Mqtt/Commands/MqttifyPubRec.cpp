@@ -1,13 +1,9 @@
 #include "Mqtt/Commands/MqttifyPubRec.h"
 
-#include "Packets/MqttifyPubCompPacket.h"
-#include "Packets/MqttifyPubRecPacket.h"
+#include "LogMqttify.h"
 
 namespace Mqttify
 {
-	using FPubRecPacket = TMqttifyPubRecPacket<GMqttifyProtocol>;
-	using FPubCompPacket = TMqttifyPubCompPacket<GMqttifyProtocol>;
-
 	FMqttifyPubRec::FMqttifyPubRec(
 		const uint16 InPacketId,
 		const EMqttifyReasonCode InReasonCode,
@@ -34,7 +30,7 @@ namespace Mqttify
 		PubRecState = EPubRecState::Complete;
 	}
 
-	bool FMqttifyPubRec::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool FMqttifyPubRec::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
 		LOG_MQTTIFY(
@@ -42,12 +38,12 @@ namespace Mqttify
 			TEXT("(Connection %s, ClientId %s) Acknowledge %s"),
 			*Settings->GetHost(),
 			*Settings->GetClientId(),
-			EnumToTCharString(InPacket->GetPacketType()));
+			EnumToTCharString(InPacket.GetPacketType()));
 		if (PubRecState == EPubRecState::Unacknowledged)
 		{
 			PubRecState = EPubRecState::Released;
 			SetPromiseValue(TMqttifyResult<void>{true});
-			RetryWaitTime = FDateTime::MinValue();
+			RetryWaitTime = 0.0;
 			PacketTries = 0;
 		}
 
@@ -56,24 +52,19 @@ namespace Mqttify
 
 	bool FMqttifyPubRec::NextImpl()
 	{
-		TSharedPtr<IMqttifyControlPacket> Packet;
 		switch (PubRecState)
 		{
 			case EPubRecState::Unacknowledged:
-				Packet = GetPacket<FPubRecPacket>();
-				break;
+				SendAckInternal(EMqttifyPacketType::PubRec, PacketId, ReasonCode);
+				return false;
 			case EPubRecState::Released:
-				Packet = GetPacket<FPubCompPacket>();
 				PubRecState = EPubRecState::Complete;
-				break;
+				SendAckInternal(EMqttifyPacketType::PubComp, PacketId, ReasonCode);
+				return true;
 			case EPubRecState::Complete:
 				return true;
 		}
-
-		check(Packet.IsValid())
-
-		SendPacketInternal(Packet.ToSharedRef());
-		return PubRecState == EPubRecState::Complete;
+		return false;
 	}
 
 	bool FMqttifyPubRec::IsDone() const
@@ -32,7 +32,7 @@ namespace Mqttify
 			const FMqttifyConnectionSettingsRef& InConnectionSettings);
 
 		virtual void Abandon() override;
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
 
 		/**
 		 * @brief Get the key for the command
@@ -48,20 +48,5 @@ namespace Mqttify
 	protected:
 		virtual bool NextImpl() override;
 		virtual bool IsDone() const override;
-		template <typename TPacket>
-		TSharedPtr<TPacket> GetPacket() const;
 	};
-
-	template <typename TPacket>
-	TSharedPtr<TPacket> FMqttifyPubRec::GetPacket() const
-	{
-		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_3_1_1)
-		{
-			return MakeShared<TPacket>(PacketId);
-		}
-		else if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
-		{
-			return MakeShared<TPacket>(PacketId, ReasonCode);
-		}
-	}
 }
\ No newline at end of file
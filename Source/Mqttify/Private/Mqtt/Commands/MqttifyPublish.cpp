@@ -1,28 +1,102 @@
 #include "Mqtt/Commands/MqttifyPublish.h"
 
 #include "Mqtt/MqttifyMessage.h"
-#include "Packets/MqttifyPubRelPacket.h"
 
 namespace Mqttify
 {
+	namespace
+	{
+		/**
+		 * @brief Get the encoded bytes of a publish from the retransmit cache, encoding it on a miss.
+		 * @param InCache The retransmit cache.
+		 * @param InPacket The publish packet.
+		 * @param bIsRetry True to mark the packet as a duplicate.
+		 * @return The encoded packet, null if the packet cannot be encoded.
+		 */
+		FMqttifyEncodedPacketPtr GetEncodedPublish(FMqttifyPacketCache& InCache,
+													FMqttifyPublishPacketBase& InPacket,
+													const bool bIsRetry)
+		{
+			FMqttifyEncodedPacketPtr Encoded = InCache.Find(InPacket.GetPacketId());
+			if (!Encoded.IsValid())
+			{
+				Encoded = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+				if (!EncodePacket(InPacket, *Encoded))
+				{
+					return nullptr;
+				}
+				InCache.Add(InPacket.GetPacketId(), Encoded.ToSharedRef());
+			}
+
+			if (bIsRetry)
+			{
+				FMqttifyPacketCache::SetDuplicateFlag(*Encoded);
+			}
+			return Encoded;
+		}
+
+		/**
+		 * @brief Alias the topic of a publish on its first send. Retries drop the alias and carry the full topic
+		 * name again, the alias may have been remapped or the connection may have changed since the first send.
+		 * @param InTopicAliases The topic aliases of the connection, may be null.
+		 * @param InPacket The publish packet.
+		 * @param InCache The retransmit cache holding the encoded packet, may be null.
+		 * @param bIsRetry True if the packet was sent before.
+		 */
+		void ApplyTopicAlias(FMqttifyOutboundTopicAliases* InTopicAliases,
+							FMqttifyPublishPacketBase& InPacket,
+							FMqttifyPacketCache* InCache,
+							const bool bIsRetry)
+		{
+			if (!bIsRetry)
+			{
+				if (InTopicAliases != nullptr)
+				{
+					bool bIsNew = false;
+					if (const uint16 Alias = InTopicAliases->Assign(InPacket.GetTopicName(), bIsNew); Alias != 0)
+					{
+						InPacket.SetTopicAlias(Alias, !bIsNew);
+					}
+				}
+			}
+			else if (InPacket.GetTopicAlias() != 0)
+			{
+				InPacket.SetTopicAlias(0, false);
+				if (InCache != nullptr)
+				{
+					InCache->Remove(InPacket.GetPacketId());
+				}
+			}
+		}
+	} // namespace
+
 	TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::TMqttifyPublish(
 		FMqttifyMessage&& InMessage,
 		const uint16 InPacketId,
 		const TWeakPtr<FMqttifySocketBase>& InSocket,
-		const FMqttifyConnectionSettingsRef& InConnectionSettings
+		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedRef<FMqttifyPacketCache>& InRetransmitCache,
+		const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases
 		)
 		: TMqttifyAcknowledgeable{InPacketId, InSocket, InConnectionSettings}
 		, PublishPacket{MakeShared<TMqttifyPublishPacket<GMqttifyProtocol>>(MoveTemp(InMessage), InPacketId)}
+		, RetransmitCache{InRetransmitCache}
+		, TopicAliases{InTopicAliases}
 		, bIsDone{false} {}
 
 	bool TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::NextImpl()
 	{
-		if (PacketTries == 1)
+		ApplyTopicAlias(TopicAliases.Get(), *PublishPacket, &RetransmitCache.Get(), bHasBeenSent);
+		const FMqttifyEncodedPacketPtr Encoded = GetEncodedPublish(
+			*RetransmitCache,
+			*PublishPacket,
+			bHasBeenSent || bIsRecovered);
+		if (!Encoded.IsValid())
 		{
-			PublishPacket = PublishPacket->GetDuplicate(MoveTemp(PublishPacket));
+			Abandon();
+			return true;
 		}
-
-		SendPacketInternal(PublishPacket);
+		SendEncodedInternal(EMqttifyPacketType::Publish, PacketId, *Encoded);
 		return false;
 	}
 
@@ -32,6 +106,7 @@ namespace Mqttify
 		if (!bIsDone)
 		{
 			bIsDone = true;
+			RetransmitCache->Remove(PacketId);
 			LOG_MQTTIFY_PACKET(
 				Error,
 				TEXT("[Publish (Connection %s, ClientId %s)] Abandoning"),
@@ -42,11 +117,11 @@ namespace Mqttify
 		}
 	}
 
-	bool TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
-		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket->GetPacketType()));
-		if (InPacket->GetPacketType() != EMqttifyPacketType::PubAck)
+		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket.GetPacketType()));
+		if (InPacket.GetPacketType() != EMqttifyPacketType::PubAck)
 		{
 			LOG_MQTTIFY(
 				Error,
@@ -54,20 +129,41 @@ namespace Mqttify
 				*Settings->GetHost(),
 				*Settings->GetClientId(),
 				EnumToTCharString(EMqttifyPacketType::PubAck),
-				EnumToTCharString(InPacket->GetPacketType()));
+				EnumToTCharString(InPacket.GetPacketType()));
 			Abandon();
 			return true;
 		}
 
 		if (!bIsDone)
 		{
+			SampleRoundTrip();
 			bIsDone = true;
+			RetransmitCache->Remove(PacketId);
 			SetPromiseValue(TMqttifyResult<void>{true});
 		}
 
 		return true;
 	}
 
+	bool TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::EncodeForBatch(TArray<uint8>& OutBuffer)
+	{
+		FScopeLock Lock{&CriticalSection};
+		if (bIsDone || bHasBeenSent)
+		{
+			return false;
+		}
+
+		// Not cached, a retry encodes the packet again with the DUP flag
+		ApplyTopicAlias(TopicAliases.Get(), *PublishPacket, &RetransmitCache.Get(), false);
+		return EncodePacket(*PublishPacket, OutBuffer);
+	}
+
+	void TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::MarkRecovered()
+	{
+		FScopeLock Lock{&CriticalSection};
+		bIsRecovered = true;
+	}
+
 	bool TMqttifyPublish<EMqttifyQualityOfService::AtLeastOnce>::IsDone() const
 	{
 		FScopeLock Lock{&CriticalSection};
@@ -78,16 +174,20 @@ namespace Mqttify
 		FMqttifyMessage&& InMessage,
 		const uint16 InPacketId,
 		const TWeakPtr<FMqttifySocketBase>& InSocket,
-		const FMqttifyConnectionSettingsRef& InConnectionSettings
+		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedRef<FMqttifyPacketCache>& InRetransmitCache,
+		const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases
 		)
 		: TMqttifyAcknowledgeable{InPacketId, InSocket, InConnectionSettings}
 		, PublishPacket{MakeShared<TMqttifyPublishPacket<GMqttifyProtocol>>(MoveTemp(InMessage), InPacketId)}
+		, RetransmitCache{InRetransmitCache}
+		, TopicAliases{InTopicAliases}
 		, PublishState{EPublishState::Unacknowledged} {}
 
-	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
-		switch (InPacket->GetPacketType())
+		switch (InPacket.GetPacketType())
 		{
 			case EMqttifyPacketType::PubRec:
 				return HandlePubRec(InPacket);
@@ -100,7 +200,7 @@ namespace Mqttify
 					*Settings->GetClientId(),
 					MqttifyPacketType::InvalidPacketType,
 					EnumToTCharString(EMqttifyPacketType::PubRec),
-					EnumToTCharString(InPacket->GetPacketType()))				;
+					EnumToTCharString(InPacket.GetPacketType()))				;
 				Abandon();
 				return true;
 		}
@@ -111,10 +211,22 @@ namespace Mqttify
 		switch (PublishState)
 		{
 			case EPublishState::Unacknowledged:
-				SendPacketInternal(PublishPacket);
+			{
+				ApplyTopicAlias(TopicAliases.Get(), *PublishPacket, &RetransmitCache.Get(), bHasBeenSent);
+				const FMqttifyEncodedPacketPtr Encoded = GetEncodedPublish(
+					*RetransmitCache,
+					*PublishPacket,
+					bHasBeenSent || bIsRecovered);
+				if (!Encoded.IsValid())
+				{
+					Abandon();
+					return true;
+				}
+				SendEncodedInternal(EMqttifyPacketType::Publish, PacketId, *Encoded);
 				return false;
+			}
 			case EPublishState::Received:
-				SendPacketInternal(MakeShared<TMqttifyPubRelPacket<GMqttifyProtocol>>(PacketId));
+				SendAckInternal(EMqttifyPacketType::PubRel, PacketId);
 				return false;
 			case EPublishState::Complete:
 				return true;
@@ -123,60 +235,94 @@ namespace Mqttify
 	}
 
 
+	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::EncodeForBatch(TArray<uint8>& OutBuffer)
+	{
+		FScopeLock Lock{&CriticalSection};
+		if (PublishState != EPublishState::Unacknowledged || bHasBeenSent)
+		{
+			return false;
+		}
+
+		ApplyTopicAlias(TopicAliases.Get(), *PublishPacket, &RetransmitCache.Get(), false);
+		return EncodePacket(*PublishPacket, OutBuffer);
+	}
+
 	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::IsDone() const
 	{
 		FScopeLock Lock{&CriticalSection};
 		return PublishState == EPublishState::Complete;
 	}
 
-	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::HandlePubRec(const FMqttifyPacketPtr& InPacket)
+	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::HandlePubRec(const IMqttifyControlPacket& InPacket)
 	{
 		if (PublishState == EPublishState::Complete)
 		{
 			return true;
 		}
 
-		if (InPacket->GetPacketId() != PacketId)
+		if (InPacket.GetPacketId() != PacketId)
 		{
-			LOG_MQTTIFY(Error, TEXT("Invalid packet id. Expected:%d Actual: %d"), PacketId, InPacket->GetPacketId());
+			LOG_MQTTIFY(Error, TEXT("Invalid packet id. Expected:%d Actual: %d"), PacketId, InPacket.GetPacketId());
 			return false;
 		}
 
 		if (PublishState == EPublishState::Unacknowledged)
 		{
+			SampleRoundTrip();
 			PublishState = EPublishState::Received;
-			SendPacketInternal(MakeShared<TMqttifyPubRelPacket<GMqttifyProtocol>>(PacketId));
-			SetPromiseValue(TMqttifyResult<void>{true});
-			RetryWaitTime = FDateTime::MinValue();
+			RetransmitCache->Remove(PacketId);
+			// Start the PUBREL as a first try, sending it schedules its retry and times its PUBCOMP
+			RetryWaitTime = 0.0;
 			PacketTries = 0;
+			SendAckInternal(EMqttifyPacketType::PubRel, PacketId);
+			SetPromiseValue(TMqttifyResult<void>{true});
 		}
 
 		return false;
 	}
 
-	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::HandlePubComp(const FMqttifyPacketPtr& InPacket)
+	bool TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::HandlePubComp(const IMqttifyControlPacket& InPacket)
 	{
 		if (PublishState == EPublishState::Complete)
 		{
 			return true;
 		}
 
-		if (InPacket->GetPacketId() != PacketId)
+		if (InPacket.GetPacketId() != PacketId)
 		{
-			LOG_MQTTIFY(Error, TEXT("Invalid packet id. Expected:%d Actual: %d"), PacketId, InPacket->GetPacketId());
+			LOG_MQTTIFY(Error, TEXT("Invalid packet id. Expected:%d Actual: %d"), PacketId, InPacket.GetPacketId());
 			return false;
 		}
 
+		SampleRoundTrip();
 		PublishState = EPublishState::Complete;
 		return true;
 	}
 
+	void TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::RestoreReleased()
+	{
+		FScopeLock Lock{&CriticalSection};
+		if (PublishState == EPublishState::Unacknowledged)
+		{
+			PublishState = EPublishState::Received;
+			RetransmitCache->Remove(PacketId);
+			SetPromiseValue(TMqttifyResult<void>{true});
+		}
+	}
+
+	void TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::MarkRecovered()
+	{
+		FScopeLock Lock{&CriticalSection};
+		bIsRecovered = true;
+	}
+
 	void TMqttifyPublish<EMqttifyQualityOfService::ExactlyOnce>::Abandon()
 	{
 		FScopeLock Lock{&CriticalSection};
 		if (PublishState != EPublishState::Complete)
 		{
 			PublishState = EPublishState::Complete;
+			RetransmitCache->Remove(PacketId);
 			LOG_MQTTIFY_PACKET(
 				Error,
 				TEXT("[Publish (Connection %s, ClientId %s)] Abandoning"),
@@ -191,14 +337,17 @@ namespace Mqttify
 	TMqttifyPublish<EMqttifyQualityOfService::AtMostOnce>::TMqttifyPublish(
 		FMqttifyMessage&& InMessage,
 		const TWeakPtr<FMqttifySocketBase>& InSocket,
-		const FMqttifyConnectionSettingsRef& InConnectionSettings
+		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases
 		)
 		: TMqttifyQueueable{InSocket, InConnectionSettings}
 		, PublishPacket{MakeShared<TMqttifyPublishPacket<GMqttifyProtocol>>(MoveTemp(InMessage), 0)}
+		, TopicAliases{InTopicAliases}
 		, bIsDone{false} {}
 
 	bool TMqttifyPublish<EMqttifyQualityOfService::AtMostOnce>::NextImpl()
 	{
+		ApplyTopicAlias(TopicAliases.Get(), *PublishPacket, nullptr, false);
 		SendPacketInternal(PublishPacket);
 		SetPromiseValue(TMqttifyResult<void>{true});
 		bIsDone = true;
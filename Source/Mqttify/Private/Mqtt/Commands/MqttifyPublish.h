@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Mqtt/Commands/MqttifyAcknowledgeable.h"
+#include "Mqtt/State/MqttifyTopicAliases.h"
+#include "Packets/MqttifyPacketCache.h"
 #include "Packets/MqttifyPublishPacket.h"
 
 struct FMqttifyMessage;
@@ -17,19 +19,29 @@ namespace Mqttify
 	{
 	private:
 		TSharedRef<TMqttifyPublishPacket<GMqttifyProtocol>> PublishPacket;
+		TSharedRef<FMqttifyPacketCache> RetransmitCache;
+		TSharedPtr<FMqttifyOutboundTopicAliases> TopicAliases;
 		bool bIsDone;
+		/// @brief Recovered from the session store, the publish may have reached the broker before the restart.
+		bool bIsRecovered = false;
 
 	public:
 		explicit TMqttifyPublish(
 			FMqttifyMessage&& InMessage,
 			const uint16 InPacketId,
 			const TWeakPtr<FMqttifySocketBase>& InSocket,
-			const FMqttifyConnectionSettingsRef& InConnectionSettings
+			const FMqttifyConnectionSettingsRef& InConnectionSettings,
+			const TSharedRef<FMqttifyPacketCache>& InRetransmitCache,
+			const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases = nullptr
 			);
 
 		virtual bool NextImpl() override;
 		virtual void Abandon() override;
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
+		virtual bool EncodeForBatch(TArray<uint8>& OutBuffer) override;
+
+		/// @brief Send the publish with the DUP flag, it was recovered from the session store after a restart.
+		void MarkRecovered();
 
 	protected:
 		virtual bool IsDone() const override;
@@ -47,24 +59,40 @@ namespace Mqttify
 		};
 
 		TSharedRef<FMqttifyPublishPacketBase> PublishPacket;
+		TSharedRef<FMqttifyPacketCache> RetransmitCache;
+		TSharedPtr<FMqttifyOutboundTopicAliases> TopicAliases;
 		EPublishState PublishState;
+		/// @brief Recovered from the session store, the publish may have reached the broker before the restart.
+		bool bIsRecovered = false;
 
 	public:
 		TMqttifyPublish(
 			FMqttifyMessage&& InMessage,
 			const uint16 InPacketId,
 			const TWeakPtr<FMqttifySocketBase>& InSocket,
-			const FMqttifyConnectionSettingsRef& InConnectionSettings
+			const FMqttifyConnectionSettingsRef& InConnectionSettings,
+			const TSharedRef<FMqttifyPacketCache>& InRetransmitCache,
+			const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases = nullptr
 			);
 
 		virtual void Abandon() override;
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
+		virtual bool EncodeForBatch(TArray<uint8>& OutBuffer) override;
+
+		/**
+		 * @brief Continue a publish whose PUBREC was received before the client restarted, the next packet sent is
+		 * its PUBREL.
+		 */
+		void RestoreReleased();
+
+		/// @brief Send the publish with the DUP flag, it was recovered from the session store after a restart.
+		void MarkRecovered();
 
 	protected:
 		virtual bool NextImpl() override;
 		virtual bool IsDone() const override;
-		bool HandlePubRec(const FMqttifyPacketPtr& InPacket);
-		bool HandlePubComp(const FMqttifyPacketPtr& InPacket);
+		bool HandlePubRec(const IMqttifyControlPacket& InPacket);
+		bool HandlePubComp(const IMqttifyControlPacket& InPacket);
 	};
 
 	template <>
@@ -72,13 +100,15 @@ namespace Mqttify
 	{
 	private:
 		TSharedRef<TMqttifyPublishPacket<GMqttifyProtocol>> PublishPacket;
+		TSharedPtr<FMqttifyOutboundTopicAliases> TopicAliases;
 		bool bIsDone;
 
 	public:
 		explicit TMqttifyPublish(
 			FMqttifyMessage&& InMessage,
 			const TWeakPtr<FMqttifySocketBase>& InSocket,
-			const FMqttifyConnectionSettingsRef& InConnectionSettings
+			const FMqttifyConnectionSettingsRef& InConnectionSettings,
+			const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases = nullptr
 			);
 
 		virtual bool NextImpl() override;
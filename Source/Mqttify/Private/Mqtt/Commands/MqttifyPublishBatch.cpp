@@ -0,0 +1,165 @@
+#include "Mqtt/Commands/MqttifyPublishBatch.h"
+
+#include "LogMqttify.h"
+#include "Packets/MqttifyPublishPacket.h"
+
+namespace Mqttify
+{
+	FMqttifyPublishBatch::FMqttifyPublishBatch(
+		const int32 InNumMessages,
+		const TWeakPtr<FMqttifySocketBase>& InSocket,
+		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases
+		)
+		: TMqttifyQueueable{InSocket, InConnectionSettings}
+		, NumBytes{0}
+		, TopicAliases{InTopicAliases}
+		, bIsDone{false}
+		, NumRemaining{InNumMessages}
+		, bHaveAllSucceeded{true}
+	{
+		Results.Init(TMqttifyResult<void>{false}, InNumMessages);
+		if (InNumMessages == 0)
+		{
+			SetPromiseValue(TMqttifyResult<FMqttifyPublishResults>{true, FMqttifyPublishResults{}});
+		}
+	}
+
+	void FMqttifyPublishBatch::AddMessage(const int32 InIndex, FMqttifyMessage&& InMessage, const uint32 InSize)
+	{
+		Entries.Add(FEntry{InIndex, MoveTemp(InMessage), nullptr});
+		NumBytes += InSize;
+	}
+
+	void FMqttifyPublishBatch::AddPublish(const int32 InIndex,
+										const TSharedRef<FMqttifyQueueable>& InPublish,
+										const uint32 InSize)
+	{
+		Entries.Add(FEntry{InIndex, {}, InPublish});
+		NumBytes += InSize;
+	}
+
+	void FMqttifyPublishBatch::DropPublishes()
+	{
+		Entries.RemoveAll([](const FEntry& InEntry) { return !InEntry.Message.IsSet(); });
+	}
+
+	void FMqttifyPublishBatch::SetResult(const int32 InIndex, const TMqttifyResult<void>& InResult)
+	{
+		FScopeLock Lock{&ResultsCriticalSection};
+		if (!Results.IsValidIndex(InIndex) || NumRemaining == 0)
+		{
+			return;
+		}
+
+		Results[InIndex] = InResult;
+		bHaveAllSucceeded &= InResult.HasSucceeded();
+		if (--NumRemaining == 0)
+		{
+			SetPromiseValue(TMqttifyResult<FMqttifyPublishResults>{bHaveAllSucceeded, MoveTemp(Results)});
+		}
+	}
+
+	bool FMqttifyPublishBatch::NextImpl()
+	{
+		bIsDone = true;
+		const TSharedPtr<FMqttifySocketBase> PinnedSocket = Socket.Pin();
+		if (!PinnedSocket.IsValid() || !PinnedSocket->IsConnected())
+		{
+			// The QoS 1 and 2 publishes stay in flight and send themselves on the next connection
+			for (const FEntry& Entry : Entries)
+			{
+				if (Entry.Message.IsSet())
+				{
+					SetResult(Entry.Index, TMqttifyResult<void>{false});
+				}
+			}
+			Entries.Empty();
+			return true;
+		}
+
+		TArray<uint8> Buffer;
+		Buffer.Reserve(NumBytes);
+		TArray<int32> Written;
+		TArray<TSharedPtr<FMqttifyQueueable>> Publishes;
+		for (FEntry& Entry : Entries)
+		{
+			if (Entry.Message.IsSet())
+			{
+				TMqttifyPublishPacket<GMqttifyProtocol> Packet{MoveTemp(Entry.Message.GetValue()), 0};
+				if (TopicAliases.IsValid())
+				{
+					bool bIsNew = false;
+					if (const uint16 Alias = TopicAliases->Assign(Packet.GetTopicName(), bIsNew); Alias != 0)
+					{
+						Packet.SetTopicAlias(Alias, !bIsNew);
+					}
+				}
+				if (EncodePacket(Packet, Buffer))
+				{
+					Written.Add(Entry.Index);
+				}
+				else
+				{
+					SetResult(Entry.Index, TMqttifyResult<void>{false});
+				}
+			}
+			else if (const TSharedPtr<FMqttifyQueueable> Publish = Entry.Publish.Pin())
+			{
+				// A publish that was already sent by the in-flight table is skipped
+				if (Publish->EncodeForBatch(Buffer))
+				{
+					Publishes.Add(Publish);
+				}
+			}
+		}
+		Entries.Empty();
+
+		LOG_MQTTIFY(
+			VeryVerbose,
+			TEXT("(Connection %s, ClientId %s) Sending a batch of %d publishes, %d bytes"),
+			*Settings->GetHost(),
+			*Settings->GetClientIdRef(),
+			Written.Num() + Publishes.Num(),
+			Buffer.Num());
+		PinnedSocket->SendEncoded(Buffer);
+
+		for (const TSharedPtr<FMqttifyQueueable>& Publish : Publishes)
+		{
+			Publish->MarkSent(*PinnedSocket);
+		}
+		for (const int32 Index : Written)
+		{
+			SetResult(Index, TMqttifyResult<void>{true});
+		}
+		return true;
+	}
+
+	void FMqttifyPublishBatch::Abandon()
+	{
+		FScopeLock Lock{&CriticalSection};
+		if (!bIsDone)
+		{
+			bIsDone = true;
+			LOG_MQTTIFY(
+				Warning,
+				TEXT("[Publish Batch (Connection %s, ClientId %s)] Abandoning"),
+				*Settings->GetHost(),
+				*Settings->GetClientId());
+			for (const FEntry& Entry : Entries)
+			{
+				if (Entry.Message.IsSet())
+				{
+					SetResult(Entry.Index, TMqttifyResult<void>{false});
+				}
+			}
+			Entries.Empty();
+		}
+	}
+
+	bool FMqttifyPublishBatch::IsDone() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return bIsDone;
+	}
+} // namespace Mqttify
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/Commands/MqttifyQueueable.h"
+#include "Mqtt/State/MqttifyTopicAliases.h"
+
+namespace Mqttify
+{
+	/// @brief Results of a batch publish, one per message in the order the messages were given.
+	using FMqttifyPublishResults = TArray<TMqttifyResult<void>>;
+
+	/**
+	 * @brief Publishes many messages with one future.
+	 *
+	 * Run as a one shot command, the batch encodes its QoS 0 messages and the first send of the QoS 1 and 2
+	 * publishes it was given into one buffer and writes it to the socket at once. The QoS 1 and 2 publishes are
+	 * still commands of their own, in flight until acknowledged, and report their results to the batch through
+	 * SetResult. The future is fulfilled once every message has a result, it succeeds if all of them did.
+	 */
+	class FMqttifyPublishBatch final : public TMqttifyQueueable<FMqttifyPublishResults>
+	{
+	private:
+		struct FEntry
+		{
+			/// @brief Position of the message in the batch.
+			int32 Index;
+			/// @brief A QoS 0 message, written by the batch.
+			TOptional<FMqttifyMessage> Message;
+			/// @brief A QoS 1 or 2 publish whose first send is written by the batch. Owned by the in-flight table.
+			TWeakPtr<FMqttifyQueueable> Publish;
+		};
+
+		TArray<FEntry> Entries;
+		/// @brief Encoded size of the entries, the buffer is reserved once.
+		uint32 NumBytes;
+		TSharedPtr<FMqttifyOutboundTopicAliases> TopicAliases;
+		bool bIsDone;
+
+		/// @brief Guards the results, which the publishes of the batch report from any thread.
+		FCriticalSection ResultsCriticalSection{};
+		FMqttifyPublishResults Results;
+		int32 NumRemaining;
+		bool bHaveAllSucceeded;
+
+	public:
+		/**
+		 * @brief Create a batch.
+		 * @param InNumMessages The number of messages in the batch, each of which gets a result.
+		 * @param InSocket The socket to write to.
+		 * @param InConnectionSettings The connection settings.
+		 * @param InTopicAliases The topic aliases of the connection, may be null.
+		 */
+		explicit FMqttifyPublishBatch(
+			int32 InNumMessages,
+			const TWeakPtr<FMqttifySocketBase>& InSocket,
+			const FMqttifyConnectionSettingsRef& InConnectionSettings,
+			const TSharedPtr<FMqttifyOutboundTopicAliases>& InTopicAliases = nullptr
+			);
+
+		/**
+		 * @brief Add a QoS 0 message, it succeeds once written to the socket.
+		 * @param InIndex The position of the message in the batch.
+		 * @param InMessage The message.
+		 * @param InSize The encoded size of the message.
+		 */
+		void AddMessage(int32 InIndex, FMqttifyMessage&& InMessage, uint32 InSize);
+
+		/**
+		 * @brief Add a QoS 1 or 2 publish whose first send the batch writes. Its result is reported through
+		 * SetResult by the caller.
+		 * @param InIndex The position of the message in the batch.
+		 * @param InPublish The publish command.
+		 * @param InSize The encoded size of the publish.
+		 */
+		void AddPublish(int32 InIndex, const TSharedRef<FMqttifyQueueable>& InPublish, uint32 InSize);
+
+		/// @brief Leave the QoS 1 and 2 publishes to send themselves, used when they have to wait for the window.
+		void DropPublishes();
+
+		/// @return True if the batch has anything to write.
+		bool HasEntries() const { return Entries.Num() > 0; }
+
+		/**
+		 * @brief Record the result of a message.
+		 * @param InIndex The position of the message in the batch.
+		 * @param InResult The result.
+		 */
+		void SetResult(int32 InIndex, const TMqttifyResult<void>& InResult);
+
+		virtual bool NextImpl() override;
+		virtual void Abandon() override;
+
+	protected:
+		virtual bool IsDone() const override;
+	};
+
+	using FMqttifyPublishBatchRef = TSharedRef<FMqttifyPublishBatch>;
+} // namespace Mqttify
@@ -5,7 +5,7 @@
 
 namespace Mqttify
 {
-	bool FMqttifyQueueable::Next()
+	bool FMqttifyQueueable::Next(const double InNow)
 	{
 		FScopeLock Lock{&CriticalSection};
 
@@ -14,7 +14,7 @@ namespace Mqttify
 			return true;
 		}
 
-		if (RetryWaitTime > FDateTime::UtcNow())
+		if (RetryWaitTime > InNow)
 		{
 			return false;
 		}
@@ -28,6 +28,13 @@ namespace Mqttify
 		return NextImpl();
 	}
 
+	void FMqttifyQueueable::Rearm()
+	{
+		FScopeLock Lock{&CriticalSection};
+		PacketTries = 0;
+		RetryWaitTime = 0.0;
+	}
+
 	void FMqttifyQueueable::SendPacketInternal(const TSharedRef<IMqttifyControlPacket>& InPacket)
 	{
 
@@ -38,6 +45,7 @@ namespace Mqttify
 				return;
 			}
 			++PacketTries;
+			LastSendTime = FPlatformTime::Seconds();
 			LOG_MQTTIFY_PACKET(
 				VeryVerbose,
 				TEXT( "(Connection %s, ClientId %s) Sending %s, Attempt %d"),
@@ -48,6 +56,7 @@ namespace Mqttify
 				PacketTries);
 
 			PinnedSocket->Send(InPacket);
+			bHasBeenSent = true;
 
 			if (!PinnedSocket->IsConnected())
 			{
@@ -60,19 +69,133 @@ namespace Mqttify
 				Abandon();
 			}
 
-			const double Jitter = FMath::RandRange(0.0, 1.0);
-			const double Backoff = FMath::Pow(Settings->GetPacketRetryBackoffMultiplier(), PacketTries);
-			const double RetryInterval = FMath::Min(
-				Settings->GetInitialRetryIntervalSeconds() * Backoff,
-				Settings->GetMaxPacketRetryIntervalSeconds());
-			RetryWaitTime = FDateTime::UtcNow() + FTimespan::FromSeconds(RetryInterval + Jitter);
+			ScheduleRetry(*PinnedSocket);
+		}
+	}
+
+	void FMqttifyQueueable::MarkSent(FMqttifySocketBase& InSocket)
+	{
+		FScopeLock Lock{&CriticalSection};
+		++PacketTries;
+		LastSendTime = FPlatformTime::Seconds();
+		bHasBeenSent = true;
+		ScheduleRetry(InSocket);
+	}
+
+	void FMqttifyQueueable::SendAckInternal(const EMqttifyPacketType InPacketType,
+											const uint16 InPacketId,
+											const EMqttifyReasonCode InReasonCode)
+	{
+		if (const TSharedPtr<FMqttifySocketBase> PinnedSocket = Socket.Pin())
+		{
+			if (!PinnedSocket->IsConnected())
+			{
+				return;
+			}
+			++PacketTries;
+			LastSendTime = FPlatformTime::Seconds();
 			LOG_MQTTIFY(
 				VeryVerbose,
-				TEXT( "(Connection %s, ClientId %s) Retry interval %f, Retry wait time %s"),
+				TEXT( "(Connection %s, ClientId %s) Sending %s %d, Attempt %d"),
 				*Settings->GetHost(),
-				*Settings->GetClientId(),
-				RetryInterval,
-				*RetryWaitTime.ToString());
+				*Settings->GetClientIdRef(),
+				EnumToTCharString(InPacketType),
+				InPacketId,
+				PacketTries);
+
+			PinnedSocket->SendAck(InPacketType, InPacketId, InReasonCode);
+			bHasBeenSent = true;
+			ScheduleRetry(*PinnedSocket);
+		}
+	}
+
+	void FMqttifyQueueable::SendEncodedInternal(const EMqttifyPacketType InPacketType,
+												const uint16 InPacketId,
+												const TArray<uint8>& InBytes)
+	{
+		if (const TSharedPtr<FMqttifySocketBase> PinnedSocket = Socket.Pin())
+		{
+			if (!PinnedSocket->IsConnected())
+			{
+				return;
+			}
+			++PacketTries;
+			LastSendTime = FPlatformTime::Seconds();
+			LOG_MQTTIFY_PACKET_DATA(
+				VeryVerbose,
+				InBytes.GetData(),
+				InBytes.Num(),
+				TEXT( "(Connection %s, ClientId %s) Sending %s %d, Attempt %d"),
+				*Settings->GetHost(),
+				*Settings->GetClientIdRef(),
+				EnumToTCharString(InPacketType),
+				InPacketId,
+				PacketTries);
+
+			PinnedSocket->SendEncoded(InBytes);
+			bHasBeenSent = true;
+
+			// The command stays in flight, it is sent again if the next connection resumes the session
+			UE_CLOG(
+				!PinnedSocket->IsConnected(),
+				LogMqttify,
+				Warning,
+				TEXT( "(Connection %s, ClientId %s) Socket disconnected while sending %s %d"),
+				*Settings->GetHost(),
+				*Settings->GetClientIdRef(),
+				EnumToTCharString(InPacketType),
+				InPacketId);
+
+			ScheduleRetry(*PinnedSocket);
+		}
+	}
+
+	void FMqttifyQueueable::ScheduleRetry(FMqttifySocketBase& InSocket)
+	{
+		double RetryInterval;
+		switch (Settings->GetRetryPolicy())
+		{
+			case EMqttifyRetryPolicy::Adaptive:
+			{
+				// Back off from the estimated timeout for each try, as TCP does
+				const double Backoff = FMath::Pow(Settings->GetPacketRetryBackoffMultiplier(), PacketTries - 1);
+				RetryInterval = FMath::Min(
+					InSocket.GetRttEstimator().GetRetryTimeout() * Backoff,
+					static_cast<double>(Settings->GetMaxPacketRetryIntervalSeconds()));
+				break;
+			}
+			case EMqttifyRetryPolicy::ExponentialBackoff:
+			default:
+			{
+				const double Jitter = FMath::RandRange(0.0, 1.0);
+				const double Backoff = FMath::Pow(Settings->GetPacketRetryBackoffMultiplier(), PacketTries);
+				RetryInterval = FMath::Min(
+					Settings->GetInitialRetryIntervalSeconds() * Backoff,
+					Settings->GetMaxPacketRetryIntervalSeconds()) + Jitter;
+				break;
+			}
+		}
+
+		RetryWaitTime = FPlatformTime::Seconds() + RetryInterval;
+		LOG_MQTTIFY(
+			VeryVerbose,
+			TEXT( "(Connection %s, ClientId %s) Retry interval %f, Retry wait time %f"),
+			*Settings->GetHost(),
+			*Settings->GetClientId(),
+			RetryInterval,
+			RetryWaitTime);
+	}
+
+	void FMqttifyQueueable::SampleRoundTrip()
+	{
+		if (PacketTries != 1 || LastSendTime <= 0.0)
+		{
+			return;
+		}
+
+		if (const TSharedPtr<FMqttifySocketBase> PinnedSocket = Socket.Pin())
+		{
+			PinnedSocket->GetRttEstimator().AddSample(FPlatformTime::Seconds() - LastSendTime);
 		}
 	}
-}
\ No newline at end of file
+}
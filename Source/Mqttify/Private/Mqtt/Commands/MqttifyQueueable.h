@@ -28,7 +28,7 @@ namespace Mqttify
 		 * @param InPacket The acknowledge packet
 		 * @return True if the command is done.
 		 */
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) = 0;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) = 0;
 
 		/**
 		 * @brief Get the key of the command
@@ -51,14 +51,24 @@ namespace Mqttify
 			)
 			: Settings{InConnectionSettings}
 			, Socket{InSocket}
-			, RetryWaitTime{FDateTime::MinValue()}
-			, PacketTries{0} {}
+			, RetryWaitTime{0.0}
+			, LastSendTime{0.0}
+			, CreatedTime{FPlatformTime::Seconds()}
+			, PacketTries{0}
+			, bHasBeenSent{false} {}
 
 		/**
 		 * @brief Trigger the action
 		 * @return True if the command is done.
 		 */
-		bool Next();
+		bool Next() { return Next(FPlatformTime::Seconds()); }
+
+		/**
+		 * @brief Trigger the action
+		 * @param InNow The current FPlatformTime::Seconds(), so a batch of commands shares one clock read.
+		 * @return True if the command is done.
+		 */
+		bool Next(double InNow);
 
 		/**
 		 * @brief Abandon the command.
@@ -72,6 +82,50 @@ namespace Mqttify
 		 */
 		virtual IMqttifyAcknowledgeable* AsAcknowledgeable() { return nullptr; }
 
+		/**
+		 * @brief Get the time the command is next due, as read by the in-flight table after Next or Acknowledge.
+		 * @return The FPlatformTime::Seconds() after which the command is due.
+		 */
+		double GetRetryWaitTime() const { return RetryWaitTime; }
+
+		/**
+		 * @brief Get the number of times the current packet has been sent.
+		 * @return The number of tries.
+		 */
+		uint8 GetPacketTries() const { return PacketTries; }
+
+		/**
+		 * @brief Make the command due straight away with a fresh set of tries. Used to send it again on a new
+		 * connection that resumed the session, a publish sent before still goes out as a duplicate.
+		 */
+		void Rearm();
+
+		/**
+		 * @brief Check if the packet of the command was sent on this or an earlier connection.
+		 * @return True if the packet was sent at least once.
+		 */
+		bool HasBeenSent() const { return bHasBeenSent; }
+
+		/**
+		 * @brief Encode the first send of the packet after the bytes already in a buffer, for a batch that writes
+		 * the packets of many commands to the socket at once. Call MarkSent once the buffer was written.
+		 * @param OutBuffer The buffer to append to.
+		 * @return False if the command can't be batched or was already sent, nothing is written then.
+		 */
+		virtual bool EncodeForBatch(TArray<uint8>& OutBuffer) { return false; }
+
+		/**
+		 * @brief Record a send made on behalf of the command, scheduling its retry as if it had sent the packet.
+		 * @param InSocket The socket the packet was written to.
+		 */
+		void MarkSent(FMqttifySocketBase& InSocket);
+
+		/**
+		 * @brief Get the time the command was created.
+		 * @return The FPlatformTime::Seconds() the command was created at.
+		 */
+		double GetCreatedTime() const { return CreatedTime; }
+
 	protected:
 		/**
 		 * @brief Send the packet over the Socket.
@@ -79,6 +133,37 @@ namespace Mqttify
 		 */
 		void SendPacketInternal(const TSharedRef<IMqttifyControlPacket>& InPacket);
 
+		/**
+		 * @brief Send an acknowledgement or PINGREQ over the Socket without building a packet.
+		 * @param InPacketType The packet type to send.
+		 * @param InPacketId The packet identifier.
+		 * @param InReasonCode The MQTT 5 reason code.
+		 */
+		void SendAckInternal(EMqttifyPacketType InPacketType,
+							uint16 InPacketId = 0,
+							EMqttifyReasonCode InReasonCode = EMqttifyReasonCode::Success);
+
+		/**
+		 * @brief Send an already encoded packet over the Socket.
+		 * @param InPacketType The packet type, for logging.
+		 * @param InPacketId The packet identifier, for logging.
+		 * @param InBytes The encoded packet.
+		 */
+		void SendEncodedInternal(EMqttifyPacketType InPacketType, uint16 InPacketId, const TArray<uint8>& InBytes);
+
+		/**
+		 * @brief Set RetryWaitTime after a send, following the retry policy of the connection settings.
+		 * @param InSocket The socket the packet was sent over.
+		 */
+		void ScheduleRetry(FMqttifySocketBase& InSocket);
+
+		/**
+		 * @brief Feed the time since the last send to the round trip time estimate of the socket.
+		 * Call when the acknowledgement of the last packet sent arrives. Packets that were sent more than once are
+		 * skipped, as the acknowledgement can't be matched to one of the copies (Karn's algorithm).
+		 */
+		void SampleRoundTrip();
+
 		/**
 		 * @brief Trigger the action
 		 * @return True if the command is done.
@@ -93,9 +178,16 @@ namespace Mqttify
 
 		FMqttifyConnectionSettingsRef Settings;
 		TWeakPtr<FMqttifySocketBase> Socket;
-		FDateTime RetryWaitTime;
+		/// @brief FPlatformTime::Seconds() after which the command is due again.
+		double RetryWaitTime;
+		/// @brief FPlatformTime::Seconds() of the last send.
+		double LastSendTime;
+		/// @brief FPlatformTime::Seconds() the command was created at.
+		double CreatedTime;
 		mutable FCriticalSection CriticalSection{};
 		uint8 PacketTries;
+		/// @brief True once the packet was sent, kept across connections so a replayed publish is marked DUP.
+		bool bHasBeenSent;
 	};
 
 	template <typename TReturnValue>
@@ -103,6 +195,7 @@ namespace Mqttify
 	{
 	private:
 		TSharedRef<TPromise<TMqttifyResult<TReturnValue>>> CommandPromise;
+		TFunction<void(const TMqttifyResult<TReturnValue>&)> OnResult;
 		std::atomic_bool bIsDone;
 
 	public:
@@ -125,6 +218,17 @@ namespace Mqttify
 			return CommandPromise->GetFuture();
 		}
 
+		/**
+		 * @brief Report the result to a callback on the thread that completes the command, instead of dispatching
+		 * it to the future. Used by batches, which fulfil one future for many commands. Set before the command is
+		 * queued.
+		 * @param InOnResult Called once with the result.
+		 */
+		void SetOnResult(TFunction<void(const TMqttifyResult<TReturnValue>&)>&& InOnResult)
+		{
+			OnResult = MoveTemp(InOnResult);
+		}
+
 	protected:
 		/**
 		 * @brief Sets the promise value for the MQTT command result.
@@ -152,6 +256,14 @@ namespace Mqttify
 				*Settings->GetClientIdRef(),
 				InValue.HasSucceeded() ? TEXT("true") : TEXT("false"));
 
+			// Nothing waits on the future of a batched command, set it in place
+			if (OnResult)
+			{
+				OnResult(InValue);
+				CommandPromise->SetValue(MoveTemp(InValue));
+				return;
+			}
+
 			TSharedRef<TPromise<TMqttifyResult<TReturnValue>>> CapturedPromise = CommandPromise;
 			FMqttifyConnectionSettingsRef CapturedSettings = Settings;
 			DispatchWithThreadHandling(
@@ -35,36 +35,37 @@ namespace Mqttify
 		SetPromiseValue(TMqttifyResult<TArray<FMqttifySubscribeResult>>{false, {}});
 	}
 
-	bool FMqttifySubscribe::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool FMqttifySubscribe::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
-		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket->GetPacketType()));
+		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledge %s"), EnumToTCharString(InPacket.GetPacketType()));
 
 		if (bIsDone)
 		{
 			return true;
 		}
 
-		if (InPacket->GetPacketType() != EMqttifyPacketType::SubAck)
+		if (InPacket.GetPacketType() != EMqttifyPacketType::SubAck)
 		{
 			LOG_MQTTIFY(
 				Error,
 				TEXT("[Subscribe] %s Expected: Actual: %s"),
 				EnumToTCharString(EMqttifyPacketType::SubAck),
-				EnumToTCharString(InPacket->GetPacketType()));
+				EnumToTCharString(InPacket.GetPacketType()));
 			Abandon();
 			return true;
 		}
 
+		SampleRoundTrip();
 		bIsDone = true;
 
 		TArray<FMqttifySubscribeResult> SubscribeResults;
 		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
 		{
-			const FMqttifySubAckPacket5* SubAckPacket = static_cast<const FMqttifySubAckPacket5*>(InPacket.Get());
+			const FMqttifySubAckPacket5& SubAckPacket = static_cast<const FMqttifySubAckPacket5&>(InPacket);
 			for (int32 i = 0; i < TopicFilters.Num(); ++i)
 			{
-				switch (SubAckPacket->GetReasonCodes()[i])
+				switch (SubAckPacket.GetReasonCodes()[i])
 				{
 					case EMqttifyReasonCode::Success:
 					case EMqttifyReasonCode::GrantedQualityOfService1:
@@ -85,9 +86,9 @@ namespace Mqttify
 		}
 		else
 		{
-			const FMqttifySubAckPacket3* SubAckPacket = static_cast<const FMqttifySubAckPacket3*>(InPacket.Get());
+			const FMqttifySubAckPacket3& SubAckPacket = static_cast<const FMqttifySubAckPacket3&>(InPacket);
 
-			if (TopicFilters.Num() != SubAckPacket->GetReturnCodes().Num())
+			if (TopicFilters.Num() != SubAckPacket.GetReturnCodes().Num())
 			{
 				LOG_MQTTIFY(
 					Error,
@@ -95,14 +96,14 @@ namespace Mqttify
 					*Settings->GetHost(),
 					*Settings->GetClientId(),
 					TopicFilters.Num(),
-					SubAckPacket->GetReturnCodes().Num());
+					SubAckPacket.GetReturnCodes().Num());
 				Abandon();
 				return true;
 			}
 
 			for (int32 i = 0; i < TopicFilters.Num(); ++i)
 			{
-				const bool bSuccess = SubAckPacket->GetReturnCodes()[i] != EMqttifySubscribeReturnCode::Failure;
+				const bool bSuccess = SubAckPacket.GetReturnCodes()[i] != EMqttifySubscribeReturnCode::Failure;
 				if (!bSuccess)
 				{
 					SubscribeResults.Add(FMqttifySubscribeResult{TopicFilters[i].Get<0>(), bSuccess});
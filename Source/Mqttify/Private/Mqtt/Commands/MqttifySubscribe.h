@@ -18,7 +18,7 @@ namespace Mqttify
 			const FMqttifyConnectionSettingsRef& InConnectionSettings);
 
 		virtual void Abandon() override;
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
 
 	protected:
 		virtual bool IsDone() const override;
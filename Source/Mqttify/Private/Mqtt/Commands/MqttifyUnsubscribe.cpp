@@ -41,7 +41,7 @@ namespace Mqttify
 		return bIsDone;
 	}
 
-	bool FMqttifyUnsubscribe::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	bool FMqttifyUnsubscribe::Acknowledge(const IMqttifyControlPacket& InPacket)
 	{
 		FScopeLock Lock{&CriticalSection};
 		LOG_MQTTIFY(
@@ -49,20 +49,14 @@ namespace Mqttify
 			TEXT("[Acknowledge (Connection %s, ClientId %s)] Acknowledge %s"),
 			*Settings->GetHost(),
 			*Settings->GetClientId(),
-			EnumToTCharString(InPacket->GetPacketType()));
+			EnumToTCharString(InPacket.GetPacketType()));
 
 		if (bIsDone)
 		{
 			return true;
 		}
 
-		if (InPacket == nullptr)
-		{
-			checkNoEntry();
-			return false;
-		}
-
-		if (InPacket->GetPacketType() != EMqttifyPacketType::UnsubAck)
+		if (InPacket.GetPacketType() != EMqttifyPacketType::UnsubAck)
 		{
 			LOG_MQTTIFY(
 				Error,
@@ -70,21 +64,22 @@ namespace Mqttify
 				*Settings->GetHost(),
 				*Settings->GetClientId(),
 				EnumToTCharString(EMqttifyPacketType::UnsubAck),
-				EnumToTCharString(InPacket->GetPacketType()));
+				EnumToTCharString(InPacket.GetPacketType()));
 			Abandon();
 			return true;
 		}
 
+		SampleRoundTrip();
 		bIsDone = true;
 
 		TArray<FMqttifyUnsubscribeResult> UnsubscribeResults;
 
 		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
 		{
-			const FMqttifyUnsubAckPacket5* UnsubAckPacket = static_cast<const FMqttifyUnsubAckPacket5*>(InPacket.Get());
+			const FMqttifyUnsubAckPacket5& UnsubAckPacket = static_cast<const FMqttifyUnsubAckPacket5&>(InPacket);
 			for (int32 i = 0; i < TopicFilters.Num(); ++i)
 			{
-				switch (UnsubAckPacket->GetReasonCodes()[i])
+				switch (UnsubAckPacket.GetReasonCodes()[i])
 				{
 					case EMqttifyReasonCode::Success:
 					case EMqttifyReasonCode::NoSubscriptionExisted:
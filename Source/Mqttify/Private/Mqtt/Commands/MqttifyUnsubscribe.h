@@ -22,7 +22,7 @@ namespace Mqttify
 		                             const uint16 InPacketId,
 		                             const TWeakPtr<FMqttifySocketBase>& InSocket,
 		                             const FMqttifyConnectionSettingsRef& InConnectionSettings);
-		virtual bool Acknowledge(const FMqttifyPacketPtr& InPacket) override;
+		virtual bool Acknowledge(const IMqttifyControlPacket& InPacket) override;
 		virtual void Abandon() override;
 
 	private:
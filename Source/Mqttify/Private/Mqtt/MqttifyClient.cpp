@@ -3,13 +3,13 @@
 #include "LogMqttify.h"
 #include "MqttifyAsync.h"
 #include "Commands/MqttifyPublish.h"
-#include "Commands/MqttifySubscribe.h"
-#include "Commands/MqttifyUnsubscribe.h"
 #include "Interface/IMqttifyPacketReceiver.h"
 #include "Interface/IMqttifySocketConnectedHandler.h"
 #include "Interface/IMqttifySocketDisconnectHandler.h"
 #include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/MqttifySubscribeResult.h"
 #include "Mqtt/MqttifyTopicFilter.h"
+#include "Mqtt/MqttifyUnsubscribeResult.h"
 #include "Mqtt/Interface/IMqttifyConnectableAsync.h"
 #include "Mqtt/Interface/IMqttifyDisconnectableAsync.h"
 #include "Mqtt/State/MqttifyClientDisconnectedState.h"
@@ -17,12 +17,58 @@
 
 namespace Mqttify
 {
-	FMqttifyClient::FMqttifyClient(const FMqttifyConnectionSettingsRef& InConnectionSettings)
-		: Context{MakeShared<FMqttifyClientContext>(InConnectionSettings)}
-		, Socket{FMqttifySocketBase::Create(InConnectionSettings)} {}
+	FMqttifyClient::FMqttifyClient(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+									const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel)
+		: TimerWheel{InTimerWheel.IsValid() ? InTimerWheel.ToSharedRef() : MakeShared<FMqttifyTimerWheel>()}
+		, bOwnsTimerWheel{!InTimerWheel.IsValid()}
+		, Context{MakeShared<FMqttifyClientContext>(InConnectionSettings, TimerWheel)}
+		, Socket{FMqttifySocketBase::Create(InConnectionSettings, TimerWheel)}
+	{
+		RestoreSession();
+	}
+
+	void FMqttifyClient::RestoreSession() const
+	{
+		for (FMqttifySessionStore::FStoredPublish& Recovered : Context->TakeRecoveredPublishes())
+		{
+			// The broker may have received the publish before the restart, it is sent again as a duplicate
+			if (Recovered.Message.GetQualityOfService() == EMqttifyQualityOfService::AtLeastOnce)
+			{
+				const FMqttifyPubAtLeastOnceRef PublishCommand = MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+					MoveTemp(Recovered.Message),
+					Recovered.PacketId,
+					Socket,
+					Context->GetConnectionSettings(),
+					Context->GetRetransmitCache(),
+					Context->GetOutboundTopicAliases());
+				PublishCommand->MarkRecovered();
+				Context->AddPublishCommand(PublishCommand);
+				continue;
+			}
+
+			const FMqttifyPubExactlyOnceRef PublishCommand = MakeShared<FMqttifyPubExactlyOnce, ESPMode::ThreadSafe>(
+				MoveTemp(Recovered.Message),
+				Recovered.PacketId,
+				Socket,
+				Context->GetConnectionSettings(),
+				Context->GetRetransmitCache(),
+				Context->GetOutboundTopicAliases());
+			PublishCommand->MarkRecovered();
+			if (Recovered.bIsReleased)
+			{
+				PublishCommand->RestoreReleased();
+			}
+			Context->AddPublishCommand(PublishCommand);
+		}
+	}
 
 	void FMqttifyClient::Tick()
 	{
+		if (bOwnsTimerWheel)
+		{
+			TimerWheel->Advance();
+		}
+
 		FScopeLock Lock{&StateLock};
 		if (!CurrentState.IsValid())
 		{
@@ -85,7 +131,6 @@ namespace Mqttify
 
 	TFuture<TMqttifyResult<void>> FMqttifyClient::PublishAsync(FMqttifyMessage&& InMessage)
 	{
-		FScopeLock Lock{&StateLock};
 		LOG_MQTTIFY(
 			Verbose,
 			TEXT("[Publishing (Connection %s, ClientId %s)] %s, QoS %s"),
@@ -93,47 +138,29 @@ namespace Mqttify
 			*GetConnectionSettings()->GetClientIdRef(),
 			*InMessage.GetTopic(),
 			EnumToTCharString(InMessage.GetQualityOfService()));
-		switch (InMessage.GetQualityOfService())
+		return Context->PublishAsync(MoveTemp(InMessage), Socket);
+	}
+
+	TFuture<TMqttifyResult<TArray<TMqttifyResult<void>>>> FMqttifyClient::PublishBatchAsync(
+		TArray<FMqttifyMessage>&& InMessages)
+	{
+		LOG_MQTTIFY(
+			Verbose,
+			TEXT("[Publishing (Connection %s, ClientId %s)] Batch of %d messages"),
+			*GetConnectionSettings()->GetHost(),
+			*GetConnectionSettings()->GetClientIdRef(),
+			InMessages.Num());
+		return Context->PublishBatchAsync(MoveTemp(InMessages), Socket);
+	}
+
+	bool FMqttifyClient::PublishFireAndForget(FMqttifyMessage&& InMessage)
+	{
+		FScopeLock Lock{&StateLock};
+		if (!CurrentState.IsValid() || CurrentState->GetState() != EMqttifyState::Connected)
 		{
-			case EMqttifyQualityOfService::AtMostOnce:
-			{
-				const FMqttifyPubAtMostOnceRef PublishCommand = MakeShared<FMqttifyPubAtMostOnce, ESPMode::ThreadSafe>(
-					MoveTemp(InMessage),
-					Socket,
-					Context->GetConnectionSettings());
-				Context->AddOneShotCommand(PublishCommand);
-				return PublishCommand->GetFuture();
-			}
-			case EMqttifyQualityOfService::AtLeastOnce:
-			{
-				const uint16 PacketId = Context->GetNextId();
-				const FMqttifyPubAtLeastOnceRef PublishCommand = MakeShared<
-					FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
-					MoveTemp(InMessage),
-					PacketId,
-					Socket,
-					Context->GetConnectionSettings());
-				Context->AddAcknowledgeableCommand(PublishCommand);
-				return PublishCommand->GetFuture();
-			}
-			case EMqttifyQualityOfService::ExactlyOnce:
-			{
-				const uint16 PacketId = Context->GetNextId();
-				const FMqttifyPubExactlyOnceRef PublishCommand = MakeShared<
-					FMqttifyPubExactlyOnce, ESPMode::ThreadSafe>(
-					MoveTemp(InMessage),
-					PacketId,
-					Socket,
-					Context->GetConnectionSettings());
-				Context->AddAcknowledgeableCommand(PublishCommand);
-				return PublishCommand->GetFuture();
-			}
-			default:
-			{
-				ensureMsgf(false, TEXT("Invalid quality of service"));
-				return MakeThreadAwareFulfilledPromise<TMqttifyResult<void>>(TMqttifyResult<void>{false});
-			}
+			return false;
 		}
+		return Context->PublishFireAndForget(MoveTemp(InMessage), Socket);
 	}
 
 	TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> FMqttifyClient::SubscribeAsync(
@@ -146,10 +173,9 @@ namespace Mqttify
 	}
 
 	TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> FMqttifyClient::SubscribeAsync_Internal(
-		TArray<FMqttifyTopicFilter>&& InTopicFilters)
+		TArray<FMqttifyTopicFilter>&& InTopicFilters,
+		const FOnBulkSubscribeProgress* InOnBulkProgress)
 	{
-		const uint16 PacketId = Context->GetNextId();
-
 		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
 		TopicFilters.Reserve(InTopicFilters.Num());
 		for (FMqttifyTopicFilter& TF : InTopicFilters)
@@ -158,15 +184,12 @@ namespace Mqttify
 			TopicFilters.Emplace(MoveTemp(TF), Delegate);
 		}
 
-		const TSharedRef<FMqttifySubscribe> SubscribeCommand = MakeShared<FMqttifySubscribe>(
-			TopicFilters,
-			PacketId,
-			Socket,
-			Context->GetConnectionSettings());
-
-		Context->AddAcknowledgeableCommand(SubscribeCommand);
+		// Sent with the other subscribes of the tick once connected, or a few packets at a time for a bulk subscribe
 		TWeakPtr<FMqttifyClientContext> WeakContext = Context;
-		return SubscribeCommand->GetFuture().Next(
+		TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> Future = InOnBulkProgress != nullptr
+			? Context->AddBulkSubscribeRequest(MoveTemp(TopicFilters), *InOnBulkProgress)
+			: Context->AddSubscribeRequest(MoveTemp(TopicFilters));
+		return Future.Next(
 			[WeakContext](const TMqttifyResult<TArray<FMqttifySubscribeResult>>& InResult) {
 				if (InResult.HasSucceeded())
 				{
@@ -212,6 +235,13 @@ namespace Mqttify
 		return SubscribeAsync(MoveTemp(TopicFilter));
 	}
 
+	TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> FMqttifyClient::SubscribeBulkAsync(
+		TArray<FMqttifyTopicFilter>&& InTopicFilters,
+		const FOnBulkSubscribeProgress& InOnProgress)
+	{
+		return SubscribeAsync_Internal(MoveTemp(InTopicFilters), &InOnProgress);
+	}
+
 	TFuture<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>> FMqttifyClient::UnsubscribeAsync(
 		const TSet<FString>& InTopicFilters
 		)
@@ -223,23 +253,15 @@ namespace Mqttify
 			TopicFilters.Emplace(TopicFilter);
 		}
 
-		const uint16 PacketId = Context->GetNextId();
-		const TSharedRef<FMqttifyUnsubscribe> UnsubscribeCommand = MakeShared<FMqttifyUnsubscribe>(
-			TopicFilters,
-			PacketId,
-			Socket,
-			Context->GetConnectionSettings());
-
-		Context->AddAcknowledgeableCommand(UnsubscribeCommand);
+		// Sent with the other unsubscribes of the tick once connected, the context drops the delegates on UNSUBACK
 		TWeakPtr<FMqttifyClientContext> WeakContext = Context;
-		return UnsubscribeCommand->GetFuture().Next(
+		return Context->AddUnsubscribeRequest(MoveTemp(TopicFilters)).Next(
 			[WeakContext](const TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>& InResult) {
 				if (InResult.HasSucceeded())
 				{
 					if (const TSharedPtr<FMqttifyClientContext> ContextPtr = WeakContext.Pin())
 					{
 						ContextPtr->OnUnsubscribe().Broadcast(InResult.GetResult());
-						ContextPtr->ClearMessageDelegates(InResult.GetResult());
 					}
 				}
 				else
@@ -292,6 +314,11 @@ namespace Mqttify
 		return CurrentState.IsValid() && CurrentState->GetState() == EMqttifyState::Connected;
 	}
 
+	double FMqttifyClient::GetPingRoundTripSeconds() const
+	{
+		return Context->GetPingRoundTripSeconds();
+	}
+
 	void FMqttifyClient::CloseSocket(int32 Code, const FString& Reason)
 	{
 		// Guard with the same lock used for other state interactions and let the socket handle idempotent Close
@@ -333,6 +360,11 @@ namespace Mqttify
 			*GetConnectionSettings()->GetClientIdRef(),
 			EnumToTCharString(CurrentState->GetState()),
 			EnumToTCharString(InState->GetState()));
+		// The connecting state flushed the offline publishes before it handed over to the connected state
+		if (InState->GetState() != EMqttifyState::Connected)
+		{
+			Context->MarkOffline();
+		}
 		CurrentState = InState;
 	}
 
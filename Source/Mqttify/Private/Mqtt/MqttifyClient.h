@@ -23,7 +23,14 @@ namespace Mqttify
 	class FMqttifyClient final : public ITickableMqttifyClient, public TSharedFromThis<FMqttifyClient>
 	{
 	public:
-		explicit FMqttifyClient(const FMqttifyConnectionSettingsRef& InConnectionSettings);
+		/**
+		 * @brief Constructor for FMqttifyClient.
+		 * @param InConnectionSettings The connection settings.
+		 * @param InTimerWheel The timer wheel shared with other clients, advanced by its owner. When nullptr the
+		 * client creates its own and advances it on tick.
+		 */
+		explicit FMqttifyClient(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+								const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel = nullptr);
 		virtual ~FMqttifyClient() override = default;
 
 		// ITickableMqttifyClient
@@ -35,12 +42,16 @@ namespace Mqttify
 
 		// IMqttifyPublishableAsync
 		virtual FPublishFuture PublishAsync(FMqttifyMessage&& InMessage) override;
+		virtual FPublishesFuture PublishBatchAsync(TArray<FMqttifyMessage>&& InMessages) override;
+		virtual bool PublishFireAndForget(FMqttifyMessage&& InMessage) override;
 		// ~IMqttifyPublishableAsync
 
 		// IMqttifySubscribableAsync
 		virtual FSubscribesFuture SubscribeAsync(const TArray<FMqttifyTopicFilter>& InTopicFilters) override;
 		virtual FSubscribeFuture SubscribeAsync(FMqttifyTopicFilter&& InTopicFilter) override;
 		virtual FSubscribeFuture SubscribeAsync(const FString& InTopicFilter) override;
+		virtual FSubscribesFuture SubscribeBulkAsync(TArray<FMqttifyTopicFilter>&& InTopicFilters,
+													const FOnBulkSubscribeProgress& InOnProgress = {}) override;
 		// ~IMqttifySubscribableAsync
 
 		// IMqttifyUnsubscribableAsync
@@ -57,6 +68,7 @@ namespace Mqttify
 		virtual FOnMessage& OnMessage() override;
 		virtual const FMqttifyConnectionSettingsRef GetConnectionSettings() const override;
 		virtual bool IsConnected() const override;
+		virtual double GetPingRoundTripSeconds() const override;
 		virtual void CloseSocket(int32 Code = 1000, const FString& Reason = {}) override;
 		// ~IMqttifyClient
 
@@ -76,10 +88,22 @@ namespace Mqttify
 		void OnReceivePacket(const TSharedPtr<FArrayReader>& InPacket) const;
 		// ~FMqttifySocketBase Callbacks
 
-		FSubscribesFuture SubscribeAsync_Internal(TArray<FMqttifyTopicFilter>&& InTopicFilters);
+		/**
+		 * @brief Subscribe to the topic filters, sent with the other subscribes of the tick or as a bulk subscribe.
+		 * @param InTopicFilters The topic filters.
+		 * @param InOnBulkProgress The progress delegate of a bulk subscribe, nullptr for a regular one.
+		 */
+		FSubscribesFuture SubscribeAsync_Internal(TArray<FMqttifyTopicFilter>&& InTopicFilters,
+												const FOnBulkSubscribeProgress* InOnBulkProgress = nullptr);
+
+		/// @brief Queue the publishes recovered from the session store, sent once the client connects.
+		void RestoreSession() const;
 		
 		/// @brief The current state of the MQTT client.
 		TSharedPtr<FMqttifyClientState> CurrentState;
+		TSharedRef<FMqttifyTimerWheel> TimerWheel;
+		/// @brief True when the timer wheel was created by this client, which then advances it on tick.
+		bool bOwnsTimerWheel;
 		TSharedRef<FMqttifyClientContext> Context;
 		FMqttifySocketRef Socket;
 		friend class FMqttifyClientState;
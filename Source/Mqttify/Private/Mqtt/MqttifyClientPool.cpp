@@ -10,10 +10,13 @@ namespace Mqttify
 {
 	TSharedPtr<ITickableMqttifyClient> FMqttifyClientPool::Create(
 		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedRef<FMqttifyTimerWheel>& InTimerWheel,
 		FDeleter&& InDeleter
 		)
 	{
-		return MakeShareable<FMqttifyClient>(new FMqttifyClient(InConnectionSettings), MoveTemp(InDeleter));
+		return MakeShareable<FMqttifyClient>(
+			new FMqttifyClient(InConnectionSettings, InTimerWheel),
+			MoveTemp(InDeleter));
 	}
 
 	TSharedPtr<IMqttifyClient> FMqttifyClientPool::GetOrCreateClient(
@@ -61,7 +64,7 @@ namespace Mqttify
 			delete InClient;
 		};
 
-		TSharedPtr<ITickableMqttifyClient> OutClient = Create(InConnectionSettings, MoveTemp(Deleter));
+		TSharedPtr<ITickableMqttifyClient> OutClient = Create(InConnectionSettings, TimerWheel, MoveTemp(Deleter));
 
 		if (nullptr == OutClient)
 		{
@@ -93,7 +96,8 @@ namespace Mqttify
 	}
 
 	FMqttifyClientPool::FMqttifyClientPool()
-		: Thread{nullptr}
+		: TimerWheel{MakeShared<FMqttifyTimerWheel>()}
+		, Thread{nullptr}
 	{
 		if constexpr (GMqttifyThreadMode == EMqttifyThreadMode::GameThread)
 		{
@@ -133,7 +137,10 @@ namespace Mqttify
 			const double StartTime = FPlatformTime::Seconds();
 			Tick();
 			const double EndTime = FPlatformTime::Seconds();
-			const float SleepTime = MaxTickRate - static_cast<float>(EndTime - StartTime);
+			// Wake up early when a timer falls due before the next regular tick
+			const float SleepTime = FMath::Min(
+				MaxTickRate - static_cast<float>(EndTime - StartTime),
+				static_cast<float>(TimerWheel->GetSecondsUntilNextTimer(MaxTickRate)));
 			FPlatformProcess::SleepNoStats(FMath::Max(MinWaitTime, SleepTime));
 		}
 		return 0;
@@ -162,6 +169,7 @@ namespace Mqttify
 
 	void FMqttifyClientPool::TickInternal()
 	{
+		TimerWheel->Advance();
 		for (auto& Client : MqttifyClients)
 		{
 			if (const auto ClientPtr = Client.Value.Pin())
@@ -181,13 +189,7 @@ namespace Mqttify
 	{
 		check(IsInGameThread());
 		FScopeLock Lock(&ClientMapLock);
-		for (auto& Client : MqttifyClients)
-		{
-			if (const auto ClientPtr = Client.Value.Pin())
-			{
-				ClientPtr->Tick();
-			}
-		}
+		TickInternal();
 		return true;
 	}
 } // namespace Mqttify
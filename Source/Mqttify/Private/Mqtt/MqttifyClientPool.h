@@ -3,6 +3,7 @@
 #include "HAL/Runnable.h"
 #include "Misc/SingleThreadRunnable.h"
 #include "Mqtt/MqttifyConnectionSettings.h"
+#include "Mqtt/MqttifyTimerWheel.h"
 
 enum class EMqttifyThreadMode : uint8;
 enum class EMqttifyProtocolVersion : uint8;
@@ -31,6 +32,7 @@ namespace Mqttify
 		 * @return A shared pointer to the MQTT client if the URL was valid
 		 */
 		static TSharedPtr<ITickableMqttifyClient> Create(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		                                                 const TSharedRef<FMqttifyTimerWheel>& InTimerWheel,
 		                                                 FDeleter&& InDeleter);
 
 	public:
@@ -69,6 +71,9 @@ namespace Mqttify
 		/// @brief Tick the connection on the main thread
 		bool GameThreadTick(float DeltaTime);
 
+		/// @brief Timer wheel shared by the clients of the pool, advanced once per tick.
+		TSharedRef<FMqttifyTimerWheel> TimerWheel;
+
 		mutable FCriticalSection ClientMapLock;
 		TMap<int32, TWeakPtr<ITickableMqttifyClient>> MqttifyClients;
 
@@ -23,7 +23,17 @@ FMqttifyConnectionSettings::FMqttifyConnectionSettings(
 	const uint8 InMaxPacketRetries,
 	const bool bInShouldVerifyCertificate,
 	const uint32 InSessionExpiryInterval,
-	FString&& InClientId
+	FString&& InClientId,
+	const EMqttifyRetryPolicy InRetryPolicy,
+	const uint16 InReceiveMaximum,
+	const uint16 InTopicAliasMaximum,
+	const uint32 InPublishDeadlineSeconds,
+	const uint32 InOfflineBufferMaxMessages,
+	const uint32 InOfflineBufferMaxBytes,
+	const EMqttifyOfflineDropPolicy InOfflineDropPolicy,
+	const FString& InSessionStoreDirectory,
+	const uint32 InMaxOutstandingSubscribes,
+	const uint32 InMaxTopicFiltersPerSubscribe
 	)
 	: MaxPacketSize{InMaxPacketSize}
 	, MaxBufferSize{InMaxBufferSize}
@@ -43,6 +53,16 @@ FMqttifyConnectionSettings::FMqttifyConnectionSettings(
 	, MaxConnectionRetries{InMaxConnectionRetries}
 	, MaxPacketRetries{InMaxPacketRetries}
 	, bShouldVerifyServerCertificate{bInShouldVerifyCertificate}
+	, RetryPolicy{InRetryPolicy}
+	, ReceiveMaximum{InReceiveMaximum}
+	, TopicAliasMaximum{InTopicAliasMaximum}
+	, PublishDeadlineSeconds{InPublishDeadlineSeconds}
+	, OfflineBufferMaxMessages{InOfflineBufferMaxMessages}
+	, OfflineBufferMaxBytes{InOfflineBufferMaxBytes}
+	, OfflineDropPolicy{InOfflineDropPolicy}
+	, SessionStoreDirectory{InSessionStoreDirectory}
+	, MaxOutstandingSubscribes{FMath::Max(InMaxOutstandingSubscribes, 1u)}
+	, MaxTopicFiltersPerSubscribe{FMath::Max(InMaxTopicFiltersPerSubscribe, 1u)}
 	, SessionExpiryInterval(InSessionExpiryInterval)
 {
 	if (ClientId.IsEmpty())
@@ -103,6 +123,36 @@ uint32 FMqttifyConnectionSettings::GetHashCode() const
 	// Hash MaxConnectionRetries
 	Hash = HashCombine(Hash, GetTypeHash(MaxConnectionRetries));
 
+	// Hash RetryPolicy
+	Hash = HashCombine(Hash, GetTypeHash(RetryPolicy));
+
+	// Hash ReceiveMaximum
+	Hash = HashCombine(Hash, GetTypeHash(ReceiveMaximum));
+
+	// Hash TopicAliasMaximum
+	Hash = HashCombine(Hash, GetTypeHash(TopicAliasMaximum));
+
+	// Hash PublishDeadlineSeconds
+	Hash = HashCombine(Hash, GetTypeHash(PublishDeadlineSeconds));
+
+	// Hash OfflineBufferMaxMessages
+	Hash = HashCombine(Hash, GetTypeHash(OfflineBufferMaxMessages));
+
+	// Hash OfflineBufferMaxBytes
+	Hash = HashCombine(Hash, GetTypeHash(OfflineBufferMaxBytes));
+
+	// Hash OfflineDropPolicy
+	Hash = HashCombine(Hash, GetTypeHash(OfflineDropPolicy));
+
+	// Hash SessionStoreDirectory
+	Hash = HashCombine(Hash, GetTypeHash(SessionStoreDirectory));
+
+	// Hash MaxOutstandingSubscribes
+	Hash = HashCombine(Hash, GetTypeHash(MaxOutstandingSubscribes));
+
+	// Hash MaxTopicFiltersPerSubscribe
+	Hash = HashCombine(Hash, GetTypeHash(MaxTopicFiltersPerSubscribe));
+
 	return Hash;
 }
 
@@ -121,7 +171,17 @@ TSharedPtr<FMqttifyConnectionSettings> FMqttifyConnectionSettings::CreateShared(
 	const uint8 InMaxPacketRetries,
 	const bool bInShouldVerifyCertificate,
 	const uint32 InSessionExpiryInterval,
-	FString&& InClientId
+	FString&& InClientId,
+	const EMqttifyRetryPolicy InRetryPolicy,
+	const uint16 InReceiveMaximum,
+	const uint16 InTopicAliasMaximum,
+	const uint32 InPublishDeadlineSeconds,
+	const uint32 InOfflineBufferMaxMessages,
+	const uint32 InOfflineBufferMaxBytes,
+	const EMqttifyOfflineDropPolicy InOfflineDropPolicy,
+	const FString& InSessionStoreDirectory,
+	const uint32 InMaxOutstandingSubscribes,
+	const uint32 InMaxTopicFiltersPerSubscribe
 	)
 {
 	const FRegexPattern URLPattern(
@@ -167,7 +227,17 @@ TSharedPtr<FMqttifyConnectionSettings> FMqttifyConnectionSettings::CreateShared(
 			InMaxPacketRetries,
 			bInShouldVerifyCertificate,
 			InSessionExpiryInterval,
-			MoveTemp(InClientId));
+			MoveTemp(InClientId),
+			InRetryPolicy,
+			InReceiveMaximum,
+			InTopicAliasMaximum,
+			InPublishDeadlineSeconds,
+			InOfflineBufferMaxMessages,
+			InOfflineBufferMaxBytes,
+			InOfflineDropPolicy,
+			InSessionStoreDirectory,
+			InMaxOutstandingSubscribes,
+			InMaxTopicFiltersPerSubscribe);
 	}
 
 	return nullptr;
@@ -190,7 +260,17 @@ TSharedPtr<FMqttifyConnectionSettings> FMqttifyConnectionSettings::CreateShared(
 	const uint8 InMaxPacketRetries,
 	const bool bInShouldVerifyCertificate,
 	const uint32 InSessionExpiryInterval,
-	FString&& InClientId
+	FString&& InClientId,
+	const EMqttifyRetryPolicy InRetryPolicy,
+	const uint16 InReceiveMaximum,
+	const uint16 InTopicAliasMaximum,
+	const uint32 InPublishDeadlineSeconds,
+	const uint32 InOfflineBufferMaxMessages,
+	const uint32 InOfflineBufferMaxBytes,
+	const EMqttifyOfflineDropPolicy InOfflineDropPolicy,
+	const FString& InSessionStoreDirectory,
+	const uint32 InMaxOutstandingSubscribes,
+	const uint32 InMaxTopicFiltersPerSubscribe
 	)
 {
 	const FRegexPattern URLPattern(
@@ -237,7 +317,17 @@ TSharedPtr<FMqttifyConnectionSettings> FMqttifyConnectionSettings::CreateShared(
 			InMaxPacketRetries,
 			bInShouldVerifyCertificate,
 			InSessionExpiryInterval,
-			MoveTemp(InClientId));
+			MoveTemp(InClientId),
+			InRetryPolicy,
+			InReceiveMaximum,
+			InTopicAliasMaximum,
+			InPublishDeadlineSeconds,
+			InOfflineBufferMaxMessages,
+			InOfflineBufferMaxBytes,
+			InOfflineDropPolicy,
+			InSessionStoreDirectory,
+			InMaxOutstandingSubscribes,
+			InMaxTopicFiltersPerSubscribe);
 	}
 
 	return nullptr;
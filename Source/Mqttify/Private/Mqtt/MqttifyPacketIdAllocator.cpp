@@ -0,0 +1,85 @@
+#include "Mqtt/MqttifyPacketIdAllocator.h"
+
+namespace Mqttify
+{
+	FMqttifyPacketIdAllocator::FMqttifyPacketIdAllocator()
+	{
+		for (std::atomic<uint64>& Word : Words)
+		{
+			Word.store(0, std::memory_order_relaxed);
+		}
+		// Identifier 0 is not a valid packet identifier
+		Words[0].store(1, std::memory_order_release);
+	}
+
+	uint16 FMqttifyPacketIdAllocator::Allocate()
+	{
+		const uint32 Start = Cursor.load(std::memory_order_relaxed);
+		for (uint32 Offset = 0; Offset < kNumWords; ++Offset)
+		{
+			const uint32 Index = (Start + Offset) % kNumWords;
+			std::atomic<uint64>& Word = Words[Index];
+			uint64 Bits = Word.load(std::memory_order_relaxed);
+			while (Bits != kFullWord)
+			{
+				const uint64 Bit = FMath::CountTrailingZeros64(~Bits);
+				if (Word.compare_exchange_weak(
+					Bits,
+					Bits | static_cast<uint64>(1) << Bit,
+					std::memory_order_acq_rel,
+					std::memory_order_relaxed))
+				{
+					Cursor.store(Index, std::memory_order_relaxed);
+					return static_cast<uint16>(Index * 64 + Bit);
+				}
+			}
+		}
+		return 0;
+	}
+
+	bool FMqttifyPacketIdAllocator::Claim(const uint16 InId)
+	{
+		if (InId == 0)
+		{
+			return false;
+		}
+
+		const uint64 Mask = static_cast<uint64>(1) << (InId % 64);
+		const uint64 Previous = Words[InId / 64].fetch_or(Mask, std::memory_order_acq_rel);
+		return (Previous & Mask) == 0;
+	}
+
+	bool FMqttifyPacketIdAllocator::Release(const uint16 InId)
+	{
+		if (InId == 0)
+		{
+			return false;
+		}
+
+		const uint64 Mask = static_cast<uint64>(1) << (InId % 64);
+		const uint64 Previous = Words[InId / 64].fetch_and(~Mask, std::memory_order_acq_rel);
+		return (Previous & Mask) != 0;
+	}
+
+	bool FMqttifyPacketIdAllocator::IsAllocated(const uint16 InId) const
+	{
+		if (InId == 0)
+		{
+			return false;
+		}
+
+		const uint64 Mask = static_cast<uint64>(1) << (InId % 64);
+		return (Words[InId / 64].load(std::memory_order_acquire) & Mask) != 0;
+	}
+
+	int32 FMqttifyPacketIdAllocator::Num() const
+	{
+		int32 Count = 0;
+		for (const std::atomic<uint64>& Word : Words)
+		{
+			Count += static_cast<int32>(FMath::CountBits(Word.load(std::memory_order_relaxed)));
+		}
+		// Do not count the reserved identifier 0
+		return Count - 1;
+	}
+} // namespace Mqttify
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+namespace Mqttify
+{
+	/**
+	 * @brief Lock free allocator for MQTT packet identifiers.
+	 *
+	 * Every identifier is one bit in an 8 KiB bitmap, so the allocator lives inline in its owner and
+	 * never touches the heap. Allocation scans for the first clear bit with a compare and swap, starting
+	 * from the word the last identifier came from so identifiers rotate instead of being reused straight
+	 * away. Identifier 0 is reserved by the protocol and is never handed out.
+	 */
+	class FMqttifyPacketIdAllocator final
+	{
+	public:
+		/// @brief Number of identifiers that can be in use at once.
+		static constexpr int32 kCapacity = std::numeric_limits<uint16>::max();
+
+		FMqttifyPacketIdAllocator();
+		FMqttifyPacketIdAllocator(const FMqttifyPacketIdAllocator&) = delete;
+		FMqttifyPacketIdAllocator& operator=(const FMqttifyPacketIdAllocator&) = delete;
+
+		/**
+		 * @brief Take a free identifier.
+		 * @return The identifier, or 0 if all identifiers are in use.
+		 */
+		uint16 Allocate();
+
+		/**
+		 * @brief Take a given identifier, used to restore identifiers that were in use before a restart.
+		 * @param InId The identifier to take.
+		 * @return False if the identifier is 0 or already in use.
+		 */
+		bool Claim(uint16 InId);
+
+		/**
+		 * @brief Return an identifier.
+		 * @param InId The identifier to return.
+		 * @return False if the identifier is 0 or was not in use.
+		 */
+		bool Release(uint16 InId);
+
+		/**
+		 * @brief Check whether an identifier is in use.
+		 * @param InId The identifier.
+		 * @return True if the identifier has been allocated and not released.
+		 */
+		bool IsAllocated(uint16 InId) const;
+
+		/**
+		 * @brief Count the identifiers in use. This scans the whole bitmap and is meant for diagnostics.
+		 * @return The number of identifiers in use.
+		 */
+		int32 Num() const;
+
+	private:
+		static constexpr int32 kNumWords = (1 << 16) / 64;
+		static constexpr uint64 kFullWord = ~static_cast<uint64>(0);
+
+		std::atomic<uint64> Words[kNumWords];
+		/// @brief Word the last identifier was taken from, where the next scan starts.
+		std::atomic<uint32> Cursor{0};
+	};
+} // namespace Mqttify
@@ -0,0 +1,45 @@
+#include "Mqtt/MqttifyRttEstimator.h"
+
+namespace Mqttify
+{
+	void FMqttifyRttEstimator::AddSample(const double InRoundTripSeconds)
+	{
+		const double Sample = FMath::Max(InRoundTripSeconds, 0.0);
+
+		FScopeLock Lock{&CriticalSection};
+		if (!bHasSample)
+		{
+			SmoothedRoundTrip = Sample;
+			RoundTripVariation = Sample / 2.0;
+			bHasSample = true;
+		}
+		else
+		{
+			// The variation is updated with the previous smoothed round trip time
+			RoundTripVariation = (1.0 - kBeta) * RoundTripVariation + kBeta * FMath::Abs(SmoothedRoundTrip - Sample);
+			SmoothedRoundTrip = (1.0 - kAlpha) * SmoothedRoundTrip + kAlpha * Sample;
+		}
+
+		RetryTimeout = FMath::Max(
+			SmoothedRoundTrip + FMath::Max(kClockGranularitySeconds, kK * RoundTripVariation),
+			kMinRetryTimeoutSeconds);
+	}
+
+	double FMqttifyRttEstimator::GetRetryTimeout() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return RetryTimeout;
+	}
+
+	double FMqttifyRttEstimator::GetSmoothedRoundTrip() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return SmoothedRoundTrip;
+	}
+
+	double FMqttifyRttEstimator::GetRoundTripVariation() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return RoundTripVariation;
+	}
+} // namespace Mqttify
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace Mqttify
+{
+	/**
+	 * @brief Round trip time estimator for a connection, following the retransmission timer of RFC 6298.
+	 *
+	 * Samples are the time between sending a packet and receiving its acknowledgement. The smoothed round trip
+	 * time and its variance give the retry timeout, SRTT + max(G, K * RTTVAR), with a floor well under the one
+	 * second of the RFC so packets lost on a fast link are sent again quickly.
+	 */
+	class FMqttifyRttEstimator final
+	{
+	public:
+		/// @brief Retry timeout until the first sample is taken.
+		static constexpr double kInitialRetryTimeoutSeconds = 1.0;
+		/// @brief Lower bound of the retry timeout.
+		static constexpr double kMinRetryTimeoutSeconds = 0.2;
+		/// @brief Clock granularity, the resolution of the timer wheel retries are scheduled on.
+		static constexpr double kClockGranularitySeconds = 0.001;
+
+		FMqttifyRttEstimator() = default;
+		FMqttifyRttEstimator(const FMqttifyRttEstimator&) = delete;
+		FMqttifyRttEstimator& operator=(const FMqttifyRttEstimator&) = delete;
+
+		/**
+		 * @brief Add a round trip time measurement. Only packets that were sent once may be measured (Karn's algorithm).
+		 * @param InRoundTripSeconds The time between sending a packet and receiving its acknowledgement.
+		 */
+		void AddSample(double InRoundTripSeconds);
+
+		/// @return The time to wait for an acknowledgement before sending a packet again.
+		double GetRetryTimeout() const;
+
+		/// @return The smoothed round trip time, 0 before the first sample.
+		double GetSmoothedRoundTrip() const;
+
+		/// @return The round trip time variation, 0 before the first sample.
+		double GetRoundTripVariation() const;
+
+	private:
+		static constexpr double kAlpha = 1.0 / 8.0;
+		static constexpr double kBeta = 1.0 / 4.0;
+		static constexpr double kK = 4.0;
+
+		mutable FCriticalSection CriticalSection;
+		double SmoothedRoundTrip = 0.0;
+		double RoundTripVariation = 0.0;
+		double RetryTimeout = kInitialRetryTimeoutSeconds;
+		bool bHasSample = false;
+	};
+} // namespace Mqttify
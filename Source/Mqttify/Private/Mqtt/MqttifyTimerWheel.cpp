@@ -0,0 +1,252 @@
+#include "Mqtt/MqttifyTimerWheel.h"
+
+namespace
+{
+	uint64 RotateRight(const uint64 InBits, const int32 InShift)
+	{
+		return InShift == 0 ? InBits : InBits >> InShift | InBits << (64 - InShift);
+	}
+} // namespace
+
+namespace Mqttify
+{
+	FMqttifyTimerWheel::FMqttifyTimerWheel()
+		: CyclesPerTick{FMath::Max<uint64>(1, static_cast<uint64>(kTickSeconds / FPlatformTime::GetSecondsPerCycle64()))}
+		, CurrentTick{0}
+	{
+		CurrentTick = CyclesToTicks(FPlatformTime::Cycles64());
+		for (int32 Level = 0; Level < kNumLevels; ++Level)
+		{
+			for (int32 Slot = 0; Slot < kSlotsPerLevel; ++Slot)
+			{
+				Heads[Level][Slot] = INDEX_NONE;
+			}
+		}
+	}
+
+	FMqttifyTimerHandle FMqttifyTimerWheel::Schedule(const double InDelaySeconds, TFunction<void()>&& InCallback)
+	{
+		const uint64 Ticks = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(InDelaySeconds / kTickSeconds)));
+		const uint64 NowTick = CyclesToTicks(FPlatformTime::Cycles64());
+
+		FScopeLock Lock{&CriticalSection};
+		int32 Index = FreeHead;
+		if (Index != INDEX_NONE)
+		{
+			FreeHead = Timers[Index].Next;
+		}
+		else
+		{
+			Index = Timers.AddDefaulted();
+		}
+
+		FTimer& Timer = Timers[Index];
+		Timer.Callback = MoveTemp(InCallback);
+		Timer.ExpiryTick = FMath::Max(NowTick + Ticks, CurrentTick + 1);
+		LinkLocked(Index);
+		++NumPending;
+		return FMqttifyTimerHandle{Index, Timer.Serial};
+	}
+
+	bool FMqttifyTimerWheel::Cancel(FMqttifyTimerHandle& InOutHandle)
+	{
+		const FMqttifyTimerHandle Handle = InOutHandle;
+		InOutHandle.Invalidate();
+		if (!Handle.IsValid())
+		{
+			return false;
+		}
+
+		FScopeLock Lock{&CriticalSection};
+		if (!Timers.IsValidIndex(Handle.Index)
+			|| Timers[Handle.Index].Serial != Handle.Serial
+			|| Timers[Handle.Index].Level == INDEX_NONE)
+		{
+			return false;
+		}
+
+		UnlinkLocked(Handle.Index);
+		FreeLocked(Handle.Index);
+		--NumPending;
+		return true;
+	}
+
+	int32 FMqttifyTimerWheel::AdvanceTo(const uint64 InNowCycles)
+	{
+		TArray<TFunction<void()>, TInlineAllocator<8>> Fired;
+		{
+			FScopeLock Lock{&CriticalSection};
+			const uint64 NowTick = CyclesToTicks(InNowCycles);
+			while (CurrentTick < NowTick)
+			{
+				if (NumPending == 0)
+				{
+					CurrentTick = NowTick;
+					break;
+				}
+
+				// Nothing can fire before the next cascade when the lowest level is empty
+				if (Occupied[0] == 0)
+				{
+					const uint64 NextBoundary = (CurrentTick | (kSlotsPerLevel - 1)) + 1;
+					if (NextBoundary > NowTick)
+					{
+						CurrentTick = NowTick;
+						break;
+					}
+					CurrentTick = NextBoundary - 1;
+				}
+
+				++CurrentTick;
+				for (int32 Level = 1; Level < kNumLevels; ++Level)
+				{
+					if ((CurrentTick & ((static_cast<uint64>(1) << (Level * kSlotBits)) - 1)) != 0)
+					{
+						break;
+					}
+					CascadeLocked(Level);
+				}
+
+				const int32 Slot = static_cast<int32>(CurrentTick & (kSlotsPerLevel - 1));
+				int32 Index = Heads[0][Slot];
+				Heads[0][Slot] = INDEX_NONE;
+				Occupied[0] &= ~(static_cast<uint64>(1) << Slot);
+				while (Index != INDEX_NONE)
+				{
+					const int32 Next = Timers[Index].Next;
+					Fired.Add(MoveTemp(Timers[Index].Callback));
+					FreeLocked(Index);
+					--NumPending;
+					Index = Next;
+				}
+			}
+		}
+
+		for (TFunction<void()>& Callback : Fired)
+		{
+			if (Callback)
+			{
+				Callback();
+			}
+		}
+		return Fired.Num();
+	}
+
+	double FMqttifyTimerWheel::GetSecondsUntilNextTimer(const double InMaxSeconds) const
+	{
+		const uint64 NowTick = CyclesToTicks(FPlatformTime::Cycles64());
+
+		FScopeLock Lock{&CriticalSection};
+		if (NumPending == 0)
+		{
+			return InMaxSeconds;
+		}
+
+		// A timer of a higher level can fire before those of the lowest level that holds timers, as it cascades on
+		// the next boundary of the level below. Every level is checked, each gives the first tick of its next slot
+		// that holds timers, which is never later than the timers in that slot expire.
+		uint64 NextTick = TNumericLimits<uint64>::Max();
+		for (int32 Level = 0; Level < kNumLevels; ++Level)
+		{
+			if (Occupied[Level] == 0)
+			{
+				continue;
+			}
+
+			// The next slot of this level that holds timers, searching from the one after the current position
+			const int32 Shift = Level * kSlotBits;
+			const uint64 Position = CurrentTick >> Shift;
+			const int32 Start = static_cast<int32>((Position + 1) & (kSlotsPerLevel - 1));
+			const uint64 Offset = FMath::CountTrailingZeros64(RotateRight(Occupied[Level], Start)) + 1;
+			NextTick = FMath::Min(NextTick, (Position + Offset) << Shift);
+		}
+
+		if (NextTick == TNumericLimits<uint64>::Max())
+		{
+			return InMaxSeconds;
+		}
+		const double Seconds = NextTick > NowTick ? (NextTick - NowTick) * kTickSeconds : 0.0;
+		return FMath::Min(Seconds, InMaxSeconds);
+	}
+
+	int32 FMqttifyTimerWheel::Num() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return NumPending;
+	}
+
+	void FMqttifyTimerWheel::LinkLocked(const int32 InIndex)
+	{
+		FTimer& Timer = Timers[InIndex];
+		const uint64 Delta = Timer.ExpiryTick > CurrentTick ? Timer.ExpiryTick - CurrentTick : 0;
+
+		int32 Level = 0;
+		while (Level < kNumLevels - 1 && Delta >= static_cast<uint64>(1) << ((Level + 1) * kSlotBits))
+		{
+			++Level;
+		}
+
+		// Timers beyond the range of the wheel are filed in the furthest slot and filed again when it cascades
+		constexpr uint64 kRange = static_cast<uint64>(1) << (kNumLevels * kSlotBits);
+		const uint64 FileTick = Delta < kRange ? Timer.ExpiryTick : CurrentTick + kRange - 1;
+		const int32 Slot = static_cast<int32>((FileTick >> (Level * kSlotBits)) & (kSlotsPerLevel - 1));
+
+		Timer.Level = static_cast<int8>(Level);
+		Timer.Slot = static_cast<uint8>(Slot);
+		Timer.Prev = INDEX_NONE;
+		Timer.Next = Heads[Level][Slot];
+		if (Timer.Next != INDEX_NONE)
+		{
+			Timers[Timer.Next].Prev = InIndex;
+		}
+		Heads[Level][Slot] = InIndex;
+		Occupied[Level] |= static_cast<uint64>(1) << Slot;
+	}
+
+	void FMqttifyTimerWheel::UnlinkLocked(const int32 InIndex)
+	{
+		const FTimer& Timer = Timers[InIndex];
+		if (Timer.Prev != INDEX_NONE)
+		{
+			Timers[Timer.Prev].Next = Timer.Next;
+		}
+		else
+		{
+			Heads[Timer.Level][Timer.Slot] = Timer.Next;
+			if (Timer.Next == INDEX_NONE)
+			{
+				Occupied[Timer.Level] &= ~(static_cast<uint64>(1) << Timer.Slot);
+			}
+		}
+
+		if (Timer.Next != INDEX_NONE)
+		{
+			Timers[Timer.Next].Prev = Timer.Prev;
+		}
+	}
+
+	void FMqttifyTimerWheel::FreeLocked(const int32 InIndex)
+	{
+		FTimer& Timer = Timers[InIndex];
+		Timer.Callback.Reset();
+		Timer.Level = INDEX_NONE;
+		Timer.Prev = INDEX_NONE;
+		++Timer.Serial;
+		Timer.Next = FreeHead;
+		FreeHead = InIndex;
+	}
+
+	void FMqttifyTimerWheel::CascadeLocked(const int32 InLevel)
+	{
+		const int32 Slot = static_cast<int32>((CurrentTick >> (InLevel * kSlotBits)) & (kSlotsPerLevel - 1));
+		int32 Index = Heads[InLevel][Slot];
+		Heads[InLevel][Slot] = INDEX_NONE;
+		Occupied[InLevel] &= ~(static_cast<uint64>(1) << Slot);
+		while (Index != INDEX_NONE)
+		{
+			const int32 Next = Timers[Index].Next;
+			LinkLocked(Index);
+			Index = Next;
+		}
+	}
+} // namespace Mqttify
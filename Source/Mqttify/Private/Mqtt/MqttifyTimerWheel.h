@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace Mqttify
+{
+	/// @brief Handle to a timer scheduled on an FMqttifyTimerWheel.
+	struct FMqttifyTimerHandle
+	{
+		int32 Index = INDEX_NONE;
+		uint32 Serial = 0;
+
+		bool IsValid() const { return Index != INDEX_NONE; }
+		void Invalidate() { Index = INDEX_NONE; }
+	};
+
+	/**
+	 * @brief Hierarchical timer wheel on the FPlatformTime cycle counter, shared by the clients of a pool.
+	 *
+	 * Timers are one shot. The wheel has kNumLevels levels of kSlotsPerLevel slots with a resolution of
+	 * kTickSeconds, each level covering kSlotsPerLevel times the range of the one below. A timer is filed in the
+	 * lowest level that can hold its expiry and moves down a level each time the level below wraps, so advancing
+	 * the wheel only visits the slots that fall due. Per level occupancy masks let empty stretches be skipped
+	 * and give the next deadline without walking the timers.
+	 *
+	 * Scheduling and cancelling are thread safe. Callbacks run on the thread that advances the wheel, outside
+	 * of the wheel lock, so they may schedule or cancel timers.
+	 */
+	class FMqttifyTimerWheel final
+	{
+	public:
+		/// @brief Resolution of the wheel.
+		static constexpr double kTickSeconds = 0.001;
+		static constexpr int32 kNumLevels = 4;
+		static constexpr int32 kSlotBits = 6;
+		static constexpr int32 kSlotsPerLevel = 1 << kSlotBits;
+
+		FMqttifyTimerWheel();
+		FMqttifyTimerWheel(const FMqttifyTimerWheel&) = delete;
+		FMqttifyTimerWheel& operator=(const FMqttifyTimerWheel&) = delete;
+
+		/**
+		 * @brief Schedule a callback.
+		 * @param InDelaySeconds Seconds from now, rounded up to the wheel resolution.
+		 * @param InCallback The callback, run from Advance.
+		 * @return The handle of the timer.
+		 */
+		FMqttifyTimerHandle Schedule(double InDelaySeconds, TFunction<void()>&& InCallback);
+
+		/**
+		 * @brief Cancel a timer. Cancelling a timer that has fired or been cancelled does nothing.
+		 * @param InOutHandle The handle of the timer, invalidated on return.
+		 * @return True if a pending timer was cancelled.
+		 */
+		bool Cancel(FMqttifyTimerHandle& InOutHandle);
+
+		/**
+		 * @brief Fire the timers that are due on the current cycle counter.
+		 * @return The number of timers fired.
+		 */
+		int32 Advance() { return AdvanceTo(FPlatformTime::Cycles64()); }
+
+		/**
+		 * @brief Fire the timers that are due at a given cycle count.
+		 * @param InNowCycles The cycle count to advance to.
+		 * @return The number of timers fired.
+		 */
+		int32 AdvanceTo(uint64 InNowCycles);
+
+		/**
+		 * @brief Get a lower bound of the time until the next timer fires, for sleeping until it is due.
+		 * @param InMaxSeconds The value returned when no timer is pending or the next one is further away.
+		 * @return Seconds until the next timer.
+		 */
+		double GetSecondsUntilNextTimer(double InMaxSeconds) const;
+
+		/// @return The number of pending timers.
+		int32 Num() const;
+
+	private:
+		struct FTimer
+		{
+			TFunction<void()> Callback;
+			uint64 ExpiryTick = 0;
+			int32 Prev = INDEX_NONE;
+			int32 Next = INDEX_NONE;
+			uint32 Serial = 0;
+			int8 Level = INDEX_NONE;
+			uint8 Slot = 0;
+		};
+
+		uint64 CyclesToTicks(const uint64 InCycles) const { return InCycles / CyclesPerTick; }
+		void LinkLocked(int32 InIndex);
+		void UnlinkLocked(int32 InIndex);
+		void FreeLocked(int32 InIndex);
+		void CascadeLocked(int32 InLevel);
+
+		uint64 CyclesPerTick;
+		/// @brief The last tick that has been processed.
+		uint64 CurrentTick;
+
+		TArray<FTimer> Timers;
+		int32 FreeHead = INDEX_NONE;
+		int32 NumPending = 0;
+
+		int32 Heads[kNumLevels][kSlotsPerLevel];
+		uint64 Occupied[kNumLevels] = {};
+
+		mutable FCriticalSection CriticalSection;
+	};
+} // namespace Mqttify
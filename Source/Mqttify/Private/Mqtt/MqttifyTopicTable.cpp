@@ -0,0 +1,152 @@
+#include "Mqtt/MqttifyTopicTable.h"
+
+#include "LogMqttify.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/MqttifyFArchiveEncodeDecode.h"
+
+namespace
+{
+	uint32 HashUtf8(const UTF8CHAR* InData, const int32 InLength)
+	{
+		return CityHash32(reinterpret_cast<const char*>(InData), static_cast<uint32>(InLength));
+	}
+} // namespace
+
+const FString& FMqttifyTopicHandle::ToString() const
+{
+	return Mqttify::FMqttifyTopicTable::Get().Resolve(*this);
+}
+
+namespace Mqttify
+{
+	FMqttifyTopicTable& FMqttifyTopicTable::Get()
+	{
+		static FMqttifyTopicTable Table;
+		return Table;
+	}
+
+	FMqttifyTopicHandle FMqttifyTopicTable::Intern(const UTF8CHAR* InData, const int32 InLength)
+	{
+		const uint32 Hash = HashUtf8(InData, InLength);
+		{
+			FReadScopeLock ReadLock(Lock);
+			const FMqttifyTopicHandle Existing = FindLocked(InData, InLength, Hash);
+			if (Existing.IsValid())
+			{
+				return Existing;
+			}
+		}
+
+		FWriteScopeLock WriteLock(Lock);
+		// Another thread may have interned the same topic between the locks
+		const FMqttifyTopicHandle Existing = FindLocked(InData, InLength, Hash);
+		if (Existing.IsValid())
+		{
+			return Existing;
+		}
+
+		if (Entries.Num() >= kMaxEntries)
+		{
+			UE_CLOG(
+				!bHasWarnedFull,
+				LogMqttify,
+				Warning,
+				TEXT("Topic table is full, topics will no longer be interned"));
+			bHasWarnedFull = true;
+			return FMqttifyTopicHandle{};
+		}
+
+		TUniquePtr<FEntry> Entry = MakeUnique<FEntry>();
+		Entry->Utf8.Append(InData, InLength);
+		Entries.Emplace(MoveTemp(Entry));
+
+		const uint32 Id = static_cast<uint32>(Entries.Num());
+		Buckets.Add(Hash, Id);
+		return FMqttifyTopicHandle{Id};
+	}
+
+	FMqttifyTopicHandle FMqttifyTopicTable::Intern(const FString& InTopic)
+	{
+		TArray<uint8, TInlineAllocator<256>> Utf8;
+		Data::StringToUtf8(InTopic, Utf8);
+		return Intern(reinterpret_cast<const UTF8CHAR*>(Utf8.GetData()), Utf8.Num());
+	}
+
+	FMqttifyTopicHandle FMqttifyTopicTable::Find(const FString& InTopic) const
+	{
+		TArray<uint8, TInlineAllocator<256>> Utf8;
+		Data::StringToUtf8(InTopic, Utf8);
+		const UTF8CHAR* Utf8Data = reinterpret_cast<const UTF8CHAR*>(Utf8.GetData());
+		const uint32 Hash = HashUtf8(Utf8Data, Utf8.Num());
+		FReadScopeLock ReadLock(Lock);
+		return FindLocked(Utf8Data, Utf8.Num(), Hash);
+	}
+
+	const FString& FMqttifyTopicTable::Resolve(const FMqttifyTopicHandle InHandle)
+	{
+		static const FString Empty{};
+		if (!InHandle.IsValid())
+		{
+			return Empty;
+		}
+
+		FEntry* Entry = nullptr;
+		{
+			FReadScopeLock ReadLock(Lock);
+			if (InHandle.GetId() > static_cast<uint32>(Entries.Num()))
+			{
+				return Empty;
+			}
+			Entry = Entries[InHandle.GetId() - 1].Get();
+			if (Entry->bHasTopic)
+			{
+				return Entry->Topic;
+			}
+		}
+
+		FWriteScopeLock WriteLock(Lock);
+		if (!Entry->bHasTopic)
+		{
+			UE_CLOG(
+				!Data::Utf8ToString(reinterpret_cast<const uint8*>(Entry->Utf8.GetData()), Entry->Utf8.Num(), Entry->Topic),
+				LogMqttify,
+				Warning,
+				Data::InvalidUtf8String);
+			Entry->bHasTopic = true;
+		}
+		return Entry->Topic;
+	}
+
+	TArrayView<const UTF8CHAR> FMqttifyTopicTable::ResolveUtf8(const FMqttifyTopicHandle InHandle) const
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (!InHandle.IsValid() || InHandle.GetId() > static_cast<uint32>(Entries.Num()))
+		{
+			return {};
+		}
+		return Entries[InHandle.GetId() - 1]->Utf8;
+	}
+
+	int32 FMqttifyTopicTable::Num() const
+	{
+		FReadScopeLock ReadLock(Lock);
+		return Entries.Num();
+	}
+
+	FMqttifyTopicHandle FMqttifyTopicTable::FindLocked(const UTF8CHAR* InData,
+														const int32 InLength,
+														const uint32 InHash) const
+	{
+		for (auto It = Buckets.CreateConstKeyIterator(InHash); It; ++It)
+		{
+			const FEntry& Entry = *Entries[It.Value() - 1];
+			if (Entry.Utf8.Num() == InLength
+				&& FMemory::Memcmp(Entry.Utf8.GetData(), InData, InLength) == 0)
+			{
+				return FMqttifyTopicHandle{It.Value()};
+			}
+		}
+		return FMqttifyTopicHandle{};
+	}
+} // namespace Mqttify
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Mqtt/MqttifyTopicHandle.h"
+
+namespace Mqttify
+{
+	/**
+	 * @brief Thread safe intern table for topic names, keyed on their UTF-8 bytes.
+	 *
+	 * Interning a topic that is already in the table costs one hash and one probe under a
+	 * read lock and does not allocate. Entries are never removed, so handles and the strings
+	 * they resolve to stay valid for the lifetime of the module.
+	 */
+	class FMqttifyTopicTable final
+	{
+	public:
+		/// @brief Maximum number of distinct topics that will be interned.
+		static constexpr int32 kMaxEntries = 1 << 16;
+
+		/**
+		 * @brief Get the process wide topic table.
+		 * @return The topic table.
+		 */
+		static FMqttifyTopicTable& Get();
+
+		FMqttifyTopicTable() = default;
+		FMqttifyTopicTable(const FMqttifyTopicTable&) = delete;
+		FMqttifyTopicTable& operator=(const FMqttifyTopicTable&) = delete;
+
+		/**
+		 * @brief Intern a topic from its UTF-8 encoding.
+		 * @param InData The UTF-8 bytes of the topic, not null terminated.
+		 * @param InLength The number of bytes.
+		 * @return The handle for the topic, or an invalid handle if the table is full.
+		 */
+		FMqttifyTopicHandle Intern(const UTF8CHAR* InData, int32 InLength);
+
+		/**
+		 * @brief Intern a topic.
+		 * @param InTopic The topic name.
+		 * @return The handle for the topic, or an invalid handle if the table is full.
+		 */
+		FMqttifyTopicHandle Intern(const FString& InTopic);
+
+		/**
+		 * @brief Find a topic without interning it.
+		 * @param InTopic The topic name.
+		 * @return The handle for the topic, or an invalid handle if it has not been interned.
+		 */
+		FMqttifyTopicHandle Find(const FString& InTopic) const;
+
+		/**
+		 * @brief Get the topic name for a handle, building the string on first use.
+		 * @param InHandle The topic handle.
+		 * @return The topic name, empty if the handle is invalid.
+		 */
+		const FString& Resolve(FMqttifyTopicHandle InHandle);
+
+		/**
+		 * @brief Get the UTF-8 bytes for a handle.
+		 * @param InHandle The topic handle.
+		 * @return A view of the UTF-8 bytes, empty if the handle is invalid.
+		 */
+		TArrayView<const UTF8CHAR> ResolveUtf8(FMqttifyTopicHandle InHandle) const;
+
+		/**
+		 * @brief Get the number of interned topics.
+		 * @return The number of interned topics.
+		 */
+		int32 Num() const;
+
+	private:
+		struct FEntry
+		{
+			TArray<UTF8CHAR> Utf8;
+			FString Topic;
+			bool bHasTopic = false;
+		};
+
+		FMqttifyTopicHandle FindLocked(const UTF8CHAR* InData, int32 InLength, uint32 InHash) const;
+
+		/// @brief Entries indexed by handle id - 1. Entries are heap allocated so they never move.
+		TArray<TUniquePtr<FEntry>> Entries;
+		/// @brief Hash of the UTF-8 bytes to handle id.
+		TMultiMap<uint32, uint32> Buckets;
+		/// @brief Whether the table being full was logged, it is only logged once.
+		bool bHasWarnedFull = false;
+		mutable FRWLock Lock;
+	};
+} // namespace Mqttify
@@ -9,11 +9,16 @@
 #include "Mqtt/State/MqttifyClientConnectingState.h"
 #include "Mqtt/State/MqttifyClientDisconnectedState.h"
 #include "Mqtt/State/MqttifyClientDisconnectingState.h"
-#include "Packets/MqttifyPubAckPacket.h"
+#include "Packets/MqttifyDisconnectPacket.h"
 #include "Packets/MqttifyPublishPacket.h"
 
 namespace Mqttify
 {
+	FMqttifyClientConnectedState::~FMqttifyClientConnectedState()
+	{
+		Context->GetTimerWheel()->Cancel(KeepAliveTimer);
+	}
+
 	void FMqttifyClientConnectedState::OnSocketDisconnect()
 	{
 		SocketTransitionToState<FMqttifyClientConnectingState>();
@@ -47,51 +52,87 @@ namespace Mqttify
 
 		Socket->Tick();
 
-		if (Context->GetConnectionSettings()->GetKeepAliveIntervalSeconds() > 0)
+		if (const uint16 KeepAliveIntervalSeconds = Context->GetKeepAliveIntervalSeconds(); KeepAliveIntervalSeconds > 0)
 		{
-			const FDateTime Now = FDateTime::UtcNow();
-			const FDateTime KeepAliveEndTime = LastPingTime + FTimespan::FromSeconds(
-				Context->GetConnectionSettings()->GetKeepAliveIntervalSeconds());
-			if (PingReqCommand == nullptr && KeepAliveEndTime < Now)
+			if (PingReqCommand == nullptr && bKeepAliveDue.exchange(false, std::memory_order_acq_rel))
 			{
-				LastPingTime = Now;
-				PingReqCommand = MakeShared<FMqttifyPingReq>(Socket, Context->GetConnectionSettings());
-
-				TWeakPtr<FMqttifyClientConnectedState> WeakConnectedPtr = AsWeak();
-				PingReqCommand->GetFuture().Next(
-					[this, WeakConnectedPtr](const TMqttifyResult<void>& InResult) {
-						const TSharedPtr<FMqttifyClientConnectedState> SharedConnectedPtr = WeakConnectedPtr.Pin();
-						if (!InResult.HasSucceeded() && SharedConnectedPtr.IsValid())
-						{
-							LOG_MQTTIFY(Warning, TEXT("Failed to send ping request. Reconnecting"));
-							SharedConnectedPtr->TransitionTo(
-								MakeShared<FMqttifyClientConnectingState>(OnStateChanged, Context, false, Socket));
-						}
-					});
+				// Any packet sent counts as keep alive, only ping once the connection has been quiet for a whole interval
+				const double IdleSeconds = FPlatformTime::Seconds() - Socket->GetLastSendTime();
+				if (IdleSeconds < KeepAliveIntervalSeconds)
+				{
+					ScheduleKeepAlive(KeepAliveIntervalSeconds - IdleSeconds);
+				}
+				else
+				{
+					ScheduleKeepAlive(KeepAliveIntervalSeconds);
+					SendPingReq(KeepAliveIntervalSeconds);
+				}
 			}
 
 			if (nullptr != PingReqCommand && PingReqCommand->Next())
 			{
 				PingReqCommand = nullptr;
 			}
-
-			Context->ProcessCommands();
 		}
+
+		Context->FlushSubscriptionRequests(Socket);
+		Context->SendBulkSubscribes(Socket);
+		Context->ProcessCommands();
 	}
 
-	void FMqttifyClientConnectedState::OnReceivePacket(const TSharedPtr<FArrayReader>& InPacket)
+	void FMqttifyClientConnectedState::SendPingReq(const uint16 InKeepAliveIntervalSeconds)
 	{
-		FMqttifyPacketPtr Packet = CreatePacket(InPacket);
+		PingReqCommand = MakeShared<FMqttifyPingReq>(Socket, Context->GetConnectionSettings(), InKeepAliveIntervalSeconds);
+
+		TWeakPtr<FMqttifyClientConnectedState> WeakConnectedPtr = AsWeak();
+		PingReqCommand->GetFuture().Next(
+			[this, WeakConnectedPtr](const TMqttifyResult<void>& InResult) {
+				const TSharedPtr<FMqttifyClientConnectedState> SharedConnectedPtr = WeakConnectedPtr.Pin();
+				if (!InResult.HasSucceeded() && SharedConnectedPtr.IsValid())
+				{
+					LOG_MQTTIFY(Warning, TEXT("Failed to send ping request. Reconnecting"));
+					SharedConnectedPtr->TransitionTo(
+						MakeShared<FMqttifyClientConnectingState>(OnStateChanged, Context, false, Socket));
+				}
+			});
+	}
 
-		if (Packet == nullptr)
+	void FMqttifyClientConnectedState::ScheduleKeepAlive(const double InDelaySeconds)
+	{
+		const TSharedRef<FMqttifyTimerWheel>& TimerWheel = Context->GetTimerWheel();
+		TimerWheel->Cancel(KeepAliveTimer);
+
+		TWeakPtr<FMqttifyClientConnectedState> WeakConnectedPtr = AsWeak();
+		KeepAliveTimer = TimerWheel->Schedule(
+			InDelaySeconds,
+			[WeakConnectedPtr] {
+				if (const TSharedPtr<FMqttifyClientConnectedState> SharedConnectedPtr = WeakConnectedPtr.Pin())
+				{
+					SharedConnectedPtr->bKeepAliveDue.store(true, std::memory_order_release);
+				}
+			});
+	}
+
+	void FMqttifyClientConnectedState::OnReceivePacket(const TSharedPtr<FArrayReader>& InPacket)
+	{
+		FMqttifyInboundPacket Packet;
+		if (!DecodePacket(InPacket, Packet))
 		{
 			LOG_MQTTIFY(Error, TEXT("Failed to parse packet"));
 			return;
 		}
 
-		if (!Packet->IsValid())
+		// A string that is not well formed UTF-8 sets the reader error, MQTT treats it as a malformed packet too
+		if (!Packet->IsValid() || InPacket->IsError())
 		{
 			LOG_MQTTIFY(Error, TEXT("Malformed packet. %s"), EnumToTCharString(Packet->GetPacketType()));
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				Socket->Send(
+					MakeShared<TMqttifyDisconnectPacket<EMqttifyProtocolVersion::Mqtt_5>>(
+						EMqttifyReasonCode::MalformedPacket));
+			}
+			Socket->Disconnect();
 			SocketTransitionToState<FMqttifyClientConnectingState>();
 			return;
 		}
@@ -100,8 +141,12 @@ namespace Mqttify
 		{
 			case EMqttifyPacketType::PingResp:
 			{
-				if (PingReqCommand != nullptr && PingReqCommand->Acknowledge(Packet))
+				if (PingReqCommand != nullptr && PingReqCommand->Acknowledge(Packet.Get()))
 				{
+					if (const double RoundTripSeconds = PingReqCommand->GetRoundTripSeconds(); RoundTripSeconds >= 0.0)
+					{
+						Context->SetPingRoundTripSeconds(RoundTripSeconds);
+					}
 					PingReqCommand = nullptr;
 				}
 				break;
@@ -111,35 +156,46 @@ namespace Mqttify
 			case EMqttifyPacketType::PubComp:
 			case EMqttifyPacketType::SubAck:
 			case EMqttifyPacketType::UnsubAck:
-				Context->Acknowledge(Packet);
+				Context->Acknowledge(Packet.Get());
 				break;
 
 			case EMqttifyPacketType::Publish:
 			{
 				const uint32 ServerId = static_cast<uint32>(Packet->GetPacketId()) << 16;
-				TUniquePtr<FMqttifyPublishPacketBase> PublishPacket = TUniquePtr<FMqttifyPublishPacketBase>(
-					static_cast<FMqttifyPublishPacketBase*>(Packet.Release()));
+				FMqttifyPublishPacketBase& PublishPacket = Packet.As<FMqttifyPublishPacketBase>();
+
+				// Resolve before the duplicate check, a duplicate may still map an alias
+				if (const EMqttifyReasonCode ReasonCode = Context->GetInboundTopicAliases()->Resolve(PublishPacket);
+					ReasonCode != EMqttifyReasonCode::Success)
+				{
+					LOG_MQTTIFY(Error, TEXT("Invalid topic in publish, disconnecting with %s."), EnumToTCharString(ReasonCode));
+					if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+					{
+						Socket->Send(MakeShared<TMqttifyDisconnectPacket<EMqttifyProtocolVersion::Mqtt_5>>(ReasonCode));
+					}
+					Socket->Disconnect();
+					SocketTransitionToState<FMqttifyClientConnectingState>();
+					return;
+				}
 
-				if (PublishPacket->GetIsDuplicate() && Context->HasAcknowledgeableCommand(ServerId))
+				if (PublishPacket.GetIsDuplicate() && Context->HasAcknowledgeableCommand(ServerId))
 				{
 					return;
 				}
 
 				// ReSharper disable once CppIncompleteSwitchStatement
 				// ReSharper disable once CppDefaultCaseNotHandledInSwitchStatement
-				switch (PublishPacket->GetQualityOfService())
+				switch (PublishPacket.GetQualityOfService())
 				{
 					case EMqttifyQualityOfService::AtLeastOnce:
 					{
-						const auto PubAckPacket = MakeShared<TMqttifyPubAckPacket<GMqttifyProtocol>>(
-							PublishPacket->GetPacketId());
-						Socket->Send(PubAckPacket);
+						Socket->SendAck(EMqttifyPacketType::PubAck, PublishPacket.GetPacketId());
 						break;
 					}
 					case EMqttifyQualityOfService::ExactlyOnce:
 					{
 						const auto PubRec = MakeShared<FMqttifyPubRec>(
-							PublishPacket->GetPacketId(),
+							PublishPacket.GetPacketId(),
 							EMqttifyReasonCode::Success,
 							Socket,
 							Context->GetConnectionSettings());
@@ -154,7 +210,7 @@ namespace Mqttify
 
 			case EMqttifyPacketType::PubRel:
 			{
-				Context->Acknowledge(Packet);
+				Context->Acknowledge(Packet.Get());
 				break;
 			}
 			default: ;
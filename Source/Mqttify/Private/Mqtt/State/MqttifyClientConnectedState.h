@@ -1,4 +1,5 @@
 #pragma once
+#include "Mqtt/MqttifyTimerWheel.h"
 #include "Mqtt/Commands/MqttifyPingReq.h"
 #include "Mqtt/Interface/IMqttifyConnectableAsync.h"
 #include "Mqtt/Interface/IMqttifyDisconnectableAsync.h"
@@ -25,8 +26,11 @@ namespace Mqttify
 	private:
 		FMqttifySocketRef Socket;
 		bool bTransitioning = false;
-		FDateTime LastPingTime;
 		TSharedPtr<FMqttifyPingReq> PingReqCommand;
+		/// @brief Set by the keep alive timer, the next tick pings if nothing was sent for a whole keep alive interval.
+		/// True so the first tick arms the timer.
+		std::atomic<bool> bKeepAliveDue{true};
+		FMqttifyTimerHandle KeepAliveTimer;
 
 	public:
 		explicit FMqttifyClientConnectedState(
@@ -37,6 +41,8 @@ namespace Mqttify
 			: FMqttifyClientState{InOnStateChanged, InContext}
 			, Socket{InSocket} {}
 
+		virtual ~FMqttifyClientConnectedState() override;
+
 		// FMqttifyClientState
 		virtual EMqttifyState GetState() override { return EMqttifyState::Connected; }
 		virtual IMqttifyConnectableAsync* AsConnectable() override { return this; }
@@ -68,6 +74,18 @@ namespace Mqttify
 	private:
 		template <typename TClientState>
 		void SocketTransitionToState();
+
+		/**
+		 * @brief Schedule the next keep alive check on the timer wheel.
+		 * @param InDelaySeconds The time until the check.
+		 */
+		void ScheduleKeepAlive(double InDelaySeconds);
+
+		/**
+		 * @brief Send a PINGREQ, reconnecting if no PINGRESP arrives.
+		 * @param InKeepAliveIntervalSeconds The keep alive of the connection.
+		 */
+		void SendPingReq(uint16 InKeepAliveIntervalSeconds);
 	};
 
 	template <typename TClientState>
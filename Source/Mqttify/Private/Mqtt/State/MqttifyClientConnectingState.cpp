@@ -49,6 +49,30 @@ namespace Mqttify
 			});
 		}
 
+		// Let the broker pace the QoS 1 and 2 publishes it sends us
+		PropertyArr.Add(
+		{
+			FMqttifyProperty::Create<EMqttifyPropertyIdentifier::ReceiveMaximum>(
+				Context->GetConnectionSettings()->GetReceiveMaximum())
+		});
+
+		// Let the broker replace repeated topic names with aliases
+		if (const uint16 TopicAliasMaximum = Context->GetConnectionSettings()->GetTopicAliasMaximum();
+			TopicAliasMaximum > 0)
+		{
+			PropertyArr.Add(
+			{
+				FMqttifyProperty::Create<EMqttifyPropertyIdentifier::TopicAliasMaximum>(TopicAliasMaximum)
+			});
+		}
+
+		// Let the broker know the largest packet we read before dropping the connection
+		PropertyArr.Add(
+		{
+			FMqttifyProperty::Create<EMqttifyPropertyIdentifier::MaximumPacketSize>(
+				Context->GetConnectionSettings()->GetMaxPacketSize())
+		});
+
 		const FMqttifyCredentialsProviderRef Credentials = Context->GetConnectionSettings()->GetCredentialsProvider();
 
 		// Enhanced authentication: include Authentication Method and optional initial Authentication Data
@@ -109,6 +133,8 @@ namespace Mqttify
 	void FMqttifyClientConnectingState::Tick()
 	{
 		Socket->Tick();
+		Context->ExpireCommands(FPlatformTime::Seconds());
+		Context->CommitSessionStore();
 	}
 
 	FDisconnectFuture FMqttifyClientConnectingState::DisconnectAsync()
@@ -128,9 +154,8 @@ namespace Mqttify
 
 	void FMqttifyClientConnectingState::OnReceivePacket(const TSharedPtr<FArrayReader>& InPacket)
 	{
-		FMqttifyPacketPtr Packet = CreatePacket(InPacket);
-
-		if (Packet == nullptr)
+		FMqttifyInboundPacket Packet;
+		if (!DecodePacket(InPacket, Packet))
 		{
 			LOG_MQTTIFY(Error, TEXT("Failed to parse packet."));
 			return;
@@ -147,15 +172,15 @@ namespace Mqttify
 		{
 			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
 			{
-				TUniquePtr<FMqttifyAuthPacket> AuthPacket(static_cast<FMqttifyAuthPacket*>(Packet.Release()));
-				switch (const EMqttifyReasonCode ReasonCode = AuthPacket->GetReasonCode())
+				const FMqttifyAuthPacket& AuthPacket = Packet.As<FMqttifyAuthPacket>();
+				switch (const EMqttifyReasonCode ReasonCode = AuthPacket.GetReasonCode())
 				{
 					
 					case EMqttifyReasonCode::ContinueAuthentication:
 					{
 						FString ServerMethod;
 						TArray<uint8> ServerData;
-						for (const FMqttifyProperty& Prop : AuthPacket->GetProperties().GetProperties())
+						for (const FMqttifyProperty& Prop : AuthPacket.GetProperties().GetProperties())
 						{
 							switch (Prop.GetIdentifier())
 							{
@@ -220,16 +245,16 @@ namespace Mqttify
 			return;
 		}
 
+		bool bSessionPresent = false;
 		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
 		{
-			const auto ConnAckPacket = TUniquePtr<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_5>>(
-				static_cast<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_5>*>(Packet.Release()));
-			if (ConnAckPacket->GetReasonCode() != EMqttifyReasonCode::Success)
+			const auto& ConnAckPacket = Packet.As<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_5>>();
+			if (ConnAckPacket.GetReasonCode() != EMqttifyReasonCode::Success)
 			{
 				LOG_MQTTIFY(
 					Error,
 					TEXT("Failed to connect. Reason: %s."),
-					EnumToTCharString(ConnAckPacket->GetReasonCode()));
+					EnumToTCharString(ConnAckPacket.GetReasonCode()));
 				Socket->Disconnect();
 				return;
 			}
@@ -238,23 +263,72 @@ namespace Mqttify
 				LOG_MQTTIFY(
 					Log,
 					TEXT("Mqtt_5 connect success. GetSessionPresent(): %s."),
-					ConnAckPacket->GetSessionPresent() ? TEXT("TRUE") : TEXT("FALSE"));
+					ConnAckPacket.GetSessionPresent() ? TEXT("TRUE") : TEXT("FALSE"));
 			}
+
+			// An absent Receive Maximum means 65535, an absent Topic Alias Maximum means no aliases and an absent
+			// Server Keep Alive means the keep alive we asked for, an absent Maximum Packet Size means no limit
+			uint16 ServerReceiveMaximum = std::numeric_limits<uint16>::max();
+			uint16 TopicAliasMaximum = 0;
+			uint16 KeepAliveIntervalSeconds = Context->GetConnectionSettings()->GetKeepAliveIntervalSeconds();
+			uint32 ServerMaximumPacketSize = 0;
+			for (const FMqttifyProperty& Property : ConnAckPacket.GetProperties().GetProperties())
+			{
+				switch (Property.GetIdentifier())
+				{
+					case EMqttifyPropertyIdentifier::ReceiveMaximum:
+						Property.TryGetValue(ServerReceiveMaximum);
+						break;
+					case EMqttifyPropertyIdentifier::TopicAliasMaximum:
+						Property.TryGetValue(TopicAliasMaximum);
+						break;
+					case EMqttifyPropertyIdentifier::ServerKeepAlive:
+						Property.TryGetValue(KeepAliveIntervalSeconds);
+						break;
+					case EMqttifyPropertyIdentifier::MaximumPacketSize:
+						Property.TryGetValue(ServerMaximumPacketSize);
+						break;
+					default:
+						break;
+				}
+			}
+			Context->SetKeepAliveIntervalSeconds(KeepAliveIntervalSeconds);
+			Context->SetServerMaximumPacketSize(ServerMaximumPacketSize);
+			Context->GetOutboundTopicAliases()->Reset(TopicAliasMaximum);
+			Context->GetInboundTopicAliases()->Reset(Context->GetConnectionSettings()->GetTopicAliasMaximum());
+			Context->SetServerReceiveMaximum(ServerReceiveMaximum);
+			bSessionPresent = ConnAckPacket.GetSessionPresent();
 		}
 		else if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_3_1_1)
 		{
-			const auto ConnAckPacket = TUniquePtr<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>>(
-				static_cast<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>*>(Packet.Release()));
-			if (ConnAckPacket->GetReasonCode() != EMqttifyConnectReturnCode::Accepted)
+			const auto& ConnAckPacket = Packet.As<TMqttifyConnAckPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>>();
+			if (ConnAckPacket.GetReasonCode() != EMqttifyConnectReturnCode::Accepted)
 			{
 				LOG_MQTTIFY(
 					Error,
 					TEXT("Failed to connect. Reason: %s."),
-					EnumToTCharString(ConnAckPacket->GetReasonCode()));
+					EnumToTCharString(ConnAckPacket.GetReasonCode()));
 				Socket->Disconnect();
 				return;
 			}
+
+			Context->SetKeepAliveIntervalSeconds(Context->GetConnectionSettings()->GetKeepAliveIntervalSeconds());
+			Context->SetServerMaximumPacketSize(0);
+			bSessionPresent = ConnAckPacket.GetSessionPresent();
+		}
+
+		// Pick up the in-flight state where the last connection left it, or let go of it and restore the
+		// subscriptions if the broker has not. Publishes made while offline go out after it
+		if (bSessionPresent)
+		{
+			Context->ResumeSession();
+		}
+		else
+		{
+			Context->DiscardSession();
+			Context->Resubscribe(Socket);
 		}
+		Context->FlushOfflinePublishes();
 
 		const TSharedRef<FMqttifyClientConnectingState> StrongThis = AsShared();
 		StrongThis->SocketTransitionToState<FMqttifyClientConnectedState>();
@@ -3,11 +3,225 @@
 #include "LogMqttify.h"
 #include "MqttifyAsync.h"
 #include "Mqtt/MqttifyResult.h"
+#include "Mqtt/MqttifyTopicTable.h"
+#include "Mqtt/MqttifySubscribeResult.h"
 #include "Mqtt/Commands/MqttifyAcknowledgeable.h"
+#include "Mqtt/Commands/MqttifyPublish.h"
+#include "Mqtt/Commands/MqttifyPublishBatch.h"
+#include "Mqtt/MqttifyUnsubscribeResult.h"
+#include "Mqtt/Commands/MqttifySubscribe.h"
+#include "Mqtt/Commands/MqttifyUnsubscribe.h"
+#include "Misc/Paths.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Packets/MqttifySubscribePacket.h"
+#include "Packets/MqttifyUnsubscribePacket.h"
 #include "Packets/Interface/IMqttifyControlPacket.h"
 
 namespace Mqttify
 {
+	namespace
+	{
+		/**
+		 * @brief Gathers the results of one subscribe or unsubscribe call from the packets its topic filters went
+		 * out in, fulfilling its promise once every topic filter has a result.
+		 */
+		template <typename TResult>
+		class TSubscriptionCall final
+		{
+		public:
+			using FPromise = TPromise<TMqttifyResult<TArray<TResult>>>;
+
+			TSubscriptionCall(const TSharedRef<FPromise>& InPromise, const TArray<FMqttifyTopicFilter>& InTopicFilters)
+				: Promise{InPromise}
+				, NumPending{InTopicFilters.Num()}
+			{
+				Results.Reserve(InTopicFilters.Num());
+				for (const FMqttifyTopicFilter& TopicFilter : InTopicFilters)
+				{
+					Results.Emplace(TopicFilter, false);
+				}
+
+				if (NumPending == 0)
+				{
+					Promise->SetValue(TMqttifyResult<TArray<TResult>>{false, {}});
+				}
+			}
+
+			/**
+			 * @brief Set the result of a topic filter of the call.
+			 * @param InIndex The index of the topic filter in the call.
+			 * @param InResult The result from the acknowledgement, nullptr if the packet failed.
+			 */
+			void SetResult(const int32 InIndex, const TResult* InResult)
+			{
+				TArray<TResult> Completed;
+				bool bCompletedSuccessfully;
+				{
+					FScopeLock Lock{&CriticalSection};
+					if (InResult != nullptr)
+					{
+						Results[InIndex] = *InResult;
+					}
+					else
+					{
+						bHasSucceeded = false;
+					}
+
+					if (--NumPending > 0)
+					{
+						return;
+					}
+					Completed = MoveTemp(Results);
+					bCompletedSuccessfully = bHasSucceeded;
+				}
+				Promise->SetValue(TMqttifyResult<TArray<TResult>>{bCompletedSuccessfully, MoveTemp(Completed)});
+			}
+
+		private:
+			TSharedRef<FPromise> Promise;
+			TArray<TResult> Results;
+			int32 NumPending;
+			bool bHasSucceeded = true;
+			FCriticalSection CriticalSection;
+		};
+
+		template <typename TRequest>
+		struct TSubscriptionRequestTraits;
+
+		template <>
+		struct TSubscriptionRequestTraits<FMqttifySubscribeRequest>
+		{
+			using FPacket = TMqttifySubscribePacket<GMqttifyProtocol>;
+			using FCommand = FMqttifySubscribe;
+			using FResult = FMqttifySubscribeResult;
+
+			static void OnAcknowledged(FMqttifyClientContext& InContext,
+										const TMqttifyResult<TArray<FResult>>& InResult)
+			{
+				InContext.AddActiveSubscriptions(*InResult.GetResult());
+			}
+		};
+
+		template <>
+		struct TSubscriptionRequestTraits<FMqttifyUnsubscribeRequest>
+		{
+			using FPacket = TMqttifyUnsubscribePacket<GMqttifyProtocol>;
+			using FCommand = FMqttifyUnsubscribe;
+			using FResult = FMqttifyUnsubscribeResult;
+
+			static void OnAcknowledged(FMqttifyClientContext& InContext,
+										const TMqttifyResult<TArray<FResult>>& InResult)
+			{
+				InContext.ClearMessageDelegates(InResult.GetResult());
+			}
+		};
+
+		/**
+		 * @brief Create the call gathering the results of a subscribe call.
+		 * @param InTopicFilters The topic filters of the call with their delegates.
+		 * @param OutFuture Receives the future of the call.
+		 * @return The call.
+		 */
+		TSharedRef<TSubscriptionCall<FMqttifySubscribeResult>> MakeSubscribeCall(
+			const TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>& InTopicFilters,
+			TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>>& OutFuture)
+		{
+			using FCall = TSubscriptionCall<FMqttifySubscribeResult>;
+			const TSharedRef<FCall::FPromise> Promise = MakeShared<FCall::FPromise>();
+			OutFuture = Promise->GetFuture();
+
+			TArray<FMqttifyTopicFilter> TopicFilters;
+			TopicFilters.Reserve(InTopicFilters.Num());
+			for (const TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>& Entry : InTopicFilters)
+			{
+				TopicFilters.Add(Entry.Get<0>());
+			}
+			return MakeShared<FCall>(Promise, TopicFilters);
+		}
+
+		const FMqttifyTopicFilter& GetTopicFilter(const TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>& InEntry)
+		{
+			return InEntry.Get<0>();
+		}
+
+		const FMqttifyTopicFilter& GetTopicFilter(const FMqttifyTopicFilter& InEntry)
+		{
+			return InEntry;
+		}
+
+		/**
+		 * @brief Assign topic filters to packets in order, starting a new packet once the next topic filter would
+		 * take the current one over the broker's Maximum Packet Size.
+		 * @param InLengths The length each topic filter takes in the payload.
+		 * @param InMaximumPacketSize The largest packet the broker accepts, 0 for no limit.
+		 * @param OutPackets Receives the packet of each topic filter, INDEX_NONE if it does not fit a packet alone.
+		 * @return The number of packets.
+		 */
+		template <typename TPacket>
+		int32 AssignPackets(const TArray<uint32>& InLengths,
+							const uint32 InMaximumPacketSize,
+							TArray<int32>& OutPackets)
+		{
+			OutPackets.SetNumUninitialized(InLengths.Num());
+			int32 NumPackets = 0;
+			uint32 PacketLength = 0;
+			for (int32 Index = 0; Index < InLengths.Num(); ++Index)
+			{
+				const uint32 Length = InLengths[Index];
+				if (InMaximumPacketSize > 0 && TPacket::GetPacketSize(Length) > InMaximumPacketSize)
+				{
+					OutPackets[Index] = INDEX_NONE;
+					continue;
+				}
+
+				const bool bIsFull = InMaximumPacketSize > 0
+					&& TPacket::GetPacketSize(PacketLength + Length) > InMaximumPacketSize;
+				if (NumPackets == 0 || bIsFull)
+				{
+					++NumPackets;
+					PacketLength = 0;
+				}
+				OutPackets[Index] = NumPackets - 1;
+				PacketLength += Length;
+			}
+			return NumPackets;
+		}
+
+		/**
+		 * @brief Combine the subscription options of two subscribers of a topic filter, so one subscription on the
+		 * broker serves both. The higher QoS wins, and local messages, the published retain flag and retained
+		 * messages at subscribe time are kept if either subscriber wants them.
+		 * @param InSubscribed The topic filter as sent to the broker.
+		 * @param InAdded The topic filter of the new subscriber.
+		 * @return The topic filter with the combined options.
+		 */
+		FMqttifyTopicFilter MergeTopicFilters(const FMqttifyTopicFilter& InSubscribed, const FMqttifyTopicFilter& InAdded)
+		{
+			const EMqttifyQualityOfService QualityOfService = FMath::Max(
+				InSubscribed.GetQualityOfService(),
+				InAdded.GetQualityOfService());
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				return FMqttifyTopicFilter{
+					InSubscribed.GetFilter(),
+					QualityOfService,
+					InSubscribed.GetIsNoLocal() && InAdded.GetIsNoLocal(),
+					InSubscribed.GetIsRetainAsPublished() || InAdded.GetIsRetainAsPublished(),
+					FMath::Min(InSubscribed.GetRetainHandlingOptions(), InAdded.GetRetainHandlingOptions())};
+			}
+			else
+			{
+				// MQTT 3.1.1 only has the QoS, the other options are never sent
+				return FMqttifyTopicFilter{
+					InSubscribed.GetFilter(),
+					QualityOfService,
+					InSubscribed.GetIsNoLocal(),
+					InSubscribed.GetIsRetainAsPublished(),
+					InSubscribed.GetRetainHandlingOptions()};
+			}
+		}
+	} // namespace
+
 	FMqttifyClientContext::~FMqttifyClientContext()
 	{
 		ClearMessageDelegates();
@@ -16,40 +230,105 @@ namespace Mqttify
 		AbandonCommands();
 	}
 
-	FMqttifyClientContext::FMqttifyClientContext(const FMqttifyConnectionSettingsRef& InConnectionSettings)
+	FMqttifyClientContext::FMqttifyClientContext(
+		const FMqttifyConnectionSettingsRef& InConnectionSettings,
+		const TSharedRef<FMqttifyTimerWheel>& InTimerWheel
+		)
 		: ConnectionSettings{InConnectionSettings}
+		, TimerWheel{InTimerWheel}
+		, AcknowledgeableCommands{InTimerWheel}
+		, OfflinePublishes{
+			InConnectionSettings->GetOfflineBufferMaxMessages(),
+			InConnectionSettings->GetOfflineBufferMaxBytes(),
+			InConnectionSettings->GetOfflineDropPolicy()}
+		, KeepAliveIntervalSeconds{InConnectionSettings->GetKeepAliveIntervalSeconds()}
 	{
-		for (uint16 i = 1; i < kMaxCount; ++i)
+		const FString& StoreDirectory = InConnectionSettings->GetSessionStoreDirectory();
+		if (StoreDirectory.IsEmpty())
 		{
-			IdPool.Enqueue(i);
+			return;
+		}
+
+		SessionStore = FMqttifySessionStore::Open(
+			FPaths::Combine(StoreDirectory, InConnectionSettings->GetClientId() + TEXT(".mqttsession")),
+			RecoveredPublishes);
+		for (const FMqttifySessionStore::FStoredPublish& Recovered : RecoveredPublishes)
+		{
+			IdAllocator.Claim(Recovered.PacketId);
 		}
 	}
 
 	uint16 FMqttifyClientContext::GetNextId()
 	{
-		FScopeLock Lock(&IdPoolCriticalSection);
-		uint16 Id;
-		if (!IdPool.Dequeue(Id))
+		const uint16 Id = IdAllocator.Allocate();
+		if (Id == 0)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("No more IDs available!"));
-			Id = 0;
 		}
 		return Id;
 	}
 
+	bool FMqttifyClientContext::ReserveIds(const int32 InCount, TArray<uint16>& OutIds)
+	{
+		OutIds.Reset(InCount);
+		for (int32 Index = 0; Index < InCount; ++Index)
+		{
+			const uint16 Id = IdAllocator.Allocate();
+			if (Id == 0)
+			{
+				LOG_MQTTIFY(Warning, TEXT("Only %d of %d IDs available"), OutIds.Num(), InCount);
+				for (const uint16 Taken : OutIds)
+				{
+					IdAllocator.Release(Taken);
+				}
+				OutIds.Reset();
+				return false;
+			}
+			OutIds.Add(Id);
+		}
+		return true;
+	}
+
+	bool FMqttifyClientContext::IsIdAllocated(const uint16 InId) const
+	{
+		return IdAllocator.IsAllocated(InId);
+	}
+
 	void FMqttifyClientContext::ReleaseId(const uint16 Id)
 	{
-		FScopeLock Lock(&IdPoolCriticalSection);
-		if (Id > 0 && Id <= kMaxCount)
+		// Every QoS 1 and 2 publish gives its identifier back once it is acknowledged or failed
+		if (SessionStore.IsValid())
 		{
-			IdPool.Enqueue(Id);
+			SessionStore->Remove(Id);
 		}
-		else
+
+		if (!IdAllocator.Release(Id))
 		{
 			UE_LOG(LogTemp, Warning, TEXT("Invalid ID!"));
 		}
 	}
 
+	void FMqttifyClientContext::PersistPublish(const uint16 InPacketId, const FMqttifyMessage& InMessage)
+	{
+		if (SessionStore.IsValid())
+		{
+			SessionStore->AddPublish(InPacketId, InMessage);
+		}
+	}
+
+	void FMqttifyClientContext::CommitSessionStore()
+	{
+		if (SessionStore.IsValid())
+		{
+			SessionStore->Commit();
+		}
+	}
+
+	TArray<FMqttifySessionStore::FStoredPublish> FMqttifyClientContext::TakeRecoveredPublishes()
+	{
+		return MoveTemp(RecoveredPublishes);
+	}
+
 	void FMqttifyClientContext::AddAcknowledgeableCommand(const TSharedRef<FMqttifyQueueable>& InCommand)
 	{
 		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
@@ -59,7 +338,433 @@ namespace Mqttify
 		}
 	}
 
-	bool FMqttifyClientContext::HasAcknowledgeableCommand(const uint16 InPacketIdentifier) const
+	void FMqttifyClientContext::AddPublishCommand(const TSharedRef<FMqttifyQueueable>& InCommand)
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		// Queue behind earlier publishes even if there is room, so publishes go out in order
+		if (NumPendingPublishes == 0 && WindowPublishIds.Num() < ServerReceiveMaximum)
+		{
+			AddToWindowLocked(InCommand);
+			return;
+		}
+
+		PendingPublishes.Enqueue(InCommand);
+		++NumPendingPublishes;
+		LOG_MQTTIFY(
+			VeryVerbose,
+			TEXT("Receive Maximum %d reached, %d publishes pending"),
+			ServerReceiveMaximum,
+			NumPendingPublishes);
+	}
+
+	void FMqttifyClientContext::AddPublishBatch(const TSharedRef<FMqttifyPublishBatch>& InBatch,
+												const TArray<TSharedRef<FMqttifyQueueable>>& InPublishes)
+	{
+		{
+			FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+			if (NumPendingPublishes == 0 && WindowPublishIds.Num() + InPublishes.Num() <= ServerReceiveMaximum)
+			{
+				// The batch writes their first send before the in-flight table gets to them
+				for (const TSharedRef<FMqttifyQueueable>& Publish : InPublishes)
+				{
+					AddToWindowLocked(Publish);
+				}
+			}
+			else
+			{
+				InBatch->DropPublishes();
+				for (const TSharedRef<FMqttifyQueueable>& Publish : InPublishes)
+				{
+					PendingPublishes.Enqueue(Publish);
+				}
+				NumPendingPublishes += InPublishes.Num();
+				FillWindowLocked();
+				LOG_MQTTIFY(
+					VeryVerbose,
+					TEXT("Receive Maximum %d reached, %d publishes pending"),
+					ServerReceiveMaximum,
+					NumPendingPublishes);
+			}
+		}
+
+		if (InBatch->HasEntries())
+		{
+			AddOneShotCommand(InBatch);
+		}
+	}
+
+	TFuture<TMqttifyResult<void>> FMqttifyClientContext::PublishAsync(FMqttifyMessage&& InMessage,
+																	const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		// The broker disconnects on a packet above its Maximum Packet Size, fail the publish before it is encoded
+		const uint32 PacketSize = TMqttifyPublishPacket<GMqttifyProtocol>::GetPacketSize(
+			InMessage,
+			OutboundTopicAliases->GetTopicAliasMaximum() > 0);
+		if (const uint32 ServerMaximumPacketSize = GetServerMaximumPacketSize(); ServerMaximumPacketSize > 0)
+		{
+			if (PacketSize > ServerMaximumPacketSize)
+			{
+				LOG_MQTTIFY(
+					Warning,
+					TEXT("[Publishing (Connection %s, ClientId %s)] %s is %u bytes, the broker accepts at most %u"),
+					*GetConnectionSettings()->GetHost(),
+					*GetConnectionSettings()->GetClientIdRef(),
+					*InMessage.GetTopic(),
+					PacketSize,
+					ServerMaximumPacketSize);
+				return MakeThreadAwareFulfilledPromise<TMqttifyResult<void>>(
+					TMqttifyResult<void>{false, EMqttifyReasonCode::PacketTooLarge});
+			}
+		}
+
+		// Without a session the publish waits in the offline buffer, it is sent once the broker accepts a connection
+		const EMqttifyQualityOfService QualityOfService = InMessage.GetQualityOfService();
+
+		switch (QualityOfService)
+		{
+			case EMqttifyQualityOfService::AtMostOnce:
+			{
+				const FMqttifyPubAtMostOnceRef PublishCommand = MakeShared<FMqttifyPubAtMostOnce, ESPMode::ThreadSafe>(
+					MoveTemp(InMessage),
+					InSocket,
+					GetConnectionSettings(),
+					GetOutboundTopicAliases());
+				AddPublish(PublishCommand, QualityOfService, PacketSize);
+				return PublishCommand->GetFuture();
+			}
+			case EMqttifyQualityOfService::AtLeastOnce:
+			{
+				const uint16 PacketId = GetNextId();
+				PersistPublish(PacketId, InMessage);
+				const FMqttifyPubAtLeastOnceRef PublishCommand = MakeShared<
+					FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+					MoveTemp(InMessage),
+					PacketId,
+					InSocket,
+					GetConnectionSettings(),
+					GetRetransmitCache(),
+					GetOutboundTopicAliases());
+				AddPublish(PublishCommand, QualityOfService, PacketSize);
+				return PublishCommand->GetFuture();
+			}
+			case EMqttifyQualityOfService::ExactlyOnce:
+			{
+				const uint16 PacketId = GetNextId();
+				PersistPublish(PacketId, InMessage);
+				const FMqttifyPubExactlyOnceRef PublishCommand = MakeShared<
+					FMqttifyPubExactlyOnce, ESPMode::ThreadSafe>(
+					MoveTemp(InMessage),
+					PacketId,
+					InSocket,
+					GetConnectionSettings(),
+					GetRetransmitCache(),
+					GetOutboundTopicAliases());
+				AddPublish(PublishCommand, QualityOfService, PacketSize);
+				return PublishCommand->GetFuture();
+			}
+			default:
+			{
+				ensureMsgf(false, TEXT("Invalid quality of service"));
+				return MakeThreadAwareFulfilledPromise<TMqttifyResult<void>>(TMqttifyResult<void>{false});
+			}
+		}
+	}
+
+	TFuture<TMqttifyResult<TArray<TMqttifyResult<void>>>> FMqttifyClientContext::PublishBatchAsync(
+		TArray<FMqttifyMessage>&& InMessages,
+		const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		const int32 NumMessages = InMessages.Num();
+		const FMqttifyPublishBatchRef Batch = MakeShared<FMqttifyPublishBatch, ESPMode::ThreadSafe>(
+			NumMessages,
+			InSocket,
+			GetConnectionSettings(),
+			GetOutboundTopicAliases());
+		TFuture<TMqttifyResult<TArray<TMqttifyResult<void>>>> Future = Batch->GetFuture();
+		const auto ReportTo = [&Batch](const int32 InIndex) {
+			return [Batch, InIndex](const TMqttifyResult<void>& InResult) { Batch->SetResult(InIndex, InResult); };
+		};
+
+		// A size of 0 marks a message that failed before it was queued
+		const uint32 ServerMaximumPacketSize = GetServerMaximumPacketSize();
+		const bool bMayUseTopicAlias = OutboundTopicAliases->GetTopicAliasMaximum() > 0;
+		TArray<uint32> PacketSizes;
+		PacketSizes.SetNumUninitialized(NumMessages);
+		TArray<EMqttifyQualityOfService> QualityOfServices;
+		QualityOfServices.SetNumUninitialized(NumMessages);
+		int32 NumAcknowledged = 0;
+		for (int32 Index = 0; Index < NumMessages; ++Index)
+		{
+			QualityOfServices[Index] = InMessages[Index].GetQualityOfService();
+			PacketSizes[Index] = TMqttifyPublishPacket<GMqttifyProtocol>::GetPacketSize(
+				InMessages[Index],
+				bMayUseTopicAlias);
+			if (ServerMaximumPacketSize > 0 && PacketSizes[Index] > ServerMaximumPacketSize)
+			{
+				LOG_MQTTIFY(
+					Warning,
+					TEXT("[Publishing (Connection %s, ClientId %s)] %s is %u bytes, the broker accepts at most %u"),
+					*GetConnectionSettings()->GetHost(),
+					*GetConnectionSettings()->GetClientIdRef(),
+					*InMessages[Index].GetTopic(),
+					PacketSizes[Index],
+					ServerMaximumPacketSize);
+				PacketSizes[Index] = 0;
+				Batch->SetResult(Index, TMqttifyResult<void>{false, EMqttifyReasonCode::PacketTooLarge});
+			}
+			else if (QualityOfServices[Index] != EMqttifyQualityOfService::AtMostOnce)
+			{
+				++NumAcknowledged;
+			}
+		}
+
+		// Packet identifiers for the whole batch are taken up front, all or none
+		TArray<uint16> PacketIds;
+		if (!ReserveIds(NumAcknowledged, PacketIds))
+		{
+			for (int32 Index = 0; Index < NumMessages; ++Index)
+			{
+				if (PacketSizes[Index] > 0 && QualityOfServices[Index] != EMqttifyQualityOfService::AtMostOnce)
+				{
+					PacketSizes[Index] = 0;
+					Batch->SetResult(Index, TMqttifyResult<void>{false, EMqttifyReasonCode::QuotaExceeded});
+				}
+			}
+		}
+
+		// The QoS 1 and 2 publishes are logged before they are queued, wherever they go
+		TArray<TSharedPtr<TMqttifyQueueable<void>>> Commands;
+		Commands.SetNum(NumMessages);
+		int32 NextPacketId = 0;
+		for (int32 Index = 0; Index < NumMessages; ++Index)
+		{
+			const EMqttifyQualityOfService QualityOfService = QualityOfServices[Index];
+			if (PacketSizes[Index] == 0 || QualityOfService == EMqttifyQualityOfService::AtMostOnce)
+			{
+				continue;
+			}
+
+			const uint16 PacketId = PacketIds[NextPacketId++];
+			PersistPublish(PacketId, InMessages[Index]);
+			if (QualityOfService == EMqttifyQualityOfService::AtLeastOnce)
+			{
+				Commands[Index] = MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+					MoveTemp(InMessages[Index]),
+					PacketId,
+					InSocket,
+					GetConnectionSettings(),
+					GetRetransmitCache(),
+					GetOutboundTopicAliases());
+			}
+			else
+			{
+				Commands[Index] = MakeShared<FMqttifyPubExactlyOnce, ESPMode::ThreadSafe>(
+					MoveTemp(InMessages[Index]),
+					PacketId,
+					InSocket,
+					GetConnectionSettings(),
+					GetRetransmitCache(),
+					GetOutboundTopicAliases());
+			}
+			Commands[Index]->SetOnResult(ReportTo(Index));
+		}
+
+		// Decided under the offline lock, so the batch cannot be queued after the connection was lost
+		TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+		{
+			FScopeLock Lock(&OfflinePublishesCriticalSection);
+			TArray<TSharedRef<FMqttifyQueueable>> Publishes;
+			Publishes.Reserve(PacketIds.Num());
+			for (int32 Index = 0; Index < NumMessages; ++Index)
+			{
+				if (PacketSizes[Index] == 0)
+				{
+					continue;
+				}
+
+				const EMqttifyQualityOfService QualityOfService = QualityOfServices[Index];
+				if (bIsOnline)
+				{
+					if (QualityOfService == EMqttifyQualityOfService::AtMostOnce)
+					{
+						Batch->AddMessage(Index, MoveTemp(InMessages[Index]), PacketSizes[Index]);
+					}
+					else
+					{
+						Batch->AddPublish(Index, Commands[Index].ToSharedRef(), PacketSizes[Index]);
+						Publishes.Add(Commands[Index].ToSharedRef());
+					}
+					continue;
+				}
+
+				if (QualityOfService == EMqttifyQualityOfService::AtMostOnce)
+				{
+					Commands[Index] = MakeShared<FMqttifyPubAtMostOnce, ESPMode::ThreadSafe>(
+						MoveTemp(InMessages[Index]),
+						InSocket,
+						GetConnectionSettings(),
+						GetOutboundTopicAliases());
+					Commands[Index]->SetOnResult(ReportTo(Index));
+				}
+				OfflinePublishes.Add(Commands[Index].ToSharedRef(), QualityOfService, PacketSizes[Index], Dropped);
+			}
+
+			if (bIsOnline)
+			{
+				AddPublishBatch(Batch, Publishes);
+			}
+		}
+
+		UE_CLOG(
+			Dropped.Num() > 0,
+			LogMqttify,
+			Warning,
+			TEXT("Offline publish buffer full, dropped %d publishes"),
+			Dropped.Num());
+		AbandonOfflinePublishes(Dropped);
+		return Future;
+	}
+
+	bool FMqttifyClientContext::PublishFireAndForget(FMqttifyMessage&& InMessage,
+													const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		if (InMessage.GetQualityOfService() != EMqttifyQualityOfService::AtMostOnce)
+		{
+			LOG_MQTTIFY(Warning, TEXT("Fire and forget publishes are QoS 0, %s is not"), *InMessage.GetTopic());
+			return false;
+		}
+
+		const TSharedPtr<FMqttifySocketBase> Socket = InSocket.Pin();
+		if (!Socket.IsValid() || !Socket->IsConnected())
+		{
+			return false;
+		}
+
+		if (const uint32 MaximumPacketSize = GetServerMaximumPacketSize(); MaximumPacketSize > 0)
+		{
+			if (TMqttifyPublishPacket<GMqttifyProtocol>::GetPacketSize(InMessage) > MaximumPacketSize)
+			{
+				LOG_MQTTIFY(
+					Warning,
+					TEXT("%s is larger than the broker accepts, %u bytes"),
+					*InMessage.GetTopic(),
+					MaximumPacketSize);
+				return false;
+			}
+		}
+
+		TMqttifyPublishPacket<GMqttifyProtocol> Packet{MoveTemp(InMessage), 0};
+		return Socket->SendInPlace(Packet);
+	}
+
+	void FMqttifyClientContext::SetServerReceiveMaximum(const uint16 InReceiveMaximum)
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		// A Receive Maximum of 0 is a protocol error, don't let it stall the client
+		ServerReceiveMaximum = FMath::Max<uint16>(InReceiveMaximum, 1);
+		FillWindowLocked();
+	}
+
+	void FMqttifyClientContext::AddOfflinePublish(const TSharedRef<FMqttifyQueueable>& InCommand,
+												const EMqttifyQualityOfService InQualityOfService,
+												const uint32 InSize)
+	{
+		TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+		{
+			FScopeLock Lock(&OfflinePublishesCriticalSection);
+			OfflinePublishes.Add(InCommand, InQualityOfService, InSize, Dropped);
+		}
+
+		UE_CLOG(
+			Dropped.Num() > 0,
+			LogMqttify,
+			Warning,
+			TEXT("Offline publish buffer full, dropped %d publishes"),
+			Dropped.Num());
+		AbandonOfflinePublishes(Dropped);
+	}
+
+	void FMqttifyClientContext::AddPublish(const TSharedRef<FMqttifyQueueable>& InCommand,
+										const EMqttifyQualityOfService InQualityOfService,
+										const uint32 InSize)
+	{
+		TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+		{
+			FScopeLock Lock(&OfflinePublishesCriticalSection);
+			if (!bIsOnline)
+			{
+				OfflinePublishes.Add(InCommand, InQualityOfService, InSize, Dropped);
+			}
+			else if (InQualityOfService == EMqttifyQualityOfService::AtMostOnce)
+			{
+				AddOneShotCommand(InCommand);
+			}
+			else
+			{
+				AddPublishCommand(InCommand);
+			}
+		}
+
+		UE_CLOG(
+			Dropped.Num() > 0,
+			LogMqttify,
+			Warning,
+			TEXT("Offline publish buffer full, dropped %d publishes"),
+			Dropped.Num());
+		AbandonOfflinePublishes(Dropped);
+	}
+
+	void FMqttifyClientContext::FlushOfflinePublishes()
+	{
+		// Queued under the lock, a publish made meanwhile waits for the flush and goes out after it
+		FScopeLock Lock(&OfflinePublishesCriticalSection);
+		bIsOnline = true;
+		TArray<FMqttifyOfflineBuffer::FEntry> Entries;
+		OfflinePublishes.Drain(Entries);
+		if (Entries.Num() == 0)
+		{
+			return;
+		}
+
+		LOG_MQTTIFY(Verbose, TEXT("Sending %d publishes held while offline"), Entries.Num());
+		for (const FMqttifyOfflineBuffer::FEntry& Entry : Entries)
+		{
+			if (Entry.QualityOfService == EMqttifyQualityOfService::AtMostOnce)
+			{
+				AddOneShotCommand(Entry.Command.ToSharedRef());
+			}
+			else
+			{
+				AddPublishCommand(Entry.Command.ToSharedRef());
+			}
+		}
+	}
+
+	void FMqttifyClientContext::MarkOffline()
+	{
+		FScopeLock Lock(&OfflinePublishesCriticalSection);
+		bIsOnline = false;
+	}
+
+	int32 FMqttifyClientContext::GetNumOfflinePublishes() const
+	{
+		FScopeLock Lock(&OfflinePublishesCriticalSection);
+		return OfflinePublishes.Num();
+	}
+
+	int32 FMqttifyClientContext::GetNumInFlightPublishes() const
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		return WindowPublishIds.Num();
+	}
+
+	int32 FMqttifyClientContext::GetNumPendingPublishes() const
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		return NumPendingPublishes;
+	}
+
+	bool FMqttifyClientContext::HasAcknowledgeableCommand(const uint32 InPacketIdentifier) const
 	{
 		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
 		return AcknowledgeableCommands.Contains(InPacketIdentifier);
@@ -77,24 +782,36 @@ namespace Mqttify
 		// is a large number of commands to process, we may want to process them in batches
 		// and set a limit to the number of commands we have pending
 
-		/// Process OneShotCommands
+		// Publishes must be durable before they can reach the broker. A publish is logged before it is queued, so
+		// committing once the commands to run were taken covers all of them, even one queued meanwhile
+		TArray<TSharedPtr<FMqttifyQueueable>, TInlineAllocator<16>> Commands;
 		TSharedPtr<FMqttifyQueueable> Command = nullptr;
 		while (OneShotCommands.Dequeue(Command))
 		{
-			if (Command.IsValid())
+			Commands.Add(Command);
+		}
+		CommitSessionStore();
+
+		/// Process OneShotCommands
+		for (const TSharedPtr<FMqttifyQueueable>& OneShotCommand : Commands)
+		{
+			if (OneShotCommand.IsValid())
 			{
-				Command->Next();
+				OneShotCommand->Next();
 			}
 		}
 
 		{
 			FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
-			for (auto It = AcknowledgeableCommands.CreateIterator(); It; ++It)
+			CommitSessionStore();
+			TArray<uint32, TInlineAllocator<16>> RemovedKeys;
+			AcknowledgeableCommands.ProcessDue(
+				FPlatformTime::Seconds(),
+				GetConnectionSettings()->GetMaxPacketRetries(),
+				&RemovedKeys);
+			for (const uint32 Key : RemovedKeys)
 			{
-				if (It.Value()->Next())
-				{
-					It.RemoveCurrent();
-				}
+				OnCommandRemovedLocked(Key);
 			}
 		}
 	}
@@ -149,9 +866,15 @@ namespace Mqttify
 			}
 			WildcardDelegates.Emplace(FMqttifyTopicFilter{InTopic}, Delegate);
 		}
+		else if (const FMqttifyTopicHandle TopicHandle = FMqttifyTopicTable::Get().Intern(InTopic);
+			TopicHandle.IsValid())
+		{
+			ExactDelegates.Add(TopicHandle, Delegate);
+		}
 		else
 		{
-			ExactDelegates.Add(InTopic, Delegate);
+			// Messages on a topic the full table could not intern arrive without a handle, match them on the name
+			UninternedExactDelegates.Add(InTopic, Delegate);
 		}
 		LOG_MQTTIFY(VeryVerbose, TEXT("GetMessageDelegate %s %d"), *InTopic, OnMessageDelegates.Num());
 		return Delegate;
@@ -165,12 +888,20 @@ namespace Mqttify
 		for (FMqttifyUnsubscribeResult& Result : *InUnsubscribeResults)
 		{
 			const FString Key = Result.GetFilter().GetFilter();
+			if (SubscriberCounts.Contains(Key))
+			{
+				// Subscribed to again while the UNSUBSCRIBE was on its way, the new subscribers keep the delegate
+				continue;
+			}
+
 			if (const TSharedRef<FOnMessage>* Delegate = OnMessageDelegates.Find(Key))
 			{
 				(*Delegate)->Clear();
 				OnMessageDelegates.Remove(Key);
 			}
-			ExactDelegates.Remove(Key);
+			ActiveSubscriptions.Remove(Key);
+			ExactDelegates.Remove(FMqttifyTopicTable::Get().Find(Key));
+			UninternedExactDelegates.Remove(Key);
 			WildcardDelegates.RemoveAll([&](const TPair<FMqttifyTopicFilter, TSharedRef<FOnMessage>>& P) {
 				return P.Key.GetFilter() == Key;
 			});
@@ -193,132 +924,713 @@ namespace Mqttify
 						ThisSharedPtr->OnDisconnectPromises.Reserve(kPromiseInitialReserve);
 					}
 
-					ThisSharedPtr->OnDisconnect().Broadcast(true);
-					for (const auto& Promise : Snapshot)
+					ThisSharedPtr->OnDisconnect().Broadcast(true);
+					for (const auto& Promise : Snapshot)
+					{
+						Promise->SetValue(TMqttifyResult<void>{true});
+					}
+				}
+			});
+	}
+
+	void FMqttifyClientContext::CompleteConnect()
+	{
+		TWeakPtr<FMqttifyClientContext> ThisWeakPtr = AsWeak();
+		DispatchWithThreadHandling(
+			[ThisWeakPtr] {
+				if (const TSharedPtr<FMqttifyClientContext> ThisSharedPtr = ThisWeakPtr.Pin())
+				{
+					TArray<TSharedPtr<TPromise<TMqttifyResult<void>>>> Snapshot;
+					{
+						FScopeLock Lock(&ThisSharedPtr->OnConnectPromisesCriticalSection);
+						Snapshot = ThisSharedPtr->OnConnectPromises;
+						ThisSharedPtr->OnConnectPromises.Empty();
+						ThisSharedPtr->OnConnectPromises.Reserve(kPromiseInitialReserve);
+					}
+
+					ThisSharedPtr->OnConnect().Broadcast(true);
+					for (const auto& Promise : Snapshot)
+					{
+						Promise->SetValue(TMqttifyResult<void>{true});
+					}
+				}
+			});
+	}
+
+	void FMqttifyClientContext::CompleteMessage(FMqttifyMessage&& InMessage)
+	{
+		TWeakPtr<FMqttifyClientContext> ThisWeakPtr = AsWeak();
+		DispatchWithThreadHandling(
+			[ThisWeakPtr, Message = MoveTemp(InMessage)]() mutable {
+				if (const TSharedPtr<FMqttifyClientContext> ThisSharedPtr = ThisWeakPtr.Pin())
+				{
+					const FMqttifyTopicHandle TopicHandle = Message.GetTopicHandle().IsValid()
+						? Message.GetTopicHandle()
+						: FMqttifyTopicTable::Get().Find(Message.GetTopic());
+					TSharedPtr<FOnMessage> ExactToCall;
+					TArray<TPair<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> WildcardSnapshot;
+					{
+						FScopeLock Lock(&ThisSharedPtr->OnMessageDelegatesCriticalSection);
+						const TSharedRef<FOnMessage>* Exact = TopicHandle.IsValid()
+							? ThisSharedPtr->ExactDelegates.Find(TopicHandle)
+							: nullptr;
+						if (Exact == nullptr && ThisSharedPtr->UninternedExactDelegates.Num() > 0)
+						{
+							Exact = ThisSharedPtr->UninternedExactDelegates.Find(Message.GetTopic());
+						}
+						if (Exact != nullptr)
+						{
+							ExactToCall = *Exact;
+						}
+						WildcardSnapshot = ThisSharedPtr->WildcardDelegates;
+					}
+
+					ThisSharedPtr->OnMessage().Broadcast(Message);
+					LOG_MQTTIFY(VeryVerbose, TEXT("OnMessage %s"), *Message.GetTopic());
+
+					if (ExactToCall.IsValid())
+					{
+						ExactToCall->Broadcast(Message);
+					}
+
+					for (const auto& Entry : WildcardSnapshot)
+					{
+						const FMqttifyTopicFilter& Filter = Entry.Key;
+						if (Filter.MatchesWildcard(Message.GetTopic()))
+						{
+							Entry.Value->Broadcast(Message);
+						}
+					}
+				}
+			});
+	}
+
+	void FMqttifyClientContext::Acknowledge(const IMqttifyControlPacket& InPacket)
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+
+		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledging %s"), EnumToTCharString(InPacket.GetPacketType()));
+
+		// The reason for the bit shift is we are using the first 16 bits for our packet identifier
+		// and the last 16 bits for the identifiers generated by the broker.
+		const uint32 InPacketIdentifier = InPacket.GetPacketType() != EMqttifyPacketType::PubRel
+			? InPacket.GetPacketId()
+			: static_cast<uint32>(InPacket.GetPacketId()) << 16;;
+
+		if (!InPacketIdentifier)
+		{
+			return;
+		}
+
+		if (SessionStore.IsValid() && InPacket.GetPacketType() == EMqttifyPacketType::PubRec)
+		{
+			SessionStore->Release(InPacket.GetPacketId());
+		}
+
+		if (AcknowledgeableCommands.Acknowledge(InPacketIdentifier, InPacket))
+		{
+			LOG_MQTTIFY(
+				VeryVerbose,
+				TEXT("Removed packet identifier %d, Type %s"),
+				InPacketIdentifier,
+				EnumToTCharString(InPacket.GetPacketType()));
+			OnCommandRemovedLocked(InPacketIdentifier);
+		}
+	}
+
+	void FMqttifyClientContext::ClearMessageDelegates()
+	{
+		FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+		for (const auto& Pair : OnMessageDelegates)
+		{
+			Pair.Value->Clear();
+		}
+		OnMessageDelegates.Empty();
+		ExactDelegates.Empty();
+		UninternedExactDelegates.Empty();
+		WildcardDelegates.Empty();
+		ActiveSubscriptions.Empty();
+		SubscriberCounts.Empty();
+		PendingSubscribes.Empty();
+	}
+
+	void FMqttifyClientContext::AddActiveSubscriptions(const TArray<FMqttifySubscribeResult>& InSubscribeResults)
+	{
+		FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+		for (const FMqttifySubscribeResult& Result : InSubscribeResults)
+		{
+			FMqttifyTopicFilter Filter = Result.GetFilter();
+			if (Result.WasSuccessful())
+			{
+				ActiveSubscriptions.Add(Filter.GetFilter(), MoveTemp(Filter));
+			}
+			else if (ActiveSubscriptions.Remove(Filter.GetFilter()) > 0)
+			{
+				// Refused when resubscribing on a new session, the broker no longer has it
+				LOG_MQTTIFY(Warning, TEXT("Subscription to %s was refused, it is no longer active"), *Filter.GetFilter());
+			}
+		}
+	}
+
+	int32 FMqttifyClientContext::GetNumActiveSubscriptions() const
+	{
+		FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+		return ActiveSubscriptions.Num();
+	}
+
+	int32 FMqttifyClientContext::Resubscribe(const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
+		{
+			FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+			TopicFilters.Reserve(ActiveSubscriptions.Num());
+			for (const TPair<FString, FMqttifyTopicFilter>& Subscription : ActiveSubscriptions)
+			{
+				if (const TSharedRef<FOnMessage>* Delegate = OnMessageDelegates.Find(Subscription.Key))
+				{
+					TopicFilters.Emplace(Subscription.Value, *Delegate);
+				}
+			}
+		}
+
+		if (TopicFilters.Num() == 0)
+		{
+			return 0;
+		}
+
+		const int32 NumTopicFilters = TopicFilters.Num();
+		TArray<FMqttifySubscribeRequest> Requests;
+		Requests.Add(FMqttifySubscribeRequest{
+			MoveTemp(TopicFilters),
+			MakeShared<TPromise<TMqttifyResult<TArray<FMqttifySubscribeResult>>>>()});
+		const int32 NumPackets = SendSubscriptionRequests(MoveTemp(Requests), InSocket);
+		LOG_MQTTIFY(
+			Log,
+			TEXT("Session not present, resubscribing to %d topic filters in %d packets"),
+			NumTopicFilters,
+			NumPackets);
+		return NumPackets;
+	}
+
+	TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> FMqttifyClientContext::AddSubscribeRequest(
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>&& InTopicFilters)
+	{
+		TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> Future;
+		const TSharedRef<TSubscriptionCall<FMqttifySubscribeResult>> Call = MakeSubscribeCall(InTopicFilters, Future);
+
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> ToSend;
+		TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>> Pending;
+		AddSubscribers(InTopicFilters, Call, ToSend, Pending);
+		if (ToSend.Num() == 0)
+		{
+			return Future;
+		}
+
+		FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+		SubscriptionRequests.Emplace(
+			TInPlaceType<FMqttifySubscribeRequest>(),
+			FMqttifySubscribeRequest{MoveTemp(ToSend), MakeSubscribePromise(MoveTemp(Pending))});
+		return Future;
+	}
+
+	TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> FMqttifyClientContext::AddBulkSubscribeRequest(
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>&& InTopicFilters,
+		const FOnBulkSubscribeProgress& InOnProgress)
+	{
+		TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> Future;
+		const TSharedRef<TSubscriptionCall<FMqttifySubscribeResult>> Call = MakeSubscribeCall(InTopicFilters, Future);
+
+		const TSharedRef<FMqttifyBulkSubscribe> Bulk = MakeShared<FMqttifyBulkSubscribe>();
+		AddSubscribers(InTopicFilters, Call, Bulk->TopicFilters, Bulk->Pending);
+		if (Bulk->TopicFilters.Num() == 0)
+		{
+			return Future;
+		}
+
+		const int32 NumTopicFilters = Bulk->TopicFilters.Num();
+		Bulk->OnPacketAcknowledged = [InOnProgress, NumTopicFilters, StartSeconds = FPlatformTime::Seconds()](
+			const int32 InNumAcknowledged)
+			{
+				const FMqttifyBulkSubscribeProgress Progress{
+					NumTopicFilters,
+					InNumAcknowledged,
+					FPlatformTime::Seconds() - StartSeconds};
+				if (Progress.GetNumCompleted() == Progress.GetNumTopicFilters())
+				{
+					LOG_MQTTIFY(
+						Log,
+						TEXT("Bulk subscribe of %d topic filters took %.2f s, %.0f topic filters per second"),
+						Progress.GetNumTopicFilters(),
+						Progress.GetElapsedSeconds(),
+						Progress.GetTopicFiltersPerSecond());
+				}
+				InOnProgress.ExecuteIfBound(Progress);
+			};
+
+		FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+		BulkSubscribes.Add(Bulk);
+		return Future;
+	}
+
+	int32 FMqttifyClientContext::SendBulkSubscribes(const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		using FPacket = TMqttifySubscribePacket<GMqttifyProtocol>;
+
+		struct FBatch
+		{
+			TSharedRef<FMqttifyBulkSubscribe> Bulk;
+			int32 First;
+			int32 Num;
+		};
+
+		const uint32 MaximumPacketSize = GetServerMaximumPacketSize();
+		const int32 MaxOutstanding = static_cast<int32>(GetConnectionSettings()->GetMaxOutstandingSubscribes());
+		const int32 MaxTopicFilters = static_cast<int32>(GetConnectionSettings()->GetMaxTopicFiltersPerSubscribe());
+		TArray<FBatch> Batches;
+		{
+			FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+			BulkSubscribes.RemoveAll([](const TSharedRef<FMqttifyBulkSubscribe>& InBulk)
+			{
+				return InBulk->NumSent == InBulk->TopicFilters.Num();
+			});
+
+			for (const TSharedRef<FMqttifyBulkSubscribe>& Bulk : BulkSubscribes)
+			{
+				while (Bulk->NumOutstanding < MaxOutstanding && Bulk->NumSent < Bulk->TopicFilters.Num())
+				{
+					// Fill a packet up to the broker's limit and the topic filter budget, a topic filter too large for
+					// a packet goes alone and fails
+					const int32 First = Bulk->NumSent;
+					uint32 PacketLength = 0;
+					while (Bulk->NumSent < Bulk->TopicFilters.Num())
+					{
+						const FMqttifyTopicFilter& TopicFilter = Bulk->TopicFilters[Bulk->NumSent].Get<0>();
+						const uint32 Length = FPacket::GetTopicFilterLength(TopicFilter);
+						const bool bIsFull = Bulk->NumSent - First == MaxTopicFilters
+							|| (MaximumPacketSize > 0
+								&& FPacket::GetPacketSize(PacketLength + Length) > MaximumPacketSize);
+						if (Bulk->NumSent > First && bIsFull)
+						{
+							break;
+						}
+						PacketLength += Length;
+						++Bulk->NumSent;
+					}
+					++Bulk->NumOutstanding;
+					Batches.Add(FBatch{Bulk, First, Bulk->NumSent - First});
+				}
+			}
+		}
+
+		int32 NumPackets = 0;
+		for (FBatch& Batch : Batches)
+		{
+			TArray<FMqttifySubscribeRequest> Requests;
+			Requests.Add(FMqttifySubscribeRequest{
+				TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>(
+					Batch.Bulk->TopicFilters.GetData() + Batch.First,
+					Batch.Num),
+				MakeSubscribePromise(
+					TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>>(
+						Batch.Bulk->Pending.GetData() + Batch.First,
+						Batch.Num),
+					[WeakThis = AsWeak(), Bulk = Batch.Bulk, Num = Batch.Num](
+					const TMqttifyResult<TArray<FMqttifySubscribeResult>>& InResult)
+					{
+						int32 NumAcknowledged = INDEX_NONE;
+						if (const TSharedPtr<FMqttifyClientContext> This = WeakThis.Pin())
+						{
+							FScopeLock Lock(&This->SubscriptionRequestsCriticalSection);
+							--Bulk->NumOutstanding;
+							if (InResult.HasSucceeded())
+							{
+								NumAcknowledged = Bulk->NumAcknowledged += Num;
+							}
+						}
+
+						// A packet that failed or was abandoned made no progress
+						if (NumAcknowledged != INDEX_NONE)
+						{
+							Bulk->OnPacketAcknowledged(NumAcknowledged);
+						}
+					})});
+			NumPackets += SendSubscriptionRequests(MoveTemp(Requests), InSocket);
+		}
+		return NumPackets;
+	}
+
+	int32 FMqttifyClientContext::GetNumBulkSubscribes() const
+	{
+		FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+		return BulkSubscribes.FilterByPredicate([](const TSharedRef<FMqttifyBulkSubscribe>& InBulk)
+		{
+			return InBulk->NumSent < InBulk->TopicFilters.Num();
+		}).Num();
+	}
+
+	template <typename TCall>
+	void FMqttifyClientContext::AddSubscribers(
+		const TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>& InTopicFilters,
+		const TSharedRef<TCall>& InCall,
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>& OutToSend,
+		TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>>& OutPending)
+	{
+		// Only the first subscriber of a topic filter goes to the broker, the others share its SUBACK unless they
+		// need more of the subscription than was sent
+		TArray<FMqttifySubscribeResult> Granted;
+		TArray<int32> GrantedIndices;
+		{
+			FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+			for (int32 Index = 0; Index < InTopicFilters.Num(); ++Index)
+			{
+				const FMqttifyTopicFilter& TopicFilter = InTopicFilters[Index].Get<0>();
+				const TSharedRef<FOnMessage>& Delegate = InTopicFilters[Index].Get<1>();
+				const FString& Key = TopicFilter.GetFilter();
+				TFunction<void(bool, bool)> Waiter = [InCall, Index, TopicFilter, Delegate](
+					const bool bInWasAcknowledged,
+					const bool bInWasGranted)
+				{
+					const FMqttifySubscribeResult Result{
+						TopicFilter,
+						bInWasGranted,
+						bInWasGranted ? Delegate.ToSharedPtr() : nullptr};
+					InCall->SetResult(Index, bInWasAcknowledged ? &Result : nullptr);
+				};
+
+				int32& NumSubscribers = SubscriberCounts.FindOrAdd(Key);
+				const TSharedRef<FMqttifyPendingSubscribe>* Pending = PendingSubscribes.Find(Key);
+				const FMqttifyTopicFilter* Subscribed = nullptr;
+				if (NumSubscribers > 0)
+				{
+					Subscribed = Pending != nullptr ? &(*Pending)->TopicFilter : ActiveSubscriptions.Find(Key);
+				}
+				const FMqttifyTopicFilter Merged = Subscribed != nullptr
+					? MergeTopicFilters(*Subscribed, TopicFilter)
+					: TopicFilter;
+				if (Subscribed == nullptr || Merged != *Subscribed)
+				{
+					const TSharedRef<FMqttifyPendingSubscribe> Next = MakeShared<FMqttifyPendingSubscribe>();
+					Next->TopicFilter = Merged;
+					if (Pending != nullptr)
 					{
-						Promise->SetValue(TMqttifyResult<void>{true});
+						// The later SUBSCRIBE replaces the subscription on the broker, its SUBACK answers everyone
+						Next->Waiters = MoveTemp((*Pending)->Waiters);
 					}
+					Next->Waiters.Add(MoveTemp(Waiter));
+					PendingSubscribes.Add(Key, Next);
+					OutPending.Emplace(Key, Next);
+					OutToSend.Emplace(Merged, Delegate);
 				}
-			});
+				else if (Pending != nullptr)
+				{
+					(*Pending)->Waiters.Add(MoveTemp(Waiter));
+				}
+				else
+				{
+					Granted.Emplace(TopicFilter, true, Delegate);
+					GrantedIndices.Add(Index);
+				}
+				++NumSubscribers;
+			}
+		}
+
+		for (int32 Index = 0; Index < Granted.Num(); ++Index)
+		{
+			InCall->SetResult(GrantedIndices[Index], &Granted[Index]);
+		}
 	}
 
-	void FMqttifyClientContext::CompleteConnect()
+	TSharedRef<TPromise<TMqttifyResult<TArray<FMqttifySubscribeResult>>>> FMqttifyClientContext::MakeSubscribePromise(
+		TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>>&& InPending,
+		TFunction<void(const TMqttifyResult<TArray<FMqttifySubscribeResult>>&)>&& InOnAcknowledged)
 	{
-		TWeakPtr<FMqttifyClientContext> ThisWeakPtr = AsWeak();
-		DispatchWithThreadHandling(
-			[ThisWeakPtr] {
-				if (const TSharedPtr<FMqttifyClientContext> ThisSharedPtr = ThisWeakPtr.Pin())
+		const TSharedRef<TPromise<TMqttifyResult<TArray<FMqttifySubscribeResult>>>> Promise = MakeShared<TPromise<
+			TMqttifyResult<TArray<FMqttifySubscribeResult>>>>();
+		Promise->GetFuture().Next(
+			[WeakThis = AsWeak(), Pending = MoveTemp(InPending), OnAcknowledged = MoveTemp(InOnAcknowledged)](
+			const TMqttifyResult<TArray<FMqttifySubscribeResult>>& InResult)
+			{
+				if (OnAcknowledged)
 				{
-					TArray<TSharedPtr<TPromise<TMqttifyResult<void>>>> Snapshot;
+					OnAcknowledged(InResult);
+				}
+
+				// A refused topic filter is acknowledged but not granted, a failed SUBSCRIBE fails its callers
+				const TSharedPtr<FMqttifyClientContext> This = WeakThis.Pin();
+				const TArray<FMqttifySubscribeResult>* Results = InResult.HasSucceeded()
+					? InResult.GetResult().Get()
+					: nullptr;
+				for (int32 Index = 0; Index < Pending.Num(); ++Index)
+				{
+					const bool bWasAcknowledged = Results != nullptr && Results->IsValidIndex(Index);
+					const bool bWasGranted = bWasAcknowledged && (*Results)[Index].WasSuccessful();
+					if (This.IsValid())
 					{
-						FScopeLock Lock(&ThisSharedPtr->OnConnectPromisesCriticalSection);
-						Snapshot = ThisSharedPtr->OnConnectPromises;
-						ThisSharedPtr->OnConnectPromises.Empty();
-						ThisSharedPtr->OnConnectPromises.Reserve(kPromiseInitialReserve);
+						This->CompletePendingSubscribe(
+							Pending[Index].Key,
+							Pending[Index].Value,
+							bWasAcknowledged,
+							bWasGranted);
 					}
-
-					ThisSharedPtr->OnConnect().Broadcast(true);
-					for (const auto& Promise : Snapshot)
+					else
 					{
-						Promise->SetValue(TMqttifyResult<void>{true});
+						for (const TFunction<void(bool, bool)>& Waiter : Pending[Index].Value->Waiters)
+						{
+							Waiter(false, false);
+						}
 					}
 				}
 			});
+		return Promise;
 	}
 
-	void FMqttifyClientContext::CompleteMessage(FMqttifyMessage&& InMessage)
+	TFuture<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>> FMqttifyClientContext::AddUnsubscribeRequest(
+		TArray<FMqttifyTopicFilter>&& InTopicFilters)
 	{
-		TWeakPtr<FMqttifyClientContext> ThisWeakPtr = AsWeak();
-		DispatchWithThreadHandling(
-			[ThisWeakPtr, Message = MoveTemp(InMessage)]() mutable {
-				if (const TSharedPtr<FMqttifyClientContext> ThisSharedPtr = ThisWeakPtr.Pin())
+		using FCall = TSubscriptionCall<FMqttifyUnsubscribeResult>;
+		const TSharedRef<FCall::FPromise> Promise = MakeShared<FCall::FPromise>();
+		TFuture<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>> Future = Promise->GetFuture();
+		const TSharedRef<FCall> Call = MakeShared<FCall>(Promise, InTopicFilters);
+
+		// Only the last subscriber of a topic filter goes to the broker, the others just let go of it
+		TArray<FMqttifyTopicFilter> ToSend;
+		TArray<int32> SentIndices;
+		TArray<int32> ReleasedIndices;
+		{
+			FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+			for (int32 Index = 0; Index < InTopicFilters.Num(); ++Index)
+			{
+				const FString& Key = InTopicFilters[Index].GetFilter();
+				if (int32* NumSubscribers = SubscriberCounts.Find(Key); NumSubscribers && *NumSubscribers > 1)
 				{
-					const FString Topic = Message.GetTopic();
-					TSharedPtr<FOnMessage> ExactToCall;
-					TArray<TPair<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> WildcardSnapshot;
-					{
-						FScopeLock Lock(&ThisSharedPtr->OnMessageDelegatesCriticalSection);
-						if (const TSharedRef<FOnMessage>* Exact = ThisSharedPtr->ExactDelegates.Find(Topic))
-						{
-							ExactToCall = *Exact;
-						}
-						WildcardSnapshot = ThisSharedPtr->WildcardDelegates;
-					}
+					--*NumSubscribers;
+					ReleasedIndices.Add(Index);
+					continue;
+				}
 
-					ThisSharedPtr->OnMessage().Broadcast(Message);
-					LOG_MQTTIFY(VeryVerbose, TEXT("OnMessage %s"), *Topic);
+				// A SUBSCRIBE still on its way completes its callers, but no longer counts towards the filter
+				SubscriberCounts.Remove(Key);
+				PendingSubscribes.Remove(Key);
+				ToSend.Add(InTopicFilters[Index]);
+				SentIndices.Add(Index);
+			}
+		}
 
-					if (ExactToCall.IsValid())
-					{
-						ExactToCall->Broadcast(Message);
-					}
+		for (const int32 Index : ReleasedIndices)
+		{
+			const FMqttifyUnsubscribeResult Result{InTopicFilters[Index], true};
+			Call->SetResult(Index, &Result);
+		}
 
-					for (const auto& Entry : WildcardSnapshot)
-					{
-						const FMqttifyTopicFilter& Filter = Entry.Key;
-						if (Filter.MatchesWildcard(Topic))
-						{
-							Entry.Value->Broadcast(Message);
-						}
-					}
+		if (ToSend.Num() == 0)
+		{
+			return Future;
+		}
+
+		const TSharedRef<FCall::FPromise> SendPromise = MakeShared<FCall::FPromise>();
+		SendPromise->GetFuture().Next(
+			[Call, SentIndices = MoveTemp(SentIndices)](
+			const TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>& InResult)
+			{
+				const TArray<FMqttifyUnsubscribeResult>* Results = InResult.HasSucceeded()
+					? InResult.GetResult().Get()
+					: nullptr;
+				for (int32 Index = 0; Index < SentIndices.Num(); ++Index)
+				{
+					const bool bHasResult = Results != nullptr && Results->IsValidIndex(Index);
+					Call->SetResult(SentIndices[Index], bHasResult ? &(*Results)[Index] : nullptr);
 				}
 			});
+
+		FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+		SubscriptionRequests.Emplace(
+			TInPlaceType<FMqttifyUnsubscribeRequest>(),
+			FMqttifyUnsubscribeRequest{MoveTemp(ToSend), SendPromise});
+		return Future;
 	}
 
-	void FMqttifyClientContext::Acknowledge(const FMqttifyPacketPtr& InPacket)
+	int32 FMqttifyClientContext::GetNumSubscribers(const FString& InTopicFilter) const
 	{
-		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+		const int32* NumSubscribers = SubscriberCounts.Find(InTopicFilter);
+		return NumSubscribers ? *NumSubscribers : 0;
+	}
 
-		if (!InPacket.IsValid())
+	void FMqttifyClientContext::CompletePendingSubscribe(const FString& InTopicFilter,
+														const TSharedRef<FMqttifyPendingSubscribe>& InPending,
+														const bool bInWasAcknowledged,
+														const bool bInWasGranted)
+	{
+		TArray<TFunction<void(bool, bool)>> Waiters;
 		{
-			LOG_MQTTIFY(Error, TEXT("Invalid packet pointer"));
-			return;
+			FScopeLock Lock(&OnMessageDelegatesCriticalSection);
+			Waiters = MoveTemp(InPending->Waiters);
+
+			// Once the last subscriber let go, the filter's count belongs to whoever subscribes to it next
+			const TSharedRef<FMqttifyPendingSubscribe>* Current = PendingSubscribes.Find(InTopicFilter);
+			if (Current != nullptr && *Current == InPending)
+			{
+				PendingSubscribes.Remove(InTopicFilter);
+				int32* NumSubscribers = SubscriberCounts.Find(InTopicFilter);
+				if (!bInWasGranted && NumSubscribers != nullptr && (*NumSubscribers -= Waiters.Num()) <= 0)
+				{
+					SubscriberCounts.Remove(InTopicFilter);
+				}
+			}
 		}
 
-		LOG_MQTTIFY(VeryVerbose, TEXT("Acknowledging %s"), EnumToTCharString(InPacket->GetPacketType()));
+		for (const TFunction<void(bool, bool)>& Waiter : Waiters)
+		{
+			Waiter(bInWasAcknowledged, bInWasGranted);
+		}
+	}
 
-		// The reason for the bit shift is we are using the first 16 bits for our packet identifier
-		// and the last 16 bits for the identifiers generated by the broker.
-		const uint32 InPacketIdentifier = InPacket->GetPacketType() != EMqttifyPacketType::PubRel
-			? InPacket->GetPacketId()
-			: static_cast<uint32>(InPacket->GetPacketId()) << 16;;
+	int32 FMqttifyClientContext::GetNumSubscriptionRequests() const
+	{
+		FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+		return SubscriptionRequests.Num();
+	}
 
-		if (!InPacketIdentifier)
+	int32 FMqttifyClientContext::FlushSubscriptionRequests(const TWeakPtr<FMqttifySocketBase>& InSocket)
+	{
+		TArray<FSubscriptionRequest> Requests;
 		{
-			return;
+			FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+			if (SubscriptionRequests.Num() == 0)
+			{
+				return 0;
+			}
+			Requests = MoveTemp(SubscriptionRequests);
 		}
 
-		if (const TSharedRef<FMqttifyQueueable>* Command = AcknowledgeableCommands.Find(InPacketIdentifier))
+		// Merge each run of calls of the same kind, an unsubscribe between two subscribes keeps its place
+		int32 NumPackets = 0;
+		TArray<FMqttifySubscribeRequest> Subscribes;
+		TArray<FMqttifyUnsubscribeRequest> Unsubscribes;
+		for (FSubscriptionRequest& Request : Requests)
 		{
-			if (IMqttifyAcknowledgeable* Acknowledgeable = (*Command)->AsAcknowledgeable())
+			if (Request.IsType<FMqttifySubscribeRequest>())
 			{
-				if (Acknowledgeable->Acknowledge(InPacket))
+				if (Unsubscribes.Num() > 0)
 				{
-					LOG_MQTTIFY(
-						VeryVerbose,
-						TEXT("Removing packet identifier %d, Type %s"),
-						InPacketIdentifier,
-						EnumToTCharString(InPacket->GetPacketType()));
-					AcknowledgeableCommands.Remove(InPacketIdentifier);
-					if (InPacketIdentifier <= kMaxCount)
-					{
-						ReleaseId(InPacket->GetPacketId());
-					}
+					NumPackets += SendSubscriptionRequests(MoveTemp(Unsubscribes), InSocket);
+					Unsubscribes.Reset();
+				}
+				Subscribes.Add(MoveTemp(Request.Get<FMqttifySubscribeRequest>()));
+			}
+			else
+			{
+				if (Subscribes.Num() > 0)
+				{
+					NumPackets += SendSubscriptionRequests(MoveTemp(Subscribes), InSocket);
+					Subscribes.Reset();
 				}
+				Unsubscribes.Add(MoveTemp(Request.Get<FMqttifyUnsubscribeRequest>()));
 			}
 		}
+
+		if (Subscribes.Num() > 0)
+		{
+			NumPackets += SendSubscriptionRequests(MoveTemp(Subscribes), InSocket);
+		}
+		if (Unsubscribes.Num() > 0)
+		{
+			NumPackets += SendSubscriptionRequests(MoveTemp(Unsubscribes), InSocket);
+		}
+
+		LOG_MQTTIFY(
+			VeryVerbose,
+			TEXT("Sending %d subscribe and unsubscribe calls in %d packets"),
+			Requests.Num(),
+			NumPackets);
+		return NumPackets;
 	}
 
-	void FMqttifyClientContext::ClearMessageDelegates()
+	template <typename TRequest>
+	int32 FMqttifyClientContext::SendSubscriptionRequests(TArray<TRequest>&& InRequests,
+														const TWeakPtr<FMqttifySocketBase>& InSocket)
 	{
-		FScopeLock Lock(&OnMessageDelegatesCriticalSection);
-		for (const auto& Pair : OnMessageDelegates)
+		using FTraits = TSubscriptionRequestTraits<TRequest>;
+		using FResult = typename FTraits::FResult;
+		using FEntry = typename decltype(TRequest::TopicFilters)::ElementType;
+
+		// Lay the topic filters of all calls end to end, a packet may carry several calls and a call may span packets
+		TArray<TSharedRef<TSubscriptionCall<FResult>>> Calls;
+		TArray<TPair<int32, int32>> Slots;
+		TArray<uint32> Lengths;
+		Calls.Reserve(InRequests.Num());
+		for (const TRequest& Request : InRequests)
 		{
-			Pair.Value->Clear();
+			TArray<FMqttifyTopicFilter> TopicFilters;
+			TopicFilters.Reserve(Request.TopicFilters.Num());
+			for (const FEntry& Entry : Request.TopicFilters)
+			{
+				TopicFilters.Add(GetTopicFilter(Entry));
+				Slots.Emplace(Calls.Num(), TopicFilters.Num() - 1);
+				Lengths.Add(FTraits::FPacket::GetTopicFilterLength(TopicFilters.Last()));
+			}
+			Calls.Add(MakeShared<TSubscriptionCall<FResult>>(Request.Promise.ToSharedRef(), TopicFilters));
 		}
-		OnMessageDelegates.Empty();
-		ExactDelegates.Empty();
-		WildcardDelegates.Empty();
+
+		TArray<int32> PacketOfSlot;
+		const uint32 MaximumPacketSize = GetServerMaximumPacketSize();
+		const int32 NumPackets = AssignPackets<typename FTraits::FPacket>(Lengths, MaximumPacketSize, PacketOfSlot);
+
+		TArray<TArray<FEntry>> PacketEntries;
+		TArray<TArray<TPair<TSharedRef<TSubscriptionCall<FResult>>, int32>>> PacketTargets;
+		PacketEntries.SetNum(NumPackets);
+		PacketTargets.SetNum(NumPackets);
+		for (int32 Slot = 0; Slot < Slots.Num(); ++Slot)
+		{
+			const TSharedRef<TSubscriptionCall<FResult>>& Call = Calls[Slots[Slot].Key];
+			const int32 Index = Slots[Slot].Value;
+			FEntry& Entry = InRequests[Slots[Slot].Key].TopicFilters[Index];
+			if (PacketOfSlot[Slot] == INDEX_NONE)
+			{
+				LOG_MQTTIFY(
+					Warning,
+					TEXT("Not sending %s, it does not fit the broker's Maximum Packet Size of %u"),
+					*GetTopicFilter(Entry).GetFilter(),
+					MaximumPacketSize);
+				Call->SetResult(Index, nullptr);
+				continue;
+			}
+
+			PacketEntries[PacketOfSlot[Slot]].Add(MoveTemp(Entry));
+			PacketTargets[PacketOfSlot[Slot]].Emplace(Call, Index);
+		}
+
+		for (int32 Packet = 0; Packet < NumPackets; ++Packet)
+		{
+			const TSharedRef<typename FTraits::FCommand> Command = MakeShared<typename FTraits::FCommand>(
+				PacketEntries[Packet],
+				GetNextId(),
+				InSocket,
+				GetConnectionSettings());
+			Command->GetFuture().Next(
+				[WeakThis = AsWeak(), Targets = MoveTemp(PacketTargets[Packet])](
+				const TMqttifyResult<TArray<FResult>>& InResult)
+				{
+					const TArray<FResult>* Results = InResult.HasSucceeded() ? InResult.GetResult().Get() : nullptr;
+					if (Results != nullptr && Results->Num() != Targets.Num())
+					{
+						Results = nullptr;
+					}
+
+					if (const TSharedPtr<FMqttifyClientContext> This = WeakThis.Pin(); This.IsValid() && Results)
+					{
+						FTraits::OnAcknowledged(*This, InResult);
+					}
+
+					for (int32 Index = 0; Index < Targets.Num(); ++Index)
+					{
+						Targets[Index].Key->SetResult(Targets[Index].Value, Results ? &(*Results)[Index] : nullptr);
+					}
+				});
+			AddAcknowledgeableCommand(Command);
+		}
+
+		return NumPackets;
 	}
 
 	void FMqttifyClientContext::ClearDisconnectPromises()
@@ -359,10 +1671,239 @@ namespace Mqttify
 
 	void FMqttifyClientContext::AbandonCommands()
 	{
+		TArray<FSubscriptionRequest> Requests;
+		TArray<TSharedRef<FMqttifyBulkSubscribe>> Bulks;
+		{
+			FScopeLock Lock(&SubscriptionRequestsCriticalSection);
+			Requests = MoveTemp(SubscriptionRequests);
+			Bulks = MoveTemp(BulkSubscribes);
+		}
+		for (const TSharedRef<FMqttifyBulkSubscribe>& Bulk : Bulks)
+		{
+			for (int32 Index = Bulk->NumSent; Index < Bulk->Pending.Num(); ++Index)
+			{
+				CompletePendingSubscribe(Bulk->Pending[Index].Key, Bulk->Pending[Index].Value, false, false);
+			}
+		}
+		for (const FSubscriptionRequest& Request : Requests)
+		{
+			if (const FMqttifySubscribeRequest* Subscribe = Request.TryGet<FMqttifySubscribeRequest>())
+			{
+				Subscribe->Promise->SetValue(TMqttifyResult<TArray<FMqttifySubscribeResult>>{false});
+			}
+			else
+			{
+				Request.Get<FMqttifyUnsubscribeRequest>().Promise->SetValue(
+					TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>{false});
+			}
+		}
+
 		OneShotCommands.Empty();
+		TArray<TPair<uint32, TSharedRef<FMqttifyQueueable>>> InFlight;
+		TArray<TSharedPtr<FMqttifyQueueable>> Pending;
+		{
+			FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+			AcknowledgeableCommands.RemoveIf([](uint32, const FMqttifyQueueable&) { return true; }, InFlight);
+			WindowPublishIds.Empty();
+			TSharedPtr<FMqttifyQueueable> Command;
+			while (PendingPublishes.Dequeue(Command))
+			{
+				Pending.Add(Command);
+			}
+			NumPendingPublishes = 0;
+
+			// The identifiers go back to the allocator, the session store keeps the publishes for the next start
+			for (const TPair<uint32, TSharedRef<FMqttifyQueueable>>& Entry : InFlight)
+			{
+				if (Entry.Key <= kMaxCount)
+				{
+					IdAllocator.Release(static_cast<uint16>(Entry.Key));
+				}
+			}
+			for (const TSharedPtr<FMqttifyQueueable>& Queued : Pending)
+			{
+				if (const IMqttifyAcknowledgeable* Acknowledgeable = Queued->AsAcknowledgeable())
+				{
+					IdAllocator.Release(static_cast<uint16>(Acknowledgeable->GetId()));
+				}
+			}
+		}
+		RetransmitCache->Empty();
+
+		for (const TSharedPtr<FMqttifyQueueable>& Command : Pending)
+		{
+			Command->Abandon();
+		}
+
+		TArray<FMqttifyOfflineBuffer::FEntry> Offline;
+		{
+			FScopeLock Lock(&OfflinePublishesCriticalSection);
+			OfflinePublishes.Drain(Offline);
+		}
+
+		// Unlike a failed publish, one cut short here stays in the session store and is sent on the next start
+		for (const FMqttifyOfflineBuffer::FEntry& Entry : Offline)
+		{
+			Entry.Command->Abandon();
+			if (const IMqttifyAcknowledgeable* Acknowledgeable = Entry.Command->AsAcknowledgeable())
+			{
+				IdAllocator.Release(static_cast<uint16>(Acknowledgeable->GetId()));
+			}
+		}
+	}
+
+	void FMqttifyClientContext::ResumeSession()
+	{
+		FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+		LOG_MQTTIFY(
+			Verbose,
+			TEXT("Session resumed, sending %d in-flight commands again"),
+			AcknowledgeableCommands.Num());
+		AcknowledgeableCommands.Rearm();
+	}
+
+	void FMqttifyClientContext::DiscardSession()
+	{
+		// Broker identifiers and packets it has seen mean nothing to a new session
+		const int32 NumAbandoned = AbandonCommandsIf(
+			[](const uint32 InKey, const FMqttifyQueueable& InCommand)
+			{
+				return InKey > kMaxCount || InCommand.HasBeenSent();
+			});
+		UE_CLOG(
+			NumAbandoned > 0,
+			LogMqttify,
+			Warning,
+			TEXT("Session lost, abandoned %d in-flight commands"),
+			NumAbandoned);
+	}
+
+	void FMqttifyClientContext::ExpireCommands(const double InNow)
+	{
+		const uint32 DeadlineSeconds = GetConnectionSettings()->GetPublishDeadlineSeconds();
+		if (DeadlineSeconds == 0)
+		{
+			return;
+		}
+
+		// Pending publishes first, abandoning in-flight ones makes room for the pending ones in the window
+		const double Cutoff = InNow - DeadlineSeconds;
+		TArray<TSharedPtr<FMqttifyQueueable>> Expired;
+		{
+			// The queue is oldest first
+			FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
+			const TSharedPtr<FMqttifyQueueable>* Oldest = PendingPublishes.Peek();
+			while (Oldest != nullptr && (*Oldest)->GetCreatedTime() < Cutoff)
+			{
+				Expired.Add(*Oldest);
+				PendingPublishes.Pop();
+				--NumPendingPublishes;
+				Oldest = PendingPublishes.Peek();
+			}
+		}
+
+		for (const TSharedPtr<FMqttifyQueueable>& Command : Expired)
+		{
+			Command->Abandon();
+			if (const IMqttifyAcknowledgeable* Acknowledgeable = Command->AsAcknowledgeable())
+			{
+				ReleaseId(static_cast<uint16>(Acknowledgeable->GetId()));
+			}
+		}
+
+		TArray<FMqttifyOfflineBuffer::FEntry> ExpiredOffline;
+		{
+			FScopeLock Lock(&OfflinePublishesCriticalSection);
+			OfflinePublishes.RemoveOlderThan(Cutoff, EMqttifyQualityOfService::AtLeastOnce, ExpiredOffline);
+		}
+		AbandonOfflinePublishes(ExpiredOffline);
+
+		// Only publishes have a deadline, a SUBSCRIBE or UNSUBSCRIBE in flight waits for its acknowledgement.
+		// The predicate runs under AcknowledgeableCommandsCriticalSection, which guards WindowPublishIds
+		const int32 NumExpired = Expired.Num() + ExpiredOffline.Num() + AbandonCommandsIf(
+			[this, Cutoff](const uint32 InKey, const FMqttifyQueueable& InCommand)
+			{
+				return InKey <= kMaxCount
+					&& WindowPublishIds.Contains(static_cast<uint16>(InKey))
+					&& InCommand.GetCreatedTime() < Cutoff;
+			});
+
+		UE_CLOG(
+			NumExpired > 0,
+			LogMqttify,
+			Warning,
+			TEXT("Connection down for longer than the publish deadline, abandoned %d commands"),
+			NumExpired);
+	}
+
+	int32 FMqttifyClientContext::AbandonCommandsIf(
+		const TFunctionRef<bool(uint32 InKey, const FMqttifyQueueable& InCommand)> InPredicate)
+	{
+		TArray<TPair<uint32, TSharedRef<FMqttifyQueueable>>> Removed;
 		{
 			FScopeLock Lock(&AcknowledgeableCommandsCriticalSection);
-			AcknowledgeableCommands.Empty();
+			AcknowledgeableCommands.RemoveIf(InPredicate, Removed);
+			for (const TPair<uint32, TSharedRef<FMqttifyQueueable>>& Entry : Removed)
+			{
+				OnCommandRemovedLocked(Entry.Key);
+			}
+		}
+
+		for (const TPair<uint32, TSharedRef<FMqttifyQueueable>>& Entry : Removed)
+		{
+			Entry.Value->Abandon();
+		}
+		return Removed.Num();
+	}
+
+	void FMqttifyClientContext::AbandonOfflinePublishes(const TArray<FMqttifyOfflineBuffer::FEntry>& InEntries)
+	{
+		for (const FMqttifyOfflineBuffer::FEntry& Entry : InEntries)
+		{
+			Entry.Command->Abandon();
+			if (const IMqttifyAcknowledgeable* Acknowledgeable = Entry.Command->AsAcknowledgeable())
+			{
+				ReleaseId(static_cast<uint16>(Acknowledgeable->GetId()));
+			}
+		}
+	}
+
+	void FMqttifyClientContext::OnCommandRemovedLocked(const uint32 InKey)
+	{
+		// Broker identifiers live in the high 16 bits and are not ours to release
+		if (InKey > kMaxCount)
+		{
+			return;
+		}
+
+		const uint16 PacketId = static_cast<uint16>(InKey);
+		ReleaseId(PacketId);
+		if (WindowPublishIds.Remove(PacketId) > 0)
+		{
+			FillWindowLocked();
+		}
+	}
+
+	void FMqttifyClientContext::AddToWindowLocked(const TSharedRef<FMqttifyQueueable>& InCommand)
+	{
+		if (const IMqttifyAcknowledgeable* Acknowledgeable = InCommand->AsAcknowledgeable())
+		{
+			const uint32 Key = Acknowledgeable->GetId();
+			if (Key != 0)
+			{
+				WindowPublishIds.Add(static_cast<uint16>(Key));
+			}
+			AcknowledgeableCommands.Add(Key, InCommand);
+		}
+	}
+
+	void FMqttifyClientContext::FillWindowLocked()
+	{
+		TSharedPtr<FMqttifyQueueable> Command;
+		while (WindowPublishIds.Num() < ServerReceiveMaximum && PendingPublishes.Dequeue(Command))
+		{
+			--NumPendingPublishes;
+			AddToWindowLocked(Command.ToSharedRef());
 		}
 	}
 } // namespace Mqttify
\ No newline at end of file
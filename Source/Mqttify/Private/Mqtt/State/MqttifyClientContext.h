@@ -2,16 +2,28 @@
 
 #include "Async/Future.h"
 #include "Containers/Queue.h"
+#include "Misc/TVariant.h"
 #include "Mqtt/MqttifyConnectionSettings.h"
+#include "Mqtt/MqttifyPacketIdAllocator.h"
 #include "Mqtt/MqttifyResult.h"
+#include "Mqtt/MqttifyTimerWheel.h"
+#include "Mqtt/MqttifyTopicHandle.h"
+#include "Mqtt/Delegates/OnBulkSubscribeProgress.h"
 #include "Mqtt/Delegates/OnConnect.h"
 #include "Mqtt/Delegates/OnDisconnect.h"
 #include "Mqtt/Delegates/OnMessage.h"
 #include "Mqtt/Delegates/OnPublish.h"
 #include "Mqtt/Delegates/OnSubscribe.h"
 #include "Mqtt/Delegates/OnUnsubscribe.h"
+#include "Mqtt/State/MqttifyInFlightTable.h"
+#include "Mqtt/State/MqttifyOfflineBuffer.h"
+#include "Mqtt/State/MqttifySessionStore.h"
+#include "Mqtt/State/MqttifyTopicAliases.h"
+#include "Packets/MqttifyPacketCache.h"
 #include "Packets/Interface/IMqttifyControlPacket.h"
 
+#include <atomic>
+
 struct FMqttifyUnsubscribeResult;
 enum class EMqttifyConnectReturnCode : uint8;
 struct FMqttifySubscribeResult;
@@ -22,10 +34,51 @@ namespace Mqttify
 {
 	class IMqttifyControlPacket;
 	class FMqttifyQueueable;
+	class FMqttifyPublishBatch;
+	class FMqttifySocketBase;
 
-	using FAcknowledgeableCommands = TMap<uint32, TSharedRef<FMqttifyQueueable>>;
 	using FOneShotCommands = TQueue<TSharedPtr<FMqttifyQueueable>, EQueueMode::Mpsc>;
 
+	/// @brief A subscribe call waiting to be sent with the other subscribe calls of the tick.
+	struct FMqttifySubscribeRequest
+	{
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
+		TSharedPtr<TPromise<TMqttifyResult<TArray<FMqttifySubscribeResult>>>> Promise;
+	};
+
+	/// @brief An unsubscribe call waiting to be sent with the other unsubscribe calls of the tick.
+	struct FMqttifyUnsubscribeRequest
+	{
+		TArray<FMqttifyTopicFilter> TopicFilters;
+		TSharedPtr<TPromise<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>>> Promise;
+	};
+
+	/// @brief Subscribe calls waiting on the SUBACK of a topic filter that is already on its way to the broker.
+	struct FMqttifyPendingSubscribe
+	{
+		/// @brief The topic filter and subscription options sent, serving every subscriber of the filter.
+		FMqttifyTopicFilter TopicFilter;
+		/// @brief Called with whether the broker answered the SUBSCRIBE and whether it granted the topic filter.
+		TArray<TFunction<void(bool bInWasAcknowledged, bool bInWasGranted)>> Waiters;
+	};
+
+	/// @brief A bulk subscribe call, sent a few SUBSCRIBE packets at a time as the earlier ones are acknowledged.
+	struct FMqttifyBulkSubscribe
+	{
+		/// @brief Topic filters no other call subscribed to, sent in order.
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
+		/// @brief Calls waiting on each topic filter of TopicFilters.
+		TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>> Pending;
+		/// @brief Number of topic filters sent so far.
+		int32 NumSent = 0;
+		/// @brief Packets sent and not acknowledged yet.
+		int32 NumOutstanding = 0;
+		/// @brief Topic filters whose SUBACK arrived.
+		int32 NumAcknowledged = 0;
+		/// @brief Called with NumAcknowledged as each SUBACK arrives, before the calls waiting on it complete.
+		TFunction<void(int32 InNumAcknowledged)> OnPacketAcknowledged;
+	};
+
 	/**
 	 * @brief Interface for MQTT client context.
 	 */
@@ -87,19 +140,42 @@ namespace Mqttify
 
 	private:
 		static constexpr uint32 kMaxCount = std::numeric_limits<uint16>::max();
-		TQueue<uint16> IdPool;
-		mutable FCriticalSection IdPoolCriticalSection{};
+		FMqttifyPacketIdAllocator IdAllocator;
 
 		FMqttifyConnectionSettingsRef ConnectionSettings;
 		mutable FCriticalSection ConnectionSettingsCriticalSection{};
 
+		/// @brief Timer wheel the retries of the commands are scheduled on.
+		TSharedRef<FMqttifyTimerWheel> TimerWheel;
+
 		/// @brief Delegates for when a message is received matching a subscription.
 		TMap<FString, TSharedRef<FOnMessage>> OnMessageDelegates{};
 		mutable FCriticalSection OnMessageDelegatesCriticalSection{};
 
-		/// @brief Exact-topic cache for standard filters
-		TMap<FString, TSharedRef<FOnMessage>> ExactDelegates{};
+		/// @brief Exact-topic cache for standard filters, keyed on the interned topic
+		TMap<FMqttifyTopicHandle, TSharedRef<FOnMessage>> ExactDelegates{};
+
+		/// @brief Standard filters that could not be interned because the topic table is full, keyed on the filter.
+		TMap<FString, TSharedRef<FOnMessage>> UninternedExactDelegates{};
 		
+		/// @brief Topic filters the broker granted, keyed on the filter. Guarded by OnMessageDelegatesCriticalSection.
+		TMap<FString, FMqttifyTopicFilter> ActiveSubscriptions{};
+
+		/// @brief Subscribe calls holding each topic filter. Guarded by OnMessageDelegatesCriticalSection.
+		TMap<FString, int32> SubscriberCounts{};
+
+		/// @brief Topic filters with a SUBSCRIBE not acknowledged yet. Guarded by OnMessageDelegatesCriticalSection.
+		TMap<FString, TSharedRef<FMqttifyPendingSubscribe>> PendingSubscribes{};
+
+		using FSubscriptionRequest = TVariant<FMqttifySubscribeRequest, FMqttifyUnsubscribeRequest>;
+
+		/// @brief Subscribe and unsubscribe calls not sent yet, in the order they were made.
+		TArray<FSubscriptionRequest> SubscriptionRequests;
+		mutable FCriticalSection SubscriptionRequestsCriticalSection{};
+
+		/// @brief Bulk subscribe calls still sending. Guarded by SubscriptionRequestsCriticalSection.
+		TArray<TSharedRef<FMqttifyBulkSubscribe>> BulkSubscribes;
+
 		/// @brief Cache for filters with wind cards
 		TArray<TPair<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> WildcardDelegates{};
 
@@ -117,21 +193,61 @@ namespace Mqttify
 		TArray<TSharedPtr<TPromise<TMqttifyResult<void>>>> OnConnectPromises;
 		mutable FCriticalSection OnConnectPromisesCriticalSection{};
 
-		/// @brief Acknowledgeable commands.
-		FAcknowledgeableCommands AcknowledgeableCommands;
+		/// @brief Acknowledgeable commands, indexed by packet identifier.
+		FMqttifyInFlightTable AcknowledgeableCommands;
 		mutable FCriticalSection AcknowledgeableCommandsCriticalSection{};
 
+		/// @brief Receive Maximum of the broker, the most QoS 1 and 2 publishes it takes unacknowledged at once.
+		uint16 ServerReceiveMaximum = kMaxCount;
+		/// @brief Packet identifiers of the QoS 1 and 2 publishes in flight. Guarded by AcknowledgeableCommandsCriticalSection.
+		TSet<uint16> WindowPublishIds;
+		/// @brief Publishes waiting for room in the window, oldest first. Guarded by AcknowledgeableCommandsCriticalSection.
+		TQueue<TSharedPtr<FMqttifyQueueable>> PendingPublishes;
+		int32 NumPendingPublishes = 0;
+
+		/// @brief Publishes made while the client has no session, sent once the broker accepts a connection.
+		FMqttifyOfflineBuffer OfflinePublishes;
+		mutable FCriticalSection OfflinePublishesCriticalSection{};
+		/// @brief True from the flush of the offline publishes until the client leaves the connected state.
+		/// Guarded by OfflinePublishesCriticalSection.
+		bool bIsOnline = false;
+
+		/// @brief Log of the unacknowledged QoS 1 and 2 publishes, null unless the settings name a directory for it.
+		TSharedPtr<FMqttifySessionStore> SessionStore;
+		/// @brief Publishes read back from the session store when the context was created.
+		TArray<FMqttifySessionStore::FStoredPublish> RecoveredPublishes;
+
+		/// @brief Keep alive of the current connection, the broker's ServerKeepAlive when it sent one.
+		std::atomic<uint16> KeepAliveIntervalSeconds;
+		/// @brief Round trip time of the last answered PINGREQ, negative until the first PINGRESP.
+		std::atomic<double> PingRoundTripSeconds{-1.0};
+		/// @brief Maximum Packet Size of the broker from the CONNACK, 0 if it set no limit.
+		std::atomic<uint32> ServerMaximumPacketSize{0};
+
 		/// @brief Fire and forget commands.
 		FOneShotCommands OneShotCommands;
 
+		/// @brief Encoded in-flight publishes, shared by the publish commands for retransmission.
+		TSharedRef<FMqttifyPacketCache> RetransmitCache = MakeShared<FMqttifyPacketCache>();
+
+		/// @brief Topic aliases sent to the broker, reset for each connection.
+		TSharedRef<FMqttifyOutboundTopicAliases> OutboundTopicAliases = MakeShared<FMqttifyOutboundTopicAliases>();
+
+		/// @brief Topic aliases received from the broker, reset for each connection.
+		TSharedRef<FMqttifyInboundTopicAliases> InboundTopicAliases = MakeShared<FMqttifyInboundTopicAliases>();
+
 	public:
 		virtual ~FMqttifyClientContext() override;
 
 		/**
 		 * @brief Constructor for FMqttifyClientContext.
 		 * @param InConnectionSettings The connection settings.
+		 * @param InTimerWheel The timer wheel to schedule retries on. The caller owns it and must advance it, retries
+		 * and keep alive never fire otherwise.
 		 */
-		explicit FMqttifyClientContext(const FMqttifyConnectionSettingsRef& InConnectionSettings);
+		FMqttifyClientContext(
+			const FMqttifyConnectionSettingsRef& InConnectionSettings,
+			const TSharedRef<FMqttifyTimerWheel>& InTimerWheel);
 
 		FMqttifyClientContext(const FMqttifyClientContext&) = delete;
 		FMqttifyClientContext& operator=(const FMqttifyClientContext&) = delete;
@@ -142,24 +258,189 @@ namespace Mqttify
 		 */
 		uint16 GetNextId();
 
+		/**
+		 * @brief Take several Ids at once, for a batch of publishes.
+		 * @param InCount The number of Ids.
+		 * @param OutIds Receives the Ids, in the order they were taken.
+		 * @return False if fewer Ids than asked for are available, none are taken then.
+		 */
+		bool ReserveIds(int32 InCount, TArray<uint16>& OutIds);
+
 		/**
 		 * @brief Releases an ID back into the pool.
 		 * @param Id The ID to release.
 		 */
 		void ReleaseId(const uint16 Id);
 
+		/**
+		 * @brief Check whether an Id is taken.
+		 * @param InId The Id.
+		 * @return True if the Id was taken and not released since.
+		 */
+		bool IsIdAllocated(uint16 InId) const;
+
+		/**
+		 * @brief Log a QoS 1 or 2 publish in the session store, if there is one. It is written to disk before the
+		 * next commands are processed.
+		 * @param InPacketId The packet identifier of the publish.
+		 * @param InMessage The message.
+		 */
+		void PersistPublish(uint16 InPacketId, const FMqttifyMessage& InMessage);
+
+		/// @brief Write the records logged in the session store to disk, if there is one.
+		void CommitSessionStore();
+
+		/**
+		 * @brief Take the publishes read back from the session store, their packet identifiers are already in use.
+		 * @return The publishes in the order they were made, empty after the first call.
+		 */
+		TArray<FMqttifySessionStore::FStoredPublish> TakeRecoveredPublishes();
+
 		/**
 		 * @brief Add an acknowledgeable command.
 		 * @param InCommand The acknowledgeable command.
 		 */
 		void AddAcknowledgeableCommand(const TSharedRef<FMqttifyQueueable>& InCommand);
 
+		/**
+		 * @brief Add a QoS 1 or 2 publish. It goes in flight if the broker's Receive Maximum allows,
+		 * otherwise it waits behind the publishes already pending until an acknowledgement makes room.
+		 * @param InCommand The publish command.
+		 */
+		void AddPublishCommand(const TSharedRef<FMqttifyQueueable>& InCommand);
+
+		/**
+		 * @brief Add the QoS 1 and 2 publishes of a batch and queue the batch to write them with its QoS 0 messages.
+		 * If the window has no room for all of them they wait behind the pending publishes and send themselves.
+		 * @param InBatch The batch.
+		 * @param InPublishes The QoS 1 and 2 publishes of the batch, in order.
+		 */
+		void AddPublishBatch(const TSharedRef<FMqttifyPublishBatch>& InBatch,
+							const TArray<TSharedRef<FMqttifyQueueable>>& InPublishes);
+
+		/**
+		 * @brief Publish a message. A message larger than the broker's Maximum Packet Size fails with
+		 * PacketTooLarge before it is encoded, otherwise the publish is queued or held offline, see AddPublish.
+		 * @param InMessage The message.
+		 * @param InSocket The socket the publish is sent on.
+		 * @return The future of the publish.
+		 */
+		TFuture<TMqttifyResult<void>> PublishAsync(FMqttifyMessage&& InMessage,
+													const TWeakPtr<FMqttifySocketBase>& InSocket);
+
+		/**
+		 * @brief Publish many messages with one future. A message larger than the broker's Maximum Packet Size fails
+		 * with PacketTooLarge, and the QoS 1 and 2 messages fail with QuotaExceeded if there are not enough packet
+		 * identifiers for all of them. Online, the rest is written at once by a batch, see AddPublishBatch. Offline,
+		 * each message is held in the offline buffer, decided under the same lock as AddPublish.
+		 * @param InMessages The messages.
+		 * @param InSocket The socket the publishes are sent on.
+		 * @return The future of the batch, with the result of each message in order.
+		 */
+		TFuture<TMqttifyResult<TArray<TMqttifyResult<void>>>> PublishBatchAsync(
+			TArray<FMqttifyMessage>&& InMessages,
+			const TWeakPtr<FMqttifySocketBase>& InSocket);
+
+		/**
+		 * @brief Write a QoS 0 publish straight to the socket on the calling thread. There is no command, future or
+		 * dispatch, the packet is built on the stack and encoded into the reused send buffer of the socket. The
+		 * topic is always sent in full, as mapping a topic alias allocates the properties of the packet.
+		 * @param InMessage The message, its quality of service must be AtMostOnce.
+		 * @param InSocket The socket to write to.
+		 * @return True if the message was written. False if it is not QoS 0, the socket is not connected or the
+		 * packet is larger than the broker accepts.
+		 */
+		bool PublishFireAndForget(FMqttifyMessage&& InMessage, const TWeakPtr<FMqttifySocketBase>& InSocket);
+
+		/**
+		 * @brief Set the Receive Maximum of the broker from the CONNACK, sending pending publishes that now fit.
+		 * @param InReceiveMaximum The Receive Maximum, 65535 if the broker did not send one.
+		 */
+		void SetServerReceiveMaximum(uint16 InReceiveMaximum);
+
+		/**
+		 * @brief Set the keep alive of the connection from the CONNACK.
+		 * @param InKeepAliveIntervalSeconds The broker's ServerKeepAlive, or the keep alive the client asked for.
+		 */
+		void SetKeepAliveIntervalSeconds(const uint16 InKeepAliveIntervalSeconds)
+		{
+			KeepAliveIntervalSeconds.store(InKeepAliveIntervalSeconds, std::memory_order_relaxed);
+		}
+
+		/// @return The keep alive of the connection in seconds, 0 if keep alive is off.
+		uint16 GetKeepAliveIntervalSeconds() const { return KeepAliveIntervalSeconds.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Record the round trip time of an answered PINGREQ.
+		 * @param InSeconds The time from sending the PINGREQ to receiving the PINGRESP.
+		 */
+		void SetPingRoundTripSeconds(const double InSeconds)
+		{
+			PingRoundTripSeconds.store(InSeconds, std::memory_order_relaxed);
+		}
+
+		/// @return The round trip time of the last answered PINGREQ in seconds, negative if none was answered yet.
+		double GetPingRoundTripSeconds() const { return PingRoundTripSeconds.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Set the Maximum Packet Size of the broker from the CONNACK.
+		 * @param InMaximumPacketSize The broker's Maximum Packet Size, 0 if it did not send one.
+		 */
+		void SetServerMaximumPacketSize(const uint32 InMaximumPacketSize)
+		{
+			ServerMaximumPacketSize.store(InMaximumPacketSize, std::memory_order_relaxed);
+		}
+
+		/// @return The largest packet the broker accepts in bytes, 0 if it set no limit.
+		uint32 GetServerMaximumPacketSize() const { return ServerMaximumPacketSize.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Hold a publish made while the client has no session. Publishes dropped to keep the buffer within
+		 * its budget fail.
+		 * @param InCommand The publish command.
+		 * @param InQualityOfService The quality of service of the publish.
+		 * @param InSize The encoded size of the publish.
+		 */
+		void AddOfflinePublish(const TSharedRef<FMqttifyQueueable>& InCommand,
+								EMqttifyQualityOfService InQualityOfService,
+								uint32 InSize);
+
+		/**
+		 * @brief Queue a publish for sending, or hold it in the offline buffer while the client has no session.
+		 * Decided under the lock FlushOfflinePublishes takes, so no publish is left in the buffer after a flush.
+		 * @param InCommand The publish command.
+		 * @param InQualityOfService The quality of service of the publish.
+		 * @param InSize The encoded size of the publish.
+		 */
+		void AddPublish(const TSharedRef<FMqttifyQueueable>& InCommand,
+						EMqttifyQualityOfService InQualityOfService,
+						uint32 InSize);
+
+		/**
+		 * @brief Queue the publishes held while offline for sending, oldest first, and queue later publishes
+		 * directly. Called once the broker accepts a connection, after the in-flight state of the session was
+		 * resumed or discarded.
+		 */
+		void FlushOfflinePublishes();
+
+		/// @brief Hold publishes in the offline buffer again. Called when the client leaves the connected state.
+		void MarkOffline();
+
+		/// @return The number of publishes held while offline.
+		int32 GetNumOfflinePublishes() const;
+
+		/// @return The number of QoS 1 and 2 publishes in flight.
+		int32 GetNumInFlightPublishes() const;
+
+		/// @return The number of publishes waiting for room in the window.
+		int32 GetNumPendingPublishes() const;
+
 		/**
 		 * @brief Check if an acknowledgeable command exists.
-		 * @param InPacketIdentifier The packet identifier.
+		 * @param InPacketIdentifier The command key, broker packet identifiers are shifted left by 16 bits.
 		 * @return True if the command exists, false otherwise.
 		 */
-		bool HasAcknowledgeableCommand(const uint16 InPacketIdentifier) const;
+		bool HasAcknowledgeableCommand(const uint32 InPacketIdentifier) const;
 
 		/**
 		 * @brief Add a command that is executed once without acknowledgment.
@@ -178,6 +459,30 @@ namespace Mqttify
 		 */
 		FMqttifyConnectionSettingsRef GetConnectionSettings() const;
 
+		/**
+		 * @brief Get the cache of encoded in-flight publishes.
+		 * @return A SharedRef to the cache.
+		 */
+		const TSharedRef<FMqttifyPacketCache>& GetRetransmitCache() const { return RetransmitCache; }
+
+		/**
+		 * @brief Get the topic aliases sent to the broker.
+		 * @return A SharedRef to the topic aliases.
+		 */
+		const TSharedRef<FMqttifyOutboundTopicAliases>& GetOutboundTopicAliases() const { return OutboundTopicAliases; }
+
+		/**
+		 * @brief Get the topic aliases received from the broker.
+		 * @return A SharedRef to the topic aliases.
+		 */
+		const TSharedRef<FMqttifyInboundTopicAliases>& GetInboundTopicAliases() const { return InboundTopicAliases; }
+
+		/**
+		 * @brief Get the timer wheel shared by the client.
+		 * @return A SharedRef to the timer wheel.
+		 */
+		const TSharedRef<FMqttifyTimerWheel>& GetTimerWheel() const { return TimerWheel; }
+
 		/**
 		 * @brief Create a promise for when the disconnect is complete.
 		 * @return A SharedPtr to the promise.
@@ -218,20 +523,125 @@ namespace Mqttify
 		 * @brief Acknowledge the given packet.
 		 * @param InPacket The packet to acknowledge.
 		 */
-		void Acknowledge(const FMqttifyPacketPtr& InPacket);
+		void Acknowledge(const IMqttifyControlPacket& InPacket);
 
-		/// @brief Clear all Message delegates.
+		/// @brief Clear all Message delegates and forget the active subscriptions.
 		void ClearMessageDelegates();
 
+		/**
+		 * @brief Track the topic filters a SUBACK granted, so they can be restored on a new session, and forget the
+		 * ones it refused.
+		 * @param InSubscribeResults The results of the subscribe command.
+		 */
+		void AddActiveSubscriptions(const TArray<FMqttifySubscribeResult>& InSubscribeResults);
+
+		/// @return The number of topic filters the broker acknowledged and that were not unsubscribed since.
+		int32 GetNumActiveSubscriptions() const;
+
+		/**
+		 * @brief Subscribe again to the active subscriptions on a connection where the broker has no session.
+		 * The topic filters are packed into as few SUBSCRIBE packets as the broker's Maximum Packet Size allows.
+		 * @param InSocket The socket to send the subscribes on.
+		 * @return The number of SUBSCRIBE packets queued.
+		 */
+		int32 Resubscribe(const TWeakPtr<FMqttifySocketBase>& InSocket);
+
+		/**
+		 * @brief Queue a subscribe call. The calls made in the same tick are merged into as few SUBSCRIBE packets as
+		 * the broker's Maximum Packet Size allows. Only the first subscriber of a topic filter is sent, later ones
+		 * share its SUBACK, or complete right away once the filter is granted. A later subscriber asking for a
+		 * higher QoS or other subscription options sends the filter again with options that serve all of them.
+		 * @param InTopicFilters The topic filters with their delegates.
+		 * @return A future with the result of each topic filter of this call.
+		 */
+		TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> AddSubscribeRequest(
+			TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>&& InTopicFilters);
+
+		/**
+		 * @brief Queue an unsubscribe call. The calls made in the same tick are merged into as few UNSUBSCRIBE
+		 * packets as the broker's Maximum Packet Size allows. Only the last subscriber of a topic filter is sent,
+		 * the others complete right away and leave the filter's delegate in place. The delegate is shared and does
+		 * not record which call bound what, so the handlers of those callers stay bound and keep receiving until
+		 * they remove themselves or the last subscriber unsubscribes.
+		 * @param InTopicFilters The topic filters.
+		 * @return A future with the result of each topic filter of this call.
+		 */
+		TFuture<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>> AddUnsubscribeRequest(
+			TArray<FMqttifyTopicFilter>&& InTopicFilters);
+
+		/**
+		 * @brief Get the number of subscribe calls holding a topic filter.
+		 * @param InTopicFilter The topic filter.
+		 * @return The subscribe calls that are pending or granted and not unsubscribed since.
+		 */
+		int32 GetNumSubscribers(const FString& InTopicFilter) const;
+
+		/**
+		 * @brief Queue a subscribe call for a large set of topic filters. Its topic filters are sent in packets sized
+		 * to the broker's Maximum Packet Size and of at most MaxTopicFiltersPerSubscribe topic filters, with at most
+		 * MaxOutstandingSubscribes of them waiting for a SUBACK.
+		 * Topic filters other calls hold are shared the way AddSubscribeRequest shares them.
+		 * @param InTopicFilters The topic filters with their delegates.
+		 * @param InOnProgress Called as the SUBACK of each packet arrives.
+		 * @return A future with the result of each topic filter of this call.
+		 */
+		TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> AddBulkSubscribeRequest(
+			TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>&& InTopicFilters,
+			const FOnBulkSubscribeProgress& InOnProgress);
+
+		/**
+		 * @brief Send the next packets of the bulk subscribe calls that have room for more SUBSCRIBEs waiting for a
+		 * SUBACK, called once per tick while connected.
+		 * @param InSocket The socket to send the packets on.
+		 * @return The number of packets queued.
+		 */
+		int32 SendBulkSubscribes(const TWeakPtr<FMqttifySocketBase>& InSocket);
+
+		/// @return The number of bulk subscribe calls with topic filters not sent yet.
+		int32 GetNumBulkSubscribes() const;
+
+		/// @return The number of subscribe and unsubscribe calls waiting to be sent.
+		int32 GetNumSubscriptionRequests() const;
+
+		/**
+		 * @brief Send the subscribe and unsubscribe calls queued since the last flush, called once per tick while
+		 * connected. Consecutive calls of the same kind share packets, calls of different kinds keep their order.
+		 * @param InSocket The socket to send the packets on.
+		 * @return The number of packets queued.
+		 */
+		int32 FlushSubscriptionRequests(const TWeakPtr<FMqttifySocketBase>& InSocket);
+
 		/// @brief Clear all Disconnect promises.
 		void ClearDisconnectPromises();
 
 		/// @brief Clear all Connect promises.
 		void ClearConnectPromises();
 
-		/// @brief Abandon all Acknowledgeable commands.
+		/**
+		 * @brief Abandon all Acknowledgeable commands. Their packet identifiers are released, their publishes stay
+		 * in the session store.
+		 */
 		void AbandonCommands();
 
+		/**
+		 * @brief Send the in-flight state again on a connection that resumed the session. Unacknowledged publishes
+		 * go out again marked DUP and unanswered PUBRELs again, in the order they were first sent.
+		 */
+		void ResumeSession();
+
+		/**
+		 * @brief Drop the in-flight state of a session the broker no longer has. Commands that were sent fail,
+		 * commands that never left the client stay queued and go out on the new session.
+		 */
+		void DiscardSession();
+
+		/**
+		 * @brief Fail the commands older than the publish deadline of the connection settings, called while the
+		 * connection is down. Does nothing if the deadline is 0.
+		 * @param InNow The current FPlatformTime::Seconds().
+		 */
+		void ExpireCommands(double InNow);
+
 		/**
 		 * @brief Get the OnConnect delegate.
 		 * @return The OnConnect delegate.
@@ -267,5 +677,78 @@ namespace Mqttify
 		 * @return The OnMessage delegate.
 		 */
 		virtual FOnMessage& OnMessage() override { return OnMessageDelegate; }
+
+	private:
+		/**
+		 * @brief Release the packet identifier and window slot of a command that left the in-flight table.
+		 * @param InKey The key of the command.
+		 */
+		void OnCommandRemovedLocked(uint32 InKey);
+
+		/// @brief Put a publish in flight and count it against the window.
+		void AddToWindowLocked(const TSharedRef<FMqttifyQueueable>& InCommand);
+
+		/// @brief Move pending publishes in flight while the window has room.
+		void FillWindowLocked();
+
+		/**
+		 * @brief Remove the in-flight commands that match a predicate and abandon them.
+		 * @param InPredicate Called with the key and command of each in-flight command, returns true to abandon it.
+		 * @return The number of commands abandoned.
+		 */
+		int32 AbandonCommandsIf(TFunctionRef<bool(uint32 InKey, const FMqttifyQueueable& InCommand)> InPredicate);
+
+		/**
+		 * @brief Abandon publishes taken out of the offline buffer and release their packet identifiers.
+		 * @param InEntries The publishes.
+		 */
+		void AbandonOfflinePublishes(const TArray<FMqttifyOfflineBuffer::FEntry>& InEntries);
+
+		/**
+		 * @brief Count a subscribe call as a subscriber of each of its topic filters. Topic filters already granted
+		 * complete right away, ones already on their way to the broker wait for their SUBACK.
+		 * @param InTopicFilters The topic filters of the call with their delegates.
+		 * @param InCall The call, given the result of each topic filter.
+		 * @param OutToSend Receives the topic filters no other call holds, to be sent.
+		 * @param OutPending Receives the calls waiting on each topic filter of OutToSend.
+		 */
+		template <typename TCall>
+		void AddSubscribers(const TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>& InTopicFilters,
+							const TSharedRef<TCall>& InCall,
+							TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>& OutToSend,
+							TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>>& OutPending);
+
+		/**
+		 * @brief Create the promise of a SUBSCRIBE, completing the calls waiting on its topic filters once it is set.
+		 * @param InPending The calls waiting on each topic filter of the SUBSCRIBE.
+		 * @param InOnAcknowledged Called first with the result of the SUBSCRIBE, may be empty.
+		 * @return The promise.
+		 */
+		TSharedRef<TPromise<TMqttifyResult<TArray<FMqttifySubscribeResult>>>> MakeSubscribePromise(
+			TArray<TPair<FString, TSharedRef<FMqttifyPendingSubscribe>>>&& InPending,
+			TFunction<void(const TMqttifyResult<TArray<FMqttifySubscribeResult>>&)>&& InOnAcknowledged = nullptr);
+
+		/**
+		 * @brief Complete the subscribe calls waiting on the SUBACK of a topic filter. If the filter was not granted,
+		 * they no longer count as its subscribers.
+		 * @param InTopicFilter The topic filter.
+		 * @param InPending The calls waiting on the SUBSCRIBE.
+		 * @param bInWasAcknowledged Whether the broker answered the SUBSCRIBE, the calls fail if not.
+		 * @param bInWasGranted Whether the broker granted the topic filter.
+		 */
+		void CompletePendingSubscribe(const FString& InTopicFilter,
+									const TSharedRef<FMqttifyPendingSubscribe>& InPending,
+									bool bInWasAcknowledged,
+									bool bInWasGranted);
+
+		/**
+		 * @brief Send subscribe or unsubscribe calls of one kind as commands, each caller getting the results of its
+		 * own topic filters once the acknowledgements of the packets they went out in arrive.
+		 * @param InRequests The calls, in order.
+		 * @param InSocket The socket to send the packets on.
+		 * @return The number of packets queued.
+		 */
+		template <typename TRequest>
+		int32 SendSubscriptionRequests(TArray<TRequest>&& InRequests, const TWeakPtr<FMqttifySocketBase>& InSocket);
 	};
 } // namespace Mqttify
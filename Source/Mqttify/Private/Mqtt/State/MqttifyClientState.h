@@ -2,7 +2,7 @@
 
 #include "Mqtt/MqttifyState.h"
 #include "Mqtt/State/MqttifyClientContext.h"
-#include "Packets/MqttifyConnAckPacket.h"
+#include "Packets/MqttifyInboundPacket.h"
 
 class FArrayReader;
 
@@ -24,8 +24,13 @@ namespace Mqttify
 		virtual ~FMqttifyClientState() = default;
 
 	protected:
-		/// @brief Create a new packet
-		static FMqttifyPacketPtr CreatePacket(const TSharedPtr<FArrayReader>& InData);
+		/**
+		 * @brief Decode a received packet in place.
+		 * @param InData The received data.
+		 * @param OutPacket The packet to decode into.
+		 * @return True if a packet was decoded.
+		 */
+		static bool DecodePacket(const TSharedPtr<FArrayReader>& InData, FMqttifyInboundPacket& OutPacket);
 		/**
 		 * @brief Transition to a new state
 		 * @param InState The new state to transition to
@@ -0,0 +1,247 @@
+#include "Mqtt/State/MqttifyInFlightTable.h"
+
+#include "LogMqttify.h"
+#include "Mqtt/Commands/MqttifyQueueable.h"
+
+namespace Mqttify
+{
+	void FMqttifyInFlightTable::Add(const uint32 InKey, const TSharedRef<FMqttifyQueueable>& InCommand)
+	{
+		const uint16 PacketId = GetPacketId(InKey);
+		if (PacketId == 0)
+		{
+			// Packet identifier 0 is never valid, the command could not be acknowledged so fail it now
+			LOG_MQTTIFY(Error, TEXT("[In Flight] Command with packet identifier 0 abandoned, key %u"), InKey);
+			InCommand->Abandon();
+			return;
+		}
+
+		TArray<int32>& Index = GetIndex(InKey);
+		if (PacketId >= Index.Num())
+		{
+			const int32 OldNum = Index.Num();
+			Index.SetNumUninitialized(FMath::Min(FMath::Max(PacketId + 1, OldNum * 2), 1 << 16));
+			for (int32 Id = OldNum; Id < Index.Num(); ++Id)
+			{
+				Index[Id] = INDEX_NONE;
+			}
+		}
+
+		if (const int32 Existing = Index[PacketId]; Existing != INDEX_NONE)
+		{
+			TimerWheel->Cancel(Timers[Existing]);
+			Tries[Existing] = 0;
+			Sequences[Existing] = NextSequence++;
+			Commands[Existing] = InCommand;
+		}
+		else
+		{
+			Index[PacketId] = Commands.Num();
+			Keys.Add(InKey);
+			Timers.AddDefaulted();
+			Tries.Add(0);
+			Sequences.Add(NextSequence++);
+			Commands.Add(InCommand);
+		}
+		DueKeys->Enqueue(InKey);
+	}
+
+	bool FMqttifyInFlightTable::Remove(const uint32 InKey)
+	{
+		const int32 Slot = FindSlot(InKey);
+		if (Slot == INDEX_NONE)
+		{
+			return false;
+		}
+		RemoveSlot(Slot);
+		return true;
+	}
+
+	bool FMqttifyInFlightTable::Acknowledge(const uint32 InKey, const IMqttifyControlPacket& InPacket)
+	{
+		const int32 Slot = FindSlot(InKey);
+		if (Slot == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const TSharedRef<FMqttifyQueueable> Command = Commands[Slot];
+		IMqttifyAcknowledgeable* Acknowledgeable = Command->AsAcknowledgeable();
+		if (Acknowledgeable == nullptr)
+		{
+			return false;
+		}
+
+		if (Acknowledgeable->Acknowledge(InPacket))
+		{
+			RemoveSlot(Slot);
+			return true;
+		}
+
+		Tries[Slot] = Command->GetPacketTries();
+		ScheduleSlot(Slot, FPlatformTime::Seconds());
+		return false;
+	}
+
+	void FMqttifyInFlightTable::ProcessDue(const double InNow,
+											const uint8 InMaxTries,
+											TArray<uint32>* OutRemovedKeys)
+	{
+		// Take the keys that are due now, commands that are still due after running are queued for the next call
+		TArray<uint32, TInlineAllocator<16>> Due;
+		uint32 Key;
+		while (DueKeys->Dequeue(Key))
+		{
+			Due.Add(Key);
+		}
+
+		for (const uint32 DueKey : Due)
+		{
+			int32 Slot = FindSlot(DueKey);
+			if (Slot == INDEX_NONE)
+			{
+				continue;
+			}
+
+			// Keep the command alive, sending can disconnect the socket and empty the table
+			const TSharedRef<FMqttifyQueueable> Command = Commands[Slot];
+			TimerWheel->Cancel(Timers[Slot]);
+			if (Tries[Slot] >= InMaxTries)
+			{
+				Command->Abandon();
+				Slot = FindSlot(DueKey);
+				if (Slot != INDEX_NONE && &Commands[Slot].Get() == &Command.Get())
+				{
+					RemoveSlot(Slot);
+					if (OutRemovedKeys != nullptr)
+					{
+						OutRemovedKeys->Add(DueKey);
+					}
+				}
+				continue;
+			}
+
+			const bool bIsDone = Command->Next(InNow);
+			Slot = FindSlot(DueKey);
+			if (Slot == INDEX_NONE || &Commands[Slot].Get() != &Command.Get())
+			{
+				continue;
+			}
+
+			if (bIsDone)
+			{
+				RemoveSlot(Slot);
+				if (OutRemovedKeys != nullptr)
+				{
+					OutRemovedKeys->Add(DueKey);
+				}
+			}
+			else
+			{
+				Tries[Slot] = Command->GetPacketTries();
+				ScheduleSlot(Slot, InNow);
+			}
+		}
+	}
+
+	void FMqttifyInFlightTable::Rearm()
+	{
+		DueKeys->Empty();
+
+		TArray<int32, TInlineAllocator<16>> Order;
+		Order.Reserve(Commands.Num());
+		for (int32 Slot = 0; Slot < Commands.Num(); ++Slot)
+		{
+			TimerWheel->Cancel(Timers[Slot]);
+			Tries[Slot] = 0;
+			Commands[Slot]->Rearm();
+			Order.Add(Slot);
+		}
+
+		Order.Sort([this](const int32 A, const int32 B) { return Sequences[A] < Sequences[B]; });
+		for (const int32 Slot : Order)
+		{
+			DueKeys->Enqueue(Keys[Slot]);
+		}
+	}
+
+	void FMqttifyInFlightTable::RemoveIf(
+		const TFunctionRef<bool(uint32 InKey, const FMqttifyQueueable& InCommand)> InPredicate,
+		TArray<TPair<uint32, TSharedRef<FMqttifyQueueable>>>& OutRemoved)
+	{
+		// Walk backwards, swap removal only moves slots that were already visited
+		for (int32 Slot = Commands.Num() - 1; Slot >= 0; --Slot)
+		{
+			if (InPredicate(Keys[Slot], *Commands[Slot]))
+			{
+				OutRemoved.Emplace(Keys[Slot], Commands[Slot]);
+				RemoveSlot(Slot);
+			}
+		}
+	}
+
+	void FMqttifyInFlightTable::Empty()
+	{
+		for (FMqttifyTimerHandle& Timer : Timers)
+		{
+			TimerWheel->Cancel(Timer);
+		}
+		ClientSlots.Empty();
+		ServerSlots.Empty();
+		Keys.Empty();
+		Timers.Empty();
+		Tries.Empty();
+		Sequences.Empty();
+		Commands.Empty();
+		DueKeys->Empty();
+	}
+
+	int32 FMqttifyInFlightTable::FindSlot(const uint32 InKey) const
+	{
+		const TArray<int32>& Index = GetIndex(InKey);
+		const uint16 PacketId = GetPacketId(InKey);
+		return PacketId < Index.Num() ? Index[PacketId] : INDEX_NONE;
+	}
+
+	void FMqttifyInFlightTable::RemoveSlot(const int32 InSlot)
+	{
+		TimerWheel->Cancel(Timers[InSlot]);
+		GetIndex(Keys[InSlot])[GetPacketId(Keys[InSlot])] = INDEX_NONE;
+
+		const int32 Last = Commands.Num() - 1;
+		if (InSlot != Last)
+		{
+			GetIndex(Keys[Last])[GetPacketId(Keys[Last])] = InSlot;
+		}
+
+		Keys.RemoveAtSwap(InSlot, 1, EAllowShrinking::No);
+		Timers.RemoveAtSwap(InSlot, 1, EAllowShrinking::No);
+		Tries.RemoveAtSwap(InSlot, 1, EAllowShrinking::No);
+		Sequences.RemoveAtSwap(InSlot, 1, EAllowShrinking::No);
+		Commands.RemoveAtSwap(InSlot, 1, EAllowShrinking::No);
+	}
+
+	void FMqttifyInFlightTable::ScheduleSlot(const int32 InSlot, const double InNow)
+	{
+		TimerWheel->Cancel(Timers[InSlot]);
+
+		const uint32 Key = Keys[InSlot];
+		const double Delay = Commands[InSlot]->GetRetryWaitTime() - InNow;
+		if (Delay <= 0.0)
+		{
+			DueKeys->Enqueue(Key);
+			return;
+		}
+
+		TWeakPtr<FDueKeys, ESPMode::ThreadSafe> WeakDueKeys = DueKeys;
+		Timers[InSlot] = TimerWheel->Schedule(
+			Delay,
+			[WeakDueKeys, Key]
+			{
+				if (const TSharedPtr<FDueKeys, ESPMode::ThreadSafe> PinnedDueKeys = WeakDueKeys.Pin())
+				{
+					PinnedDueKeys->Enqueue(Key);
+				}
+			});
+	}
+} // namespace Mqttify
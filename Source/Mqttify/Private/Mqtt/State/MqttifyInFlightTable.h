@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Mqtt/MqttifyTimerWheel.h"
+
+namespace Mqttify
+{
+	class IMqttifyControlPacket;
+	class FMqttifyQueueable;
+
+	/**
+	 * @brief Table of the acknowledgeable commands that are in flight, indexed by packet identifier.
+	 *
+	 * Keys follow IMqttifyAcknowledgeable::GetId: the low 16 bits hold identifiers allocated by the client and
+	 * the high 16 bits identifiers chosen by the broker. Each key maps straight to a slot through a per direction
+	 * index that grows to the highest identifier seen. The slots are stored as parallel arrays and kept dense with
+	 * swap removal. Retry deadlines are timers on the shared timer wheel, which queue the key when they fire, so
+	 * processing only visits the commands that are due.
+	 *
+	 * The table is not thread safe, the owner is expected to lock around it.
+	 */
+	class FMqttifyInFlightTable final
+	{
+	public:
+		explicit FMqttifyInFlightTable(const TSharedRef<FMqttifyTimerWheel>& InTimerWheel)
+			: TimerWheel{InTimerWheel} {}
+
+		~FMqttifyInFlightTable() { Empty(); }
+
+		FMqttifyInFlightTable(const FMqttifyInFlightTable&) = delete;
+		FMqttifyInFlightTable& operator=(const FMqttifyInFlightTable&) = delete;
+
+		/**
+		 * @brief Add a command, replacing any command with the same key. The command is due straight away. A command
+		 * whose key has no packet identifier, as when the identifiers ran out, is abandoned instead.
+		 * @param InKey The key of the command.
+		 * @param InCommand The command.
+		 */
+		void Add(uint32 InKey, const TSharedRef<FMqttifyQueueable>& InCommand);
+
+		/**
+		 * @brief Check if a command is in flight.
+		 * @param InKey The key of the command.
+		 * @return True if the command is in the table.
+		 */
+		bool Contains(const uint32 InKey) const { return FindSlot(InKey) != INDEX_NONE; }
+
+		/**
+		 * @brief Remove a command.
+		 * @param InKey The key of the command.
+		 * @return True if a command was removed.
+		 */
+		bool Remove(uint32 InKey);
+
+		/**
+		 * @brief Pass an acknowledgement to the command it belongs to, removing the command if it is done.
+		 * Otherwise the command is scheduled again, as acknowledgements can restart its retries.
+		 * @param InKey The key of the command.
+		 * @param InPacket The acknowledgement.
+		 * @return True if the command was found and is done.
+		 */
+		bool Acknowledge(uint32 InKey, const IMqttifyControlPacket& InPacket);
+
+		/**
+		 * @brief Run the commands whose timers have fired, abandoning the ones out of tries.
+		 * @param InNow The current FPlatformTime::Seconds().
+		 * @param InMaxTries The maximum number of tries before a command is abandoned.
+		 * @param OutRemovedKeys If set, receives the keys of the commands that were done or abandoned.
+		 */
+		void ProcessDue(double InNow, uint8 InMaxTries, TArray<uint32>* OutRemovedKeys = nullptr);
+
+		/**
+		 * @brief Make every command due straight away with a fresh set of tries, queued in the order the commands
+		 * were added. Used to send the in-flight state again when a new connection resumes the session.
+		 */
+		void Rearm();
+
+		/**
+		 * @brief Remove the commands that match a predicate, without running or abandoning them.
+		 * @param InPredicate Called with the key and command of each slot, returns true to remove the command.
+		 * @param OutRemoved Receives the keys and commands that were removed.
+		 */
+		void RemoveIf(TFunctionRef<bool(uint32 InKey, const FMqttifyQueueable& InCommand)> InPredicate,
+					TArray<TPair<uint32, TSharedRef<FMqttifyQueueable>>>& OutRemoved);
+
+		/// @brief Remove every command.
+		void Empty();
+
+		/// @return The number of commands in flight.
+		int32 Num() const { return Commands.Num(); }
+
+	private:
+		static constexpr uint32 kServerKeyShift = 16;
+
+		using FDueKeys = TQueue<uint32, EQueueMode::Mpsc>;
+
+		int32 FindSlot(uint32 InKey) const;
+		void RemoveSlot(int32 InSlot);
+
+		/**
+		 * @brief Queue a slot for processing once the retry wait time of its command has passed.
+		 * @param InSlot The slot.
+		 * @param InNow The current FPlatformTime::Seconds().
+		 */
+		void ScheduleSlot(int32 InSlot, double InNow);
+
+		TArray<int32>& GetIndex(const uint32 InKey) { return InKey >> kServerKeyShift ? ServerSlots : ClientSlots; }
+
+		const TArray<int32>& GetIndex(const uint32 InKey) const
+		{
+			return InKey >> kServerKeyShift ? ServerSlots : ClientSlots;
+		}
+
+		static uint16 GetPacketId(const uint32 InKey)
+		{
+			return static_cast<uint16>(InKey >> kServerKeyShift ? InKey >> kServerKeyShift : InKey);
+		}
+
+		/// @brief Slot per client allocated packet identifier, INDEX_NONE if the identifier is not in flight.
+		TArray<int32> ClientSlots;
+		/// @brief Slot per broker allocated packet identifier, INDEX_NONE if the identifier is not in flight.
+		TArray<int32> ServerSlots;
+
+		TArray<uint32> Keys;
+		TArray<FMqttifyTimerHandle> Timers;
+		TArray<uint8> Tries;
+		/// @brief Order in which the commands were added, so in-flight state can be sent again in order.
+		TArray<uint64> Sequences;
+		TArray<TSharedRef<FMqttifyQueueable>> Commands;
+		uint64 NextSequence = 0;
+
+		TSharedRef<FMqttifyTimerWheel> TimerWheel;
+		/// @brief Keys whose timers have fired. Shared with the timer callbacks, which may outlive the table.
+		TSharedRef<FDueKeys, ESPMode::ThreadSafe> DueKeys = MakeShared<FDueKeys, ESPMode::ThreadSafe>();
+	};
+} // namespace Mqttify
@@ -0,0 +1,124 @@
+#include "Mqtt/State/MqttifyOfflineBuffer.h"
+
+#include "Mqtt/Commands/MqttifyQueueable.h"
+
+namespace Mqttify
+{
+	FMqttifyOfflineBuffer::FMqttifyOfflineBuffer(const uint32 InMaxMessages,
+												const uint32 InMaxBytes,
+												const EMqttifyOfflineDropPolicy InDropPolicy)
+		: MaxMessages{InMaxMessages}
+		, MaxBytes{InMaxBytes}
+		, DropPolicy{InDropPolicy} {}
+
+	void FMqttifyOfflineBuffer::Add(const TSharedRef<FMqttifyQueueable>& InCommand,
+									const EMqttifyQualityOfService InQualityOfService,
+									const uint32 InSize,
+									TArray<FEntry>& OutDropped)
+	{
+		FEntry Entry{InCommand, InQualityOfService, InSize, NextSequence++};
+		const int32 Lane = static_cast<int32>(InQualityOfService);
+
+		// A publish larger than the whole budget never fits, whatever is dropped to make room
+		bool bFits = MaxMessages > 0 && InSize <= MaxBytes;
+		while (bFits && (static_cast<uint32>(NumMessages) >= MaxMessages || NumBytes + InSize > MaxBytes))
+		{
+			int32 DropLane = INDEX_NONE;
+			switch (DropPolicy)
+			{
+				case EMqttifyOfflineDropPolicy::DropOldest:
+					DropLane = GetOldestLane();
+					break;
+				case EMqttifyOfflineDropPolicy::DropLowestQualityOfService:
+					// The new publish goes first if nothing buffered has a lower quality of service
+					DropLane = GetLowestLane();
+					DropLane = DropLane <= Lane ? DropLane : INDEX_NONE;
+					break;
+				case EMqttifyOfflineDropPolicy::DropNewest:
+				default:
+					break;
+			}
+
+			if (DropLane == INDEX_NONE)
+			{
+				bFits = false;
+				break;
+			}
+			PopFront(DropLane, OutDropped);
+			++NumDropped;
+		}
+
+		if (!bFits)
+		{
+			OutDropped.Add(MoveTemp(Entry));
+			++NumDropped;
+			return;
+		}
+
+		++NumMessages;
+		NumBytes += InSize;
+		++LaneCounts[Lane];
+		Lanes[Lane].Enqueue(MoveTemp(Entry));
+	}
+
+	void FMqttifyOfflineBuffer::Drain(TArray<FEntry>& OutEntries)
+	{
+		OutEntries.Reserve(OutEntries.Num() + NumMessages);
+		for (int32 Lane = GetOldestLane(); Lane != INDEX_NONE; Lane = GetOldestLane())
+		{
+			PopFront(Lane, OutEntries);
+		}
+	}
+
+	void FMqttifyOfflineBuffer::RemoveOlderThan(const double InCutoff,
+												const EMqttifyQualityOfService InMinQualityOfService,
+												TArray<FEntry>& OutRemoved)
+	{
+		// Each queue is oldest first, stop at the first publish inside the cutoff
+		for (int32 Lane = static_cast<int32>(InMinQualityOfService); Lane < kNumLanes; ++Lane)
+		{
+			const FEntry* Front = Lanes[Lane].Peek();
+			while (Front != nullptr && Front->Command->GetCreatedTime() < InCutoff)
+			{
+				PopFront(Lane, OutRemoved);
+				Front = Lanes[Lane].Peek();
+			}
+		}
+	}
+
+	int32 FMqttifyOfflineBuffer::GetOldestLane()
+	{
+		int32 OldestLane = INDEX_NONE;
+		uint64 OldestSequence = std::numeric_limits<uint64>::max();
+		for (int32 Lane = 0; Lane < kNumLanes; ++Lane)
+		{
+			if (const FEntry* Front = Lanes[Lane].Peek(); Front != nullptr && Front->Sequence < OldestSequence)
+			{
+				OldestLane = Lane;
+				OldestSequence = Front->Sequence;
+			}
+		}
+		return OldestLane;
+	}
+
+	int32 FMqttifyOfflineBuffer::GetLowestLane() const
+	{
+		for (int32 Lane = 0; Lane < kNumLanes; ++Lane)
+		{
+			if (LaneCounts[Lane] > 0)
+			{
+				return Lane;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	void FMqttifyOfflineBuffer::PopFront(const int32 InLane, TArray<FEntry>& OutEntries)
+	{
+		FEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Lanes[InLane].Dequeue(Entry);
+		--LaneCounts[InLane];
+		--NumMessages;
+		NumBytes -= Entry.Size;
+	}
+} // namespace Mqttify
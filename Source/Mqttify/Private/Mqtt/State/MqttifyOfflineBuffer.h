@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Mqtt/MqttifyOfflineDropPolicy.h"
+#include "Mqtt/MqttifyQualityOfService.h"
+
+namespace Mqttify
+{
+	class FMqttifyQueueable;
+
+	/**
+	 * @brief Publishes made while the client has no session, held until the broker accepts a connection.
+	 *
+	 * The buffer has a budget in messages and in encoded bytes. A publish that does not fit drops buffered
+	 * publishes, or itself, as the drop policy says. Each quality of service has its own queue so the oldest
+	 * publish of any one level is at the front of its queue, a sequence number restores the order the publishes
+	 * were made in when the buffer is drained.
+	 *
+	 * The buffer is not thread safe, the owner is expected to lock around it.
+	 */
+	class FMqttifyOfflineBuffer final
+	{
+	public:
+		/// @brief A buffered publish.
+		struct FEntry
+		{
+			TSharedPtr<FMqttifyQueueable> Command;
+			EMqttifyQualityOfService QualityOfService = EMqttifyQualityOfService::AtMostOnce;
+			/// @brief Encoded size of the publish, counted against the byte budget.
+			uint32 Size = 0;
+			uint64 Sequence = 0;
+		};
+
+		/**
+		 * @brief Constructor.
+		 * @param InMaxMessages The most publishes held at once, 0 to drop every publish.
+		 * @param InMaxBytes The most encoded bytes held at once.
+		 * @param InDropPolicy Which publish is dropped when the buffer is over its budget.
+		 */
+		FMqttifyOfflineBuffer(uint32 InMaxMessages, uint32 InMaxBytes, EMqttifyOfflineDropPolicy InDropPolicy);
+
+		FMqttifyOfflineBuffer(const FMqttifyOfflineBuffer&) = delete;
+		FMqttifyOfflineBuffer& operator=(const FMqttifyOfflineBuffer&) = delete;
+
+		/**
+		 * @brief Buffer a publish, dropping publishes until it fits the budget.
+		 * @param InCommand The publish command.
+		 * @param InQualityOfService The quality of service of the publish.
+		 * @param InSize The encoded size of the publish.
+		 * @param OutDropped Receives the publishes that were dropped, which may include the one being added.
+		 */
+		void Add(const TSharedRef<FMqttifyQueueable>& InCommand,
+				EMqttifyQualityOfService InQualityOfService,
+				uint32 InSize,
+				TArray<FEntry>& OutDropped);
+
+		/**
+		 * @brief Remove every publish, oldest first.
+		 * @param OutEntries Receives the publishes in the order they were added.
+		 */
+		void Drain(TArray<FEntry>& OutEntries);
+
+		/**
+		 * @brief Remove the publishes made before a point in time.
+		 * @param InCutoff The FPlatformTime::Seconds() before which publishes are removed.
+		 * @param InMinQualityOfService Only publishes of this quality of service or above are removed.
+		 * @param OutRemoved Receives the publishes that were removed.
+		 */
+		void RemoveOlderThan(double InCutoff, EMqttifyQualityOfService InMinQualityOfService, TArray<FEntry>& OutRemoved);
+
+		/// @return The number of publishes held.
+		int32 Num() const { return NumMessages; }
+
+		/// @return The encoded bytes held.
+		uint64 GetNumBytes() const { return NumBytes; }
+
+		/// @return The number of publishes dropped to stay within the budget.
+		int64 GetNumDropped() const { return NumDropped; }
+
+	private:
+		static constexpr int32 kNumLanes = 3;
+
+		/// @return The queue whose front publish was added first, INDEX_NONE if the buffer is empty.
+		int32 GetOldestLane();
+
+		/// @return The lowest quality of service with publishes held, INDEX_NONE if the buffer is empty.
+		int32 GetLowestLane() const;
+
+		/// @brief Move the front publish of a queue to OutEntries.
+		void PopFront(int32 InLane, TArray<FEntry>& OutEntries);
+
+		/// @brief Buffered publishes per quality of service, oldest first.
+		TQueue<FEntry> Lanes[kNumLanes];
+		int32 LaneCounts[kNumLanes] = {};
+
+		uint32 MaxMessages;
+		uint32 MaxBytes;
+		EMqttifyOfflineDropPolicy DropPolicy;
+
+		int32 NumMessages = 0;
+		uint64 NumBytes = 0;
+		int64 NumDropped = 0;
+		uint64 NextSequence = 0;
+	};
+} // namespace Mqttify
@@ -0,0 +1,391 @@
+#include "Mqtt/State/MqttifySessionStore.h"
+
+#include "LogMqttify.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace Mqttify
+{
+	namespace
+	{
+		enum class ERecordType : uint8
+		{
+			Publish = 1,
+			Release = 2,
+			Remove = 3,
+		};
+
+		/// @brief "MQSL" followed by the format version. Records are written in native byte order.
+		constexpr uint32 kMagic = 0x4C53514D;
+		constexpr uint32 kVersion = 1;
+		constexpr int32 kHeaderSize = 2 * sizeof(uint32);
+
+		/// @brief Type, packet identifier and body length before the body, CRC after it.
+		constexpr int32 kRecordPrefixSize = sizeof(uint8) + sizeof(uint16) + sizeof(uint32);
+		constexpr int32 kRecordOverhead = kRecordPrefixSize + sizeof(uint32);
+
+		template <typename T>
+		void AppendValue(TArray<uint8>& OutBytes, const T InValue)
+		{
+			OutBytes.Append(reinterpret_cast<const uint8*>(&InValue), sizeof(T));
+		}
+
+		template <typename T>
+		T ReadValue(const uint8* InBytes)
+		{
+			T Value;
+			FMemory::Memcpy(&Value, InBytes, sizeof(T));
+			return Value;
+		}
+
+		void AppendHeader(TArray<uint8>& OutBytes)
+		{
+			AppendValue(OutBytes, kMagic);
+			AppendValue(OutBytes, kVersion);
+		}
+
+		void AppendRecord(TArray<uint8>& OutBytes,
+						const ERecordType InType,
+						const uint16 InPacketId,
+						const TArray<uint8>& InBody = {})
+		{
+			const int32 Start = OutBytes.Num();
+			AppendValue(OutBytes, static_cast<uint8>(InType));
+			AppendValue(OutBytes, InPacketId);
+			AppendValue(OutBytes, static_cast<uint32>(InBody.Num()));
+			OutBytes.Append(InBody);
+			AppendValue(OutBytes, FCrc::MemCrc32(OutBytes.GetData() + Start, OutBytes.Num() - Start));
+		}
+
+		/// @brief Body of a publish record: quality of service, retain flag, UTF-8 topic and payload.
+		TArray<uint8> EncodePublishBody(const FMqttifyMessage& InMessage)
+		{
+			const FTCHARToUTF8 Topic{*InMessage.GetTopic()};
+			TArray<uint8> Body;
+			Body.Reserve(2 + sizeof(uint32) + Topic.Length() + InMessage.GetPayload().Num());
+			AppendValue(Body, static_cast<uint8>(InMessage.GetQualityOfService()));
+			AppendValue(Body, static_cast<uint8>(InMessage.GetIsRetained()));
+			AppendValue(Body, static_cast<uint32>(Topic.Length()));
+			Body.Append(reinterpret_cast<const uint8*>(Topic.Get()), Topic.Length());
+			Body.Append(InMessage.GetPayload());
+			return Body;
+		}
+
+		bool DecodePublishBody(const uint8* InBody, const uint32 InLength, FMqttifyMessage& OutMessage)
+		{
+			constexpr uint32 kFixedSize = 2 + sizeof(uint32);
+			if (InLength < kFixedSize)
+			{
+				return false;
+			}
+
+			const uint8 QualityOfService = InBody[0];
+			const bool bRetain = InBody[1] != 0;
+			const uint32 TopicLength = ReadValue<uint32>(InBody + 2);
+			if (QualityOfService > static_cast<uint8>(EMqttifyQualityOfService::ExactlyOnce)
+				|| TopicLength > InLength - kFixedSize)
+			{
+				return false;
+			}
+
+			const FUTF8ToTCHAR Topic{
+				reinterpret_cast<const ANSICHAR*>(InBody + kFixedSize),
+				static_cast<int32>(TopicLength)};
+			const uint32 PayloadOffset = kFixedSize + TopicLength;
+			OutMessage = FMqttifyMessage{
+				FString(Topic.Length(), Topic.Get()),
+				TArray<uint8>(InBody + PayloadOffset, static_cast<int32>(InLength - PayloadOffset)),
+				bRetain,
+				static_cast<EMqttifyQualityOfService>(QualityOfService)};
+			return true;
+		}
+	} // namespace
+
+	TSharedPtr<FMqttifySessionStore> FMqttifySessionStore::Open(const FString& InPath,
+																TArray<FStoredPublish>& OutRecovered)
+	{
+		const TSharedRef<FMqttifySessionStore> Store = MakeShareable(new FMqttifySessionStore{InPath});
+		if (!ReadLive(InPath, Store->LivePublishes, Store->NextSequence))
+		{
+			LOG_MQTTIFY(Warning, TEXT("%s is not a session log, starting a new one"), *InPath);
+		}
+
+		for (const TPair<uint16, FLivePublish>& Live : Store->LivePublishes)
+		{
+			Store->LiveBytes += Live.Value.Record.Num() + (Live.Value.bIsReleased ? kRecordOverhead : 0);
+		}
+
+		{
+			// Drop finished and torn records before appending to the log
+			FScopeLock Lock{&Store->CriticalSection};
+			if (!Store->RewriteLocked())
+			{
+				return nullptr;
+			}
+		}
+
+		GetStoredPublishes(Store->LivePublishes, OutRecovered);
+		UE_CLOG(
+			OutRecovered.Num() > 0,
+			LogMqttify,
+			Log,
+			TEXT("Recovered %d unacknowledged publishes from %s"),
+			OutRecovered.Num(),
+			*InPath);
+		return Store;
+	}
+
+	bool FMqttifySessionStore::Read(const FString& InPath, TArray<FStoredPublish>& OutRecovered)
+	{
+		TMap<uint16, FLivePublish> Live;
+		uint64 NextSequence = 0;
+		const bool bIsLog = ReadLive(InPath, Live, NextSequence);
+		GetStoredPublishes(Live, OutRecovered);
+		return bIsLog;
+	}
+
+	FMqttifySessionStore::FMqttifySessionStore(const FString& InPath)
+		: Path{InPath} {}
+
+	FMqttifySessionStore::~FMqttifySessionStore()
+	{
+		FScopeLock Lock{&CriticalSection};
+		CommitLocked();
+		File.Reset();
+	}
+
+	void FMqttifySessionStore::AddPublish(const uint16 InPacketId, const FMqttifyMessage& InMessage)
+	{
+		TArray<uint8> Record;
+		AppendRecord(Record, ERecordType::Publish, InPacketId, EncodePublishBody(InMessage));
+
+		FScopeLock Lock{&CriticalSection};
+		if (const FLivePublish* Existing = LivePublishes.Find(InPacketId))
+		{
+			LiveBytes -= Existing->Record.Num() + (Existing->bIsReleased ? kRecordOverhead : 0);
+		}
+		PendingWrites.Append(Record);
+		LiveBytes += Record.Num();
+		LivePublishes.Add(InPacketId, FLivePublish{MoveTemp(Record), NextSequence++, false});
+	}
+
+	void FMqttifySessionStore::Release(const uint16 InPacketId)
+	{
+		FScopeLock Lock{&CriticalSection};
+		FLivePublish* Live = LivePublishes.Find(InPacketId);
+		if (Live == nullptr || Live->bIsReleased)
+		{
+			return;
+		}
+
+		Live->bIsReleased = true;
+		AppendRecord(PendingWrites, ERecordType::Release, InPacketId);
+		LiveBytes += kRecordOverhead;
+	}
+
+	void FMqttifySessionStore::Remove(const uint16 InPacketId)
+	{
+		FScopeLock Lock{&CriticalSection};
+		const FLivePublish* Live = LivePublishes.Find(InPacketId);
+		if (Live == nullptr)
+		{
+			return;
+		}
+
+		LiveBytes -= Live->Record.Num() + (Live->bIsReleased ? kRecordOverhead : 0);
+		LivePublishes.Remove(InPacketId);
+		AppendRecord(PendingWrites, ERecordType::Remove, InPacketId);
+	}
+
+	void FMqttifySessionStore::Commit()
+	{
+		FScopeLock Lock{&CriticalSection};
+		CommitLocked();
+	}
+
+	int32 FMqttifySessionStore::Num() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return LivePublishes.Num();
+	}
+
+	int64 FMqttifySessionStore::GetFileSize() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return FileBytes + PendingWrites.Num();
+	}
+
+	void FMqttifySessionStore::CommitLocked()
+	{
+		if (PendingWrites.Num() == 0)
+		{
+			return;
+		}
+
+		if (!File.IsValid() || !File->Write(PendingWrites.GetData(), PendingWrites.Num()) || !File->Flush(true))
+		{
+			LOG_MQTTIFY(Error, TEXT("Failed to write %d bytes to the session log %s"), PendingWrites.Num(), *Path);
+			PendingWrites.Reset();
+			return;
+		}
+		FileBytes += PendingWrites.Num();
+		PendingWrites.Reset();
+
+		// Compact once finished publishes take more of the file than the live ones
+		if (FileBytes > kMinCompactionBytes && FileBytes > 2 * (kHeaderSize + LiveBytes))
+		{
+			RewriteLocked();
+		}
+	}
+
+	bool FMqttifySessionStore::ReadLive(const FString& InPath,
+										TMap<uint16, FLivePublish>& OutLive,
+										uint64& OutNextSequence)
+	{
+		TArray<uint8> Bytes;
+		if (!IFileManager::Get().FileExists(*InPath) || !FFileHelper::LoadFileToArray(Bytes, *InPath))
+		{
+			return true;
+		}
+
+		if (Bytes.Num() < kHeaderSize || ReadValue<uint32>(Bytes.GetData()) != kMagic
+			|| ReadValue<uint32>(Bytes.GetData() + sizeof(uint32)) != kVersion)
+		{
+			return false;
+		}
+
+		int32 Offset = kHeaderSize;
+		while (Bytes.Num() - Offset >= kRecordOverhead)
+		{
+			const uint8* Record = Bytes.GetData() + Offset;
+			const uint32 BodyLength = ReadValue<uint32>(Record + sizeof(uint8) + sizeof(uint16));
+			if (BodyLength > static_cast<uint32>(Bytes.Num() - Offset - kRecordOverhead))
+			{
+				break;
+			}
+
+			const int32 RecordSize = kRecordOverhead + BodyLength;
+			if (FCrc::MemCrc32(Record, RecordSize - sizeof(uint32)) != ReadValue<uint32>(
+				Record + RecordSize - sizeof(uint32)))
+			{
+				break;
+			}
+
+			const ERecordType Type = static_cast<ERecordType>(Record[0]);
+			const uint16 PacketId = ReadValue<uint16>(Record + sizeof(uint8));
+			switch (Type)
+			{
+				case ERecordType::Publish:
+					OutLive.Add(PacketId, FLivePublish{TArray<uint8>(Record, RecordSize), OutNextSequence++, false});
+					break;
+				case ERecordType::Release:
+					if (FLivePublish* Live = OutLive.Find(PacketId))
+					{
+						Live->bIsReleased = true;
+					}
+					break;
+				case ERecordType::Remove:
+					OutLive.Remove(PacketId);
+					break;
+				default:
+					break;
+			}
+			Offset += RecordSize;
+		}
+
+		UE_CLOG(
+			Offset != Bytes.Num(),
+			LogMqttify,
+			Warning,
+			TEXT("Ignoring %d bytes of torn or corrupt records at the end of %s"),
+			Bytes.Num() - Offset,
+			*InPath);
+		return true;
+	}
+
+	void FMqttifySessionStore::GetStoredPublishes(const TMap<uint16, FLivePublish>& InLive,
+												TArray<FStoredPublish>& OutPublishes)
+	{
+		TArray<const FLivePublish*> Ordered;
+		Ordered.Reserve(InLive.Num());
+		for (const TPair<uint16, FLivePublish>& Live : InLive)
+		{
+			Ordered.Add(&Live.Value);
+		}
+		Ordered.Sort([](const FLivePublish& A, const FLivePublish& B) { return A.Sequence < B.Sequence; });
+
+		OutPublishes.Reserve(OutPublishes.Num() + Ordered.Num());
+		for (const FLivePublish* Live : Ordered)
+		{
+			const uint8* Record = Live->Record.GetData();
+			FStoredPublish Stored;
+			Stored.PacketId = ReadValue<uint16>(Record + sizeof(uint8));
+			Stored.bIsReleased = Live->bIsReleased;
+			if (DecodePublishBody(
+				Record + kRecordPrefixSize,
+				Live->Record.Num() - kRecordOverhead,
+				Stored.Message))
+			{
+				OutPublishes.Add(MoveTemp(Stored));
+			}
+		}
+	}
+
+	bool FMqttifySessionStore::RewriteLocked()
+	{
+		TArray<const TPair<uint16, FLivePublish>*> Ordered;
+		Ordered.Reserve(LivePublishes.Num());
+		for (const TPair<uint16, FLivePublish>& Live : LivePublishes)
+		{
+			Ordered.Add(&Live);
+		}
+		Ordered.Sort(
+			[](const TPair<uint16, FLivePublish>& A, const TPair<uint16, FLivePublish>& B)
+			{
+				return A.Value.Sequence < B.Value.Sequence;
+			});
+
+		TArray<uint8> Bytes;
+		Bytes.Reserve(kHeaderSize + LiveBytes);
+		AppendHeader(Bytes);
+		for (const TPair<uint16, FLivePublish>* Live : Ordered)
+		{
+			Bytes.Append(Live->Value.Record);
+			if (Live->Value.bIsReleased)
+			{
+				AppendRecord(Bytes, ERecordType::Release, Live->Key);
+			}
+		}
+
+		// Write the new file aside and move it over the log, a crash leaves either the old or the new log whole
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+		const FString TempPath = Path + TEXT(".tmp");
+		bool bIsWritten;
+		{
+			const TUniquePtr<IFileHandle> TempFile{PlatformFile.OpenWrite(*TempPath)};
+			bIsWritten = TempFile.IsValid() && TempFile->Write(Bytes.GetData(), Bytes.Num()) && TempFile->Flush(true);
+		}
+
+		File.Reset();
+		if (!bIsWritten || !IFileManager::Get().Move(*Path, *TempPath, true, true))
+		{
+			LOG_MQTTIFY(Error, TEXT("Failed to compact the session log %s"), *Path);
+			PlatformFile.DeleteFile(*TempPath);
+			File.Reset(PlatformFile.OpenWrite(*Path, true));
+			return false;
+		}
+
+		File.Reset(PlatformFile.OpenWrite(*Path, true));
+		if (!File.IsValid())
+		{
+			LOG_MQTTIFY(Error, TEXT("Failed to open the session log %s"), *Path);
+			return false;
+		}
+		FileBytes = Bytes.Num();
+		return true;
+	}
+} // namespace Mqttify
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Mqtt/MqttifyMessage.h"
+
+class IFileHandle;
+
+namespace Mqttify
+{
+	/**
+	 * @brief Log on disk of the outbound QoS 1 and 2 publishes that are not acknowledged yet, so they can be sent
+	 * again after the process restarts.
+	 *
+	 * The log is append only. A record is written when a publish is made, when its PUBREC arrives and when it is
+	 * done with, each record carrying a CRC so a write torn by a crash is detected and ignored on load. Records are
+	 * buffered in memory and written with a single flush to disk on Commit, which the client calls once per tick
+	 * before anything is sent, so a publish never reaches the broker before it is durable. Once most of the file
+	 * is records of finished publishes it is compacted, the live records are written to a new file which then
+	 * replaces the log.
+	 *
+	 * The store is thread safe.
+	 */
+	class FMqttifySessionStore final
+	{
+	public:
+		/// @brief A publish read back from the log.
+		struct FStoredPublish
+		{
+			uint16 PacketId = 0;
+			FMqttifyMessage Message;
+			/// @brief True if the PUBREC was received, the publish only waits for its PUBCOMP.
+			bool bIsReleased = false;
+		};
+
+		/// @brief Size of the log below which it is never compacted.
+		static constexpr int64 kMinCompactionBytes = 1024 * 1024;
+
+		/**
+		 * @brief Open the log, reading back the publishes it holds and compacting it.
+		 * @param InPath The path of the log file.
+		 * @param OutRecovered Receives the publishes of the log, in the order they were made.
+		 * @return The store, or nullptr if the log could not be opened for writing.
+		 */
+		static TSharedPtr<FMqttifySessionStore> Open(const FString& InPath, TArray<FStoredPublish>& OutRecovered);
+
+		/**
+		 * @brief Read the publishes of a log without opening it for writing.
+		 * @param InPath The path of the log file.
+		 * @param OutRecovered Receives the publishes of the log, in the order they were made.
+		 * @return False if the file exists but is not a session log.
+		 */
+		static bool Read(const FString& InPath, TArray<FStoredPublish>& OutRecovered);
+
+		~FMqttifySessionStore();
+
+		FMqttifySessionStore(const FMqttifySessionStore&) = delete;
+		FMqttifySessionStore& operator=(const FMqttifySessionStore&) = delete;
+
+		/**
+		 * @brief Log a publish. It is durable once Commit returns.
+		 * @param InPacketId The packet identifier of the publish.
+		 * @param InMessage The message.
+		 */
+		void AddPublish(uint16 InPacketId, const FMqttifyMessage& InMessage);
+
+		/**
+		 * @brief Log the PUBREC of a QoS 2 publish.
+		 * @param InPacketId The packet identifier of the publish, ignored if the publish is not in the log.
+		 */
+		void Release(uint16 InPacketId);
+
+		/**
+		 * @brief Log that a publish is done with, acknowledged or failed.
+		 * @param InPacketId The packet identifier of the publish, ignored if the publish is not in the log.
+		 */
+		void Remove(uint16 InPacketId);
+
+		/// @brief Write the records logged since the last commit and flush them to disk, compacting if worthwhile.
+		void Commit();
+
+		/// @return The number of publishes in the log.
+		int32 Num() const;
+
+		/// @return The size of the log file, including records not committed yet.
+		int64 GetFileSize() const;
+
+	private:
+		explicit FMqttifySessionStore(const FString& InPath);
+
+		/// @brief A publish that is not done with.
+		struct FLivePublish
+		{
+			/// @brief The encoded publish record.
+			TArray<uint8> Record;
+			uint64 Sequence = 0;
+			bool bIsReleased = false;
+		};
+
+		/**
+		 * @brief Replay the records of a log file, stopping at the first record that is torn or corrupt.
+		 * @param InPath The path of the log file.
+		 * @param OutLive Receives the publishes that are not done with.
+		 * @param OutNextSequence Receives the sequence number for the next publish.
+		 * @return False if the file exists but is not a session log.
+		 */
+		static bool ReadLive(const FString& InPath, TMap<uint16, FLivePublish>& OutLive, uint64& OutNextSequence);
+
+		/// @brief Decode live publishes, in the order they were made.
+		static void GetStoredPublishes(const TMap<uint16, FLivePublish>& InLive, TArray<FStoredPublish>& OutPublishes);
+
+		/// @brief Write the live publishes to a new file that replaces the log, then reopen it for appending.
+		bool RewriteLocked();
+
+		void CommitLocked();
+
+		FString Path;
+		TUniquePtr<IFileHandle> File;
+
+		/// @brief Records logged since the last commit.
+		TArray<uint8> PendingWrites;
+		TMap<uint16, FLivePublish> LivePublishes;
+		uint64 NextSequence = 0;
+		/// @brief Bytes in the file.
+		int64 FileBytes = 0;
+		/// @brief Bytes the live publishes would take in a compacted file.
+		int64 LiveBytes = 0;
+
+		mutable FCriticalSection CriticalSection;
+	};
+} // namespace Mqttify
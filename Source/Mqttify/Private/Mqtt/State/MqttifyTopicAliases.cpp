@@ -0,0 +1,201 @@
+#include "Mqtt/State/MqttifyTopicAliases.h"
+
+#include "LogMqttify.h"
+#include "Mqtt/MqttifyTopicTable.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Serialization/MqttifyFArchiveEncodeDecode.h"
+
+namespace Mqttify
+{
+	void FMqttifyOutboundTopicAliases::Reset(const uint16 InTopicAliasMaximum)
+	{
+		FScopeLock Lock{&CriticalSection};
+		if (NumAliasMappings > 0)
+		{
+			LOG_MQTTIFY(
+				Verbose,
+				TEXT("[Topic Aliases] %lld mappings, %lld hits, %lld bytes saved"),
+				NumAliasMappings,
+				NumAliasHits,
+				BytesSaved);
+		}
+
+		TopicAliasMaximum = InTopicAliasMaximum;
+		AliasByTopic.Empty(InTopicAliasMaximum);
+		Topics.Init(FString{}, InTopicAliasMaximum + 1);
+		Prev.Init(0, InTopicAliasMaximum + 1);
+		Next.Init(0, InTopicAliasMaximum + 1);
+		Head = 0;
+		Tail = 0;
+	}
+
+	uint16 FMqttifyOutboundTopicAliases::Assign(const FString& InTopic, bool& bOutIsNew)
+	{
+		bOutIsNew = false;
+
+		FScopeLock Lock{&CriticalSection};
+		if (TopicAliasMaximum == 0)
+		{
+			return 0;
+		}
+
+		const int32 TopicLength = Data::Utf8Length(InTopic);
+		if (const uint16* Existing = AliasByTopic.Find(InTopic))
+		{
+			const uint16 Alias = *Existing;
+			if (Head != Alias)
+			{
+				UnlinkLocked(Alias);
+				LinkFrontLocked(Alias);
+			}
+			++NumAliasHits;
+			BytesSaved += TopicLength - kAliasPropertySize;
+			return Alias;
+		}
+
+		uint16 Alias = static_cast<uint16>(AliasByTopic.Num() + 1);
+		if (Alias > TopicAliasMaximum)
+		{
+			// Every alias is taken, remap the least recently used one
+			Alias = Tail;
+			UnlinkLocked(Alias);
+			AliasByTopic.Remove(Topics[Alias]);
+		}
+
+		Topics[Alias] = InTopic;
+		AliasByTopic.Add(InTopic, Alias);
+		LinkFrontLocked(Alias);
+		++NumAliasMappings;
+		BytesSaved -= kAliasPropertySize;
+		bOutIsNew = true;
+		return Alias;
+	}
+
+	uint16 FMqttifyOutboundTopicAliases::GetTopicAliasMaximum() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return TopicAliasMaximum;
+	}
+
+	int64 FMqttifyOutboundTopicAliases::GetNumAliasHits() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return NumAliasHits;
+	}
+
+	int64 FMqttifyOutboundTopicAliases::GetNumAliasMappings() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return NumAliasMappings;
+	}
+
+	int64 FMqttifyOutboundTopicAliases::GetBytesSaved() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return BytesSaved;
+	}
+
+	void FMqttifyOutboundTopicAliases::LinkFrontLocked(const uint16 InAlias)
+	{
+		Prev[InAlias] = 0;
+		Next[InAlias] = Head;
+		if (Head != 0)
+		{
+			Prev[Head] = InAlias;
+		}
+		Head = InAlias;
+		if (Tail == 0)
+		{
+			Tail = InAlias;
+		}
+	}
+
+	void FMqttifyOutboundTopicAliases::UnlinkLocked(const uint16 InAlias)
+	{
+		if (Prev[InAlias] != 0)
+		{
+			Next[Prev[InAlias]] = Next[InAlias];
+		}
+		else
+		{
+			Head = Next[InAlias];
+		}
+
+		if (Next[InAlias] != 0)
+		{
+			Prev[Next[InAlias]] = Prev[InAlias];
+		}
+		else
+		{
+			Tail = Prev[InAlias];
+		}
+	}
+
+	void FMqttifyInboundTopicAliases::Reset(const uint16 InTopicAliasMaximum)
+	{
+		FScopeLock Lock{&CriticalSection};
+		TopicAliasMaximum = InTopicAliasMaximum;
+		Topics.Init(FMqttifyTopicHandle{}, InTopicAliasMaximum + 1);
+		TopicNames.Init(FString{}, InTopicAliasMaximum + 1);
+	}
+
+	EMqttifyReasonCode FMqttifyInboundTopicAliases::Resolve(FMqttifyPublishPacketBase& InPacket)
+	{
+		const uint16 Alias = InPacket.GetTopicAlias();
+		if (Alias == 0)
+		{
+			if (!InPacket.HasTopicName())
+			{
+				LOG_MQTTIFY(Error, TEXT("[Topic Aliases] Publish has neither a topic name nor a topic alias"));
+				return EMqttifyReasonCode::ProtocolError;
+			}
+			return EMqttifyReasonCode::Success;
+		}
+
+		FScopeLock Lock{&CriticalSection};
+		if (Alias > TopicAliasMaximum)
+		{
+			LOG_MQTTIFY(
+				Error,
+				TEXT("[Topic Aliases] Alias %d exceeds the Topic Alias Maximum %d"),
+				Alias,
+				TopicAliasMaximum);
+			return EMqttifyReasonCode::TopicAliasInvalid;
+		}
+
+		if (InPacket.HasTopicName())
+		{
+			FMqttifyTopicHandle Topic = InPacket.GetTopicHandle();
+			if (!Topic.IsValid())
+			{
+				// The topic table was full when the packet was decoded
+				Topic = FMqttifyTopicTable::Get().Intern(InPacket.GetTopicName());
+			}
+			Topics[Alias] = Topic;
+			// Still full, keep the name so the alias goes on routing
+			TopicNames[Alias] = Topic.IsValid() ? FString{} : InPacket.GetTopicName();
+			return EMqttifyReasonCode::Success;
+		}
+
+		if (Topics[Alias].IsValid())
+		{
+			InPacket.SetTopicHandle(Topics[Alias]);
+			return EMqttifyReasonCode::Success;
+		}
+
+		if (!TopicNames[Alias].IsEmpty())
+		{
+			InPacket.SetTopicName(TopicNames[Alias]);
+			return EMqttifyReasonCode::Success;
+		}
+
+		LOG_MQTTIFY(Error, TEXT("[Topic Aliases] Alias %d is not mapped to a topic"), Alias);
+		return EMqttifyReasonCode::ProtocolError;
+	}
+
+	uint16 FMqttifyInboundTopicAliases::GetTopicAliasMaximum() const
+	{
+		FScopeLock Lock{&CriticalSection};
+		return TopicAliasMaximum;
+	}
+} // namespace Mqttify
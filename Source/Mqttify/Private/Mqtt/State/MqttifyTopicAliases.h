@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Mqtt/MqttifyReasonCode.h"
+#include "Mqtt/MqttifyTopicHandle.h"
+
+namespace Mqttify
+{
+	struct FMqttifyPublishPacketBase;
+
+	/**
+	 * @brief Topic aliases the client sends to the broker, one table per connection.
+	 *
+	 * Aliases run from 1 to the TopicAliasMaximum the broker sent in its CONNACK. Topics are keyed on their name
+	 * and kept with the table, not in the process wide topic table, so they go with the connection. The lookup is
+	 * case sensitive like the topic name itself. Once every alias is taken the least recently used one is remapped,
+	 * the recency list is threaded through the alias slots, 0 being the end of the list.
+	 */
+	class FMqttifyOutboundTopicAliases final
+	{
+	public:
+		/// @brief Encoded size of a TopicAlias property, the identifier byte and the two byte alias.
+		static constexpr int32 kAliasPropertySize = 3;
+
+		/**
+		 * @brief Forget every alias and set the number the broker accepts. Called for each new connection.
+		 * @param InTopicAliasMaximum The TopicAliasMaximum from the CONNACK, 0 disables aliases.
+		 */
+		void Reset(uint16 InTopicAliasMaximum);
+
+		/**
+		 * @brief Get the alias for a topic, mapping it to a free or the least recently used alias if it has none.
+		 * @param InTopic The topic name.
+		 * @param bOutIsNew Set to true if the alias was mapped by this call, the topic name must then be sent with it.
+		 * @return The alias, 0 if aliases are disabled or the topic cannot be aliased.
+		 */
+		uint16 Assign(const FString& InTopic, bool& bOutIsNew);
+
+		/// @return The TopicAliasMaximum of the broker.
+		uint16 GetTopicAliasMaximum() const;
+
+		/// @return The number of publishes sent with an alias in place of the topic name.
+		int64 GetNumAliasHits() const;
+
+		/// @return The number of times a topic was mapped to an alias.
+		int64 GetNumAliasMappings() const;
+
+		/// @return The bytes saved by sending aliases in place of topic names, less the cost of the alias properties.
+		int64 GetBytesSaved() const;
+
+	private:
+		/// @brief Topic names are case sensitive, unlike the default FString keys.
+		struct FCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, uint16, false>
+		{
+			static bool Matches(KeyInitType A, KeyInitType B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+			static uint32 GetKeyHash(KeyInitType Key) { return FCrc::StrCrc32(*Key); }
+		};
+
+		void LinkFrontLocked(uint16 InAlias);
+		void UnlinkLocked(uint16 InAlias);
+
+		/// @brief Alias of each mapped topic.
+		TMap<FString, uint16, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> AliasByTopic;
+		/// @brief Topic of each alias, indexed by alias.
+		TArray<FString> Topics;
+		TArray<uint16> Prev;
+		TArray<uint16> Next;
+		uint16 Head = 0;
+		uint16 Tail = 0;
+		uint16 TopicAliasMaximum = 0;
+
+		int64 NumAliasHits = 0;
+		int64 NumAliasMappings = 0;
+		int64 BytesSaved = 0;
+
+		mutable FCriticalSection CriticalSection;
+	};
+
+	/**
+	 * @brief Topic aliases the broker sends to the client, one table per connection.
+	 *
+	 * Aliases run from 1 to the TopicAliasMaximum the client advertised in its CONNECT and map to interned topics,
+	 * so a publish that arrives with only an alias is routed without touching the topic name. An alias whose topic
+	 * the full topic table could not intern keeps the topic name instead.
+	 */
+	class FMqttifyInboundTopicAliases final
+	{
+	public:
+		/**
+		 * @brief Forget every alias and set the number the client accepts. Called for each new connection.
+		 * @param InTopicAliasMaximum The TopicAliasMaximum sent in the CONNECT, 0 disables aliases.
+		 */
+		void Reset(uint16 InTopicAliasMaximum);
+
+		/**
+		 * @brief Resolve the topic alias of a received publish. A publish with a topic name maps its alias to the
+		 * topic, a publish with an empty topic name takes the topic its alias maps to.
+		 * @param InPacket The publish packet.
+		 * @return Success, TopicAliasInvalid if the alias is out of range, or ProtocolError if an empty topic name
+		 * comes without an alias or with one that maps to nothing. The client disconnects with the reason code.
+		 */
+		EMqttifyReasonCode Resolve(FMqttifyPublishPacketBase& InPacket);
+
+		/// @return The TopicAliasMaximum advertised to the broker.
+		uint16 GetTopicAliasMaximum() const;
+
+	private:
+		/// @brief Topic of each alias, indexed by alias.
+		TArray<FMqttifyTopicHandle> Topics;
+		/// @brief Topic name of each alias whose topic is not interned, indexed by alias.
+		TArray<FString> TopicNames;
+		uint16 TopicAliasMaximum = 0;
+
+		mutable FCriticalSection CriticalSection;
+	};
+} // namespace Mqttify
@@ -0,0 +1,51 @@
+#include "Packets/Interface/IMqttifyControlPacket.h"
+
+#include "Serialization/MqttifyPacketWriter.h"
+
+namespace Mqttify
+{
+	void IMqttifyControlPacket::EncodeTo(FMqttifyPacketWriter& InWriter)
+	{
+		FMemoryWriter Writer{InWriter.GetBuffer(), false, true};
+		Writer.SetByteSwapping(true);
+		Encode(Writer);
+		if (Writer.IsError())
+		{
+			InWriter.SetError();
+		}
+	}
+
+	uint32 IMqttifyControlPacket::GetEncodedLength() const
+	{
+		const uint32 RemainingLength = GetLength();
+		return sizeof(uint8) + Data::VariableByteIntegerSize(RemainingLength) + RemainingLength;
+	}
+
+	void IMqttifyControlPacket::EncodeWithPacketWriter(FMemoryWriter& InWriter)
+	{
+		TArray<uint8> Bytes;
+		FMqttifyPacketWriter Writer{Bytes, static_cast<int32>(GetEncodedLength())};
+		EncodeTo(Writer);
+		if (Writer.IsError())
+		{
+			InWriter.SetError();
+			return;
+		}
+		InWriter.Serialize(Bytes.GetData(), Bytes.Num());
+	}
+
+	bool EncodePacket(IMqttifyControlPacket& InPacket, TArray<uint8>& OutBuffer)
+	{
+		const int32 Start = OutBuffer.Num();
+		FMqttifyPacketWriter Writer{OutBuffer, static_cast<int32>(InPacket.GetEncodedLength())};
+		InPacket.EncodeTo(Writer);
+		if (Writer.IsError())
+		{
+			// Never leave a partly written packet behind, it would corrupt the stream
+			LOG_MQTTIFY(Error, TEXT("Failed to encode %s"), EnumToTCharString(InPacket.GetPacketType()));
+			OutBuffer.SetNum(Start, EAllowShrinking::No);
+			return false;
+		}
+		return true;
+	}
+} // namespace Mqttify
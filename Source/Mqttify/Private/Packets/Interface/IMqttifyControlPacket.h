@@ -6,6 +6,8 @@
 
 namespace Mqttify
 {
+	class FMqttifyPacketWriter;
+
 	class IMqttifyControlPacket : public ISerializable
 	{
 	public:
@@ -41,7 +43,36 @@ namespace Mqttify
 		virtual uint16 GetPacketId() const { return 0; }
 
 		virtual bool IsValid() const = 0;
+
+		/**
+		 * @brief Encode the packet straight into a byte buffer.
+		 *
+		 * The default implementation goes through Encode(FMemoryWriter&). Packets on the hot path
+		 * override it to write with direct stores and implement Encode in terms of it instead.
+		 *
+		 * @param InWriter The writer to encode to.
+		 */
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter);
+
+		/**
+		 * @brief Gets the size of the whole packet on the wire.
+		 * @return The fixed header, remaining length field and remaining length in bytes.
+		 */
+		uint32 GetEncodedLength() const;
+
+	protected:
+		/**
+		 * @brief Implements Encode(FMemoryWriter&) for packets that override EncodeTo.
+		 * @param InWriter The FMemoryWriter to encode to.
+		 */
+		void EncodeWithPacketWriter(FMemoryWriter& InWriter);
 	};
 
-	using FMqttifyPacketPtr = TUniquePtr<IMqttifyControlPacket>;
+	/**
+	 * @brief Encode a packet, growing the buffer once to the exact encoded size.
+	 * @param InPacket The packet to encode.
+	 * @param OutBuffer The buffer to append the packet to. Left as it was if the packet cannot be encoded.
+	 * @return True if the packet was encoded.
+	 */
+	bool EncodePacket(IMqttifyControlPacket& InPacket, TArray<uint8>& OutBuffer);
 } // namespace Mqttify
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "MqttifyConstants.h"
+#include "Mqtt/MqttifyReasonCode.h"
+#include "Packets/MqttifyPacketType.h"
+
+namespace Mqttify
+{
+	/**
+	 * @brief The wire bytes of an acknowledgement or PINGREQ.
+	 * These packets have a fixed layout, so they are written straight into a small inline buffer
+	 * instead of going through a packet object.
+	 */
+	struct FMqttifyEncodedAck
+	{
+		/// @brief Fixed header, remaining length, packet identifier and an optional MQTT 5 reason code.
+		static constexpr int32 kMaxSize = 5;
+
+		uint8 Bytes[kMaxSize];
+		int32 Num = 0;
+
+		const uint8* GetData() const { return Bytes; }
+	};
+
+	/**
+	 * @brief Encode PUBACK, PUBREC, PUBREL, PUBCOMP or PINGREQ.
+	 * The reason code is only written for MQTT 5 when it is not Success, with the property length omitted
+	 * as allowed by the specification.
+	 * @param InPacketType The packet type to encode.
+	 * @param InPacketId The packet identifier, ignored for PINGREQ.
+	 * @param InReasonCode The MQTT 5 reason code.
+	 * @return The encoded packet.
+	 */
+	inline FMqttifyEncodedAck EncodeAck(const EMqttifyPacketType InPacketType,
+										const uint16 InPacketId = 0,
+										const EMqttifyReasonCode InReasonCode = EMqttifyReasonCode::Success)
+	{
+		FMqttifyEncodedAck Ack;
+		switch (InPacketType)
+		{
+			case EMqttifyPacketType::PingReq:
+				Ack.Bytes[0] = static_cast<uint8>(EMqttifyPacketType::PingReq) << 4;
+				Ack.Bytes[1] = 0;
+				Ack.Num = 2;
+				return Ack;
+			case EMqttifyPacketType::PubRel:
+				// PUBREL has the reserved flags 0010
+				Ack.Bytes[0] = static_cast<uint8>(EMqttifyPacketType::PubRel) << 4 | 0x02;
+				break;
+			case EMqttifyPacketType::PubAck:
+			case EMqttifyPacketType::PubRec:
+			case EMqttifyPacketType::PubComp:
+				Ack.Bytes[0] = static_cast<uint8>(InPacketType) << 4;
+				break;
+			default:
+				checkNoEntry();
+				return Ack;
+		}
+
+		const bool bHasReasonCode = GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5
+			&& InReasonCode != EMqttifyReasonCode::Success;
+		Ack.Bytes[1] = bHasReasonCode ? 3 : 2;
+		Ack.Bytes[2] = static_cast<uint8>(InPacketId >> 8);
+		Ack.Bytes[3] = static_cast<uint8>(InPacketId);
+		Ack.Num = 4;
+		if (bHasReasonCode)
+		{
+			Ack.Bytes[Ack.Num++] = static_cast<uint8>(InReasonCode);
+		}
+		return Ack;
+	}
+} // namespace Mqttify
@@ -12,12 +12,12 @@ namespace Mqttify
 		constexpr uint32 VariableHeaderLength = 10;
 		uint32 PayloadLength = 0;
 
-		PayloadLength += StringLengthFieldSize + ClientId.Len();
+		PayloadLength += StringLengthFieldSize + Data::Utf8Length(ClientId);
 		PayloadLength += WillTopic.IsEmpty()
 			? 0
-			: StringLengthFieldSize + WillTopic.Len() + StringLengthFieldSize + WillMessage.Len();
-		PayloadLength += Username.IsEmpty() ? 0 : StringLengthFieldSize + Username.Len();
-		PayloadLength += Password.IsEmpty() ? 0 : StringLengthFieldSize + Password.Len();
+			: StringLengthFieldSize + Data::Utf8Length(WillTopic) + StringLengthFieldSize + Data::Utf8Length(WillMessage);
+		PayloadLength += Username.IsEmpty() ? 0 : StringLengthFieldSize + Data::Utf8Length(Username);
+		PayloadLength += Password.IsEmpty() ? 0 : StringLengthFieldSize + Data::Utf8Length(Password);
 
 		return VariableHeaderLength + PayloadLength;
 	}
@@ -203,12 +203,12 @@ namespace Mqttify
 		constexpr uint32 VariableHeaderLength = 10;
 		uint32 PayloadLength = 0;
 
-		PayloadLength += StringLengthFieldSize + ClientId.Len();
+		PayloadLength += StringLengthFieldSize + Data::Utf8Length(ClientId);
 		PayloadLength += WillTopic.IsEmpty()
 			? 0
-			: StringLengthFieldSize + WillTopic.Len() + StringLengthFieldSize + WillMessage.Len();
-		PayloadLength += Username.IsEmpty() ? 0 : StringLengthFieldSize + Username.Len();
-		PayloadLength += Password.IsEmpty() ? 0 : StringLengthFieldSize + Password.Len();
+			: StringLengthFieldSize + Data::Utf8Length(WillTopic) + StringLengthFieldSize + Data::Utf8Length(WillMessage);
+		PayloadLength += Username.IsEmpty() ? 0 : StringLengthFieldSize + Data::Utf8Length(Username);
+		PayloadLength += Password.IsEmpty() ? 0 : StringLengthFieldSize + Data::Utf8Length(Password);
 		PayloadLength += Properties.GetLength();
 
 		if (!WillTopic.IsEmpty())
@@ -5,6 +5,7 @@
 #include "Packets/Interface/IMqttifyControlPacket.h"
 #include "Serialization/ArrayReader.h"
 #include "Serialization/MqttifyFArchiveEncodeDecode.h"
+#include "Serialization/MqttifyPacketWriter.h"
 #include "Serialization/Interface/ISerializable.h"
 
 #include <bitset>
@@ -112,6 +113,12 @@ namespace Mqttify
 		virtual void Encode(FMemoryWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
+		/**
+		 * @brief Encode the fixed header with direct stores.
+		 * @param InWriter The writer to encode to.
+		 */
+		void EncodeTo(FMqttifyPacketWriter& InWriter) const;
+
 		static constexpr TCHAR InvalidPacketSize[] = TEXT("Invalid packet size");
 		static constexpr TCHAR InvalidRemainingLength[] = TEXT("Invalid Remaining Length.");
 	};
@@ -163,6 +170,12 @@ namespace Mqttify
 		Data::EncodeVariableByteInteger(RemainingLength, InWriter);
 	}
 
+	FORCEINLINE void FMqttifyFixedHeader::EncodeTo(FMqttifyPacketWriter& InWriter) const
+	{
+		InWriter.WriteUInt8(Flags);
+		InWriter.WriteVariableByteInteger(RemainingLength);
+	}
+
 	FORCEINLINE void FMqttifyFixedHeader::Decode(FArrayReader& InReader)
 	{
 		InReader.SetByteSwapping(true);
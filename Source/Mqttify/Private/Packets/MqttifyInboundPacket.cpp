@@ -0,0 +1,67 @@
+#include "Packets/MqttifyInboundPacket.h"
+
+#include "LogMqttify.h"
+#include "Serialization/ArrayReader.h"
+
+namespace Mqttify
+{
+	bool FMqttifyInboundPacket::Decode(FArrayReader& InReader)
+	{
+		Packet = nullptr;
+
+		const FMqttifyFixedHeader FixedHeader = FMqttifyFixedHeader::Create(InReader);
+		switch (FixedHeader.GetPacketType())
+		{
+			case EMqttifyPacketType::ConnAck:
+				Emplace<TMqttifyConnAckPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::Publish:
+				Emplace<TMqttifyPublishPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::PubAck:
+				Emplace<TMqttifyPubAckPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::PubRec:
+				Emplace<TMqttifyPubRecPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::PubRel:
+				Emplace<TMqttifyPubRelPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::PubComp:
+				Emplace<TMqttifyPubCompPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::SubAck:
+				Emplace<TMqttifySubAckPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::UnsubAck:
+				Emplace<TMqttifyUnsubAckPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::PingResp:
+				Emplace<FMqttifyPingRespPacket>(FixedHeader);
+				return true;
+			case EMqttifyPacketType::Disconnect:
+				Emplace<TMqttifyDisconnectPacket<GMqttifyProtocol>>(InReader, FixedHeader);
+				return true;
+			case EMqttifyPacketType::Auth:
+				if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+				{
+					Emplace<FMqttifyAuthPacket>(InReader, FixedHeader);
+					return true;
+				}
+			// Connect, Subscribe, Unsubscribe and PingReq are only ever sent by clients
+			case EMqttifyPacketType::Connect:
+			case EMqttifyPacketType::Subscribe:
+			case EMqttifyPacketType::Unsubscribe:
+			case EMqttifyPacketType::PingReq:
+			case EMqttifyPacketType::Max:
+			case EMqttifyPacketType::None:
+			default:
+				LOG_MQTTIFY(
+					Error,
+					TEXT("Unexpected packet type: %s, for protocol: %s"),
+					EnumToTCharString(FixedHeader.GetPacketType()),
+					EnumToTCharString(GMqttifyProtocol));
+				return false;
+		}
+	}
+} // namespace Mqttify
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Misc/TVariant.h"
+#include "Packets/MqttifyAuthPacket.h"
+#include "Packets/MqttifyConnAckPacket.h"
+#include "Packets/MqttifyDisconnectPacket.h"
+#include "Packets/MqttifyPingRespPacket.h"
+#include "Packets/MqttifyPubAckPacket.h"
+#include "Packets/MqttifyPubCompPacket.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Packets/MqttifyPubRecPacket.h"
+#include "Packets/MqttifyPubRelPacket.h"
+#include "Packets/MqttifySubAckPacket.h"
+#include "Packets/MqttifyUnsubAckPacket.h"
+
+class FArrayReader;
+
+namespace Mqttify
+{
+	/**
+	 * @brief Holds a decoded packet received from the broker.
+	 *
+	 * The packet is constructed in place inside the object, so decoding into a stack instance
+	 * does not touch the heap for packets without variable length data, such as acknowledgements
+	 * and PINGRESP. Only packets a broker may send to a client can be decoded.
+	 */
+	class FMqttifyInboundPacket final
+	{
+	public:
+		FMqttifyInboundPacket() = default;
+
+		FMqttifyInboundPacket(const FMqttifyInboundPacket&) = delete;
+		FMqttifyInboundPacket& operator=(const FMqttifyInboundPacket&) = delete;
+
+		/**
+		 * @brief Decode a packet, replacing any packet held before.
+		 * @param InReader The reader positioned at the start of the fixed header.
+		 * @return True if the packet type can be received by a client. The packet itself may still be malformed,
+		 * check IsValid on the decoded packet.
+		 */
+		bool Decode(FArrayReader& InReader);
+
+		/// @return True if a packet has been decoded.
+		bool IsSet() const { return Packet != nullptr; }
+
+		/// @return The decoded packet.
+		IMqttifyControlPacket& Get() const
+		{
+			check(Packet != nullptr);
+			return *Packet;
+		}
+
+		IMqttifyControlPacket* operator->() const { return &Get(); }
+
+		/**
+		 * @brief Access the decoded packet as its concrete type.
+		 * @tparam TPacket The packet type, it must match the decoded packet type.
+		 * @return The decoded packet.
+		 */
+		template <typename TPacket>
+		TPacket& As() const
+		{
+			return static_cast<TPacket&>(Get());
+		}
+
+	private:
+		template <typename TPacket, typename... TArgs>
+		void Emplace(TArgs&&... InArgs)
+		{
+			Storage.template Emplace<TPacket>(Forward<TArgs>(InArgs)...);
+			Packet = &Storage.template Get<TPacket>();
+		}
+
+		TVariant<
+			FEmptyVariantState,
+			TMqttifyConnAckPacket<GMqttifyProtocol>,
+			TMqttifyPublishPacket<GMqttifyProtocol>,
+			TMqttifyPubAckPacket<GMqttifyProtocol>,
+			TMqttifyPubRecPacket<GMqttifyProtocol>,
+			TMqttifyPubRelPacket<GMqttifyProtocol>,
+			TMqttifyPubCompPacket<GMqttifyProtocol>,
+			TMqttifySubAckPacket<GMqttifyProtocol>,
+			TMqttifyUnsubAckPacket<GMqttifyProtocol>,
+			FMqttifyPingRespPacket,
+			TMqttifyDisconnectPacket<GMqttifyProtocol>,
+			FMqttifyAuthPacket> Storage;
+
+		IMqttifyControlPacket* Packet = nullptr;
+	};
+} // namespace Mqttify
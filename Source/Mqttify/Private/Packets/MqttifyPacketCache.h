@@ -1,63 +1,191 @@
 #pragma once
-#include "Interface/IMqttifyControlPacket.h"
+
+#include "CoreMinimal.h"
 
 namespace Mqttify
 {
+	using FMqttifyEncodedPacketRef = TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>;
+	using FMqttifyEncodedPacketPtr = TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>;
+
+	/**
+	 * @brief Keeps the encoded bytes of in-flight publishes so retransmissions do not encode them again.
+	 *
+	 * Entries are keyed by packet identifier and evicted least recently used first once the total size
+	 * goes over the byte budget. All operations are O(1), the recency list is threaded through the map
+	 * entries by packet identifier, 0 being the end of the list.
+	 */
 	class FMqttifyPacketCache final
 	{
 	public:
-		explicit FMqttifyPacketCache(const int32 InMaxSize = 1024)
-			: MaxSize(InMaxSize) {}
+		/// @brief Default byte budget for the encoded packets.
+		static constexpr int64 kDefaultMaxBytes = 16 * 1024 * 1024;
+
+		explicit FMqttifyPacketCache(const int64 InMaxBytes = kDefaultMaxBytes)
+			: MaxBytes{InMaxBytes} {}
 
-		void AddPacket(const int32 PacketId, const TSharedRef<IMqttifyControlPacket>& Packet)
+		/**
+		 * @brief Add or replace the encoded bytes for a packet identifier and mark them most recently used.
+		 * Packets larger than the whole budget are not cached.
+		 * @param InPacketId The packet identifier.
+		 * @param InBytes The encoded packet.
+		 * @return True if the bytes were cached.
+		 */
+		bool Add(const uint16 InPacketId, const FMqttifyEncodedPacketRef& InBytes)
 		{
-			FWriteScopeLock WriteLock(RWLock);
+			FScopeLock Lock{&CriticalSection};
+			RemoveLocked(InPacketId);
+
+			const int64 Size = InBytes->Num();
+			if (InPacketId == 0 || Size > MaxBytes)
+			{
+				return false;
+			}
 
-			if (MaxSize > 0 && PacketOrder.Num() >= MaxSize)
+			while (NumBytes + Size > MaxBytes && Tail != 0)
 			{
-				const int32 EvictId = PacketOrder[0];
-				PacketOrder.RemoveAt(0);
-				PacketMap.Remove(EvictId);
+				RemoveLocked(Tail);
 			}
 
-			PacketMap.Add(PacketId, Packet);
-			PacketOrder.Add(PacketId);
+			FEntry& Entry = Entries.Add(InPacketId, FEntry{InBytes});
+			NumBytes += Size;
+			LinkFrontLocked(InPacketId, Entry);
+			return true;
 		}
 
-		bool RemovePacket(const int32 PacketId)
+		/**
+		 * @brief Find the encoded bytes for a packet identifier and mark them most recently used.
+		 * @param InPacketId The packet identifier.
+		 * @return The encoded packet, or nullptr if it is not cached.
+		 */
+		FMqttifyEncodedPacketPtr Find(const uint16 InPacketId)
 		{
-			FWriteScopeLock WriteLock(RWLock);
+			FScopeLock Lock{&CriticalSection};
+			FEntry* Entry = Entries.Find(InPacketId);
+			if (Entry == nullptr)
+			{
+				return nullptr;
+			}
 
-			const int32 Removed = PacketMap.Remove(PacketId);
-			PacketOrder.Remove(PacketId);
+			if (Head != InPacketId)
+			{
+				UnlinkLocked(*Entry);
+				LinkFrontLocked(InPacketId, *Entry);
+			}
+			return Entry->Bytes;
+		}
 
-			return Removed > 0;
+		/**
+		 * @brief Remove the encoded bytes for a packet identifier.
+		 * @param InPacketId The packet identifier.
+		 * @return True if an entry was removed.
+		 */
+		bool Remove(const uint16 InPacketId)
+		{
+			FScopeLock Lock{&CriticalSection};
+			return RemoveLocked(InPacketId);
 		}
 
-		TSharedPtr<IMqttifyControlPacket> GetPacket(const int32 PacketId) const
+		/// @brief Remove every entry.
+		void Empty()
 		{
-			FReadScopeLock ReadLock(RWLock);
+			FScopeLock Lock{&CriticalSection};
+			Entries.Empty();
+			Head = 0;
+			Tail = 0;
+			NumBytes = 0;
+		}
 
-			return PacketMap.FindRef(PacketId);
+		/// @return The number of cached packets.
+		int32 Num() const
+		{
+			FScopeLock Lock{&CriticalSection};
+			return Entries.Num();
 		}
 
-		TSharedPtr<IMqttifyControlPacket> GetAndRemovePacket(const int32 PacketId)
+		/// @return The total size of the cached packets.
+		int64 GetNumBytes() const
 		{
-			FWriteScopeLock WriteLock(RWLock);
+			FScopeLock Lock{&CriticalSection};
+			return NumBytes;
+		}
 
-			TSharedPtr<IMqttifyControlPacket> Packet = PacketMap.FindRef(PacketId);
-			if (Packet.IsValid())
+		/**
+		 * @brief Mark an encoded PUBLISH as a duplicate by setting the DUP bit of its fixed header.
+		 * @param InBytes The encoded packet.
+		 */
+		static void SetDuplicateFlag(TArray<uint8>& InBytes)
+		{
+			if (InBytes.Num() > 0)
 			{
-				PacketMap.Remove(PacketId);
-				PacketOrder.Remove(PacketId);
+				InBytes[0] |= kDuplicateFlag;
 			}
-			return Packet;
 		}
 
 	private:
-		TMap<int32, TSharedRef<IMqttifyControlPacket>> PacketMap;
-		TArray<int32> PacketOrder;
-		int32 MaxSize;
-		mutable FRWLock RWLock;
+		static constexpr uint8 kDuplicateFlag = 0x08;
+
+		struct FEntry
+		{
+			FMqttifyEncodedPacketRef Bytes;
+			uint16 Prev = 0;
+			uint16 Next = 0;
+		};
+
+		void LinkFrontLocked(const uint16 InPacketId, FEntry& InEntry)
+		{
+			InEntry.Prev = 0;
+			InEntry.Next = Head;
+			if (Head != 0)
+			{
+				Entries[Head].Prev = InPacketId;
+			}
+			Head = InPacketId;
+			if (Tail == 0)
+			{
+				Tail = InPacketId;
+			}
+		}
+
+		void UnlinkLocked(const FEntry& InEntry)
+		{
+			if (InEntry.Prev != 0)
+			{
+				Entries[InEntry.Prev].Next = InEntry.Next;
+			}
+			else
+			{
+				Head = InEntry.Next;
+			}
+
+			if (InEntry.Next != 0)
+			{
+				Entries[InEntry.Next].Prev = InEntry.Prev;
+			}
+			else
+			{
+				Tail = InEntry.Prev;
+			}
+		}
+
+		bool RemoveLocked(const uint16 InPacketId)
+		{
+			const FEntry* Entry = Entries.Find(InPacketId);
+			if (Entry == nullptr)
+			{
+				return false;
+			}
+
+			UnlinkLocked(*Entry);
+			NumBytes -= Entry->Bytes->Num();
+			Entries.Remove(InPacketId);
+			return true;
+		}
+
+		TMap<uint16, FEntry> Entries;
+		uint16 Head = 0;
+		uint16 Tail = 0;
+		int64 NumBytes = 0;
+		const int64 MaxBytes;
+		mutable FCriticalSection CriticalSection;
 	};
-} // namespace Mqttify
\ No newline at end of file
+} // namespace Mqttify
@@ -3,10 +3,14 @@
 namespace Mqttify
 {
 	void FMqttifyPingReqPacket::Encode(FMemoryWriter& InWriter)
+	{
+		EncodeWithPacketWriter(InWriter);
+	}
+
+	void FMqttifyPingReqPacket::EncodeTo(FMqttifyPacketWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PingReq]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
+		FixedHeader.EncodeTo(InWriter);
 	}
 
 	void FMqttifyPingReqPacket::Decode(FArrayReader& InReader)
@@ -17,6 +17,7 @@ namespace Mqttify
 		}
 
 		virtual void Encode(FMemoryWriter& InWriter) override;
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 		virtual uint32 GetLength() const override { return 0; }
 	};
@@ -5,9 +5,14 @@ namespace Mqttify
 #pragma region MQTT 3.1.1
 	void TMqttifyPubCompPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Encode(FMemoryWriter& InWriter)
 	{
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
-		InWriter << PacketIdentifier;
+		EncodeWithPacketWriter(InWriter);
+	}
+
+	void TMqttifyPubCompPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::EncodeTo(FMqttifyPacketWriter& InWriter)
+	{
+		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubComp]"));
+		FixedHeader.EncodeTo(InWriter);
+		InWriter.WriteUInt16(PacketIdentifier);
 	}
 
 	void TMqttifyPubCompPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Decode(FArrayReader& InReader)
@@ -44,17 +49,19 @@ namespace Mqttify
 
 	void TMqttifyPubCompPacket<EMqttifyProtocolVersion::Mqtt_5>::Encode(FMemoryWriter& InWriter)
 	{
-		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubComp]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
+		EncodeWithPacketWriter(InWriter);
+	}
 
-		InWriter << PacketIdentifier;
+	void TMqttifyPubCompPacket<EMqttifyProtocolVersion::Mqtt_5>::EncodeTo(FMqttifyPacketWriter& InWriter)
+	{
+		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubComp]"));
+		FixedHeader.EncodeTo(InWriter);
+		InWriter.WriteUInt16(PacketIdentifier);
 
 		if (ReasonCode != EMqttifyReasonCode::Success)
 		{
-			uint8 RawReasonCode = static_cast<uint8>(ReasonCode);
-			InWriter << RawReasonCode;
-			Properties.Encode(InWriter);
+			InWriter.WriteUInt8(static_cast<uint8>(ReasonCode));
+			InWriter.WriteSerializable(Properties);
 		}
 	}
 
@@ -49,6 +49,7 @@ namespace Mqttify
 
 		virtual uint32 GetLength() const override { return sizeof(PacketIdentifier); }
 		virtual void Encode(FMemoryWriter& InWriter) override;
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 	};
 
@@ -76,6 +77,7 @@ namespace Mqttify
 		virtual uint32 GetLength() const override;
 
 		virtual void Encode(FMemoryWriter& InWriter) override;
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
 		/**
@@ -4,11 +4,15 @@ namespace Mqttify
 {
 #pragma region MQTT 3.1.1
 	void TMqttifyPubRelPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Encode(FMemoryWriter& InWriter)
+	{
+		EncodeWithPacketWriter(InWriter);
+	}
+
+	void TMqttifyPubRelPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::EncodeTo(FMqttifyPacketWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubRel]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
-		InWriter << PacketIdentifier;
+		FixedHeader.EncodeTo(InWriter);
+		InWriter.WriteUInt16(PacketIdentifier);
 	}
 
 	void TMqttifyPubRelPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Decode(FArrayReader& InReader)
@@ -46,17 +50,19 @@ namespace Mqttify
 
 	void TMqttifyPubRelPacket<EMqttifyProtocolVersion::Mqtt_5>::Encode(FMemoryWriter& InWriter)
 	{
-		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubRel]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
+		EncodeWithPacketWriter(InWriter);
+	}
 
-		InWriter << PacketIdentifier;
+	void TMqttifyPubRelPacket<EMqttifyProtocolVersion::Mqtt_5>::EncodeTo(FMqttifyPacketWriter& InWriter)
+	{
+		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][PubRel]"));
+		FixedHeader.EncodeTo(InWriter);
+		InWriter.WriteUInt16(PacketIdentifier);
 
 		if (ReasonCode != EMqttifyReasonCode::Success)
 		{
-			uint8 RawReasonCode = static_cast<uint8>(ReasonCode);
-			InWriter << RawReasonCode;
-			Properties.Encode(InWriter);
+			InWriter.WriteUInt8(static_cast<uint8>(ReasonCode));
+			InWriter.WriteSerializable(Properties);
 		}
 	}
 
@@ -1,7 +1,98 @@
 #include "Packets/MqttifyPublishPacket.h"
 
+#include "Mqtt/MqttifyTopicTable.h"
+
 namespace Mqttify
 {
+	namespace
+	{
+		uint32 GetMessageTopicNameLength(const FMqttifyMessage& InMessage)
+		{
+			if (InMessage.GetTopicHandle().IsValid())
+			{
+				return FMqttifyTopicTable::Get().ResolveUtf8(InMessage.GetTopicHandle()).Num();
+			}
+			return Data::Utf8Length(InMessage.GetTopic());
+		}
+
+		uint32 GetPacketSizeFromRemainingLength(const uint32 InRemainingLength)
+		{
+			return sizeof(uint8) + Data::VariableByteIntegerSize(InRemainingLength) + InRemainingLength;
+		}
+	} // namespace
+
+	uint32 FMqttifyPublishPacketBase::GetTopicNameLength() const
+	{
+		if (bOmitTopicName)
+		{
+			return 0;
+		}
+		if (TopicHandle.IsValid())
+		{
+			return FMqttifyTopicTable::Get().ResolveUtf8(TopicHandle).Num();
+		}
+		return Data::Utf8Length(TopicName);
+	}
+
+	void FMqttifyPublishPacketBase::EncodeTopicName(FMqttifyPacketWriter& InWriter) const
+	{
+		if (bOmitTopicName)
+		{
+			InWriter.WriteUInt16(0);
+		}
+		else if (TopicHandle.IsValid())
+		{
+			InWriter.WriteUtf8(FMqttifyTopicTable::Get().ResolveUtf8(TopicHandle));
+		}
+		else
+		{
+			InWriter.WriteString(TopicName);
+		}
+	}
+
+	int32 FMqttifyPublishPacketBase::DecodeTopicName(FArrayReader& InReader)
+	{
+		uint16 Length = 0;
+		InReader << Length;
+		const int64 Offset = InReader.Tell();
+		if (InReader.IsError() || Offset + Length > InReader.TotalSize())
+		{
+			LOG_MQTTIFY(Error, TEXT("[Publish] Topic name exceeds packet size"));
+			InReader.SetError();
+			bIsValid = false;
+			return 0;
+		}
+
+		TopicName.Reset();
+		if (Length == 0)
+		{
+			// The topic travels as a topic alias
+			TopicHandle = FMqttifyTopicHandle{};
+			return StringLengthFieldSize;
+		}
+
+		// Checked before interning, a malformed topic must not reach the table
+		if (!Data::IsWellFormedUtf8(InReader.GetData() + Offset, Length))
+		{
+			LOG_MQTTIFY(Error, TEXT("[Publish] Topic name: %s"), Data::InvalidUtf8String);
+			InReader.SetError();
+			bIsValid = false;
+			return 0;
+		}
+
+		// Intern straight from the packet buffer so a repeated topic costs no allocation
+		TopicHandle = FMqttifyTopicTable::Get().Intern(
+			reinterpret_cast<const UTF8CHAR*>(InReader.GetData() + Offset),
+			Length);
+		if (!TopicHandle.IsValid())
+		{
+			// The table is full, fall back to an owned string
+			Data::Utf8ToString(InReader.GetData() + Offset, Length, TopicName);
+		}
+		InReader.Seek(Offset + Length);
+		return StringLengthFieldSize + Length;
+	}
+
 #pragma region MQTT 3.1.1
 	uint32 TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::GetLength(
 		const uint32 InTopicNameLength,
@@ -20,22 +111,37 @@ namespace Mqttify
 
 	uint32 TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::GetLength() const
 	{
-		return GetLength(TopicName.Len(), Payload.Num(), GetQualityOfService());
+		return GetLength(GetTopicNameLength(), Payload.Num(), GetQualityOfService());
+	}
+
+	uint32 TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::GetPacketSize(
+		const FMqttifyMessage& InMessage,
+		bool /* bInMayUseTopicAlias */)
+	{
+		return GetPacketSizeFromRemainingLength(
+			GetLength(
+				GetMessageTopicNameLength(InMessage),
+				InMessage.GetPayload().Num(),
+				InMessage.GetQualityOfService()));
 	}
 
 	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Encode(FMemoryWriter& InWriter)
+	{
+		EncodeWithPacketWriter(InWriter);
+	}
+
+	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::EncodeTo(FMqttifyPacketWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Publish]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
+		FixedHeader.EncodeTo(InWriter);
 
-		Data::EncodeString(TopicName, InWriter);
+		EncodeTopicName(InWriter);
 		if (static_cast<uint8>(GetQualityOfService()) > static_cast<uint8>(EMqttifyQualityOfService::AtMostOnce))
 		{
-			InWriter << PacketIdentifier;
+			InWriter.WriteUInt16(PacketIdentifier);
 		}
 
-		Data::EncodePayload(Payload, InWriter);
+		InWriter.WriteBytes(Payload.GetData(), Payload.Num());
 	}
 
 	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Decode(FArrayReader& InReader)
@@ -53,9 +159,7 @@ namespace Mqttify
 		}
 
 		int32 PayloadSize = FixedHeader.GetRemainingLength();
-		PayloadSize -= 2; // Topic length size field
-		TopicName = Data::DecodeString(InReader);
-		PayloadSize -= TopicName.Len();
+		PayloadSize -= DecodeTopicName(InReader);
 
 		if (static_cast<uint8>(GetQualityOfService()) > static_cast<uint8>(EMqttifyQualityOfService::AtMostOnce))
 		{
@@ -63,6 +167,13 @@ namespace Mqttify
 			PayloadSize -= 2;
 		}
 
+		if (PayloadSize < 0)
+		{
+			LOG_MQTTIFY(Error, TEXT("[Publish] %s"), Data::PayloadExceedsArchive);
+			bIsValid = false;
+			return;
+		}
+
 		Payload = Data::DecodePayload(InReader, PayloadSize);
 	}
 #pragma endregion MQTT 3.1.1
@@ -87,23 +198,73 @@ namespace Mqttify
 
 	uint32 TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::GetLength() const
 	{
-		return GetLength(TopicName.Len(), Payload.Num(), Properties.GetLength(), GetQualityOfService());
+		return GetLength(GetTopicNameLength(), Payload.Num(), Properties.GetLength(), GetQualityOfService());
+	}
+
+	uint32 TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::GetPacketSize(
+		const FMqttifyMessage& InMessage,
+		const bool bInMayUseTopicAlias)
+	{
+		// The publish that maps an alias carries the TopicAlias property on top of the full topic name
+		TArray<FMqttifyProperty> AliasProperties;
+		if (bInMayUseTopicAlias)
+		{
+			AliasProperties.Add(FMqttifyProperty::Create<EMqttifyPropertyIdentifier::TopicAlias>(static_cast<uint16>(1)));
+		}
+		return GetPacketSizeFromRemainingLength(
+			GetLength(
+				GetMessageTopicNameLength(InMessage),
+				InMessage.GetPayload().Num(),
+				FMqttifyProperties{AliasProperties}.GetLength(),
+				InMessage.GetQualityOfService()));
+	}
+
+	bool TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::SetTopicAlias(const uint16 InTopicAlias,
+	                                                                          const bool bInOmitTopicName)
+	{
+		TArray<FMqttifyProperty> NewProperties;
+		for (const FMqttifyProperty& Property : Properties.GetProperties())
+		{
+			if (Property.GetIdentifier() != EMqttifyPropertyIdentifier::TopicAlias)
+			{
+				NewProperties.Add(Property);
+			}
+		}
+		if (InTopicAlias != 0)
+		{
+			NewProperties.Add(FMqttifyProperty::Create<EMqttifyPropertyIdentifier::TopicAlias>(InTopicAlias));
+		}
+
+		Properties = FMqttifyProperties{NewProperties};
+		TopicAlias = InTopicAlias;
+		bOmitTopicName = InTopicAlias != 0 && bInOmitTopicName;
+		FixedHeader = FMqttifyFixedHeader::Create(
+			this,
+			GetLength(),
+			GetShouldRetain(),
+			GetQualityOfService(),
+			GetIsDuplicate());
+		return true;
 	}
 
 	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::Encode(FMemoryWriter& InWriter)
+	{
+		EncodeWithPacketWriter(InWriter);
+	}
+
+	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::EncodeTo(FMqttifyPacketWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Publish]"));
-		InWriter.SetByteSwapping(true);
-		FixedHeader.Encode(InWriter);
+		FixedHeader.EncodeTo(InWriter);
 
-		Data::EncodeString(TopicName, InWriter);
+		EncodeTopicName(InWriter);
 		if (static_cast<uint8>(GetQualityOfService()) > static_cast<uint8>(EMqttifyQualityOfService::AtMostOnce))
 		{
-			InWriter << PacketIdentifier;
+			InWriter.WriteUInt16(PacketIdentifier);
 		}
 
-		Properties.Encode(InWriter);
-		Data::EncodePayload(Payload, InWriter);
+		InWriter.WriteSerializable(Properties);
+		InWriter.WriteBytes(Payload.GetData(), Payload.Num());
 	}
 
 	void TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>::Decode(FArrayReader& InReader)
@@ -121,9 +282,7 @@ namespace Mqttify
 		}
 
 		int32 PayloadSize = FixedHeader.GetRemainingLength();
-		PayloadSize -= 2; // Topic length size field
-		TopicName = Data::DecodeString(InReader);
-		PayloadSize -= TopicName.Len();
+		PayloadSize -= DecodeTopicName(InReader);
 
 		if (static_cast<uint8>(GetQualityOfService()) > static_cast<uint8>(EMqttifyQualityOfService::AtMostOnce))
 		{
@@ -133,6 +292,20 @@ namespace Mqttify
 
 		Properties.Decode(InReader);
 		PayloadSize -= Properties.GetLength();
+		for (const FMqttifyProperty& Property : Properties.GetProperties())
+		{
+			if (Property.GetIdentifier() == EMqttifyPropertyIdentifier::TopicAlias)
+			{
+				Property.TryGetValue(TopicAlias);
+			}
+		}
+
+		if (PayloadSize < 0)
+		{
+			LOG_MQTTIFY(Error, TEXT("[Publish] %s"), Data::PayloadExceedsArchive);
+			bIsValid = false;
+			return;
+		}
 
 		Payload = Data::DecodePayload(InReader, PayloadSize);
 	}
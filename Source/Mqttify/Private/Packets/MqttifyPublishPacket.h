@@ -25,6 +25,18 @@ namespace Mqttify
 			, PacketIdentifier{InPacketIdentifier}
 			, Payload{MoveTemp(InPayload)} {}
 
+		/**
+		 * @brief Take the topic and payload out of a message. A message on an interned topic keeps its handle, the
+		 * topic is encoded from the interned UTF-8 without building a string.
+		 * @param InMessage The message.
+		 * @param InPacketIdentifier The packet identifier.
+		 */
+		explicit FMqttifyPublishPacketBase(FMqttifyMessage& InMessage, const uint16 InPacketIdentifier)
+			: TopicName{InMessage.TopicHandle.IsValid() ? FString{} : MoveTemp(InMessage.Topic)}
+			, TopicHandle{InMessage.TopicHandle}
+			, PacketIdentifier{InPacketIdentifier}
+			, Payload{MoveTemp(InMessage.Payload)} {}
+
 	public:
 		/**
 		 * @brief Get the is duplicate flag.
@@ -55,7 +67,40 @@ namespace Mqttify
 		 * @brief Get the topic name.
 		 * @return The topic name.
 		 */
-		const FString& GetTopicName() const { return TopicName; }
+		const FString& GetTopicName() const { return TopicHandle.IsValid() ? TopicHandle.ToString() : TopicName; }
+
+		/**
+		 * @brief Get the interned topic name.
+		 * @return The topic handle, valid for decoded packets and for messages published on an interned topic.
+		 */
+		FMqttifyTopicHandle GetTopicHandle() const { return TopicHandle; }
+
+		/**
+		 * @brief Check if the packet carries a topic name. MQTT 5 publishes may send a topic alias in its place.
+		 * @return True if the topic name is not empty.
+		 */
+		bool HasTopicName() const { return TopicHandle.IsValid() || !TopicName.IsEmpty(); }
+
+		/**
+		 * @brief Set the topic of a received packet, used when the topic name travelled as an alias.
+		 * @param InTopicHandle The interned topic.
+		 */
+		void SetTopicHandle(const FMqttifyTopicHandle InTopicHandle)
+		{
+			TopicName.Reset();
+			TopicHandle = InTopicHandle;
+		}
+
+		/**
+		 * @brief Set the topic of a received packet by name, used when the topic name travelled as an alias to a
+		 * topic the full topic table could not intern.
+		 * @param InTopicName The topic name.
+		 */
+		void SetTopicName(const FString& InTopicName)
+		{
+			TopicName = InTopicName;
+			TopicHandle = FMqttifyTopicHandle{};
+		}
 
 		/**
 		 * @brief Get the packet identifier.
@@ -69,20 +114,75 @@ namespace Mqttify
 		 */
 		const TArray<uint8>& GetPayload() const { return Payload; }
 
-		static FMqttifyMessage ToMqttifyMessage(TUniquePtr<FMqttifyPublishPacketBase>&& InPacket)
+		/**
+		 * @brief Set the topic alias sent with the packet. Only MQTT 5 has topic aliases.
+		 * @param InTopicAlias The alias, 0 to send the packet without one.
+		 * @param bInOmitTopicName True to send an empty topic name, the broker already maps the alias to the topic.
+		 * @return True if the packet takes the alias.
+		 */
+		virtual bool SetTopicAlias(const uint16 InTopicAlias, const bool bInOmitTopicName) { return false; }
+
+		/**
+		 * @brief Get the topic alias sent with the packet.
+		 * @return The topic alias, 0 if there is none.
+		 */
+		uint16 GetTopicAlias() const { return TopicAlias; }
+
+		/**
+		 * @brief Convert a received packet to a message, moving the topic and payload out of the packet. A message on
+		 * an interned topic keeps its handle and a copy of the name, which Blueprints read from the Topic property.
+		 * @param InPacket The packet to convert.
+		 * @return The message.
+		 */
+		static FMqttifyMessage ToMqttifyMessage(FMqttifyPublishPacketBase&& InPacket)
 		{
+			if (InPacket.TopicHandle.IsValid())
+			{
+				FMqttifyMessage Message{
+					InPacket.TopicHandle,
+					MoveTemp(InPacket.Payload),
+					InPacket.GetShouldRetain(),
+					InPacket.GetQualityOfService()
+				};
+				Message.Topic = InPacket.TopicHandle.ToString();
+				return Message;
+			}
+
 			return FMqttifyMessage{
-				MoveTemp(InPacket->TopicName),
-				MoveTemp(InPacket->Payload),
-				InPacket->GetShouldRetain(),
-				InPacket->GetQualityOfService()
+				MoveTemp(InPacket.TopicName),
+				MoveTemp(InPacket.Payload),
+				InPacket.GetShouldRetain(),
+				InPacket.GetQualityOfService()
 			};
 		}
 
 	protected:
+		/**
+		 * @brief Get the encoded length of the topic name, excluding the length field.
+		 * @return The length of the topic name.
+		 */
+		uint32 GetTopicNameLength() const;
+
+		/**
+		 * @brief Encode the topic name, using the interned bytes when the packet has a topic handle.
+		 * @param InWriter The writer to encode to.
+		 */
+		void EncodeTopicName(FMqttifyPacketWriter& InWriter) const;
+
+		/**
+		 * @brief Decode the topic name straight from the reader's buffer into the topic table.
+		 * @param InReader The reader to decode from.
+		 * @return The number of bytes consumed, including the length field.
+		 */
+		int32 DecodeTopicName(FArrayReader& InReader);
+
 		FString TopicName;
+		FMqttifyTopicHandle TopicHandle;
 		uint16 PacketIdentifier;
 		TArray<uint8> Payload;
+		uint16 TopicAlias = 0;
+		/// @brief True to encode an empty topic name, the topic travels as the alias.
+		bool bOmitTopicName = false;
 
 		// The protected token allows only members or friends to call MakeShared.
 		struct FPrivateToken
@@ -105,10 +205,10 @@ namespace Mqttify
 		}
 
 		explicit TMqttifyPublishPacket(FMqttifyMessage&& InMessage, const uint16 InPacketIdentifier)
-			: FMqttifyPublishPacketBase{MoveTemp(InMessage.Payload), MoveTemp(InMessage.Topic), InPacketIdentifier}
+			: FMqttifyPublishPacketBase{InMessage, InPacketIdentifier}
 		{
 			const uint32 PayloadSize = GetLength(
-				GetTopicName().Len(),
+				GetTopicNameLength(),
 				GetPayload().Num(),
 				InMessage.GetQualityOfService());
 
@@ -125,7 +225,17 @@ namespace Mqttify
 			uint32 InPayloadLength,
 			EMqttifyQualityOfService InQualityOfService);
 		virtual uint32 GetLength() const override;
+
+		/**
+		 * @brief Get the size a message takes on the wire once sent as a publish, without encoding it.
+		 * @param InMessage The message.
+		 * @param bInMayUseTopicAlias Unused, MQTT 3.1.1 has no topic aliases.
+		 * @return The size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(const FMqttifyMessage& InMessage, bool bInMayUseTopicAlias = false);
+
 		virtual void Encode(FMemoryWriter& InWriter) override;
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
 		/**
@@ -157,7 +267,7 @@ namespace Mqttify
 			const bool bInIsDuplicate)
 			: FMqttifyPublishPacketBase{MoveTemp(InPayload), MoveTemp(InTopicName), InPacketIdentifier}
 		{
-			const uint32 PayloadSize = GetLength(TopicName.Len(), Payload.Num(), InQualityOfService);
+			const uint32 PayloadSize = GetLength(GetTopicNameLength(), Payload.Num(), InQualityOfService);
 			FixedHeader = FMqttifyFixedHeader::Create(
 				this,
 				PayloadSize,
@@ -181,11 +291,11 @@ namespace Mqttify
 			FMqttifyMessage&& InMessage,
 			const uint16 InPacketIdentifier,
 			const FMqttifyProperties& InProperties = FMqttifyProperties{})
-			: FMqttifyPublishPacketBase{MoveTemp(InMessage.Payload), MoveTemp(InMessage.Topic), InPacketIdentifier}
+			: FMqttifyPublishPacketBase{InMessage, InPacketIdentifier}
 			, Properties{InProperties}
 		{
 			const uint32 PayloadSize = GetLength(
-				GetTopicName().Len(),
+				GetTopicNameLength(),
 				GetPayload().Num(),
 				InProperties.GetLength(),
 				InMessage.GetQualityOfService());
@@ -204,7 +314,18 @@ namespace Mqttify
 			EMqttifyQualityOfService InQualityOfService);
 		virtual uint32 GetLength() const override;
 
+		/**
+		 * @brief Get the size a message takes on the wire once sent as a publish, without encoding it.
+		 * The topic name is counted in full. The publish that maps a topic alias sends the full topic name and
+		 * the TopicAlias property, so the property is counted when the publish may carry an alias.
+		 * @param InMessage The message.
+		 * @param bInMayUseTopicAlias True if the broker accepts topic aliases.
+		 * @return The largest size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(const FMqttifyMessage& InMessage, bool bInMayUseTopicAlias = false);
+
 		virtual void Encode(FMemoryWriter& InWriter) override;
+		virtual void EncodeTo(FMqttifyPacketWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
 		/**
@@ -213,6 +334,8 @@ namespace Mqttify
 		 */
 		const FMqttifyProperties& GetProperties() const { return Properties; }
 
+		virtual bool SetTopicAlias(uint16 InTopicAlias, bool bInOmitTopicName) override;
+
 		/**
 		 * @brief Get a duplicate of the packet. Used when QoS > 0
 		 * and we need to resend the packet.
@@ -246,7 +369,7 @@ namespace Mqttify
 			, Properties{MoveTemp(InProperties)}
 		{
 			const uint32 PayloadSize = GetLength(
-				TopicName.Len(),
+				GetTopicNameLength(),
 				Payload.Num(),
 				Properties.GetLength(),
 				InQualityOfService);
@@ -11,12 +11,19 @@ uint32 Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Ge
 
 	for (auto TopicFilter : TopicFilters)
 	{
-		Length += TopicFilter.GetFilter().Len() + StringLengthFieldSize + sizeof(EMqttifyQualityOfService);
+		Length += GetTopicFilterLength(TopicFilter);
 	}
 
 	return Length;
 }
 
+uint32 Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::GetPacketSize(
+	const uint32 InTopicFiltersLength)
+{
+	const uint32 RemainingLength = sizeof(uint16) + InTopicFiltersLength;
+	return sizeof(uint8) + Data::VariableByteIntegerSize(RemainingLength) + RemainingLength;
+}
+
 void Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Encode(FMemoryWriter& InWriter)
 {
 	LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Subscribe]"));
@@ -66,7 +73,7 @@ void Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Deco
 			return;
 		}
 		ReaderPos = InReader.Tell();
-		PayloadSize -= TopicFilter.Len() + 3;
+		PayloadSize -= Data::Utf8Length(TopicFilter) + 3;
 
 		switch (QualityOfService)
 		{
@@ -95,7 +102,7 @@ uint32 Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::GetLen
 
 	for (auto TopicFilter : TopicFilters)
 	{
-		Length += TopicFilter.GetFilter().Len() + StringLengthFieldSize + 1; // 1 byte for Subscribe Options
+		Length += GetTopicFilterLength(TopicFilter);
 	}
 
 	Length += Properties.GetLength();
@@ -103,6 +110,14 @@ uint32 Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::GetLen
 	return Length;
 }
 
+uint32 Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::GetPacketSize(
+	const uint32 InTopicFiltersLength)
+{
+	// Packet identifier, then a single byte for the length of the empty properties
+	const uint32 RemainingLength = sizeof(uint16) + sizeof(uint8) + InTopicFiltersLength;
+	return sizeof(uint8) + Data::VariableByteIntegerSize(RemainingLength) + RemainingLength;
+}
+
 void Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::Encode(FMemoryWriter& InWriter)
 {
 	LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Subscribe]"));
@@ -161,7 +176,7 @@ void Mqttify::TMqttifySubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::Decode(F
 		}
 		ReaderPos = InReader.Tell();
 
-		PayloadSize -= TopicFilter.Len() + 3;
+		PayloadSize -= Data::Utf8Length(TopicFilter) + 3;
 		// 2 bytes to store the length of the topic filter utf8 string and 1 byte for Subscribe Options
 		const EMqttifyQualityOfService QualityOfService = static_cast<EMqttifyQualityOfService>(SubscribeOptions & 0x3);
 		const bool bIsNoLocal = (SubscribeOptions & 0x4) != 0;
@@ -56,6 +56,16 @@ namespace Mqttify
 		 */
 		virtual uint16 GetPacketId() const override { return PacketIdentifier; }
 
+		/**
+		 * @brief Get the bytes a topic filter takes in the payload of a subscribe, with its subscribe options.
+		 * @param InTopicFilter The topic filter.
+		 * @return The length in bytes.
+		 */
+		static uint32 GetTopicFilterLength(const FMqttifyTopicFilter& InTopicFilter)
+		{
+			return Data::Utf8Length(InTopicFilter.GetFilter()) + StringLengthFieldSize + sizeof(uint8);
+		}
+
 	protected:
 		uint16 PacketIdentifier;
 		TArray<FMqttifyTopicFilter> TopicFilters;
@@ -83,6 +93,13 @@ namespace Mqttify
 		virtual uint32 GetLength() const override;
 		virtual void Encode(FMemoryWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
+
+		/**
+		 * @brief Get the size of a subscribe without building it.
+		 * @param InTopicFiltersLength The summed GetTopicFilterLength of its topic filters.
+		 * @return The size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(uint32 InTopicFiltersLength);
 	};
 
 	template <>
@@ -109,6 +126,13 @@ namespace Mqttify
 		virtual void Encode(FMemoryWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
+		/**
+		 * @brief Get the size of a subscribe without properties without building it.
+		 * @param InTopicFiltersLength The summed GetTopicFilterLength of its topic filters.
+		 * @return The size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(uint32 InTopicFiltersLength);
+
 		/**
 		 * @brief Get the properties.
 		 * @return The properties.
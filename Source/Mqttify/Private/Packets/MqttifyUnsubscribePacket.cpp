@@ -11,12 +11,19 @@ namespace Mqttify
 
 		for (auto TopicFilter : TopicFilters)
 		{
-			Length += TopicFilter.GetFilter().Len() + StringLengthFieldSize;
+			Length += GetTopicFilterLength(TopicFilter);
 		}
 
 		return Length;
 	}
 
+	uint32 TMqttifyUnsubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::GetPacketSize(
+		const uint32 InTopicFiltersLength)
+	{
+		const uint32 RemainingLength = sizeof(uint16) + InTopicFiltersLength;
+		return sizeof(uint8) + Data::VariableByteIntegerSize(RemainingLength) + RemainingLength;
+	}
+
 	void TMqttifyUnsubscribePacket<EMqttifyProtocolVersion::Mqtt_3_1_1>::Encode(FMemoryWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Unsubscribe]"));
@@ -63,7 +70,7 @@ namespace Mqttify
 			}
 			ReaderPos = InReader.Tell();
 			TopicFilters.Add(FMqttifyTopicFilter{TopicFilter});
-			PayloadSize -= TopicFilter.Len() + StringLengthFieldSize;
+			PayloadSize -= Data::Utf8Length(TopicFilter) + StringLengthFieldSize;
 		}
 	}
 #pragma endregion MQTT 3.1.1
@@ -77,7 +84,7 @@ namespace Mqttify
 
 		for (auto TopicFilter : TopicFilters)
 		{
-			Length += TopicFilter.GetFilter().Len() + StringLengthFieldSize;
+			Length += GetTopicFilterLength(TopicFilter);
 		}
 
 		Length += Properties.GetLength();
@@ -85,6 +92,13 @@ namespace Mqttify
 		return Length;
 	}
 
+	uint32 TMqttifyUnsubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::GetPacketSize(const uint32 InTopicFiltersLength)
+	{
+		// Packet identifier, then a single byte for the length of the empty properties
+		const uint32 RemainingLength = sizeof(uint16) + sizeof(uint8) + InTopicFiltersLength;
+		return sizeof(uint8) + Data::VariableByteIntegerSize(RemainingLength) + RemainingLength;
+	}
+
 	void TMqttifyUnsubscribePacket<EMqttifyProtocolVersion::Mqtt_5>::Encode(FMemoryWriter& InWriter)
 	{
 		LOG_MQTTIFY(VeryVerbose, TEXT("[Encode][Unsubscribe]"));
@@ -132,7 +146,7 @@ namespace Mqttify
 			}
 			ReaderPos = InReader.Tell();
 			TopicFilters.Add(FMqttifyTopicFilter{TopicFilter});
-			PayloadSize -= TopicFilter.Len() + StringLengthFieldSize;
+			PayloadSize -= Data::Utf8Length(TopicFilter) + StringLengthFieldSize;
 		}
 	}
 
@@ -55,6 +55,16 @@ namespace Mqttify
 		 */
 		virtual uint16 GetPacketId() const override { return PacketIdentifier; }
 
+		/**
+		 * @brief Get the bytes a topic filter takes in the payload of an unsubscribe.
+		 * @param InTopicFilter The topic filter.
+		 * @return The length in bytes.
+		 */
+		static uint32 GetTopicFilterLength(const FMqttifyTopicFilter& InTopicFilter)
+		{
+			return Data::Utf8Length(InTopicFilter.GetFilter()) + StringLengthFieldSize;
+		}
+
 	protected:
 		uint16 PacketIdentifier;
 		TArray<FMqttifyTopicFilter> TopicFilters;
@@ -82,6 +92,13 @@ namespace Mqttify
 		virtual uint32 GetLength() const override;
 		virtual void Encode(FMemoryWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
+
+		/**
+		 * @brief Get the size of an unsubscribe without building it.
+		 * @param InTopicFiltersLength The summed GetTopicFilterLength of its topic filters.
+		 * @return The size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(uint32 InTopicFiltersLength);
 	};
 
 	template <>
@@ -108,6 +125,13 @@ namespace Mqttify
 		virtual void Encode(FMemoryWriter& InWriter) override;
 		virtual void Decode(FArrayReader& InReader) override;
 
+		/**
+		 * @brief Get the size of an unsubscribe without properties without building it.
+		 * @param InTopicFiltersLength The summed GetTopicFilterLength of its topic filters.
+		 * @return The size of the packet in bytes, including the fixed header.
+		 */
+		static uint32 GetPacketSize(uint32 InTopicFiltersLength);
+
 		/**
 		 * @brief Get the properties.
 		 * @return The properties.
@@ -200,10 +200,10 @@ namespace Mqttify
 			case EMqttifyPropertyIdentifier::ResponseInformation:
 			case EMqttifyPropertyIdentifier::ServerReference:
 			case EMqttifyPropertyIdentifier::ReasonString:
-				return sizeof(uint16) + Data.GetSubtype<FString>().Len() + 1;
+				return sizeof(uint16) + Data::Utf8Length(Data.GetSubtype<FString>()) + 1;
 			case EMqttifyPropertyIdentifier::UserProperty:
-				return sizeof(uint16) + Data.GetSubtype<TTuple<FString, FString>>().Key.Len() +
-					sizeof(uint16) + Data.GetSubtype<TTuple<FString, FString>>().Value.Len() + 1;
+				return sizeof(uint16) + Data::Utf8Length(Data.GetSubtype<TTuple<FString, FString>>().Key) +
+					sizeof(uint16) + Data::Utf8Length(Data.GetSubtype<TTuple<FString, FString>>().Value) + 1;
 			case EMqttifyPropertyIdentifier::Max:
 			case EMqttifyPropertyIdentifier::Unknown:
 			default:
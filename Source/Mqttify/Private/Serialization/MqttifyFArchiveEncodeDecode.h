@@ -11,6 +11,8 @@ namespace Mqttify::Data
 	constexpr TCHAR UnexpectedNullTerminator[] = TEXT("Unexpected null terminator");
 	constexpr TCHAR InvalidVariableByteInteger[] = TEXT("Invalid variable byte integer");
 	constexpr TCHAR PayloadLimitExceeded[] = TEXT("Payload length exceeds uint32 limit");
+	constexpr TCHAR PayloadExceedsArchive[] = TEXT("Payload length exceeds the remaining packet data");
+	constexpr TCHAR InvalidUtf8String[] = TEXT("String is not well formed UTF-8");
 
 
 	/**
@@ -91,6 +93,323 @@ namespace Mqttify::Data
 		while (InValue > 0);
 	}
 
+	/// @brief Maximum length in bytes of an MQTT UTF-8 encoded string.
+	constexpr int32 MaxStringLength = 65535;
+
+	/**
+	 * @brief Count the leading ASCII bytes of a buffer, testing eight bytes per step.
+	 * @param InData The buffer to scan.
+	 * @param InLength The length of the buffer in bytes.
+	 * @return The number of leading bytes below 0x80.
+	 */
+	inline int32 CountAsciiPrefix(const uint8* InData, const int32 InLength)
+	{
+		int32 Index = 0;
+		for (; Index + static_cast<int32>(sizeof(uint64)) <= InLength; Index += sizeof(uint64))
+		{
+			uint64 Word;
+			FMemory::Memcpy(&Word, InData + Index, sizeof(uint64));
+			if (Word & 0x8080808080808080ull)
+			{
+				break;
+			}
+		}
+		while (Index < InLength && InData[Index] < 0x80)
+		{
+			++Index;
+		}
+		return Index;
+	}
+
+	/**
+	 * @brief Check if a UTF-16 surrogate pair starts at the given index.
+	 * @param InChars The characters.
+	 * @param InIndex The index to check.
+	 * @param InNumChars The number of characters.
+	 * @return True if InChars[InIndex] and InChars[InIndex + 1] form a surrogate pair.
+	 */
+	inline bool IsSurrogatePair(const TCHAR* InChars, const int32 InIndex, const int32 InNumChars)
+	{
+		if constexpr (sizeof(TCHAR) != 2)
+		{
+			return false;
+		}
+		else
+		{
+			return InIndex + 1 < InNumChars
+				&& InChars[InIndex] >= 0xD800 && InChars[InIndex] <= 0xDBFF
+				&& InChars[InIndex + 1] >= 0xDC00 && InChars[InIndex + 1] <= 0xDFFF;
+		}
+	}
+
+	/**
+	 * @brief Get the number of bytes a string occupies when encoded as UTF-8.
+	 * @param InString The string to measure.
+	 * @return The UTF-8 length in bytes, excluding the length field.
+	 */
+	inline int32 Utf8Length(const FString& InString)
+	{
+		const TCHAR* Chars = *InString;
+		const int32 NumChars = InString.Len();
+		int32 Length = 0;
+		for (int32 Index = 0; Index < NumChars; ++Index)
+		{
+			const uint32 Char = static_cast<uint32>(Chars[Index]);
+			if (Char < 0x80)
+			{
+				Length += 1;
+			}
+			else if (Char < 0x800)
+			{
+				Length += 2;
+			}
+			else if (IsSurrogatePair(Chars, Index, NumChars))
+			{
+				// Surrogate pair, one four byte sequence
+				Length += 4;
+				++Index;
+			}
+			else if (Char < 0x10000)
+			{
+				Length += 3;
+			}
+			else
+			{
+				Length += 4;
+			}
+		}
+		return Length;
+	}
+
+	/**
+	 * @brief Decode one multi byte UTF-8 sequence, rejecting overlong forms, surrogates and out of range code points.
+	 * @param InData The start of the sequence.
+	 * @param InLength The number of bytes left from InData.
+	 * @param OutCodePoint The decoded code point.
+	 * @return The length of the sequence in bytes, 0 if it is malformed.
+	 */
+	inline int32 DecodeUtf8Sequence(const uint8* InData, const int32 InLength, uint32& OutCodePoint)
+	{
+		const uint8 Lead = InData[0];
+		uint32 CodePoint;
+		int32 SequenceLength;
+		uint32 MinCodePoint;
+		if ((Lead & 0xE0) == 0xC0)
+		{
+			CodePoint = Lead & 0x1F;
+			SequenceLength = 2;
+			MinCodePoint = 0x80;
+		}
+		else if ((Lead & 0xF0) == 0xE0)
+		{
+			CodePoint = Lead & 0x0F;
+			SequenceLength = 3;
+			MinCodePoint = 0x800;
+		}
+		else if ((Lead & 0xF8) == 0xF0)
+		{
+			CodePoint = Lead & 0x07;
+			SequenceLength = 4;
+			MinCodePoint = 0x10000;
+		}
+		else
+		{
+			return 0;
+		}
+
+		if (SequenceLength > InLength)
+		{
+			return 0;
+		}
+
+		bool bValidContinuation = true;
+		for (int32 Continuation = 1; Continuation < SequenceLength; ++Continuation)
+		{
+			const uint8 Byte = InData[Continuation];
+			bValidContinuation &= (Byte & 0xC0) == 0x80;
+			CodePoint = CodePoint << 6 | (Byte & 0x3F);
+		}
+
+		if (!bValidContinuation
+			|| CodePoint < MinCodePoint
+			|| CodePoint > 0x10FFFF
+			|| (CodePoint >= 0xD800 && CodePoint <= 0xDFFF))
+		{
+			return 0;
+		}
+
+		OutCodePoint = CodePoint;
+		return SequenceLength;
+	}
+
+	/**
+	 * @brief Check a UTF-8 span without transcoding it, with the same rules as Utf8ToString.
+	 * @param InData The UTF-8 bytes, not null terminated.
+	 * @param InLength The number of bytes.
+	 * @return True if the span is well formed UTF-8 without U+0000.
+	 */
+	inline bool IsWellFormedUtf8(const uint8* InData, const int32 InLength)
+	{
+		int32 Index = 0;
+		while (Index < InLength)
+		{
+			const int32 AsciiCount = CountAsciiPrefix(InData + Index, InLength - Index);
+			for (int32 Ascii = 0; Ascii < AsciiCount; ++Ascii)
+			{
+				if (InData[Index + Ascii] == 0)
+				{
+					return false;
+				}
+			}
+			Index += AsciiCount;
+			if (Index >= InLength)
+			{
+				break;
+			}
+
+			uint32 CodePoint;
+			const int32 SequenceLength = DecodeUtf8Sequence(InData + Index, InLength - Index, CodePoint);
+			if (SequenceLength == 0)
+			{
+				return false;
+			}
+			Index += SequenceLength;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Validate and transcode a UTF-8 span into a string in a single pass.
+	 * ASCII runs are detected a word at a time and widened directly, other sequences are decoded
+	 * and checked for overlong forms, surrogates and out of range code points. MQTT also forbids U+0000.
+	 * @param InData The UTF-8 bytes, not null terminated.
+	 * @param InLength The number of bytes.
+	 * @param OutString The decoded string.
+	 * @return True if the span was well formed UTF-8.
+	 */
+	inline bool Utf8ToString(const uint8* InData, const int32 InLength, FString& OutString)
+	{
+		// A UTF-8 sequence never produces more code units than it has bytes
+		TArray<TCHAR>& Chars = OutString.GetCharArray();
+		Chars.SetNumUninitialized(InLength + 1, EAllowShrinking::No);
+		TCHAR* Out = Chars.GetData();
+
+		int32 Index = 0;
+		bool bHasNull = false;
+		while (Index < InLength)
+		{
+			const int32 AsciiCount = CountAsciiPrefix(InData + Index, InLength - Index);
+			for (int32 Ascii = 0; Ascii < AsciiCount; ++Ascii)
+			{
+				const uint8 Byte = InData[Index + Ascii];
+				bHasNull |= Byte == 0;
+				*Out++ = static_cast<TCHAR>(Byte);
+			}
+			Index += AsciiCount;
+			if (Index >= InLength)
+			{
+				break;
+			}
+
+			uint32 CodePoint;
+			const int32 SequenceLength = DecodeUtf8Sequence(InData + Index, InLength - Index, CodePoint);
+			if (SequenceLength == 0)
+			{
+				break;
+			}
+
+			if constexpr (sizeof(TCHAR) == 2)
+			{
+				if (CodePoint >= 0x10000)
+				{
+					CodePoint -= 0x10000;
+					*Out++ = static_cast<TCHAR>(0xD800 + (CodePoint >> 10));
+					*Out++ = static_cast<TCHAR>(0xDC00 + (CodePoint & 0x3FF));
+				}
+				else
+				{
+					*Out++ = static_cast<TCHAR>(CodePoint);
+				}
+			}
+			else
+			{
+				*Out++ = static_cast<TCHAR>(CodePoint);
+			}
+			Index += SequenceLength;
+		}
+
+		const int32 NumChars = static_cast<int32>(Out - Chars.GetData());
+		*Out = TEXT('\0');
+		Chars.SetNum(NumChars + 1, EAllowShrinking::No);
+		if (NumChars == 0)
+		{
+			Chars.Reset();
+		}
+
+		// Embedded nulls would truncate the string, so treat them as malformed too
+		return Index == InLength && !bHasNull;
+	}
+
+	/**
+	 * @brief Transcode a string to UTF-8 in a single pass.
+	 * @param InString The string to encode.
+	 * @param OutData Receives the UTF-8 bytes, must hold at least Utf8Length(InString) bytes.
+	 */
+	inline void StringToUtf8(const FString& InString, uint8* OutData)
+	{
+		const TCHAR* Chars = *InString;
+		const int32 NumChars = InString.Len();
+		uint8* Out = OutData;
+
+		for (int32 Index = 0; Index < NumChars; ++Index)
+		{
+			uint32 CodePoint = static_cast<uint32>(Chars[Index]);
+			if (CodePoint < 0x80)
+			{
+				*Out++ = static_cast<uint8>(CodePoint);
+				continue;
+			}
+
+			if (IsSurrogatePair(Chars, Index, NumChars))
+			{
+				const uint32 Low = static_cast<uint32>(Chars[Index + 1]);
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+				++Index;
+			}
+
+			if (CodePoint < 0x800)
+			{
+				*Out++ = static_cast<uint8>(0xC0 | CodePoint >> 6);
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+			}
+			else if (CodePoint < 0x10000)
+			{
+				*Out++ = static_cast<uint8>(0xE0 | CodePoint >> 12);
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint >> 6 & 0x3F));
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+			}
+			else
+			{
+				*Out++ = static_cast<uint8>(0xF0 | CodePoint >> 18);
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint >> 12 & 0x3F));
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint >> 6 & 0x3F));
+				*Out++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+			}
+		}
+	}
+
+	/**
+	 * @brief Transcode a string to UTF-8 in a single pass.
+	 * @param InString The string to encode.
+	 * @param OutBytes Receives the UTF-8 bytes, sized exactly.
+	 */
+	template <typename TAllocator>
+	void StringToUtf8(const FString& InString, TArray<uint8, TAllocator>& OutBytes)
+	{
+		OutBytes.SetNumUninitialized(Utf8Length(InString));
+		StringToUtf8(InString, OutBytes.GetData());
+	}
+
 	/**
 	 * @brief Encode a string to an FArchive.
 	 * @param OutArchive FArchive object to serialize to.
@@ -99,15 +418,23 @@ namespace Mqttify::Data
 	inline void EncodeString(const FString& InString, FArchive& OutArchive)
 	{
 		UE_CLOG(!OutArchive.IsSaving(), LogMqttify, Error, ArchiveNotSaving);
-		uint16 StringLength = InString.Len();
-		UE_CLOG(StringLength > 65535, LogMqttify, Error, CharLimitExceeded);
-		const auto String = StringCast<UTF8CHAR>(*InString);
+		TArray<uint8, TInlineAllocator<256>> Utf8;
+		StringToUtf8(InString, Utf8);
+		if (Utf8.Num() > MaxStringLength)
+		{
+			LOG_MQTTIFY(Error, CharLimitExceeded);
+			OutArchive.SetError();
+			return;
+		}
+
+		uint16 StringLength = static_cast<uint16>(Utf8.Num());
 		OutArchive << StringLength;
-		OutArchive.Serialize(const_cast<void*>(static_cast<const void*>(String.Get())), StringLength);
+		OutArchive.Serialize(Utf8.GetData(), StringLength);
 	}
 
 	/**
-	 * @brief Decode a string from an FArchive.
+	 * @brief Decode a string from an FArchive. Malformed UTF-8 and U+0000 set the archive error, MQTT treats them as
+	 * a malformed packet.
 	 * @param InArchive FArchive object to deserialize from.
 	 * @return The decoded string.
 	 */
@@ -119,23 +446,24 @@ namespace Mqttify::Data
 		{
 			uint16 StringLength = 0;
 			InArchive << StringLength;
-			Result.Reserve(StringLength);
 
-			UTF8CHAR TempChar;
-			for (uint16 i = 0; i < StringLength; ++i)
+			const int64 Remaining = InArchive.TotalSize() - InArchive.Tell();
+			if (InArchive.IsError() || StringLength > Remaining)
 			{
-				const uint32 CurrentPosition = InArchive.Tell();
-				InArchive.Serialize(&TempChar, 1);
-				const TCHAR SafeChar = CharCast<TCHAR>(TempChar);
-				if (CurrentPosition == InArchive.Tell())
-				{
-					break;
-				}
-				Result.AppendChars(&SafeChar, 1);
+				LOG_MQTTIFY(Error, InvalidUtf8String);
+				InArchive.SetError();
+				return Result;
 			}
 
-			// Check the last char isn't a null terminator
-			UE_CLOG(Result.Right(1) == TEXT("\0"), LogMqttify, Error, UnexpectedNullTerminator);
+			TArray<uint8, TInlineAllocator<256>> Utf8;
+			Utf8.SetNumUninitialized(StringLength);
+			InArchive.Serialize(Utf8.GetData(), StringLength);
+
+			if (!Utf8ToString(Utf8.GetData(), StringLength, Result))
+			{
+				LOG_MQTTIFY(Error, InvalidUtf8String);
+				InArchive.SetError();
+			}
 		}
 
 		return Result;
@@ -149,17 +477,29 @@ namespace Mqttify::Data
 		OutArchive.Serialize(const_cast<void*>(static_cast<const void*>(InPayload.GetData())), PayloadSize);
 	}
 
+	/**
+	 * @brief Decode a payload from an FArchive with a single bulk read.
+	 * @param InArchive FArchive object to deserialize from.
+	 * @param PayloadSize The number of bytes to read.
+	 * @return The decoded payload, empty if the archive does not hold enough data.
+	 */
 	inline TArray<uint8> DecodePayload(FArchive& InArchive, const uint32 PayloadSize)
 	{
 		UE_CLOG(!InArchive.IsLoading(), LogMqttify, Error, ArchiveNotLoading);
 		TArray<uint8> Result;
 		if (InArchive.IsLoading())
 		{
-			Result.Init(0, PayloadSize);
-			for (uint32 Idx = 0; Idx < PayloadSize; ++Idx)
+			const int64 Remaining = InArchive.TotalSize() - InArchive.Tell();
+			if (InArchive.IsError() || static_cast<int64>(PayloadSize) > Remaining)
 			{
-				InArchive << Result[Idx];
+				LOG_MQTTIFY(Error, PayloadExceedsArchive);
+				InArchive.SetError();
+				return Result;
 			}
+
+			// No need to zero the buffer, every byte is overwritten by the read
+			Result.SetNumUninitialized(PayloadSize);
+			InArchive.Serialize(Result.GetData(), PayloadSize);
 		}
 
 		return Result;
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MqttifyFArchiveEncodeDecode.h"
+
+namespace Mqttify
+{
+	/**
+	 * @brief Writes MQTT wire data straight into a byte buffer.
+	 *
+	 * Unlike FMemoryWriter there is no virtual dispatch or byte swapping per field, integers are
+	 * stored big endian directly. Callers reserve the exact packet size up front so encoding a
+	 * packet grows the buffer at most once. A field that cannot be encoded, such as a string longer
+	 * than MQTT allows, is not written and puts the writer in error, the packet must not be sent.
+	 */
+	class FMqttifyPacketWriter final
+	{
+	public:
+		/**
+		 * @brief Create a writer that appends to a buffer.
+		 * @param InBuffer The buffer to append to.
+		 * @param InReserve The number of bytes that are about to be written.
+		 */
+		explicit FMqttifyPacketWriter(TArray<uint8>& InBuffer, const int32 InReserve = 0)
+			: Buffer{InBuffer}
+		{
+			Buffer.Reserve(Buffer.Num() + InReserve);
+		}
+
+		FMqttifyPacketWriter(const FMqttifyPacketWriter&) = delete;
+		FMqttifyPacketWriter& operator=(const FMqttifyPacketWriter&) = delete;
+
+		/// @brief Write a single byte.
+		FORCEINLINE void WriteUInt8(const uint8 InValue)
+		{
+			Buffer.Add(InValue);
+		}
+
+		/// @brief Write a two byte integer in network byte order.
+		FORCEINLINE void WriteUInt16(const uint16 InValue)
+		{
+			uint8* Out = Grow(sizeof(uint16));
+			Out[0] = static_cast<uint8>(InValue >> 8);
+			Out[1] = static_cast<uint8>(InValue);
+		}
+
+		/// @brief Write a four byte integer in network byte order.
+		FORCEINLINE void WriteUInt32(const uint32 InValue)
+		{
+			uint8* Out = Grow(sizeof(uint32));
+			Out[0] = static_cast<uint8>(InValue >> 24);
+			Out[1] = static_cast<uint8>(InValue >> 16);
+			Out[2] = static_cast<uint8>(InValue >> 8);
+			Out[3] = static_cast<uint8>(InValue);
+		}
+
+		/// @brief Write a variable byte integer.
+		void WriteVariableByteInteger(uint32 InValue)
+		{
+			do
+			{
+				uint8 Byte = InValue % 128;
+				InValue /= 128;
+				if (InValue > 0)
+				{
+					Byte |= 0x80;
+				}
+				Buffer.Add(Byte);
+			}
+			while (InValue > 0);
+		}
+
+		/// @brief Write raw bytes.
+		FORCEINLINE void WriteBytes(const uint8* InData, const int32 InLength)
+		{
+			if (InLength > 0)
+			{
+				FMemory::Memcpy(Grow(InLength), InData, InLength);
+			}
+		}
+
+		/// @brief Write a length prefixed UTF-8 string, transcoding directly into the buffer.
+		void WriteString(const FString& InString)
+		{
+			const int32 Length = Data::Utf8Length(InString);
+			if (Length > Data::MaxStringLength)
+			{
+				LOG_MQTTIFY(Error, Data::CharLimitExceeded);
+				bIsError = true;
+				return;
+			}
+			WriteUInt16(static_cast<uint16>(Length));
+			Data::StringToUtf8(InString, Grow(Length));
+		}
+
+		/// @brief Write a length prefixed string that is already UTF-8 encoded.
+		void WriteUtf8(const TArrayView<const UTF8CHAR> InUtf8)
+		{
+			if (InUtf8.Num() > Data::MaxStringLength)
+			{
+				LOG_MQTTIFY(Error, Data::CharLimitExceeded);
+				bIsError = true;
+				return;
+			}
+			WriteUInt16(static_cast<uint16>(InUtf8.Num()));
+			WriteBytes(reinterpret_cast<const uint8*>(InUtf8.GetData()), InUtf8.Num());
+		}
+
+		/**
+		 * @brief Write an object that only knows how to encode itself to an FMemoryWriter.
+		 * The object is still written in place, after the bytes already in the buffer. An error of the
+		 * FMemoryWriter puts this writer in error.
+		 * @param InSerializable The object to encode.
+		 */
+		template <typename TSerializable>
+		void WriteSerializable(TSerializable& InSerializable)
+		{
+			FMemoryWriter Writer{Buffer, false, true};
+			Writer.SetByteSwapping(true);
+			InSerializable.Encode(Writer);
+			bIsError |= Writer.IsError();
+		}
+
+		/// @return The buffer being written to.
+		TArray<uint8>& GetBuffer() const { return Buffer; }
+
+		/// @return True if a field could not be encoded.
+		bool IsError() const { return bIsError; }
+
+		/// @brief Put the writer in error, for fields encoded through another archive.
+		void SetError() { bIsError = true; }
+
+	private:
+		FORCEINLINE uint8* Grow(const int32 InCount)
+		{
+			const int32 Offset = Buffer.AddUninitialized(InCount);
+			return Buffer.GetData() + Offset;
+		}
+
+		TArray<uint8>& Buffer;
+		bool bIsError = false;
+	};
+} // namespace Mqttify
@@ -3,6 +3,8 @@
 #include "LogMqttify.h"
 #include "MqttifyConstants.h"
 #include "Async/Async.h"
+#include "Packets/MqttifyAckEncoding.h"
+#include "Packets/Interface/IMqttifyControlPacket.h"
 #include "Socket/MqttifySecureSocket.h"
 #include "Socket/MqttifyWebSocket.h"
 
@@ -16,7 +18,8 @@ namespace Mqttify
 		OnDataReceiveDelegate.Clear();
 	}
 
-	FMqttifySocketRef FMqttifySocketBase::Create(const FMqttifyConnectionSettingsRef& InConnectionSettings)
+	FMqttifySocketRef FMqttifySocketBase::Create(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+												const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel)
 	{
 
 		switch (InConnectionSettings->GetTransportProtocol())
@@ -27,7 +30,7 @@ namespace Mqttify
 			case EMqttifyConnectionProtocol::Ws:
 			case EMqttifyConnectionProtocol::Wss:
 			default:
-				return MakeShared<FMqttifyWebSocket>(InConnectionSettings);
+				return MakeShared<FMqttifyWebSocket>(InConnectionSettings, InTimerWheel);
 		}
 	}
 
@@ -136,12 +139,67 @@ namespace Mqttify
 			return;
 		}
 
-		if (GetOnDataReceivedDelegate().IsBound())
+		if (GetOnDataReceivedDelegate().IsBound() && PacketsToDispatch.Num() > 0)
 		{
+			{
+				FScopeLock Lock{&PendingAcksLock};
+				bIsDispatchingPackets = true;
+			}
+
 			for (const TSharedPtr<FArrayReader>& Packet : PacketsToDispatch)
 			{
 				GetOnDataReceivedDelegate().Broadcast(Packet);
 			}
+
+			FlushPendingAcks();
+		}
+	}
+
+	void FMqttifySocketBase::SendAck(const EMqttifyPacketType InPacketType,
+									const uint16 InPacketId,
+									const EMqttifyReasonCode InReasonCode)
+	{
+		const FMqttifyEncodedAck Ack = EncodeAck(InPacketType, InPacketId, InReasonCode);
+		{
+			FScopeLock Lock{&PendingAcksLock};
+			if (bIsDispatchingPackets)
+			{
+				PendingAcks.Append(Ack.GetData(), Ack.Num);
+				return;
+			}
+		}
+
+		Send(Ack.GetData(), Ack.Num);
+	}
+
+	bool FMqttifySocketBase::SendInPlace(IMqttifyControlPacket& InPacket)
+	{
+		FScopeLock Lock{&SocketAccessLock};
+		SendBuffer.Reset();
+		const bool bIsEncoded = EncodePacket(InPacket, SendBuffer);
+		if (bIsEncoded)
+		{
+			Send(SendBuffer.GetData(), SendBuffer.Num());
+		}
+		if (SendBuffer.Max() > kMaxRetainedSendBufferSize)
+		{
+			SendBuffer.Empty();
+		}
+		return bIsEncoded;
+	}
+
+	void FMqttifySocketBase::FlushPendingAcks()
+	{
+		{
+			FScopeLock Lock{&PendingAcksLock};
+			bIsDispatchingPackets = false;
+			Swap(PendingAcks, FlushingAcks);
+		}
+
+		if (FlushingAcks.Num() > 0)
+		{
+			Send(FlushingAcks.GetData(), FlushingAcks.Num());
+			FlushingAcks.Reset();
 		}
 	}
 } // namespace Mqttify
\ No newline at end of file
@@ -1,10 +1,16 @@
 #pragma once
 #include "Mqtt/MqttifyConnectionSettings.h"
+#include "Mqtt/MqttifyRttEstimator.h"
+#include "Mqtt/MqttifyReasonCode.h"
+#include "Packets/MqttifyPacketType.h"
 #include "Serialization/ArrayReader.h"
 
+#include <atomic>
+
 namespace Mqttify
 {
 	class IMqttifyControlPacket;
+	class FMqttifyTimerWheel;
 }
 
 class MqttifyMqttifySocketSpec;
@@ -55,8 +61,13 @@ namespace Mqttify
 		/// @brief Tick the connection (e.g., poll for incoming data, check for timeouts, etc.)
 		virtual void Tick() = 0;
 
-		/// @brief Create a Socket based on the connection settings.
-		static FMqttifySocketRef Create(const FMqttifyConnectionSettingsRef& InConnectionSettings);
+		/**
+		 * @brief Create a Socket based on the connection settings.
+		 * @param InConnectionSettings The connection settings.
+		 * @param InTimerWheel The timer wheel to schedule timeouts on, or nullptr for the socket to use its own.
+		 */
+		static FMqttifySocketRef Create(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+										const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel = nullptr);
 
 		void ReadPacketsFromBuffer();
 
@@ -66,6 +77,38 @@ namespace Mqttify
 		 */
 		virtual void Send(const TSharedRef<IMqttifyControlPacket>& InPacket) = 0;
 
+		/**
+		 * @brief Send PUBACK, PUBREC, PUBREL, PUBCOMP or PINGREQ without building a packet.
+		 * Acknowledgements produced while a read burst is dispatched are collected and written
+		 * together once the burst has been handled.
+		 * @param InPacketType The packet type to send.
+		 * @param InPacketId The packet identifier, ignored for PINGREQ.
+		 * @param InReasonCode The MQTT 5 reason code.
+		 */
+		void SendAck(EMqttifyPacketType InPacketType,
+					uint16 InPacketId = 0,
+					EMqttifyReasonCode InReasonCode = EMqttifyReasonCode::Success);
+
+		/**
+		 * @brief Send a packet that lives on the caller's stack. It is encoded into the send buffer, which is reused
+		 * between sends, so a small packet is written without touching the heap.
+		 * @param InPacket The packet to send.
+		 * @return False if the packet could not be encoded and nothing was sent.
+		 */
+		bool SendInPlace(IMqttifyControlPacket& InPacket);
+
+		/**
+		 * @brief Send a packet that has already been encoded.
+		 * @param InBytes The encoded packet.
+		 */
+		void SendEncoded(const TArray<uint8>& InBytes) { Send(InBytes.GetData(), InBytes.Num()); }
+
+		/// @return The round trip time estimate of the connection, fed by the commands sent over it.
+		FMqttifyRttEstimator& GetRttEstimator() { return RttEstimator; }
+
+		/// @return The FPlatformTime::Seconds() of the last write to the socket, 0 if nothing was written yet.
+		double GetLastSendTime() const { return LastSendTime.load(std::memory_order_relaxed); }
+
 	protected:
 		mutable FCriticalSection SocketAccessLock{};
 		FOnDataReceivedDelegate OnDataReceiveDelegate{};
@@ -73,7 +116,23 @@ namespace Mqttify
 		FOnDisconnectDelegate OnDisconnectDelegate{};
 		TArray<uint8> DataBuffer;
 		int32 DataBufferReadOffset = 0; // number of bytes already consumed from the front
+		/// @brief Outbound buffer packets are encoded into, reused between sends. Guarded by SocketAccessLock.
+		TArray<uint8> SendBuffer;
+		/// @brief Capacity above which SendBuffer is released after a send, so one large publish isn't kept around.
+		static constexpr int32 kMaxRetainedSendBufferSize = 64 * 1024;
+		/// @brief Guards PendingAcks and bIsDispatchingPackets.
+		FCriticalSection PendingAcksLock{};
+		/// @brief Acknowledgements waiting for the end of the current read burst.
+		TArray<uint8> PendingAcks;
+		/// @brief Acknowledgements being written, swapped with PendingAcks so neither reallocates.
+		TArray<uint8> FlushingAcks;
+		/// @brief True while received packets are being dispatched.
+		bool bIsDispatchingPackets = false;
 		const FMqttifyConnectionSettingsRef ConnectionSettings;
+		/// @brief Kept across reconnects, the round trip time to the same host rarely changes much.
+		FMqttifyRttEstimator RttEstimator;
+		/// @brief Time of the last write, any packet sent to the broker counts as keep alive.
+		std::atomic<double> LastSendTime{0.0};
 
 	protected:
 		/**
@@ -83,6 +142,13 @@ namespace Mqttify
 		* @return True if the data was sent successfully, false otherwise.
 		*/
 		virtual void Send(const uint8* Data, uint32 Size) = 0;
+
+		/// @brief Write the acknowledgements collected during a read burst in one send.
+		void FlushPendingAcks();
+
+		/// @brief Record a write to the socket, called by the implementations of Send.
+		void MarkSent() { LastSendTime.store(FPlatformTime::Seconds(), std::memory_order_relaxed); }
+
 		friend  ::MqttifyMqttifySocketSpec;
 		friend ::MqttifyMqttifyWebSocketSpec;
 	};
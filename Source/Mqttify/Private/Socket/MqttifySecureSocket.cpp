@@ -198,6 +198,7 @@ namespace Mqttify
 					TotalBytesSent += BytesSent;
 				}
 			}
+			MarkSent();
 		}
 	}
 
@@ -261,10 +262,16 @@ namespace Mqttify
 
 	void FMqttifySecureSocket::Send(const TSharedRef<IMqttifyControlPacket>& InPacket)
 	{
-		TArray<uint8> ActualBytes;
-		FMemoryWriter Writer(ActualBytes);
-		InPacket->Encode(Writer);
-		Send(ActualBytes.GetData(), ActualBytes.Num());
+		FScopeLock Lock{&SocketAccessLock};
+		SendBuffer.Reset();
+		if (EncodePacket(*InPacket, SendBuffer))
+		{
+			Send(SendBuffer.GetData(), SendBuffer.Num());
+		}
+		if (SendBuffer.Max() > kMaxRetainedSendBufferSize)
+		{
+			SendBuffer.Empty();
+		}
 	}
 
 	void FMqttifySecureSocket::Disconnect_Internal()
@@ -8,10 +8,13 @@
 
 namespace Mqttify
 {
-	FMqttifyWebSocket::FMqttifyWebSocket(const FMqttifyConnectionSettingsRef& InConnectionSettings)
+	FMqttifyWebSocket::FMqttifyWebSocket(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+										const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel)
 		: FMqttifySocketBase{InConnectionSettings}
 		, CurrentState{EMqttifySocketState::Disconnected}
-		, DisconnectTime{FDateTime::MaxValue()}
+		, TimerWheel{InTimerWheel.IsValid() ? InTimerWheel.ToSharedRef() : MakeShared<FMqttifyTimerWheel>()}
+		, bOwnsTimerWheel{!InTimerWheel.IsValid()}
+		, bDisconnectTimedOut{MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false)}
 	{
 	}
 
@@ -28,6 +31,7 @@ namespace Mqttify
 				Socket->OnRawMessage().RemoveAll(this);
 				Socket.Reset();
 			}
+			CancelDisconnectTimer();
 		}
 	}
 
@@ -233,8 +237,16 @@ namespace Mqttify
 		if (Socket.IsValid() && Socket->IsConnected())
 		{
 			Socket->Close();
-			const FDateTime Now = FDateTime::Now();
-			DisconnectTime = Now + FTimespan::FromSeconds(ConnectionSettings->GetSocketConnectionTimeoutSeconds());
+			CancelDisconnectTimer();
+			TWeakPtr<std::atomic<bool>, ESPMode::ThreadSafe> WeakTimedOut = bDisconnectTimedOut;
+			DisconnectTimer = TimerWheel->Schedule(
+				ConnectionSettings->GetSocketConnectionTimeoutSeconds(),
+				[WeakTimedOut] {
+					if (const TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> TimedOut = WeakTimedOut.Pin())
+					{
+						TimedOut->store(true, std::memory_order_release);
+					}
+				});
 		}
 		else
 		{
@@ -265,6 +277,7 @@ namespace Mqttify
  			*ConnectionSettings->ToString(),
  			*ConnectionSettings->GetClientId());
  		Socket->Send(Data, Size, true);
+ 		MarkSent();
  	}
  	else
  	{
@@ -296,6 +309,7 @@ namespace Mqttify
  						*StrongThis->ConnectionSettings->ToString(),
  						*StrongThis->ConnectionSettings->GetClientId());
  					StrongThis->Socket->Send(Payload.GetData(), Payload.Num(), true);
+					StrongThis->MarkSent();
  				}
  			});
  	}
@@ -314,7 +328,12 @@ namespace Mqttify
 			return;
 		}
 
-		if (DisconnectTime < FDateTime::Now())
+		if (bOwnsTimerWheel)
+		{
+			TimerWheel->Advance();
+		}
+
+		if (bDisconnectTimedOut->exchange(false, std::memory_order_acq_rel))
 		{
 			LOG_MQTTIFY(
 				Error,
@@ -336,23 +355,32 @@ namespace Mqttify
 	{
 		if constexpr (GMqttifyThreadMode == EMqttifyThreadMode::GameThread)
 		{
-			TArray<uint8> ActualBytes;
-			FMemoryWriter Writer(ActualBytes);
-			InPacket->Encode(Writer);
-			Send(ActualBytes.GetData(), ActualBytes.Num());
+			FScopeLock Lock{&SocketAccessLock};
+			SendBuffer.Reset();
+			if (EncodePacket(*InPacket, SendBuffer))
+			{
+				Send(SendBuffer.GetData(), SendBuffer.Num());
+			}
+			if (SendBuffer.Max() > kMaxRetainedSendBufferSize)
+			{
+				SendBuffer.Empty();
+			}
 		}
 		else
 		{
+			// Encode on the calling thread so only the exact sized bytes cross to the Game Thread
+			TArray<uint8> ActualBytes;
+			if (!EncodePacket(*InPacket, ActualBytes))
+			{
+				return;
+			}
 			TWeakPtr<FMqttifyWebSocket> WeakSelf = AsShared();
 			AsyncTask(
 				ENamedThreads::GameThread,
-				[this, InPacket=InPacket, WeakSelf]
+				[ActualBytes=MoveTemp(ActualBytes), WeakSelf]
 				{
 					if (const TSharedPtr<FMqttifyWebSocket> StrongThis = WeakSelf.Pin())
 					{
-						TArray<uint8> ActualBytes;
-						FMemoryWriter Writer(ActualBytes);
-						InPacket->Encode(Writer);
 						FScopeLock Lock{ &StrongThis->SocketAccessLock };
 						if (!StrongThis->IsConnected())
 						{
@@ -371,6 +399,7 @@ namespace Mqttify
 							*StrongThis->ConnectionSettings->ToString(),
 							*StrongThis->ConnectionSettings->GetClientId());
 						StrongThis->Socket->Send(ActualBytes.GetData(), ActualBytes.Num(), true);
+						StrongThis->MarkSent();
 					}
 				});
 		}
@@ -382,7 +411,7 @@ namespace Mqttify
 			FScopeLock Lock{&SocketAccessLock};
 			LOG_MQTTIFY(Display, TEXT("Connected to socket on: %s"), *ConnectionSettings->ToString());
 			CurrentState.store(EMqttifySocketState::Connected, std::memory_order_release);
-			DisconnectTime = FDateTime::MaxValue();
+			CancelDisconnectTimer();
 		}
 		OnConnectDelegate.Broadcast(true);
 	}
@@ -412,7 +441,7 @@ namespace Mqttify
 				*ConnectionSettings->ToString(),
 				*ConnectionSettings->GetClientId());
 			CurrentState.store(EMqttifySocketState::Disconnected, std::memory_order_release);
-			DisconnectTime = FDateTime::MaxValue();
+			CancelDisconnectTimer();
 		}
 		OnDisconnectDelegate.Broadcast();
 	}
@@ -486,4 +515,10 @@ namespace Mqttify
 		}
 		ReadPacketsFromBuffer();
 	}
+
+	void FMqttifyWebSocket::CancelDisconnectTimer()
+	{
+		TimerWheel->Cancel(DisconnectTimer);
+		bDisconnectTimedOut->store(false, std::memory_order_release);
+	}
 } // namespace Mqttify
@@ -4,6 +4,7 @@
 #include "IWebSocket.h"
 #include "MqttifySocketState.h"
 #include "Mqtt/MqttifyConnectionSettings.h"
+#include "Mqtt/MqttifyTimerWheel.h"
 #include "Socket/Interface/MqttifySocketBase.h"
 
 
@@ -16,10 +17,22 @@ namespace Mqttify
 	private:
 		TSharedPtr<IWebSocket> Socket;
 		std::atomic<EMqttifySocketState> CurrentState;
-		FDateTime DisconnectTime;
+		/// @brief Timer wheel the disconnect timeout is scheduled on.
+		TSharedRef<FMqttifyTimerWheel> TimerWheel;
+		/// @brief True when the wheel was created by this socket, which then advances it on tick.
+		bool bOwnsTimerWheel;
+		FMqttifyTimerHandle DisconnectTimer;
+		/// @brief Set by the disconnect timer. Shared so the timer stays safe to fire after the socket is gone.
+		TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bDisconnectTimedOut;
 
 	public:
-		explicit FMqttifyWebSocket(const FMqttifyConnectionSettingsRef& InConnectionSettings);
+		/**
+		 * @brief Constructor for FMqttifyWebSocket.
+		 * @param InConnectionSettings The connection settings.
+		 * @param InTimerWheel The timer wheel to schedule timeouts on, or nullptr to create one advanced on tick.
+		 */
+		explicit FMqttifyWebSocket(const FMqttifyConnectionSettingsRef& InConnectionSettings,
+									const TSharedPtr<FMqttifyTimerWheel>& InTimerWheel = nullptr);
 		virtual ~FMqttifyWebSocket() override;
 		virtual void Connect() override;
 		virtual void Disconnect() override;
@@ -37,5 +50,7 @@ namespace Mqttify
 		void HandleWebSocketConnectionClosed(int32 Status, const FString& Reason, bool bWasClean);
 		void HandleWebSocketData(const void* Data, SIZE_T Length, SIZE_T BytesRemaining);
 		void FinalizeDisconnect();
+		/// @brief Cancel the disconnect timeout. Must be called with SocketAccessLock held.
+		void CancelDisconnectTimer();
 	};
 } // namespace Mqttify
@@ -0,0 +1,67 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/PlatformMemory.h"
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyClient.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+
+namespace Mqttify
+{
+	BEGIN_DEFINE_SPEC(
+		FMqttifyClientCreationBenchmarkSpec,
+		"Mqttify.Benchmark.ClientCreation",
+		EAutomationTestFlags::PerfFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+		| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext)
+
+		static constexpr int32 kClients = 2000;
+
+	END_DEFINE_SPEC(FMqttifyClientCreationBenchmarkSpec)
+
+	void FMqttifyClientCreationBenchmarkSpec::Define()
+	{
+		Describe(
+			"FMqttifyClient",
+			[this]
+			{
+				It(
+					"Create and destroy short lived clients",
+					[this]
+					{
+						FMqttifyConnectionSettingsBuilder Builder(TEXT("mqtt://localhost:1883"));
+						const FMqttifyConnectionSettingsRef Settings = Builder.Build().ToSharedRef();
+
+						TArray<TSharedRef<FMqttifyClient>> Clients;
+						Clients.Reserve(kClients);
+
+						const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+						const double CreateStart = FPlatformTime::Seconds();
+						for (int32 Index = 0; Index < kClients; ++Index)
+						{
+							Clients.Add(MakeShared<FMqttifyClient>(Settings));
+						}
+						const double CreateSeconds = FPlatformTime::Seconds() - CreateStart;
+						const uint64 UsedAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+						const double DestroyStart = FPlatformTime::Seconds();
+						Clients.Empty();
+						const double DestroySeconds = FPlatformTime::Seconds() - DestroyStart;
+
+						const double BytesPerClient = UsedAfter > UsedBefore
+							? static_cast<double>(UsedAfter - UsedBefore) / kClients
+							: 0.0;
+						AddInfo(
+							FString::Printf(
+								TEXT("Create: %.2f us/client. Destroy: %.2f us/client. Memory: %.1f KiB/client (%d clients)"),
+								CreateSeconds * 1e6 / kClients,
+								DestroySeconds * 1e6 / kClients,
+								BytesPerClient / 1024.0,
+								kClients));
+						AddInfo(
+							FString::Printf(
+								TEXT("sizeof(FMqttifyClientContext): %d bytes"),
+								static_cast<int32>(sizeof(FMqttifyClientContext))));
+					});
+			});
+	}
+} // namespace Mqttify
+#endif // WITH_DEV_AUTOMATION_TESTS
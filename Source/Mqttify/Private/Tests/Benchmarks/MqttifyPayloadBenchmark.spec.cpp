@@ -0,0 +1,74 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Serialization/ArrayReader.h"
+
+namespace Mqttify
+{
+	BEGIN_DEFINE_SPEC(
+		FMqttifyPayloadBenchmarkSpec,
+		"Mqttify.Benchmark.PayloadDecoding",
+		EAutomationTestFlags::PerfFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+		| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext)
+
+		static constexpr int32 kPayloadSize = 1024 * 1024;
+		static constexpr int32 kIterations = 200;
+
+	END_DEFINE_SPEC(FMqttifyPayloadBenchmarkSpec)
+
+	void FMqttifyPayloadBenchmarkSpec::Define()
+	{
+		Describe(
+			"DecodePayload",
+			[this]
+			{
+				It(
+					"1 MiB publish payload",
+					[this]
+					{
+						TArray<uint8> Payload;
+						Payload.SetNumUninitialized(kPayloadSize);
+						for (int32 Idx = 0; Idx < kPayloadSize; ++Idx)
+						{
+							Payload[Idx] = static_cast<uint8>(Idx);
+						}
+
+						const TSharedRef<FMqttifyPublishPacket5> Outbound = MakeShared<FMqttifyPublishPacket5>(
+							FMqttifyMessage{
+								FString{TEXT("benchmark/payload")},
+								MoveTemp(Payload),
+								false,
+								EMqttifyQualityOfService::AtLeastOnce
+							},
+							1);
+
+						TArray<uint8> Bytes;
+						FMemoryWriter Writer(Bytes);
+						Outbound->Encode(Writer);
+
+						FArrayReader Reader;
+						Reader.Append(Bytes);
+
+						int64 DecodedBytes = 0;
+						const double Start = FPlatformTime::Seconds();
+						for (int32 Iteration = 0; Iteration < kIterations; ++Iteration)
+						{
+							Reader.Seek(0);
+							const FMqttifyFixedHeader Header = FMqttifyFixedHeader::Create(Reader);
+							const FMqttifyPublishPacket5 Inbound{Reader, Header};
+							DecodedBytes += Inbound.GetPayload().Num();
+						}
+						const double Seconds = FPlatformTime::Seconds() - Start;
+
+						TestEqual(TEXT("Decoded bytes"), DecodedBytes, static_cast<int64>(kPayloadSize) * kIterations);
+						AddInfo(
+							FString::Printf(
+								TEXT("Publish decode: %.1f us/packet, %.1f MiB/s"),
+								Seconds * 1e6 / kIterations,
+								DecodedBytes / Seconds / (1024.0 * 1024.0)));
+					});
+			});
+	}
+} // namespace Mqttify
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,84 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Serialization/ArrayReader.h"
+#include "Serialization/BufferArchive.h"
+#include "Serialization/MqttifyFArchiveEncodeDecode.h"
+
+namespace Mqttify
+{
+	BEGIN_DEFINE_SPEC(
+		FMqttifyStringBenchmarkSpec,
+		"Mqttify.Benchmark.StringEncodingDecoding",
+		EAutomationTestFlags::PerfFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+		| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext)
+
+		static constexpr int32 kIterations = 200000;
+
+		void RunBenchmark(const FString& InTopic)
+		{
+			FBufferArchive Encoded;
+			Data::EncodeString(InTopic, Encoded);
+
+			FArrayReader Reader;
+			Reader.Append(Encoded);
+
+			int64 Checksum = 0;
+			const double DecodeStart = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < kIterations; ++Iteration)
+			{
+				Reader.Seek(0);
+				Checksum += Data::DecodeString(Reader).Len();
+			}
+			const double DecodeSeconds = FPlatformTime::Seconds() - DecodeStart;
+
+			const double EncodeStart = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < kIterations; ++Iteration)
+			{
+				FBufferArchive Writer;
+				Data::EncodeString(InTopic, Writer);
+				Checksum += Writer.Num();
+			}
+			const double EncodeSeconds = FPlatformTime::Seconds() - EncodeStart;
+
+			TestEqual(
+				TEXT("Checksum"),
+				Checksum,
+				static_cast<int64>(kIterations) * (InTopic.Len() + Encoded.Num()));
+
+			const double Bytes = static_cast<double>(Encoded.Num()) * kIterations;
+			AddInfo(
+				FString::Printf(
+					TEXT("Decode: %.1f ns/op, %.1f MiB/s. Encode: %.1f ns/op, %.1f MiB/s (%d bytes)"),
+					DecodeSeconds * 1e9 / kIterations,
+					Bytes / DecodeSeconds / (1024.0 * 1024.0),
+					EncodeSeconds * 1e9 / kIterations,
+					Bytes / EncodeSeconds / (1024.0 * 1024.0),
+					Encoded.Num()));
+		}
+
+	END_DEFINE_SPEC(FMqttifyStringBenchmarkSpec)
+
+	void FMqttifyStringBenchmarkSpec::Define()
+	{
+		Describe(
+			"DecodeString and EncodeString",
+			[this]
+			{
+				It(
+					"ASCII topic",
+					[this]
+					{
+						RunBenchmark(TEXT("game/eu-west/3f2a9c1e-7b4d-4e8a-9d2f-0c6b5a4e3d21/players/1048576/state"));
+					});
+
+				It(
+					"Non-ASCII topic",
+					[this]
+					{
+						RunBenchmark(TEXT("spiel/\u00FCbersicht/\u6E29\u5EA6/\u0441\u0435\u043D\u0441\u043E\u0440/\U0001F600/zustand"));
+					});
+			});
+	}
+} // namespace Mqttify
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -55,6 +55,32 @@ BEGIN_DEFINE_SPEC(MqttifyConnectionSettingsSpec,
 						});
 				});
 
+		Describe("MqttifyConnectionSettings retry policy",
+				[this] {
+
+					It(TEXT("Test the retry policy defaults to exponential backoff"),
+						[this] {
+							const TSharedPtr<FMqttifyConnectionSettings> Settings = FMqttifyConnectionSettingsBuilder(
+								TEXT("mqtt://localhost:1883")).Build();
+							TestEqual(TEXT("RetryPolicy should be ExponentialBackoff"),
+									Settings->GetRetryPolicy(),
+									EMqttifyRetryPolicy::ExponentialBackoff);
+						});
+
+					It(TEXT("Test the retry policy is carried to the settings and copies"),
+						[this] {
+							const TSharedPtr<FMqttifyConnectionSettings> Settings = FMqttifyConnectionSettingsBuilder(
+								TEXT("mqtt://localhost:1883")).SetRetryPolicy(EMqttifyRetryPolicy::Adaptive).Build();
+							TestEqual(TEXT("RetryPolicy should be Adaptive"),
+									Settings->GetRetryPolicy(),
+									EMqttifyRetryPolicy::Adaptive);
+							const FMqttifyConnectionSettings Copy{*Settings};
+							TestEqual(TEXT("Copied RetryPolicy should be Adaptive"),
+									Copy.GetRetryPolicy(),
+									EMqttifyRetryPolicy::Adaptive);
+						});
+				});
+
 		Describe("MqttifyConnectionSettings FromString creates a null settings object from an invalid URL",
 				[this] {
 
@@ -0,0 +1,124 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/State/MqttifyClientConnectedState.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyAckEncoding.h"
+#include "Tests/Support/FakeTestSocket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyAckBatchingSpec,
+	"Mqttify.Automation.AckBatching",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static TArray<uint8> MakeQoS1Publish(const uint16 InPacketId)
+	{
+		TArray<uint8> Bytes = {0x32, 0x00, 0x00, 0x01, 't', static_cast<uint8>(InPacketId >> 8), static_cast<uint8>(InPacketId)};
+		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+		{
+			// Property length
+			Bytes.Add(0x00);
+		}
+		Bytes.Add('x');
+		Bytes[1] = static_cast<uint8>(Bytes.Num() - 2);
+		return Bytes;
+	}
+
+END_DEFINE_SPEC(FMqttifyAckBatchingSpec)
+
+void FMqttifyAckBatchingSpec::Define()
+{
+	Describe("EncodeAck", [this]
+	{
+		It("Should encode a PUBACK in four bytes", [this]
+		{
+			const FMqttifyEncodedAck Ack = EncodeAck(EMqttifyPacketType::PubAck, 0x1234);
+			const TArray<uint8> Expected = {0x40, 0x02, 0x12, 0x34};
+			TestEqual(TEXT("Bytes"), TArray<uint8>(Ack.GetData(), Ack.Num), Expected);
+		});
+
+		It("Should set the reserved flags on PUBREL", [this]
+		{
+			const FMqttifyEncodedAck Ack = EncodeAck(EMqttifyPacketType::PubRel, 7);
+			const TArray<uint8> Expected = {0x62, 0x02, 0x00, 0x07};
+			TestEqual(TEXT("Bytes"), TArray<uint8>(Ack.GetData(), Ack.Num), Expected);
+		});
+
+		It("Should encode a PINGREQ in two bytes", [this]
+		{
+			const FMqttifyEncodedAck Ack = EncodeAck(EMqttifyPacketType::PingReq);
+			const TArray<uint8> Expected = {0xC0, 0x00};
+			TestEqual(TEXT("Bytes"), TArray<uint8>(Ack.GetData(), Ack.Num), Expected);
+		});
+
+		It("Should only write a reason code when it is not Success", [this]
+		{
+			const FMqttifyEncodedAck Ack = EncodeAck(
+				EMqttifyPacketType::PubRec,
+				1,
+				EMqttifyReasonCode::NoMatchingSubscribers);
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				const TArray<uint8> Expected = {0x50, 0x03, 0x00, 0x01, 0x10};
+				TestEqual(TEXT("Bytes"), TArray<uint8>(Ack.GetData(), Ack.Num), Expected);
+			}
+			else
+			{
+				const TArray<uint8> Expected = {0x50, 0x02, 0x00, 0x01};
+				TestEqual(TEXT("Bytes"), TArray<uint8>(Ack.GetData(), Ack.Num), Expected);
+			}
+		});
+	});
+
+	Describe("FMqttifyClientConnectedState", [this]
+	{
+		It("Should write the PUBACKs for one read burst together", [this]
+		{
+			FMqttifyConnectionSettingsBuilder Builder(TEXT("mqtt://localhost:1883"));
+			const FMqttifyConnectionSettingsRef Settings = Builder.Build().ToSharedRef();
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			const TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(Settings, TimerWheel);
+			const TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(Settings);
+			const TSharedRef<FMqttifyClientConnectedState> State = MakeShared<FMqttifyClientConnectedState>(
+				FMqttifyClientState::FOnStateChangedDelegate{},
+				Context,
+				Socket);
+			Socket->GetOnDataReceivedDelegate().AddSP(State, &FMqttifyClientConnectedState::OnReceivePacket);
+			Socket->Connect();
+
+			TArray<uint8> Burst = MakeQoS1Publish(1);
+			Burst.Append(MakeQoS1Publish(2));
+			Burst.Append(MakeQoS1Publish(3));
+			Socket->Receive(Burst);
+
+			const TArray<uint8> Expected = {
+				0x40, 0x02, 0x00, 0x01,
+				0x40, 0x02, 0x00, 0x02,
+				0x40, 0x02, 0x00, 0x03
+			};
+			TestEqual(TEXT("Acks should be written once"), Socket->GetWriteCount(), 1);
+			TestEqual(TEXT("Acks should be in order"), Socket->GetLastSentBytes(), Expected);
+		});
+
+		It("Should send acknowledgements straight away outside a read burst", [this]
+		{
+			FMqttifyConnectionSettingsBuilder Builder(TEXT("mqtt://localhost:1883"));
+			const FMqttifyConnectionSettingsRef Settings = Builder.Build().ToSharedRef();
+			const TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(Settings);
+			Socket->Connect();
+
+			Socket->SendAck(EMqttifyPacketType::PingReq);
+			Socket->SendAck(EMqttifyPacketType::PubComp, 9);
+
+			const TArray<uint8> Expected = {0x70, 0x02, 0x00, 0x09};
+			TestEqual(TEXT("Each ack should be its own write"), Socket->GetWriteCount(), 2);
+			TestEqual(TEXT("Last write"), Socket->GetLastSentBytes(), Expected);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
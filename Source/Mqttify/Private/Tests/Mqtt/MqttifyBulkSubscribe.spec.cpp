@@ -0,0 +1,252 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifySubscribeResult.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifySubAckPacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyBulkSubscribeSpec,
+	"Mqttify.Automation.BulkSubscribe",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static constexpr int32 kMaxOutstanding = 2;
+	static constexpr int32 kMaximumPacketSize = 64;
+
+	FMqttifyTestClientContext Fixture;
+
+	using FSubscribeFuture = TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>>;
+
+	using FTopicFilters = TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>>;
+
+	FTopicFilters MakeTopicFilters(const TArray<FString>& InFilters) const
+	{
+		FTopicFilters TopicFilters;
+		for (const FString& Filter : InFilters)
+		{
+			TopicFilters.Emplace(FMqttifyTopicFilter{Filter}, Fixture.Context->GetMessageDelegate(Filter));
+		}
+		return TopicFilters;
+	}
+
+	static TArray<FString> MakeFilters(const int32 InCount)
+	{
+		TArray<FString> Filters;
+		for (int32 Index = 0; Index < InCount; ++Index)
+		{
+			Filters.Add(FString::Printf(TEXT("bulk/%02d"), Index));
+		}
+		return Filters;
+	}
+
+	/// @return The number of topic filters in a sent SUBSCRIBE shorter than 128 bytes.
+	static int32 CountTopicFilters(const TArray<uint8>& InPacket)
+	{
+		// Fixed header, packet identifier and, for MQTT 5, the empty properties
+		int32 Offset = GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5 ? 5 : 4;
+		int32 Count = 0;
+		while (Offset + 1 < InPacket.Num())
+		{
+			Offset += 2 + (InPacket[Offset] << 8 | InPacket[Offset + 1]) + 1;
+			++Count;
+		}
+		return Count;
+	}
+
+	void AcknowledgeSubscribe(const TArray<uint8>& InPacket) const
+	{
+		const uint16 PacketId = static_cast<uint16>(InPacket[2] << 8 | InPacket[3]);
+		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+		{
+			TArray<EMqttifyReasonCode> ReasonCodes;
+			ReasonCodes.Init(EMqttifyReasonCode::Success, CountTopicFilters(InPacket));
+			Fixture.Context->Acknowledge(FMqttifySubAckPacket5{PacketId, ReasonCodes});
+		}
+		else
+		{
+			TArray<EMqttifySubscribeReturnCode> ReturnCodes;
+			ReturnCodes.Init(EMqttifySubscribeReturnCode::SuccessQualityOfService0, CountTopicFilters(InPacket));
+			Fixture.Context->Acknowledge(FMqttifySubAckPacket3{PacketId, ReturnCodes});
+		}
+	}
+
+	/// @return The packets sent since the last call.
+	TArray<TArray<uint8>> TakeSentPackets() const
+	{
+		Fixture.Context->ProcessCommands();
+		TArray<TArray<uint8>> Sent = Fixture.Socket->GetSentPackets();
+		Fixture.Socket->ResetSentPackets();
+		return Sent;
+	}
+
+END_DEFINE_SPEC(FMqttifyBulkSubscribeSpec)
+
+void FMqttifyBulkSubscribeSpec::Define()
+{
+	BeforeEach([this]
+	{
+		const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+				TEXT("mqtt://localhost:1883"))
+			.SetMaxOutstandingSubscribes(kMaxOutstanding)
+			.Build()
+			.ToSharedRef();
+		Fixture.Create(Settings);
+		Fixture.Context->SetServerMaximumPacketSize(kMaximumPacketSize);
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Bulk subscribe", [this]
+	{
+		It("Should pipeline the topic filters with a bounded number of SUBSCRIBEs waiting for a SUBACK", [this]
+		{
+			constexpr int32 kNumTopicFilters = 30;
+			TArray<int32> Completed;
+			double TopicFiltersPerSecond = -1.0;
+			FSubscribeFuture Future = Fixture.Context->AddBulkSubscribeRequest(
+				MakeTopicFilters(MakeFilters(kNumTopicFilters)),
+				FOnBulkSubscribeProgress::CreateLambda(
+					[&Completed, &TopicFiltersPerSecond](const FMqttifyBulkSubscribeProgress& InProgress)
+					{
+						Completed.Add(InProgress.GetNumCompleted());
+						TopicFiltersPerSecond = InProgress.GetTopicFiltersPerSecond();
+					}));
+
+			TestEqual(TEXT("Window is filled"), Fixture.Context->SendBulkSubscribes(Fixture.Socket), kMaxOutstanding);
+			TestEqual(TEXT("Window is full"), Fixture.Context->SendBulkSubscribes(Fixture.Socket), 0);
+
+			int32 NumPackets = 0;
+			TArray<int32> Acknowledged;
+			TArray<TArray<uint8>> Sent = TakeSentPackets();
+			while (Sent.Num() > 0 && NumPackets < kNumTopicFilters)
+			{
+				TestTrue(TEXT("No more than the window is outstanding"), Sent.Num() <= kMaxOutstanding);
+				for (const TArray<uint8>& Packet : Sent)
+				{
+					TestTrue(TEXT("Packet fits the limit"), Packet.Num() <= kMaximumPacketSize);
+					FPlatformProcess::Sleep(0.001f);
+					AcknowledgeSubscribe(Packet);
+					Acknowledged.Add((Acknowledged.Num() > 0 ? Acknowledged.Last() : 0) + CountTopicFilters(Packet));
+					++NumPackets;
+				}
+				Fixture.Context->SendBulkSubscribes(Fixture.Socket);
+				Sent = TakeSentPackets();
+			}
+
+			TestTrue(TEXT("Several packets are needed"), NumPackets > kMaxOutstanding);
+			TestEqual(TEXT("Progress counts the topic filters of each SUBACK"), Completed, Acknowledged);
+			if (Completed.Num() > 0)
+			{
+				TestEqual(TEXT("Last progress is complete"), Completed.Last(), kNumTopicFilters);
+			}
+			TestTrue(TEXT("Throughput is reported"), TopicFiltersPerSecond > 0.0);
+			if (TestTrue(TEXT("Complete"), Future.IsReady()))
+			{
+				TestTrue(TEXT("Succeeded"), Future.Get().HasSucceeded());
+				TestEqual(TEXT("Results"), Future.Get().GetResult()->Num(), kNumTopicFilters);
+			}
+			TestEqual(TEXT("Nothing left to send"), Fixture.Context->GetNumBulkSubscribes(), 0);
+		});
+
+		It("Should not report progress for a SUBSCRIBE that was never acknowledged", [this]
+		{
+			TArray<int32> Completed;
+			FSubscribeFuture Future = Fixture.Context->AddBulkSubscribeRequest(
+				MakeTopicFilters(MakeFilters(30)),
+				FOnBulkSubscribeProgress::CreateLambda([&Completed](const FMqttifyBulkSubscribeProgress& InProgress)
+				{
+					Completed.Add(InProgress.GetNumCompleted());
+				}));
+			Fixture.Context->SendBulkSubscribes(Fixture.Socket);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (!TestEqual(TEXT("Window is filled"), Sent.Num(), kMaxOutstanding))
+			{
+				return;
+			}
+
+			AcknowledgeSubscribe(Sent[0]);
+			Fixture.Context->AbandonCommands();
+			if (TestEqual(TEXT("Only the SUBACK that arrived is reported"), Completed.Num(), 1))
+			{
+				TestEqual(TEXT("Its topic filters"), Completed[0], CountTopicFilters(Sent[0]));
+			}
+			TestTrue(TEXT("Failed"), Future.IsReady() && !Future.Get().HasSucceeded());
+		});
+
+		It("Should cap the topic filters of a packet when the broker sets no size limit", [this]
+		{
+			constexpr int32 kMaxTopicFilters = 8;
+			const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+					TEXT("mqtt://localhost:1883"))
+				.SetMaxOutstandingSubscribes(kMaxOutstanding)
+				.SetMaxTopicFiltersPerSubscribe(kMaxTopicFilters)
+				.Build()
+				.ToSharedRef();
+			Fixture.Reset();
+			Fixture.Create(Settings);
+
+			TArray<int32> Completed;
+			Fixture.Context->AddBulkSubscribeRequest(
+				MakeTopicFilters(MakeFilters(20)),
+				FOnBulkSubscribeProgress::CreateLambda([&Completed](const FMqttifyBulkSubscribeProgress& InProgress)
+				{
+					Completed.Add(InProgress.GetNumCompleted());
+				}));
+			TestEqual(TEXT("Window is filled"), Fixture.Context->SendBulkSubscribes(Fixture.Socket), kMaxOutstanding);
+
+			TArray<TArray<uint8>> Sent = TakeSentPackets();
+			TArray<int32> NumTopicFilters;
+			while (Sent.Num() > 0 && NumTopicFilters.Num() < 20)
+			{
+				for (const TArray<uint8>& Packet : Sent)
+				{
+					NumTopicFilters.Add(CountTopicFilters(Packet));
+					AcknowledgeSubscribe(Packet);
+				}
+				Fixture.Context->SendBulkSubscribes(Fixture.Socket);
+				Sent = TakeSentPackets();
+			}
+
+			TestEqual(TEXT("Topic filters per packet"), NumTopicFilters, TArray<int32>{8, 8, 4});
+			TestEqual(TEXT("Progress per SUBACK"), Completed, TArray<int32>{8, 16, 20});
+		});
+
+		It("Should only send the topic filters no other call holds", [this]
+		{
+			Fixture.Context->AddSubscribeRequest(MakeTopicFilters({TEXT("bulk/00")}));
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0]);
+
+			FSubscribeFuture Future = Fixture.Context->AddBulkSubscribeRequest(
+				MakeTopicFilters({TEXT("bulk/00"), TEXT("bulk/01")}),
+				FOnBulkSubscribeProgress{});
+			TestEqual(TEXT("Packets queued"), Fixture.Context->SendBulkSubscribes(Fixture.Socket), 1);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (TestEqual(TEXT("Packets sent"), Sent.Num(), 1))
+			{
+				TestEqual(TEXT("Only the new topic filter is sent"), CountTopicFilters(Sent[0]), 1);
+				AcknowledgeSubscribe(Sent[0]);
+			}
+			TestTrue(TEXT("Complete"), Future.IsReady() && Future.Get().HasSucceeded());
+		});
+
+		It("Should fail the topic filters not sent yet when the commands are abandoned", [this]
+		{
+			FSubscribeFuture Future = Fixture.Context->AddBulkSubscribeRequest(
+				MakeTopicFilters(MakeFilters(30)),
+				FOnBulkSubscribeProgress{});
+			Fixture.Context->AbandonCommands();
+
+			TestTrue(TEXT("Failed"), Future.IsReady() && !Future.Get().HasSucceeded());
+			TestEqual(TEXT("Nothing left to send"), Fixture.Context->GetNumBulkSubscribes(), 0);
+			TestEqual(TEXT("Subscribers are dropped"), Fixture.Context->GetNumSubscribers(TEXT("bulk/29")), 0);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -28,7 +28,8 @@ void FMqttifyClientDispatchSpec::Define()
 			TestTrue(TEXT("Settings should be valid"), Settings.IsValid());
 			const FMqttifyConnectionSettingsRef SettingsRef = Settings.ToSharedRef();
 
-			TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(SettingsRef);
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(SettingsRef, TimerWheel);
 
 			static const TCHAR* ExactTopic = TEXT("sensors/uk/temperatures");
 			bool bExactCalled = false;
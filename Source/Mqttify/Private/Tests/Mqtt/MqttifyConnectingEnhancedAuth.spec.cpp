@@ -62,7 +62,8 @@ void FMqttifyConnectingEnhancedAuthSpec::Define()
 			TestTrue(TEXT("Settings should be valid"), Settings.IsValid());
 			const FMqttifyConnectionSettingsRef SettingsRef = Settings.ToSharedRef();
 
-			TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(SettingsRef);
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(SettingsRef, TimerWheel);
 			TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(SettingsRef);
 
 			bool bBecameConnected = false;
@@ -0,0 +1,124 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/MqttifyTopicTable.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyFireAndForgetSpec,
+	"Mqttify.Automation.FireAndForget",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	static FMqttifyMessage MakeMessage(const EMqttifyQualityOfService InQualityOfService =
+											EMqttifyQualityOfService::AtMostOnce)
+	{
+		return FMqttifyMessage{TEXT("actor/position"), TArray<uint8>{1, 2, 3, 4}, false, InQualityOfService};
+	}
+
+	static FMqttifyMessage MakeInternedMessage(const FMqttifyTopicHandle InTopic)
+	{
+		return FMqttifyMessage{InTopic, TArray<uint8>{1, 2, 3, 4}, false, EMqttifyQualityOfService::AtMostOnce};
+	}
+
+END_DEFINE_SPEC(FMqttifyFireAndForgetSpec)
+
+void FMqttifyFireAndForgetSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Fixture.Create();
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Fire and forget publishes", [this]
+	{
+		It("Should write the publish on the calling thread without queueing a command", [this]
+		{
+			TestTrue(TEXT("Written"), Fixture.Context->PublishFireAndForget(MakeMessage(), Fixture.Socket));
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 1);
+			if (TestEqual(TEXT("Packets"), Fixture.Socket->GetSentPackets().Num(), 1))
+			{
+				TestEqual(TEXT("QoS 0 publish"), Fixture.Socket->GetSentPackets()[0][0], static_cast<uint8>(0x30));
+			}
+
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Nothing left to send"), Fixture.Socket->GetWriteCount(), 1);
+		});
+
+		It("Should write each publish on its own", [this]
+		{
+			for (int32 Index = 0; Index < 60; ++Index)
+			{
+				Fixture.Context->PublishFireAndForget(MakeMessage(), Fixture.Socket);
+			}
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 60);
+			TestTrue(
+				TEXT("Same bytes each time"),
+				Fixture.Socket->GetSentPackets()[0] == Fixture.Socket->GetSentPackets().Last());
+		});
+
+		It("Should keep the topic handle of a message on an interned topic", [this]
+		{
+			const FMqttifyTopicHandle Topic = FMqttifyTopicTable::Get().Intern(TEXT("actor/position"));
+			const TMqttifyPublishPacket<GMqttifyProtocol> Packet{MakeInternedMessage(Topic), 0};
+			TestTrue(TEXT("Handle kept"), Packet.GetTopicHandle() == Topic);
+			TestTrue(TEXT("No topic string built"), &Packet.GetTopicName() == &Topic.ToString());
+		});
+
+		It("Should write publishes on an interned topic through the same send buffer", [this]
+		{
+			const FMqttifyTopicHandle Topic = FMqttifyTopicTable::Get().Intern(TEXT("actor/position"));
+			Fixture.Context->PublishFireAndForget(MakeInternedMessage(Topic), Fixture.Socket);
+			const uint8* SendBuffer = Fixture.Socket->GetSendBufferData();
+			for (int32 Index = 0; Index < 60; ++Index)
+			{
+				Fixture.Context->PublishFireAndForget(MakeInternedMessage(Topic), Fixture.Socket);
+			}
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 61);
+			TestTrue(
+				TEXT("Send buffer reused"),
+				SendBuffer != nullptr && Fixture.Socket->GetSendBufferData() == SendBuffer);
+
+			Fixture.Context->PublishFireAndForget(MakeMessage(), Fixture.Socket);
+			TestTrue(
+				TEXT("Same bytes as the topic name"),
+				Fixture.Socket->GetSentPackets()[0] == Fixture.Socket->GetSentPackets().Last());
+		});
+
+		It("Should refuse a message that needs an acknowledgement", [this]
+		{
+			TestFalse(
+				TEXT("Refused"),
+				Fixture.Context->PublishFireAndForget(
+					MakeMessage(EMqttifyQualityOfService::AtLeastOnce),
+					Fixture.Socket));
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 0);
+		});
+
+		It("Should drop the message when the socket is not connected", [this]
+		{
+			Fixture.Socket->Disconnect();
+			TestFalse(TEXT("Dropped"), Fixture.Context->PublishFireAndForget(MakeMessage(), Fixture.Socket));
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 0);
+		});
+
+		It("Should drop a message larger than the broker's Maximum Packet Size", [this]
+		{
+			Fixture.Context->SetServerMaximumPacketSize(16);
+			TestFalse(TEXT("Dropped"), Fixture.Context->PublishFireAndForget(MakeMessage(), Fixture.Socket));
+			TestEqual(TEXT("Writes"), Fixture.Socket->GetWriteCount(), 0);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
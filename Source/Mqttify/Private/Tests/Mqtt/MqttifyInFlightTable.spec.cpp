@@ -0,0 +1,176 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/Commands/MqttifyAcknowledgeable.h"
+#include "Mqtt/State/MqttifyInFlightTable.h"
+#include "Packets/MqttifyPubAckPacket.h"
+
+using namespace Mqttify;
+
+namespace
+{
+	class FCountingCommand final : public TMqttifyAcknowledgeable<void>
+	{
+	public:
+		FCountingCommand(const uint32 InKey, const FMqttifyConnectionSettingsRef& InSettings)
+			: TMqttifyAcknowledgeable{static_cast<uint16>(InKey), nullptr, InSettings}
+			, Key{InKey} {}
+
+		virtual uint32 GetId() const override { return Key; }
+		virtual void Abandon() override { ++AbandonCount; }
+
+		virtual bool Acknowledge(const IMqttifyControlPacket&) override
+		{
+			return bCompleteOnAcknowledge;
+		}
+
+		int32 NextCount = 0;
+		int32 AbandonCount = 0;
+		bool bCompleteOnAcknowledge = true;
+
+	protected:
+		virtual bool NextImpl() override
+		{
+			++NextCount;
+			++PacketTries;
+			RetryWaitTime = FPlatformTime::Seconds() + 100.0;
+			return false;
+		}
+
+		virtual bool IsDone() const override { return false; }
+
+	private:
+		uint32 Key;
+	};
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyInFlightTableSpec,
+	"Mqttify.Automation.InFlightTable",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	TSharedPtr<FMqttifyConnectionSettings> Settings;
+	TSharedPtr<FMqttifyTimerWheel> TimerWheel;
+
+	/// @brief Fire the timers due a number of seconds from now.
+	void AdvanceWheel(const double InSeconds) const
+	{
+		TimerWheel->AdvanceTo(
+			FPlatformTime::Cycles64() + static_cast<uint64>(InSeconds / FPlatformTime::GetSecondsPerCycle64()));
+	}
+
+	TSharedRef<FCountingCommand> MakeCommand(const uint32 InKey) const
+	{
+		return MakeShared<FCountingCommand>(InKey, Settings.ToSharedRef());
+	}
+
+END_DEFINE_SPEC(FMqttifyInFlightTableSpec)
+
+void FMqttifyInFlightTableSpec::Define()
+{
+	BeforeEach([this]
+	{
+		FMqttifyConnectionSettingsBuilder Builder(TEXT("mqtt://localhost:1883"));
+		Settings = Builder.SetMaxPacketRetries(3).Build();
+		TimerWheel = MakeShared<FMqttifyTimerWheel>();
+	});
+
+	Describe("FMqttifyInFlightTable", [this]
+	{
+		It("Should keep client and broker packet identifiers apart", [this]
+		{
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			Table.Add(7, MakeCommand(7));
+			Table.Add(7 << 16, MakeCommand(7 << 16));
+
+			TestTrue(TEXT("Client identifier"), Table.Contains(7));
+			TestTrue(TEXT("Broker identifier"), Table.Contains(7 << 16));
+			TestTrue(TEXT("Remove client identifier"), Table.Remove(7));
+			TestFalse(TEXT("Client identifier removed"), Table.Contains(7));
+			TestTrue(TEXT("Broker identifier kept"), Table.Contains(7 << 16));
+		});
+
+		It("Should abandon a command without a packet identifier", [this]
+		{
+			AddExpectedError(TEXT("packet identifier 0"), EAutomationExpectedErrorFlags::Contains, 1);
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			const TSharedRef<FCountingCommand> Command = MakeCommand(0);
+			Table.Add(0, Command);
+
+			TestFalse(TEXT("Not in flight"), Table.Contains(0));
+			TestEqual(TEXT("Abandoned"), Command->AbandonCount, 1);
+		});
+
+		It("Should keep the index valid after swap removal", [this]
+		{
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			for (uint32 Key = 1; Key <= 3; ++Key)
+			{
+				Table.Add(Key, MakeCommand(Key));
+			}
+
+			TestTrue(TEXT("Remove first"), Table.Remove(1));
+			const FMqttifyPubAckPacket3 PubAck{3};
+			TestTrue(TEXT("Acknowledge moved slot"), Table.Acknowledge(3, PubAck));
+			TestFalse(TEXT("Acknowledged command removed"), Table.Contains(3));
+			TestTrue(TEXT("Remaining command"), Table.Contains(2));
+			TestEqual(TEXT("Count"), Table.Num(), 1);
+
+			Table.Empty();
+			TestEqual(TEXT("Timers cancelled"), TimerWheel->Num(), 0);
+		});
+
+		It("Should only run commands whose deadline has passed", [this]
+		{
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			const TSharedRef<FCountingCommand> Command = MakeCommand(1);
+			Table.Add(1, Command);
+
+			const double Now = FPlatformTime::Seconds();
+			Table.ProcessDue(Now, 3);
+			AdvanceWheel(1.0);
+			Table.ProcessDue(Now + 1.0, 3);
+			TestEqual(TEXT("Sent once before the deadline"), Command->NextCount, 1);
+			TestEqual(TEXT("Retry timer pending"), TimerWheel->Num(), 1);
+
+			AdvanceWheel(200.0);
+			Table.ProcessDue(Now + 200.0, 3);
+			TestEqual(TEXT("Sent again after the deadline"), Command->NextCount, 2);
+		});
+
+		It("Should abandon commands that are out of tries", [this]
+		{
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			const TSharedRef<FCountingCommand> Command = MakeCommand(1);
+			Table.Add(1, Command);
+
+			Table.ProcessDue(FPlatformTime::Seconds(), 1);
+			AdvanceWheel(200.0);
+			Table.ProcessDue(FPlatformTime::Seconds() + 200.0, 1);
+			TestEqual(TEXT("Abandoned"), Command->AbandonCount, 1);
+			TestFalse(TEXT("Removed"), Table.Contains(1));
+		});
+
+		It("Should read the deadline back when an acknowledgement does not complete the command", [this]
+		{
+			FMqttifyInFlightTable Table{TimerWheel.ToSharedRef()};
+			const TSharedRef<FCountingCommand> Command = MakeCommand(1);
+			Command->bCompleteOnAcknowledge = false;
+			Table.Add(1, Command);
+
+			const double Now = FPlatformTime::Seconds();
+			Table.ProcessDue(Now, 3);
+			const FMqttifyPubAckPacket3 PubAck{1};
+			TestFalse(TEXT("Not complete"), Table.Acknowledge(1, PubAck));
+			TestTrue(TEXT("Still in flight"), Table.Contains(1));
+
+			AdvanceWheel(1.0);
+			Table.ProcessDue(Now + 1.0, 3);
+			TestEqual(TEXT("Not due yet"), Command->NextCount, 1);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,99 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/State/MqttifyClientConnectedState.h"
+#include "Mqtt/State/MqttifyClientConnectingState.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyConnAckPacket.h"
+#include "Packets/Properties/MqttifyProperty.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyKeepAliveSpec,
+	"Mqttify.Automation.KeepAlive",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	TSharedRef<FMqttifyClientConnectedState> MakeConnectedState() const
+	{
+		const TSharedRef<FMqttifyClientConnectedState> State = MakeShared<FMqttifyClientConnectedState>(
+			FMqttifyClientState::FOnStateChangedDelegate{},
+			Fixture.Context.ToSharedRef(),
+			Fixture.Socket.ToSharedRef());
+		Fixture.Socket->GetOnDataReceivedDelegate().AddSP(State, &FMqttifyClientConnectedState::OnReceivePacket);
+		return State;
+	}
+
+END_DEFINE_SPEC(FMqttifyKeepAliveSpec)
+
+void FMqttifyKeepAliveSpec::Define()
+{
+	BeforeEach([this]
+	{
+		const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+			TEXT("mqtt://localhost:1883")).SetKeepAliveIntervalSeconds(30).Build().ToSharedRef();
+		Fixture.Create(Settings);
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("FMqttifyClientConnectedState keep alive", [this]
+	{
+		It("Should not ping while packets are being sent", [this]
+		{
+			const TSharedRef<FMqttifyClientConnectedState> State = MakeConnectedState();
+			Fixture.Socket->SendAck(EMqttifyPacketType::PubAck, 1);
+			const int32 WriteCount = Fixture.Socket->GetWriteCount();
+
+			State->Tick();
+			TestEqual(TEXT("No PINGREQ"), Fixture.Socket->GetWriteCount(), WriteCount);
+		});
+
+		It("Should ping an idle connection and record the round trip time", [this]
+		{
+			const TSharedRef<FMqttifyClientConnectedState> State = MakeConnectedState();
+			TestTrue(TEXT("No round trip time yet"), Fixture.Context->GetPingRoundTripSeconds() < 0.0);
+
+			State->Tick();
+			TestEqual(TEXT("PINGREQ"), Fixture.Socket->GetLastSentBytes(), TArray<uint8>{0xC0, 0x00});
+
+			Fixture.Socket->Receive(TArray<uint8>{0xD0, 0x00});
+			TestTrue(TEXT("Round trip time recorded"), Fixture.Context->GetPingRoundTripSeconds() >= 0.0);
+		});
+	});
+
+	Describe("FMqttifyClientConnectingState keep alive", [this]
+	{
+		It("Should adopt the Server Keep Alive from the CONNACK", [this]
+		{
+			const TSharedRef<FMqttifyClientConnectingState> State = MakeShared<FMqttifyClientConnectingState>(
+				FMqttifyClientState::FOnStateChangedDelegate{},
+				Fixture.Context.ToSharedRef(),
+				false,
+				Fixture.Socket.ToSharedRef());
+			State->OnSocketConnect(true);
+			TestEqual(TEXT("Requested keep alive"), Fixture.Context->GetKeepAliveIntervalSeconds(), 30);
+
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				FMqttifyConnAckPacket5 ConnAck{
+					false,
+					EMqttifyReasonCode::Success,
+					FMqttifyProperties{{FMqttifyProperty::Create<EMqttifyPropertyIdentifier::ServerKeepAlive>(
+						static_cast<uint16>(5))}}
+				};
+				const TSharedPtr<FArrayReader> Reader = MakeShared<FArrayReader>();
+				EncodePacket(ConnAck, *Reader);
+				State->OnReceivePacket(Reader);
+				TestEqual(TEXT("Server keep alive"), Fixture.Context->GetKeepAliveIntervalSeconds(), 5);
+			}
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
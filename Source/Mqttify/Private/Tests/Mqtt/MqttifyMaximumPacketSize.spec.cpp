@@ -0,0 +1,190 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/State/MqttifyClientConnectingState.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyConnAckPacket.h"
+#include "Packets/MqttifyConnectPacket.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Packets/Properties/MqttifyProperty.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyMaximumPacketSizeSpec,
+	"Mqttify.Automation.MaximumPacketSize",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	static FMqttifyMessage MakeMessage(const FString& InTopic,
+										const int32 InPayloadSize,
+										const EMqttifyQualityOfService InQualityOfService)
+	{
+		TArray<uint8> Payload;
+		Payload.SetNumZeroed(InPayloadSize);
+		return FMqttifyMessage{InTopic, MoveTemp(Payload), false, InQualityOfService};
+	}
+
+	template <EMqttifyProtocolVersion InProtocolVersion>
+	void TestPacketSize(const FMqttifyMessage& InMessage)
+	{
+		const uint32 PacketSize = TMqttifyPublishPacket<InProtocolVersion>::GetPacketSize(InMessage);
+		TMqttifyPublishPacket<InProtocolVersion> Packet{FMqttifyMessage{InMessage}, 1};
+		TArray<uint8> Bytes;
+		EncodePacket(Packet, Bytes);
+		TestEqual(TEXT("Size matches the encoded packet"), PacketSize, static_cast<uint32>(Bytes.Num()));
+	}
+
+END_DEFINE_SPEC(FMqttifyMaximumPacketSizeSpec)
+
+void FMqttifyMaximumPacketSizeSpec::Define()
+{
+	Describe("TMqttifyPublishPacket::GetPacketSize", [this]
+	{
+		It("Should match the encoded size of a small publish", [this]
+		{
+			const FMqttifyMessage Message = MakeMessage(TEXT("a/b"), 3, EMqttifyQualityOfService::AtMostOnce);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_3_1_1>(Message);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_5>(Message);
+		});
+
+		It("Should count the packet identifier and a multi byte remaining length", [this]
+		{
+			const FMqttifyMessage Message = MakeMessage(
+				TEXT("game/eu/match"),
+				20000,
+				EMqttifyQualityOfService::AtLeastOnce);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_3_1_1>(Message);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_5>(Message);
+		});
+
+		It("Should count the topic in UTF-8 bytes", [this]
+		{
+			const FMqttifyMessage Message = MakeMessage(
+				TEXT("caf\u00e9/\u00fcber"),
+				8,
+				EMqttifyQualityOfService::ExactlyOnce);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_3_1_1>(Message);
+			TestPacketSize<EMqttifyProtocolVersion::Mqtt_5>(Message);
+		});
+
+		It("Should count the topic alias property of the publish that maps an alias", [this]
+		{
+			const FMqttifyMessage Message = MakeMessage(TEXT("a/b"), 3, EMqttifyQualityOfService::AtLeastOnce);
+			FMqttifyPublishPacket5 Packet{FMqttifyMessage{Message}, 1};
+			Packet.SetTopicAlias(1, false);
+			TArray<uint8> Bytes;
+			EncodePacket(Packet, Bytes);
+			TestEqual(
+				TEXT("Size matches the encoded packet"),
+				FMqttifyPublishPacket5::GetPacketSize(Message, true),
+				static_cast<uint32>(Bytes.Num()));
+			TestEqual(
+				TEXT("Larger than without the alias"),
+				FMqttifyPublishPacket5::GetPacketSize(Message, true),
+				FMqttifyPublishPacket5::GetPacketSize(Message) + FMqttifyOutboundTopicAliases::kAliasPropertySize);
+		});
+	});
+
+	Describe("FMqttifyClientContext::PublishAsync Maximum Packet Size", [this]
+	{
+		BeforeEach([this]
+		{
+			Fixture.Create(
+				FMqttifyConnectionSettingsBuilder(TEXT("mqtt://localhost:1883")).Build().ToSharedRef(),
+				false);
+		});
+
+		AfterEach([this] { Fixture.Reset(); });
+
+		It("Should fail a publish that only fits without the topic alias property with PacketTooLarge", [this]
+		{
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				const FMqttifyMessage Message = MakeMessage(TEXT("a/b"), 32, EMqttifyQualityOfService::AtMostOnce);
+				Fixture.Context->SetServerMaximumPacketSize(FMqttifyPublishPacket5::GetPacketSize(Message));
+
+				const TFuture<TMqttifyResult<void>> Fits = Fixture.Context->PublishAsync(
+					FMqttifyMessage{Message},
+					Fixture.Socket);
+				TestFalse(TEXT("Fits without topic aliases"), Fits.IsReady());
+
+				Fixture.Context->GetOutboundTopicAliases()->Reset(4);
+				const TFuture<TMqttifyResult<void>> TooLarge = Fixture.Context->PublishAsync(
+					FMqttifyMessage{Message},
+					Fixture.Socket);
+				if (TestTrue(TEXT("Failed before it was queued"), TooLarge.IsReady()))
+				{
+					TestFalse(TEXT("Failed"), TooLarge.Get().HasSucceeded());
+					TestEqual(
+						TEXT("Reason code"),
+						TooLarge.Get().GetReasonCode(),
+						EMqttifyReasonCode::PacketTooLarge);
+				}
+			}
+		});
+	});
+
+	Describe("FMqttifyClientConnectingState Maximum Packet Size", [this]
+	{
+		BeforeEach([this]
+		{
+			const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+				TEXT("mqtt://localhost:1883")).SetMaxPacketSize(64 * 1024).Build().ToSharedRef();
+			Fixture.Create(Settings);
+		});
+
+		AfterEach([this] { Fixture.Reset(); });
+
+		It("Should advertise its limit and adopt the broker's", [this]
+		{
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				const TSharedRef<FMqttifyClientConnectingState> State = MakeShared<FMqttifyClientConnectingState>(
+					FMqttifyClientState::FOnStateChangedDelegate{},
+					Fixture.Context.ToSharedRef(),
+					false,
+					Fixture.Socket.ToSharedRef());
+				State->OnSocketConnect(true);
+
+				FArrayReader Sent;
+				Sent.Append(Fixture.Socket->GetLastSentBytes());
+				const FMqttifyFixedHeader Header = FMqttifyFixedHeader::Create(Sent);
+				const TMqttifyConnectPacket<EMqttifyProtocolVersion::Mqtt_5> Connect{Sent, Header};
+				uint32 Advertised = 0;
+				for (const FMqttifyProperty& Property : Connect.GetProperties().GetProperties())
+				{
+					if (Property.GetIdentifier() == EMqttifyPropertyIdentifier::MaximumPacketSize)
+					{
+						Property.TryGetValue(Advertised);
+					}
+				}
+				TestEqual(TEXT("Advertised Maximum Packet Size"), Advertised, static_cast<uint32>(64 * 1024));
+				TestEqual(
+					TEXT("No broker limit yet"),
+					Fixture.Context->GetServerMaximumPacketSize(),
+					static_cast<uint32>(0));
+
+				FMqttifyConnAckPacket5 ConnAck{
+					false,
+					EMqttifyReasonCode::Success,
+					FMqttifyProperties{{FMqttifyProperty::Create<EMqttifyPropertyIdentifier::MaximumPacketSize>(
+						static_cast<uint32>(1024))}}
+				};
+				const TSharedPtr<FArrayReader> Reader = MakeShared<FArrayReader>();
+				EncodePacket(ConnAck, *Reader);
+				State->OnReceivePacket(Reader);
+				TestEqual(
+					TEXT("Broker limit"),
+					Fixture.Context->GetServerMaximumPacketSize(),
+					static_cast<uint32>(1024));
+			}
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,278 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/Commands/MqttifyPublish.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Mqtt/State/MqttifyOfflineBuffer.h"
+#include "Tests/Support/FakeTestSocket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyOfflineBufferSpec,
+	"Mqttify.Automation.OfflineBuffer",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	TSharedPtr<FMqttifyConnectionSettings> Settings;
+
+	TSharedRef<FMqttifyQueueable> MakeCommand() const
+	{
+		return MakeShared<FMqttifyPubAtMostOnce, ESPMode::ThreadSafe>(
+			FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtMostOnce},
+			nullptr,
+			Settings.ToSharedRef());
+	}
+
+	/// @return The commands of the buffer, oldest first.
+	static TArray<FMqttifyQueueable*> Drain(FMqttifyOfflineBuffer& InBuffer)
+	{
+		TArray<FMqttifyOfflineBuffer::FEntry> Entries;
+		InBuffer.Drain(Entries);
+		TArray<FMqttifyQueueable*> Commands;
+		for (const FMqttifyOfflineBuffer::FEntry& Entry : Entries)
+		{
+			Commands.Add(Entry.Command.Get());
+		}
+		return Commands;
+	}
+
+END_DEFINE_SPEC(FMqttifyOfflineBufferSpec)
+
+void FMqttifyOfflineBufferSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Settings = FMqttifyConnectionSettingsBuilder(TEXT("mqtt://localhost:1883")).Build();
+	});
+
+	AfterEach([this]
+	{
+		Settings.Reset();
+	});
+
+	Describe("FMqttifyOfflineBuffer", [this]
+	{
+		It("Should drain publishes in the order they were added across qualities of service", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{10, 1024, EMqttifyOfflineDropPolicy::DropOldest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> First = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Second = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Third = MakeCommand();
+			Buffer.Add(First, EMqttifyQualityOfService::AtLeastOnce, 10, Dropped);
+			Buffer.Add(Second, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(Third, EMqttifyQualityOfService::ExactlyOnce, 10, Dropped);
+
+			TestEqual(TEXT("Buffered"), Buffer.Num(), 3);
+			TestEqual(TEXT("Bytes"), Buffer.GetNumBytes(), static_cast<uint64>(30));
+			TestEqual(TEXT("Drained"), Drain(Buffer), TArray<FMqttifyQueueable*>{&*First, &*Second, &*Third});
+			TestEqual(TEXT("Empty"), Buffer.Num(), 0);
+			TestEqual(TEXT("No bytes"), Buffer.GetNumBytes(), static_cast<uint64>(0));
+		});
+
+		It("Should drop the oldest publish when over the message budget", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{2, 1024, EMqttifyOfflineDropPolicy::DropOldest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> First = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Second = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Third = MakeCommand();
+			Buffer.Add(First, EMqttifyQualityOfService::ExactlyOnce, 10, Dropped);
+			Buffer.Add(Second, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(Third, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+
+			if (TestEqual(TEXT("Dropped"), Dropped.Num(), 1))
+			{
+				TestTrue(TEXT("Oldest dropped"), Dropped[0].Command.Get() == &*First);
+			}
+			TestEqual(TEXT("Drop count"), Buffer.GetNumDropped(), static_cast<int64>(1));
+			TestEqual(TEXT("Drained"), Drain(Buffer), TArray<FMqttifyQueueable*>{&*Second, &*Third});
+		});
+
+		It("Should drop the new publish when the policy keeps the oldest", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{2, 1024, EMqttifyOfflineDropPolicy::DropNewest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> First = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Second = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Third = MakeCommand();
+			Buffer.Add(First, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(Second, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(Third, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+
+			if (TestEqual(TEXT("Dropped"), Dropped.Num(), 1))
+			{
+				TestTrue(TEXT("Newest dropped"), Dropped[0].Command.Get() == &*Third);
+			}
+			TestEqual(TEXT("Drained"), Drain(Buffer), TArray<FMqttifyQueueable*>{&*First, &*Second});
+		});
+
+		It("Should drop the lowest quality of service first", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{2, 1024, EMqttifyOfflineDropPolicy::DropLowestQualityOfService};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> Reliable = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Telemetry = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> LaterReliable = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> LaterTelemetry = MakeCommand();
+			Buffer.Add(Reliable, EMqttifyQualityOfService::AtLeastOnce, 10, Dropped);
+			Buffer.Add(Telemetry, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(LaterReliable, EMqttifyQualityOfService::AtLeastOnce, 10, Dropped);
+			Buffer.Add(LaterTelemetry, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+
+			if (TestEqual(TEXT("Dropped"), Dropped.Num(), 2))
+			{
+				TestTrue(TEXT("Buffered QoS 0 dropped"), Dropped[0].Command.Get() == &*Telemetry);
+				TestTrue(TEXT("New QoS 0 dropped"), Dropped[1].Command.Get() == &*LaterTelemetry);
+			}
+			TestEqual(TEXT("Drained"), Drain(Buffer), TArray<FMqttifyQueueable*>{&*Reliable, &*LaterReliable});
+		});
+
+		It("Should drop publishes to stay within the byte budget", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{10, 100, EMqttifyOfflineDropPolicy::DropOldest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> First = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Second = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Oversized = MakeCommand();
+			Buffer.Add(First, EMqttifyQualityOfService::AtMostOnce, 60, Dropped);
+			Buffer.Add(Second, EMqttifyQualityOfService::AtMostOnce, 60, Dropped);
+			Buffer.Add(Oversized, EMqttifyQualityOfService::AtMostOnce, 101, Dropped);
+
+			if (TestEqual(TEXT("Dropped"), Dropped.Num(), 2))
+			{
+				TestTrue(TEXT("Oldest dropped for room"), Dropped[0].Command.Get() == &*First);
+				TestTrue(TEXT("Oversized publish dropped"), Dropped[1].Command.Get() == &*Oversized);
+			}
+			TestEqual(TEXT("Bytes"), Buffer.GetNumBytes(), static_cast<uint64>(60));
+		});
+
+		It("Should drop every publish without a message budget", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{0, 1024, EMqttifyOfflineDropPolicy::DropOldest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			Buffer.Add(MakeCommand(), EMqttifyQualityOfService::AtLeastOnce, 10, Dropped);
+
+			TestEqual(TEXT("Dropped"), Dropped.Num(), 1);
+			TestEqual(TEXT("Buffered"), Buffer.Num(), 0);
+		});
+
+		It("Should remove publishes older than a cutoff above a quality of service", [this]
+		{
+			FMqttifyOfflineBuffer Buffer{10, 1024, EMqttifyOfflineDropPolicy::DropOldest};
+			TArray<FMqttifyOfflineBuffer::FEntry> Dropped;
+			const TSharedRef<FMqttifyQueueable> Telemetry = MakeCommand();
+			const TSharedRef<FMqttifyQueueable> Reliable = MakeCommand();
+			Buffer.Add(Telemetry, EMqttifyQualityOfService::AtMostOnce, 10, Dropped);
+			Buffer.Add(Reliable, EMqttifyQualityOfService::AtLeastOnce, 10, Dropped);
+
+			TArray<FMqttifyOfflineBuffer::FEntry> Removed;
+			Buffer.RemoveOlderThan(FPlatformTime::Seconds() + 1.0, EMqttifyQualityOfService::AtLeastOnce, Removed);
+			if (TestEqual(TEXT("Removed"), Removed.Num(), 1))
+			{
+				TestTrue(TEXT("QoS 1 removed"), Removed[0].Command.Get() == &*Reliable);
+			}
+			TestEqual(TEXT("Drained"), Drain(Buffer), TArray<FMqttifyQueueable*>{&*Telemetry});
+		});
+	});
+
+	Describe("FMqttifyClientContext offline publishes", [this]
+	{
+		It("Should send the publishes held while offline once flushed", [this]
+		{
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			const TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(
+				Settings.ToSharedRef(),
+				TimerWheel);
+			const TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(Settings.ToSharedRef());
+
+			const uint16 PacketId = Context->GetNextId();
+			Context->AddOfflinePublish(
+				MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+					FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+					PacketId,
+					Socket,
+					Context->GetConnectionSettings(),
+					Context->GetRetransmitCache()),
+				EMqttifyQualityOfService::AtLeastOnce,
+				10);
+			TestEqual(TEXT("Held offline"), Context->GetNumOfflinePublishes(), 1);
+			TestFalse(TEXT("Not in flight"), Context->HasAcknowledgeableCommand(PacketId));
+
+			Socket->Connect();
+			Context->FlushOfflinePublishes();
+			TestEqual(TEXT("Buffer empty"), Context->GetNumOfflinePublishes(), 0);
+			TestTrue(TEXT("In flight"), Context->HasAcknowledgeableCommand(PacketId));
+
+			Context->ProcessCommands();
+			TestEqual(TEXT("Publish sent"), Socket->GetSentPackets().Num(), 1);
+			Context->AbandonCommands();
+		});
+
+		It("Should fail publishes dropped from the buffer", [this]
+		{
+			Settings = FMqttifyConnectionSettingsBuilder(TEXT("mqtt://localhost:1883"))
+						.SetOfflineBufferMaxMessages(1)
+						.Build();
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			const TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(
+				Settings.ToSharedRef(),
+				TimerWheel);
+
+			const FMqttifyPubAtMostOnceRef First = StaticCastSharedRef<FMqttifyPubAtMostOnce>(MakeCommand());
+			Context->AddOfflinePublish(First, EMqttifyQualityOfService::AtMostOnce, 10);
+			Context->AddOfflinePublish(MakeCommand(), EMqttifyQualityOfService::AtMostOnce, 10);
+
+			const TFuture<TMqttifyResult<void>> Future = First->GetFuture();
+			TestTrue(TEXT("Dropped publish completed"), Future.IsReady());
+			TestFalse(TEXT("Dropped publish failed"), Future.Get().HasSucceeded());
+			TestEqual(TEXT("Held offline"), Context->GetNumOfflinePublishes(), 1);
+			Context->AbandonCommands();
+		});
+
+		It("Should hold publishes until the flush and queue later ones directly", [this]
+		{
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			const TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(
+				Settings.ToSharedRef(),
+				TimerWheel);
+			const TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(Settings.ToSharedRef());
+			const auto AddPublish = [&Context, &Socket]
+			{
+				const uint16 PacketId = Context->GetNextId();
+				Context->AddPublish(
+					MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+						FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1}, false, EMqttifyQualityOfService::AtLeastOnce},
+						PacketId,
+						Socket,
+						Context->GetConnectionSettings(),
+						Context->GetRetransmitCache()),
+					EMqttifyQualityOfService::AtLeastOnce,
+					10);
+				return PacketId;
+			};
+
+			const uint16 Held = AddPublish();
+			TestEqual(TEXT("Held before the first connection"), Context->GetNumOfflinePublishes(), 1);
+
+			Socket->Connect();
+			Context->FlushOfflinePublishes();
+			TestTrue(TEXT("Held publish in flight"), Context->HasAcknowledgeableCommand(Held));
+
+			const uint16 Direct = AddPublish();
+			TestEqual(TEXT("Nothing held after the flush"), Context->GetNumOfflinePublishes(), 0);
+			TestTrue(TEXT("Later publish in flight"), Context->HasAcknowledgeableCommand(Direct));
+
+			Context->MarkOffline();
+			const uint16 HeldAgain = AddPublish();
+			TestEqual(TEXT("Held once offline again"), Context->GetNumOfflinePublishes(), 1);
+			TestFalse(TEXT("Not in flight"), Context->HasAcknowledgeableCommand(HeldAgain));
+			Context->AbandonCommands();
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,112 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/ParallelFor.h"
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyPacketIdAllocator.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyPacketIdAllocatorSpec,
+	"Mqttify.Automation.PacketIdAllocator",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+END_DEFINE_SPEC(FMqttifyPacketIdAllocatorSpec)
+
+void FMqttifyPacketIdAllocatorSpec::Define()
+{
+	Describe("FMqttifyPacketIdAllocator", [this]
+	{
+		It("Should hand out every identifier once and then run out", [this]
+		{
+			const TUniquePtr<FMqttifyPacketIdAllocator> Allocator = MakeUnique<FMqttifyPacketIdAllocator>();
+			TBitArray<> Seen{false, 1 << 16};
+
+			for (int32 Index = 0; Index < FMqttifyPacketIdAllocator::kCapacity; ++Index)
+			{
+				const uint16 Id = Allocator->Allocate();
+				if (Id == 0 || Seen[Id])
+				{
+					AddError(FString::Printf(TEXT("Unexpected identifier %d at allocation %d"), Id, Index));
+					return;
+				}
+				Seen[Id] = true;
+			}
+
+			TestEqual(TEXT("All identifiers should be in use"), Allocator->Num(), FMqttifyPacketIdAllocator::kCapacity);
+			TestEqual(TEXT("Allocator should be exhausted"), Allocator->Allocate(), static_cast<uint16>(0));
+
+			TestTrue(TEXT("Release should succeed"), Allocator->Release(1234));
+			TestEqual(TEXT("Released identifier should be reused"), Allocator->Allocate(), static_cast<uint16>(1234));
+		});
+
+		It("Should rotate through identifiers instead of reusing the last one", [this]
+		{
+			const TUniquePtr<FMqttifyPacketIdAllocator> Allocator = MakeUnique<FMqttifyPacketIdAllocator>();
+			for (int32 Index = 0; Index < 100; ++Index)
+			{
+				Allocator->Allocate();
+			}
+			TestTrue(TEXT("Release should succeed"), Allocator->Release(5));
+
+			// The scan continues from the word of the last allocation, so 5 is not taken again yet
+			TestEqual(TEXT("Next identifier"), Allocator->Allocate(), static_cast<uint16>(101));
+		});
+
+		It("Should reject releasing identifiers that are not in use", [this]
+		{
+			const TUniquePtr<FMqttifyPacketIdAllocator> Allocator = MakeUnique<FMqttifyPacketIdAllocator>();
+			const uint16 Id = Allocator->Allocate();
+			TestTrue(TEXT("Identifier should be in use"), Allocator->IsAllocated(Id));
+			TestTrue(TEXT("First release should succeed"), Allocator->Release(Id));
+			TestFalse(TEXT("Second release should fail"), Allocator->Release(Id));
+			TestFalse(TEXT("Identifier 0 cannot be released"), Allocator->Release(0));
+			TestEqual(TEXT("Nothing should be in use"), Allocator->Num(), 0);
+		});
+
+		It("Should claim a given identifier once and skip it when allocating", [this]
+		{
+			const TUniquePtr<FMqttifyPacketIdAllocator> Allocator = MakeUnique<FMqttifyPacketIdAllocator>();
+			TestTrue(TEXT("First claim should succeed"), Allocator->Claim(1));
+			TestFalse(TEXT("Second claim should fail"), Allocator->Claim(1));
+			TestFalse(TEXT("Identifier 0 cannot be claimed"), Allocator->Claim(0));
+			TestEqual(TEXT("Claimed identifier is skipped"), Allocator->Allocate(), static_cast<uint16>(2));
+		});
+
+		It("Should not hand out the same identifier to concurrent callers", [this]
+		{
+			const TUniquePtr<FMqttifyPacketIdAllocator> Allocator = MakeUnique<FMqttifyPacketIdAllocator>();
+			constexpr int32 kThreads = 4;
+			constexpr int32 kPerThread = 8192;
+			TArray<TArray<uint16>> Results;
+			Results.SetNum(kThreads);
+
+			ParallelFor(kThreads, [&Allocator, &Results](const int32 InThread)
+			{
+				Results[InThread].Reserve(kPerThread);
+				for (int32 Index = 0; Index < kPerThread; ++Index)
+				{
+					Results[InThread].Add(Allocator->Allocate());
+				}
+			});
+
+			TBitArray<> Seen{false, 1 << 16};
+			for (const TArray<uint16>& Ids : Results)
+			{
+				for (const uint16 Id : Ids)
+				{
+					if (Id == 0 || Seen[Id])
+					{
+						AddError(FString::Printf(TEXT("Identifier %d was handed out twice"), Id));
+						return;
+					}
+					Seen[Id] = true;
+				}
+			}
+			TestEqual(TEXT("Identifiers in use"), Allocator->Num(), kThreads * kPerThread);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,216 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/Commands/MqttifyPublishBatch.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyPubAckPacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyPublishBatchSpec,
+	"Mqttify.Automation.PublishBatch",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static constexpr EMqttifyQualityOfService kAtMostOnce = EMqttifyQualityOfService::AtMostOnce;
+	static constexpr EMqttifyQualityOfService kAtLeastOnce = EMqttifyQualityOfService::AtLeastOnce;
+
+	FMqttifyTestClientContext Fixture;
+
+	/// @return A message on its own topic for each quality of service.
+	static TArray<FMqttifyMessage> MakeMessages(const TArray<EMqttifyQualityOfService>& InQualities)
+	{
+		TArray<FMqttifyMessage> Messages;
+		for (int32 Index = 0; Index < InQualities.Num(); ++Index)
+		{
+			Messages.Emplace(FString::Printf(TEXT("batch/%d"), Index), TArray<uint8>{1, 2, 3}, false, InQualities[Index]);
+		}
+		return Messages;
+	}
+
+	TFuture<TMqttifyResult<FMqttifyPublishResults>> PublishBatch(const TArray<EMqttifyQualityOfService>& InQualities)
+	{
+		return Fixture.Context->PublishBatchAsync(MakeMessages(InQualities), Fixture.Socket);
+	}
+
+	/// @return The number of packets in a write, each shorter than 128 bytes.
+	static int32 CountPackets(const TArray<uint8>& InWrite)
+	{
+		int32 Count = 0;
+		for (int32 Offset = 0; Offset + 1 < InWrite.Num(); Offset += 2 + InWrite[Offset + 1])
+		{
+			++Count;
+		}
+		return Count;
+	}
+
+	/// @return The packet identifiers of the QoS 1 and 2 publishes in a write, each shorter than 128 bytes.
+	static TArray<uint16> GetPacketIds(const TArray<uint8>& InWrite)
+	{
+		TArray<uint16> PacketIds;
+		for (int32 Offset = 0; Offset + 1 < InWrite.Num(); Offset += 2 + InWrite[Offset + 1])
+		{
+			if ((InWrite[Offset] & 0x06) != 0)
+			{
+				const int32 IdOffset = Offset + 4 + (InWrite[Offset + 2] << 8 | InWrite[Offset + 3]);
+				PacketIds.Add(static_cast<uint16>(InWrite[IdOffset] << 8 | InWrite[IdOffset + 1]));
+			}
+		}
+		return PacketIds;
+	}
+
+	void AcknowledgeAll(const TArray<uint8>& InWrite) const
+	{
+		for (const uint16 PacketId : GetPacketIds(InWrite))
+		{
+			Fixture.Context->Acknowledge(FMqttifyPubAckPacket3{PacketId});
+		}
+	}
+
+END_DEFINE_SPEC(FMqttifyPublishBatchSpec)
+
+void FMqttifyPublishBatchSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Fixture.Create();
+		Fixture.Context->FlushOfflinePublishes();
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Publishing a batch", [this]
+	{
+		It("Should write every message of the batch to the socket at once", [this]
+		{
+			TFuture<TMqttifyResult<FMqttifyPublishResults>> Future = PublishBatch(
+				{kAtMostOnce, kAtLeastOnce, kAtMostOnce, kAtLeastOnce, kAtMostOnce});
+			Fixture.Context->ProcessCommands();
+
+			TestEqual(TEXT("One write"), Fixture.Socket->GetWriteCount(), 1);
+			if (TestEqual(TEXT("Writes"), Fixture.Socket->GetSentPackets().Num(), 1))
+			{
+				TestEqual(TEXT("Packets in the write"), CountPackets(Fixture.Socket->GetSentPackets()[0]), 5);
+			}
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 2);
+
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Nothing is sent twice"), Fixture.Socket->GetWriteCount(), 1);
+			TestFalse(TEXT("Waiting for the acknowledgements"), Future.IsReady());
+
+			AcknowledgeAll(Fixture.Socket->GetSentPackets()[0]);
+			if (TestTrue(TEXT("Complete"), Future.IsReady()))
+			{
+				TestTrue(TEXT("Succeeded"), Future.Get().HasSucceeded());
+				TestEqual(TEXT("Results"), Future.Get().GetResult()->Num(), 5);
+			}
+		});
+
+		It("Should leave the publishes to send themselves when the window has no room", [this]
+		{
+			Fixture.Context->SetServerReceiveMaximum(1);
+			PublishBatch({kAtLeastOnce, kAtLeastOnce, kAtMostOnce});
+
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 1);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 1);
+
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("The QoS 0 message and the publish in flight are sent"), Fixture.Socket->GetWriteCount(), 2);
+		});
+
+		It("Should fail a message larger than the broker's Maximum Packet Size on its own", [this]
+		{
+			TArray<FMqttifyMessage> Messages = MakeMessages({kAtMostOnce, kAtLeastOnce, kAtLeastOnce});
+			Messages[1] = FMqttifyMessage{FString::ChrN(100, TEXT('x')), TArray<uint8>{1, 2, 3}, false, kAtLeastOnce};
+			Fixture.Context->SetServerMaximumPacketSize(64);
+			TFuture<TMqttifyResult<FMqttifyPublishResults>> Future = Fixture.Context->PublishBatchAsync(
+				MoveTemp(Messages),
+				Fixture.Socket);
+			Fixture.Context->ProcessCommands();
+
+			if (!TestEqual(TEXT("One write"), Fixture.Socket->GetSentPackets().Num(), 1))
+			{
+				return;
+			}
+			TestEqual(TEXT("The other messages are written"), CountPackets(Fixture.Socket->GetSentPackets()[0]), 2);
+			AcknowledgeAll(Fixture.Socket->GetSentPackets()[0]);
+			if (TestTrue(TEXT("Complete"), Future.IsReady()))
+			{
+				const FMqttifyPublishResults& Results = *Future.Get().GetResult();
+				TestTrue(TEXT("QoS 0 message written"), Results[0].HasSucceeded());
+				TestEqual(TEXT("Too large"), Results[1].GetReasonCode(), EMqttifyReasonCode::PacketTooLarge);
+				TestTrue(TEXT("QoS 1 message acknowledged"), Results[2].HasSucceeded());
+			}
+		});
+
+		It("Should fail the QoS 1 and 2 messages when there are not enough packet identifiers", [this]
+		{
+			TArray<uint16> Taken;
+			TestTrue(TEXT("Every identifier is taken"), Fixture.Context->ReserveIds(65535, Taken));
+			TFuture<TMqttifyResult<FMqttifyPublishResults>> Future = PublishBatch({kAtMostOnce, kAtLeastOnce});
+			Fixture.Context->ProcessCommands();
+
+			if (TestTrue(TEXT("Complete"), Future.IsReady()))
+			{
+				const FMqttifyPublishResults& Results = *Future.Get().GetResult();
+				TestTrue(TEXT("QoS 0 message written"), Results[0].HasSucceeded());
+				TestEqual(TEXT("No identifier"), Results[1].GetReasonCode(), EMqttifyReasonCode::QuotaExceeded);
+			}
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 0);
+		});
+
+		It("Should hold every message in the offline buffer without a session", [this]
+		{
+			Fixture.Context->MarkOffline();
+			TFuture<TMqttifyResult<FMqttifyPublishResults>> Future = PublishBatch({kAtMostOnce, kAtLeastOnce});
+			TestEqual(TEXT("Held offline"), Fixture.Context->GetNumOfflinePublishes(), 2);
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Nothing written offline"), Fixture.Socket->GetWriteCount(), 0);
+
+			Fixture.Context->FlushOfflinePublishes();
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Each message is written on its own"), Fixture.Socket->GetWriteCount(), 2);
+			for (const TArray<uint8>& Write : Fixture.Socket->GetSentPackets())
+			{
+				AcknowledgeAll(Write);
+			}
+			TestTrue(TEXT("Succeeded"), Future.IsReady() && Future.Get().HasSucceeded());
+		});
+
+		It("Should report the result of each message in order", [this]
+		{
+			TFuture<TMqttifyResult<FMqttifyPublishResults>> Future = PublishBatch({kAtMostOnce, kAtLeastOnce});
+			Fixture.Context->ProcessCommands();
+			Fixture.Context->AbandonCommands();
+
+			if (TestTrue(TEXT("Complete"), Future.IsReady()))
+			{
+				const TMqttifyResult<FMqttifyPublishResults>& Result = Future.Get();
+				TestFalse(TEXT("A failed message fails the batch"), Result.HasSucceeded());
+				if (TestTrue(TEXT("Results"), Result.GetResult().IsValid() && Result.GetResult()->Num() == 2))
+				{
+					TestTrue(TEXT("QoS 0 message written"), (*Result.GetResult())[0].HasSucceeded());
+					TestFalse(TEXT("Abandoned publish failed"), (*Result.GetResult())[1].HasSucceeded());
+				}
+			}
+		});
+	});
+
+	Describe("Reserving packet identifiers", [this]
+	{
+		It("Should take distinct identifiers for the whole batch", [this]
+		{
+			TArray<uint16> Ids;
+			TestTrue(TEXT("Reserved"), Fixture.Context->ReserveIds(100, Ids));
+			TestEqual(TEXT("Count"), Ids.Num(), 100);
+			TestEqual(TEXT("Distinct"), TSet<uint16>(Ids).Num(), 100);
+			TestFalse(TEXT("No identifier is 0"), Ids.Contains(0));
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/Commands/MqttifyPublish.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifyPubAckPacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyReceiveMaximumSpec,
+	"Mqttify.Automation.ReceiveMaximum",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	/// @return The packet identifier of the publish.
+	uint16 Publish() const
+	{
+		const uint16 PacketId = Fixture.Context->GetNextId();
+		Fixture.Context->AddPublishCommand(
+			MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+				FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				PacketId,
+				Fixture.Socket,
+				Fixture.Context->GetConnectionSettings(),
+				Fixture.Context->GetRetransmitCache()));
+		return PacketId;
+	}
+
+END_DEFINE_SPEC(FMqttifyReceiveMaximumSpec)
+
+void FMqttifyReceiveMaximumSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Fixture.Create();
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("FMqttifyClientContext publish window", [this]
+	{
+		It("Should hold publishes beyond the broker's Receive Maximum", [this]
+		{
+			Fixture.Context->SetServerReceiveMaximum(2);
+			const uint16 First = Publish();
+			const uint16 Second = Publish();
+			Publish();
+			Publish();
+
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 2);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 2);
+			TestTrue(TEXT("First publish in flight"), Fixture.Context->HasAcknowledgeableCommand(First));
+			TestTrue(TEXT("Second publish in flight"), Fixture.Context->HasAcknowledgeableCommand(Second));
+		});
+
+		It("Should release pending publishes in order as acknowledgements arrive", [this]
+		{
+			Fixture.Context->SetServerReceiveMaximum(1);
+			const uint16 First = Publish();
+			const uint16 Second = Publish();
+			const uint16 Third = Publish();
+			TestFalse(TEXT("Second publish held"), Fixture.Context->HasAcknowledgeableCommand(Second));
+
+			Fixture.Context->Acknowledge(FMqttifyPubAckPacket3{First});
+			TestTrue(TEXT("Second publish in flight"), Fixture.Context->HasAcknowledgeableCommand(Second));
+			TestFalse(TEXT("Third publish held"), Fixture.Context->HasAcknowledgeableCommand(Third));
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 1);
+
+			Fixture.Context->Acknowledge(FMqttifyPubAckPacket3{Second});
+			Fixture.Context->Acknowledge(FMqttifyPubAckPacket3{Third});
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 0);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 0);
+		});
+
+		It("Should release pending publishes when the Receive Maximum grows", [this]
+		{
+			Fixture.Context->SetServerReceiveMaximum(1);
+			Publish();
+			Publish();
+			Publish();
+
+			Fixture.Context->SetServerReceiveMaximum(std::numeric_limits<uint16>::max());
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 3);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 0);
+		});
+
+		It("Should abandon pending publishes with the in-flight ones", [this]
+		{
+			Fixture.Context->SetServerReceiveMaximum(1);
+			const uint16 First = Publish();
+			const uint16 Second = Publish();
+
+			Fixture.Context->AbandonCommands();
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 0);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 0);
+			TestFalse(TEXT("In-flight identifier released"), Fixture.Context->IsIdAllocated(First));
+			TestFalse(TEXT("Pending identifier released"), Fixture.Context->IsIdAllocated(Second));
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
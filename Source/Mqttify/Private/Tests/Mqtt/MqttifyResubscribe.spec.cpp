@@ -0,0 +1,162 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifySubscribeResult.h"
+#include "Mqtt/MqttifyUnsubscribeResult.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifySubAckPacket.h"
+#include "Packets/MqttifySubscribePacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyResubscribeSpec,
+	"Mqttify.Automation.Resubscribe",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	/// @brief Mark topic filters as granted by the broker, the way a SUBACK does.
+	void Subscribe(const int32 InCount, const FString& InPrefix = TEXT("level/actor")) const
+	{
+		TArray<FMqttifySubscribeResult> Results;
+		for (int32 Index = 0; Index < InCount; ++Index)
+		{
+			const FString Filter = FString::Printf(TEXT("%s/%d"), *InPrefix, Index);
+			Results.Emplace(FMqttifyTopicFilter{Filter}, true, Fixture.Context->GetMessageDelegate(Filter));
+		}
+		Fixture.Context->AddActiveSubscriptions(Results);
+	}
+
+	/// @return The SUBSCRIBE packets sent.
+	TArray<TArray<uint8>> GetSentSubscribes() const
+	{
+		TArray<TArray<uint8>> Subscribes;
+		for (const TArray<uint8>& Packet : Fixture.Socket->GetSentPackets())
+		{
+			if (Packet.Num() > 0 && Packet[0] == 0x82)
+			{
+				Subscribes.Add(Packet);
+			}
+		}
+		return Subscribes;
+	}
+
+END_DEFINE_SPEC(FMqttifyResubscribeSpec)
+
+void FMqttifyResubscribeSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Fixture.Create();
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Tracking subscriptions", [this]
+	{
+		It("Should track granted topic filters until they are unsubscribed", [this]
+		{
+			Subscribe(3);
+			Fixture.Context->AddActiveSubscriptions(
+				{FMqttifySubscribeResult{FMqttifyTopicFilter{TEXT("refused")}, false}});
+			TestEqual(TEXT("Granted filters are active"), Fixture.Context->GetNumActiveSubscriptions(), 3);
+
+			const TSharedPtr<TArray<FMqttifyUnsubscribeResult>> Unsubscribed = MakeShared<TArray<
+				FMqttifyUnsubscribeResult>>();
+			Unsubscribed->Emplace(FMqttifyTopicFilter{TEXT("level/actor/1")}, true);
+			Fixture.Context->ClearMessageDelegates(Unsubscribed);
+			TestEqual(TEXT("Unsubscribed filter is forgotten"), Fixture.Context->GetNumActiveSubscriptions(), 2);
+		});
+	});
+
+	Describe("Resubscribing", [this]
+	{
+		It("Should send nothing without active subscriptions", [this]
+		{
+			TestEqual(TEXT("Packets queued"), Fixture.Context->Resubscribe(Fixture.Socket), 0);
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Subscribes sent"), GetSentSubscribes().Num(), 0);
+		});
+
+		It("Should restore every subscription in one packet when the broker sets no size limit", [this]
+		{
+			Subscribe(200);
+			TestEqual(TEXT("Packets queued"), Fixture.Context->Resubscribe(Fixture.Socket), 1);
+			Fixture.Context->ProcessCommands();
+			TestEqual(TEXT("Subscribes sent"), GetSentSubscribes().Num(), 1);
+		});
+
+		It("Should split the subscriptions at the broker's Maximum Packet Size", [this]
+		{
+			constexpr uint32 kMaximumPacketSize = 128;
+			Subscribe(40);
+			Fixture.Context->SetServerMaximumPacketSize(kMaximumPacketSize);
+
+			const int32 NumPackets = Fixture.Context->Resubscribe(Fixture.Socket);
+			TestTrue(TEXT("More than one packet is needed"), NumPackets > 1);
+			Fixture.Context->ProcessCommands();
+
+			const TArray<TArray<uint8>> Subscribes = GetSentSubscribes();
+			TestEqual(TEXT("Subscribes sent"), Subscribes.Num(), NumPackets);
+			int32 TotalSize = 0;
+			for (const TArray<uint8>& Subscribe : Subscribes)
+			{
+				TestTrue(TEXT("Packet fits the limit"), Subscribe.Num() <= static_cast<int32>(kMaximumPacketSize));
+				TotalSize += Subscribe.Num();
+			}
+
+			// Every packet but the last was closed because the next topic filter did not fit, none is longer than this
+			const int32 LongestFilterLength = static_cast<int32>(
+				TMqttifySubscribePacket<GMqttifyProtocol>::GetTopicFilterLength(
+					FMqttifyTopicFilter{TEXT("level/actor/39")}));
+			for (int32 Index = 0; Index < Subscribes.Num() - 1; ++Index)
+			{
+				TestTrue(
+					TEXT("Packet is filled"),
+					Subscribes[Index].Num() + LongestFilterLength > static_cast<int32>(kMaximumPacketSize));
+			}
+		});
+
+		It("Should skip a topic filter that does not fit a packet of its own", [this]
+		{
+			Subscribe(2);
+			Subscribe(1, FString::ChrN(200, TEXT('x')));
+			Fixture.Context->SetServerMaximumPacketSize(128);
+
+			TestEqual(TEXT("Packets queued"), Fixture.Context->Resubscribe(Fixture.Socket), 1);
+		});
+
+		It("Should forget a subscription the broker refuses on the new session", [this]
+		{
+			Subscribe(2);
+			Fixture.Context->Resubscribe(Fixture.Socket);
+			Fixture.Context->ProcessCommands();
+
+			const TArray<TArray<uint8>> Subscribes = GetSentSubscribes();
+			if (!TestEqual(TEXT("Subscribes sent"), Subscribes.Num(), 1))
+			{
+				return;
+			}
+			const uint16 PacketId = static_cast<uint16>(Subscribes[0][2] << 8 | Subscribes[0][3]);
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				Fixture.Context->Acknowledge(
+					FMqttifySubAckPacket5{PacketId, {EMqttifyReasonCode::Success, EMqttifyReasonCode::NotAuthorized}});
+			}
+			else
+			{
+				Fixture.Context->Acknowledge(
+					FMqttifySubAckPacket3{
+						PacketId,
+						{EMqttifySubscribeReturnCode::SuccessQualityOfService0, EMqttifySubscribeReturnCode::Failure}});
+			}
+			TestEqual(TEXT("Refused filter is forgotten"), Fixture.Context->GetNumActiveSubscriptions(), 1);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
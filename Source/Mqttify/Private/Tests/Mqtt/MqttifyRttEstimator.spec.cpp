@@ -0,0 +1,105 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyRttEstimator.h"
+#include "Mqtt/Commands/MqttifyUnsubscribe.h"
+#include "Tests/Support/FakeTestSocket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyRttEstimatorSpec,
+	"Mqttify.Automation.RttEstimator",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+END_DEFINE_SPEC(FMqttifyRttEstimatorSpec)
+
+void FMqttifyRttEstimatorSpec::Define()
+{
+	Describe("FMqttifyRttEstimator", [this]
+	{
+		It("Should use the initial timeout before the first sample", [this]
+		{
+			const FMqttifyRttEstimator Estimator;
+			TestEqual(TEXT("Initial timeout"), Estimator.GetRetryTimeout(), FMqttifyRttEstimator::kInitialRetryTimeoutSeconds);
+		});
+
+		It("Should take the first sample as the smoothed round trip time", [this]
+		{
+			FMqttifyRttEstimator Estimator;
+			Estimator.AddSample(0.5);
+			TestEqual(TEXT("SRTT"), Estimator.GetSmoothedRoundTrip(), 0.5);
+			TestEqual(TEXT("RTTVAR"), Estimator.GetRoundTripVariation(), 0.25);
+			TestEqual(TEXT("RTO = SRTT + 4 * RTTVAR"), Estimator.GetRetryTimeout(), 1.5);
+		});
+
+		It("Should smooth later samples", [this]
+		{
+			FMqttifyRttEstimator Estimator;
+			Estimator.AddSample(0.4);
+			Estimator.AddSample(0.8);
+			// RTTVAR = 3/4 * 0.2 + 1/4 * |0.4 - 0.8|, SRTT = 7/8 * 0.4 + 1/8 * 0.8
+			TestEqual(TEXT("RTTVAR"), Estimator.GetRoundTripVariation(), 0.25, 1e-9);
+			TestEqual(TEXT("SRTT"), Estimator.GetSmoothedRoundTrip(), 0.45, 1e-9);
+			TestEqual(TEXT("RTO"), Estimator.GetRetryTimeout(), 1.45, 1e-9);
+		});
+
+		It("Should bring the timeout under a second on a fast link", [this]
+		{
+			FMqttifyRttEstimator Estimator;
+			for (int32 i = 0; i < 64; ++i)
+			{
+				Estimator.AddSample(0.005);
+			}
+			TestEqual(TEXT("Floored timeout"), Estimator.GetRetryTimeout(), FMqttifyRttEstimator::kMinRetryTimeoutSeconds);
+		});
+
+		It("Should raise the timeout when the round trip time varies", [this]
+		{
+			FMqttifyRttEstimator Steady;
+			FMqttifyRttEstimator Jittery;
+			for (int32 i = 0; i < 64; ++i)
+			{
+				Steady.AddSample(0.3);
+				Jittery.AddSample(i % 2 == 0 ? 0.1 : 0.5);
+			}
+			TestTrue(TEXT("Jittery link waits longer"), Jittery.GetRetryTimeout() > Steady.GetRetryTimeout());
+		});
+	});
+
+	Describe("Adaptive retry policy", [this]
+	{
+		It("Should schedule retries from the estimate and back off for each try", [this]
+		{
+			const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+				TEXT("mqtt://localhost:1883")).SetRetryPolicy(EMqttifyRetryPolicy::Adaptive).Build().ToSharedRef();
+			const TSharedRef<FFakeTestSocket> Socket = MakeShared<FFakeTestSocket>(Settings);
+			Socket->Connect();
+			for (int32 i = 0; i < 64; ++i)
+			{
+				Socket->GetRttEstimator().AddSample(0.005);
+			}
+
+			const TSharedRef<FMqttifyUnsubscribe> Command = MakeShared<FMqttifyUnsubscribe>(
+				TArray<FMqttifyTopicFilter>{FMqttifyTopicFilter{TEXT("a/b")}},
+				1,
+				Socket,
+				Settings);
+
+			double Now = FPlatformTime::Seconds();
+			Command->Next(Now);
+			const double FirstWait = Command->GetRetryWaitTime() - Now;
+			TestTrue(TEXT("First retry after the estimated timeout"), FirstWait > 0.15 && FirstWait < 0.3);
+
+			Now = Command->GetRetryWaitTime();
+			Command->Next(Now);
+			const double SecondWait = Command->GetRetryWaitTime() - FPlatformTime::Seconds();
+			TestTrue(TEXT("Second retry backed off"), SecondWait > 0.3 && SecondWait < 0.5);
+			Command->Abandon();
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
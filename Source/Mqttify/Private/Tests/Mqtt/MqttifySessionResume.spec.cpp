@@ -0,0 +1,179 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/MqttifySubscribeResult.h"
+#include "Mqtt/Commands/MqttifyPublish.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifySessionResumeSpec,
+	"Mqttify.Automation.SessionResume",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	void Setup(const uint32 InPublishDeadlineSeconds)
+	{
+		const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+			TEXT("mqtt://localhost:1883")).SetPublishDeadlineSeconds(InPublishDeadlineSeconds).Build().ToSharedRef();
+		Fixture.Create(Settings);
+	}
+
+	/// @return The packet identifier of the publish.
+	uint16 Publish() const
+	{
+		const uint16 PacketId = Fixture.Context->GetNextId();
+		Fixture.Context->AddPublishCommand(
+			MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+				FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				PacketId,
+				Fixture.Socket,
+				Fixture.Context->GetConnectionSettings(),
+				Fixture.Context->GetRetransmitCache()));
+		return PacketId;
+	}
+
+	/// @return The packet identifier of an encoded publish to "a/b".
+	static uint16 GetPublishPacketId(const TArray<uint8>& InBytes)
+	{
+		// Fixed header, one byte of remaining length, then the two byte length of "a/b" and the topic itself
+		return static_cast<uint16>(InBytes[7] << 8 | InBytes[8]);
+	}
+
+END_DEFINE_SPEC(FMqttifySessionResumeSpec)
+
+void FMqttifySessionResumeSpec::Define()
+{
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Resuming the session", [this]
+	{
+		BeforeEach([this] { Setup(0); });
+
+		It("Should send the in-flight publishes again in order with the DUP flag set", [this]
+		{
+			const uint16 First = Publish();
+			const uint16 Second = Publish();
+			const uint16 Third = Publish();
+			Fixture.Context->ProcessCommands();
+
+			Fixture.Socket->Disconnect();
+			Fixture.Socket->Connect();
+			Fixture.Socket->ResetSentPackets();
+			Fixture.Context->ResumeSession();
+			Fixture.Context->ProcessCommands();
+
+			const TArray<TArray<uint8>>& Sent = Fixture.Socket->GetSentPackets();
+			if (!TestEqual(TEXT("Packets sent again"), Sent.Num(), 3))
+			{
+				return;
+			}
+			TestEqual(TEXT("First publish"), GetPublishPacketId(Sent[0]), First);
+			TestEqual(TEXT("Second publish"), GetPublishPacketId(Sent[1]), Second);
+			TestEqual(TEXT("Third publish"), GetPublishPacketId(Sent[2]), Third);
+			for (const TArray<uint8>& Bytes : Sent)
+			{
+				TestTrue(TEXT("DUP flag set"), (Bytes[0] & 0x08) != 0);
+			}
+		});
+
+		It("Should send a publish recovered from the session store with the DUP flag set", [this]
+		{
+			const FMqttifyPubAtLeastOnceRef Recovered = MakeShared<FMqttifyPubAtLeastOnce, ESPMode::ThreadSafe>(
+				FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				Fixture.Context->GetNextId(),
+				Fixture.Socket,
+				Fixture.Context->GetConnectionSettings(),
+				Fixture.Context->GetRetransmitCache());
+			Recovered->MarkRecovered();
+			Fixture.Context->AddPublishCommand(Recovered);
+			Fixture.Context->ProcessCommands();
+
+			if (TestEqual(TEXT("Packets sent"), Fixture.Socket->GetSentPackets().Num(), 1))
+			{
+				TestTrue(TEXT("DUP flag set"), (Fixture.Socket->GetSentPackets()[0][0] & 0x08) != 0);
+			}
+		});
+	});
+
+	Describe("Losing the session", [this]
+	{
+		BeforeEach([this] { Setup(0); });
+
+		It("Should abandon the publishes that were sent and keep the ones that were not", [this]
+		{
+			const uint16 Sent = Publish();
+			Fixture.Context->ProcessCommands();
+			const uint16 Unsent = Publish();
+
+			Fixture.Context->DiscardSession();
+			TestFalse(TEXT("Sent publish abandoned"), Fixture.Context->HasAcknowledgeableCommand(Sent));
+			TestTrue(TEXT("Unsent publish kept"), Fixture.Context->HasAcknowledgeableCommand(Unsent));
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 1);
+		});
+	});
+
+	Describe("Publish deadline", [this]
+	{
+		It("Should abandon publishes older than the deadline", [this]
+		{
+			Setup(1);
+			const uint16 PacketId = Publish();
+
+			Fixture.Context->ExpireCommands(FPlatformTime::Seconds());
+			TestTrue(TEXT("Publish kept before the deadline"), Fixture.Context->HasAcknowledgeableCommand(PacketId));
+
+			Fixture.Context->ExpireCommands(FPlatformTime::Seconds() + 2.0);
+			TestFalse(
+				TEXT("Publish abandoned after the deadline"),
+				Fixture.Context->HasAcknowledgeableCommand(PacketId));
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 0);
+			TestFalse(TEXT("Packet identifier released"), Fixture.Context->IsIdAllocated(PacketId));
+		});
+
+		It("Should abandon pending publishes older than the deadline", [this]
+		{
+			Setup(1);
+			Fixture.Context->SetServerReceiveMaximum(1);
+			const uint16 InFlight = Publish();
+			const uint16 Pending = Publish();
+
+			Fixture.Context->ExpireCommands(FPlatformTime::Seconds() + 2.0);
+			TestEqual(TEXT("In flight"), Fixture.Context->GetNumInFlightPublishes(), 0);
+			TestEqual(TEXT("Pending"), Fixture.Context->GetNumPendingPublishes(), 0);
+			TestFalse(TEXT("In-flight packet identifier released"), Fixture.Context->IsIdAllocated(InFlight));
+			TestFalse(TEXT("Pending packet identifier released"), Fixture.Context->IsIdAllocated(Pending));
+		});
+
+		It("Should keep a SUBSCRIBE waiting for its acknowledgement past the deadline", [this]
+		{
+			Setup(1);
+			TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
+			TopicFilters.Emplace(FMqttifyTopicFilter{TEXT("a/b")}, Fixture.Context->GetMessageDelegate(TEXT("a/b")));
+			const TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>> Future =
+				Fixture.Context->AddSubscribeRequest(MoveTemp(TopicFilters));
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			Fixture.Context->ProcessCommands();
+
+			Fixture.Context->ExpireCommands(FPlatformTime::Seconds() + 2.0);
+			TestFalse(TEXT("Subscribe still waiting"), Future.IsReady());
+		});
+
+		It("Should keep publishes without a deadline", [this]
+		{
+			Setup(0);
+			const uint16 PacketId = Publish();
+
+			Fixture.Context->ExpireCommands(FPlatformTime::Seconds() + 3600.0);
+			TestTrue(TEXT("Publish kept"), Fixture.Context->HasAcknowledgeableCommand(PacketId));
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
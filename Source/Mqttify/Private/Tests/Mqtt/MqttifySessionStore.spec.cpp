@@ -0,0 +1,219 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Mqtt/State/MqttifySessionStore.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifySessionStoreSpec,
+	"Mqttify.Automation.SessionStore",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FString Directory;
+	FString Path;
+
+	static FMqttifyMessage MakeMessage(const int32 InIndex,
+										const EMqttifyQualityOfService InQualityOfService,
+										const int32 InPayloadSize = 4)
+	{
+		TArray<uint8> Payload;
+		Payload.Init(static_cast<uint8>(InIndex), InPayloadSize);
+		return FMqttifyMessage{FString::Printf(TEXT("a/%d"), InIndex), MoveTemp(Payload), false, InQualityOfService};
+	}
+
+END_DEFINE_SPEC(FMqttifySessionStoreSpec)
+
+void FMqttifySessionStoreSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MqttifySessionStore"));
+		Path = FPaths::Combine(Directory, TEXT("Client.mqttsession"));
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	});
+
+	AfterEach([this]
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	});
+
+	Describe("FMqttifySessionStore", [this]
+	{
+		It("Should read back the publishes that are not done with in the order they were made", [this]
+		{
+			{
+				TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+				const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+				if (!TestTrue(TEXT("Store should open"), Store.IsValid()))
+				{
+					return;
+				}
+				TestEqual(TEXT("New log should be empty"), Recovered.Num(), 0);
+
+				Store->AddPublish(7, MakeMessage(1, EMqttifyQualityOfService::AtLeastOnce));
+				Store->AddPublish(3, MakeMessage(2, EMqttifyQualityOfService::ExactlyOnce));
+				Store->AddPublish(5, MakeMessage(3, EMqttifyQualityOfService::AtLeastOnce));
+				Store->Release(3);
+				Store->Remove(5);
+				Store->Remove(42);
+				Store->Commit();
+				TestEqual(TEXT("Publishes in the log"), Store->Num(), 2);
+			}
+
+			TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+			const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+			if (!TestEqual(TEXT("Recovered publishes"), Recovered.Num(), 2))
+			{
+				return;
+			}
+			TestEqual(TEXT("First packet id"), Recovered[0].PacketId, static_cast<uint16>(7));
+			TestEqual(TEXT("First topic"), Recovered[0].Message.GetTopic(), FString{TEXT("a/1")});
+			TestEqual(
+				TEXT("First quality of service"),
+				Recovered[0].Message.GetQualityOfService(),
+				EMqttifyQualityOfService::AtLeastOnce);
+			TestFalse(TEXT("First is not released"), Recovered[0].bIsReleased);
+			TestEqual(TEXT("Second packet id"), Recovered[1].PacketId, static_cast<uint16>(3));
+			TestTrue(TEXT("Second payload"), Recovered[1].Message.GetPayload() == TArray<uint8>{2, 2, 2, 2});
+			TestTrue(TEXT("Second is released"), Recovered[1].bIsReleased);
+		});
+
+		It("Should keep committed publishes when the process dies before the log is closed", [this]
+		{
+			TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+			const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+			if (!TestTrue(TEXT("Store should open"), Store.IsValid()))
+			{
+				return;
+			}
+			for (int32 Index = 1; Index <= 3; ++Index)
+			{
+				Store->AddPublish(Index, MakeMessage(Index, EMqttifyQualityOfService::AtLeastOnce));
+			}
+			Store->Commit();
+			Store->AddPublish(4, MakeMessage(4, EMqttifyQualityOfService::AtLeastOnce));
+
+			// Read while the writer is still open, as a new process would after a crash
+			TestTrue(TEXT("File should be a session log"), FMqttifySessionStore::Read(Path, Recovered));
+			TestEqual(TEXT("Only committed publishes are recovered"), Recovered.Num(), 3);
+		});
+
+		It("Should ignore a record torn by a crash", [this]
+		{
+			{
+				TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+				const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+				Store->AddPublish(1, MakeMessage(1, EMqttifyQualityOfService::AtLeastOnce));
+				Store->AddPublish(2, MakeMessage(2, EMqttifyQualityOfService::ExactlyOnce));
+			}
+
+			TArray<uint8> Bytes;
+			FFileHelper::LoadFileToArray(Bytes, *Path);
+			const int32 CompleteSize = Bytes.Num();
+			{
+				TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+				const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+				Store->AddPublish(3, MakeMessage(3, EMqttifyQualityOfService::AtLeastOnce));
+			}
+
+			// Cut the last record in half
+			FFileHelper::LoadFileToArray(Bytes, *Path);
+			Bytes.SetNum(CompleteSize + (Bytes.Num() - CompleteSize) / 2);
+			FFileHelper::SaveArrayToFile(Bytes, *Path);
+
+			TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+			TestTrue(TEXT("File should be a session log"), FMqttifySessionStore::Read(Path, Recovered));
+			TestEqual(TEXT("Records before the tear are recovered"), Recovered.Num(), 2);
+
+			// Drop the torn record and flip a byte of the checksum of the one before it
+			Bytes.SetNum(CompleteSize);
+			Bytes[CompleteSize - 1] ^= 0xFF;
+			FFileHelper::SaveArrayToFile(Bytes, *Path);
+			Recovered.Reset();
+			FMqttifySessionStore::Read(Path, Recovered);
+			TestEqual(TEXT("A record with a bad checksum is dropped"), Recovered.Num(), 1);
+		});
+
+		It("Should compact the log once it is mostly finished publishes", [this]
+		{
+			TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+			const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+			if (!TestTrue(TEXT("Store should open"), Store.IsValid()))
+			{
+				return;
+			}
+
+			constexpr int32 kPayloadSize = 64 * 1024;
+			Store->AddPublish(1, MakeMessage(1, EMqttifyQualityOfService::AtLeastOnce, kPayloadSize));
+			for (int32 Index = 2; Index < 40; ++Index)
+			{
+				Store->AddPublish(Index, MakeMessage(Index, EMqttifyQualityOfService::AtLeastOnce, kPayloadSize));
+				Store->Remove(Index);
+			}
+			TestTrue(
+				TEXT("Log should be above the compaction threshold"),
+				Store->GetFileSize() > FMqttifySessionStore::kMinCompactionBytes);
+
+			Store->Commit();
+			TestTrue(TEXT("Log should be compacted"), Store->GetFileSize() < 2 * kPayloadSize);
+			TestEqual(
+				TEXT("File size"),
+				IFileManager::Get().FileSize(*Path),
+				Store->GetFileSize());
+
+			TArray<FMqttifySessionStore::FStoredPublish> AfterCompaction;
+			FMqttifySessionStore::Read(Path, AfterCompaction);
+			if (TestEqual(TEXT("Live publish survives compaction"), AfterCompaction.Num(), 1))
+			{
+				TestEqual(TEXT("Packet id"), AfterCompaction[0].PacketId, static_cast<uint16>(1));
+			}
+		});
+	});
+
+	Describe("FMqttifyClientContext", [this]
+	{
+		It("Should recover publishes of the log and keep their packet ids in use", [this]
+		{
+			{
+				TArray<FMqttifySessionStore::FStoredPublish> Recovered;
+				const TSharedPtr<FMqttifySessionStore> Store = FMqttifySessionStore::Open(Path, Recovered);
+				Store->AddPublish(1, MakeMessage(1, EMqttifyQualityOfService::AtLeastOnce));
+			}
+
+			const FMqttifyConnectionSettingsRef Settings = FMqttifyConnectionSettingsBuilder(
+					TEXT("mqtt://localhost:1883"))
+				.SetClientId(TEXT("Client"))
+				.SetSessionStoreDirectory(Directory)
+				.Build()
+				.ToSharedRef();
+			const TSharedRef<FMqttifyTimerWheel> TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			const TSharedRef<FMqttifyClientContext> Context = MakeShared<FMqttifyClientContext>(Settings, TimerWheel);
+
+			const TArray<FMqttifySessionStore::FStoredPublish> Recovered = Context->TakeRecoveredPublishes();
+			TestEqual(TEXT("Recovered publishes"), Recovered.Num(), 1);
+			TestEqual(TEXT("Recovered packet id is not handed out"), Context->GetNextId(), static_cast<uint16>(2));
+			TestEqual(TEXT("Recovered publishes are taken once"), Context->TakeRecoveredPublishes().Num(), 0);
+
+			Context->PersistPublish(2, MakeMessage(2, EMqttifyQualityOfService::AtLeastOnce));
+			Context->ReleaseId(1);
+			Context->CommitSessionStore();
+
+			TArray<FMqttifySessionStore::FStoredPublish> Stored;
+			FMqttifySessionStore::Read(Path, Stored);
+			if (TestEqual(TEXT("Released publish is removed from the log"), Stored.Num(), 1))
+			{
+				TestEqual(TEXT("Packet id"), Stored[0].PacketId, static_cast<uint16>(2));
+			}
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,370 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/MqttifySubscribeResult.h"
+#include "Mqtt/MqttifyUnsubscribeResult.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Packets/MqttifySubAckPacket.h"
+#include "Packets/MqttifyUnsubAckPacket.h"
+#include "Tests/Support/MqttifyTestClientContext.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifySubscriptionCoalescingSpec,
+	"Mqttify.Automation.SubscriptionCoalescing",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	FMqttifyTestClientContext Fixture;
+
+	using FSubscribeFuture = TFuture<TMqttifyResult<TArray<FMqttifySubscribeResult>>>;
+	using FUnsubscribeFuture = TFuture<TMqttifyResult<TArray<FMqttifyUnsubscribeResult>>>;
+
+	FSubscribeFuture Subscribe(const TArray<FString>& InFilters,
+								const EMqttifyQualityOfService InQualityOfService =
+									EMqttifyQualityOfService::AtMostOnce) const
+	{
+		TArray<TTuple<FMqttifyTopicFilter, TSharedRef<FOnMessage>>> TopicFilters;
+		for (const FString& Filter : InFilters)
+		{
+			TopicFilters.Emplace(
+				FMqttifyTopicFilter{Filter, InQualityOfService},
+				Fixture.Context->GetMessageDelegate(Filter));
+		}
+		return Fixture.Context->AddSubscribeRequest(MoveTemp(TopicFilters));
+	}
+
+	FUnsubscribeFuture Unsubscribe(const TArray<FString>& InFilters) const
+	{
+		TArray<FMqttifyTopicFilter> TopicFilters;
+		for (const FString& Filter : InFilters)
+		{
+			TopicFilters.Emplace(Filter);
+		}
+		return Fixture.Context->AddUnsubscribeRequest(MoveTemp(TopicFilters));
+	}
+
+	/// @return The packet identifier of a sent SUBSCRIBE or UNSUBSCRIBE shorter than 128 bytes.
+	static uint16 GetPacketId(const TArray<uint8>& InPacket)
+	{
+		return static_cast<uint16>(InPacket[2] << 8 | InPacket[3]);
+	}
+
+	void AcknowledgeSubscribe(const TArray<uint8>& InPacket,
+							const int32 InNumTopicFilters,
+							const bool bInGranted = true) const
+	{
+		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+		{
+			TArray<EMqttifyReasonCode> ReasonCodes;
+			ReasonCodes.Init(
+				bInGranted ? EMqttifyReasonCode::Success : EMqttifyReasonCode::UnspecifiedError,
+				InNumTopicFilters);
+			Fixture.Context->Acknowledge(FMqttifySubAckPacket5{GetPacketId(InPacket), ReasonCodes});
+		}
+		else
+		{
+			TArray<EMqttifySubscribeReturnCode> ReturnCodes;
+			ReturnCodes.Init(
+				bInGranted
+				? EMqttifySubscribeReturnCode::SuccessQualityOfService0
+				: EMqttifySubscribeReturnCode::Failure,
+				InNumTopicFilters);
+			Fixture.Context->Acknowledge(FMqttifySubAckPacket3{GetPacketId(InPacket), ReturnCodes});
+		}
+	}
+
+	void AcknowledgeUnsubscribe(const TArray<uint8>& InPacket, const int32 InNumTopicFilters) const
+	{
+		if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+		{
+			TArray<EMqttifyReasonCode> ReasonCodes;
+			ReasonCodes.Init(EMqttifyReasonCode::Success, InNumTopicFilters);
+			Fixture.Context->Acknowledge(FMqttifyUnsubAckPacket5{GetPacketId(InPacket), ReasonCodes});
+		}
+		else
+		{
+			Fixture.Context->Acknowledge(FMqttifyUnsubAckPacket3{GetPacketId(InPacket)});
+		}
+	}
+
+	/// @return The packets sent since the last call.
+	TArray<TArray<uint8>> TakeSentPackets() const
+	{
+		Fixture.Context->ProcessCommands();
+		TArray<TArray<uint8>> Sent = Fixture.Socket->GetSentPackets();
+		Fixture.Socket->ResetSentPackets();
+		return Sent;
+	}
+
+END_DEFINE_SPEC(FMqttifySubscriptionCoalescingSpec)
+
+void FMqttifySubscriptionCoalescingSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Fixture.Create();
+	});
+
+	AfterEach([this] { Fixture.Reset(); });
+
+	Describe("Coalescing subscribe calls", [this]
+	{
+		It("Should send the subscribe calls of a tick in one packet and split the SUBACK between the callers", [this]
+		{
+			FSubscribeFuture First = Subscribe({TEXT("a/1")});
+			FSubscribeFuture Second = Subscribe({TEXT("a/2"), TEXT("a/3")});
+			FSubscribeFuture Third = Subscribe({TEXT("a/4")});
+			TestEqual(TEXT("Calls queued"), Fixture.Context->GetNumSubscriptionRequests(), 3);
+
+			TestEqual(TEXT("Packets queued"), Fixture.Context->FlushSubscriptionRequests(Fixture.Socket), 1);
+			Fixture.Context->ProcessCommands();
+			const TArray<TArray<uint8>>& Sent = Fixture.Socket->GetSentPackets();
+			if (!TestEqual(TEXT("Packets sent"), Sent.Num(), 1) || !TestEqual(TEXT("SUBSCRIBE"), Sent[0][0], 0x82))
+			{
+				return;
+			}
+			TestFalse(TEXT("Waiting for the SUBACK"), First.IsReady());
+
+			AcknowledgeSubscribe(Sent[0], 4);
+			if (!TestTrue(TEXT("All calls complete"), First.IsReady() && Second.IsReady() && Third.IsReady()))
+			{
+				return;
+			}
+			TestTrue(TEXT("Second succeeded"), Second.Get().HasSucceeded());
+			const TArray<FMqttifySubscribeResult>& Results = *Second.Get().GetResult();
+			if (TestEqual(TEXT("Second gets its own results"), Results.Num(), 2))
+			{
+				TestEqual(TEXT("First filter"), Results[0].GetFilter().GetFilter(), FString{TEXT("a/2")});
+				TestEqual(TEXT("Second filter"), Results[1].GetFilter().GetFilter(), FString{TEXT("a/3")});
+			}
+			TestEqual(TEXT("Third gets its own result"), Third.Get().GetResult()->Num(), 1);
+			TestEqual(TEXT("Granted filters are active"), Fixture.Context->GetNumActiveSubscriptions(), 4);
+		});
+
+		It("Should keep subscribes and unsubscribes in the order they were made", [this]
+		{
+			Subscribe({TEXT("a/1")});
+			Subscribe({TEXT("a/2")});
+			Unsubscribe({TEXT("a/1")});
+			Subscribe({TEXT("a/1")});
+
+			TestEqual(TEXT("Packets queued"), Fixture.Context->FlushSubscriptionRequests(Fixture.Socket), 3);
+			Fixture.Context->ProcessCommands();
+			const TArray<TArray<uint8>>& Sent = Fixture.Socket->GetSentPackets();
+			if (TestEqual(TEXT("Packets sent"), Sent.Num(), 3))
+			{
+				TestEqual(TEXT("First is a SUBSCRIBE"), Sent[0][0], 0x82);
+				TestEqual(TEXT("Second is an UNSUBSCRIBE"), Sent[1][0], 0xA2);
+				TestEqual(TEXT("Third is a SUBSCRIBE"), Sent[2][0], 0x82);
+			}
+		});
+
+		It("Should complete a call split across packets once every packet is acknowledged", [this]
+		{
+			// A SUBSCRIBE with one of these filters is at most 15 bytes, and with two at least 24
+			Fixture.Context->SetServerMaximumPacketSize(20);
+			FSubscribeFuture Future = Subscribe({TEXT("level/1"), TEXT("level/2"), TEXT("level/3")});
+
+			TestEqual(TEXT("One packet per filter"), Fixture.Context->FlushSubscriptionRequests(Fixture.Socket), 3);
+			Fixture.Context->ProcessCommands();
+			const TArray<TArray<uint8>>& Sent = Fixture.Socket->GetSentPackets();
+			if (!TestEqual(TEXT("Packets sent"), Sent.Num(), 3))
+			{
+				return;
+			}
+
+			for (const TArray<uint8>& Packet : Sent)
+			{
+				TestTrue(TEXT("Packet fits the limit"), Packet.Num() <= 20);
+				TestFalse(TEXT("Not complete before the last SUBACK"), Future.IsReady());
+				AcknowledgeSubscribe(Packet, 1);
+			}
+			if (TestTrue(TEXT("Complete after the last SUBACK"), Future.IsReady()))
+			{
+				TestTrue(TEXT("Succeeded"), Future.Get().HasSucceeded());
+				TestEqual(TEXT("Results"), Future.Get().GetResult()->Num(), 3);
+			}
+		});
+
+		It("Should fail queued calls when the commands are abandoned", [this]
+		{
+			FSubscribeFuture Subscribed = Subscribe({TEXT("a/1")});
+			FUnsubscribeFuture Unsubscribed = Unsubscribe({TEXT("a/2")});
+			Fixture.Context->AbandonCommands();
+
+			TestTrue(TEXT("Subscribe complete"), Subscribed.IsReady() && !Subscribed.Get().HasSucceeded());
+			TestTrue(TEXT("Unsubscribe complete"), Unsubscribed.IsReady() && !Unsubscribed.Get().HasSucceeded());
+			TestEqual(TEXT("Nothing queued"), Fixture.Context->GetNumSubscriptionRequests(), 0);
+		});
+	});
+
+	Describe("Sharing topic filters", [this]
+	{
+		It("Should send one SUBSCRIBE for callers of the same topic filter", [this]
+		{
+			FSubscribeFuture First = Subscribe({TEXT("shared")});
+			FSubscribeFuture Second = Subscribe({TEXT("shared")});
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("shared")), 2);
+
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (!TestEqual(TEXT("Packets sent"), Sent.Num(), 1))
+			{
+				return;
+			}
+			AcknowledgeSubscribe(Sent[0], 1);
+
+			TestTrue(TEXT("First granted"), First.IsReady() && First.Get().HasSucceeded());
+			TestTrue(TEXT("Second granted"), Second.IsReady() && Second.Get().HasSucceeded());
+			if (Second.IsReady() && Second.Get().GetResult()->Num() == 1)
+			{
+				TestTrue(TEXT("Second gets the delegate"), (*Second.Get().GetResult())[0].GetOnMessage().IsValid());
+			}
+		});
+
+		It("Should complete a subscriber of a granted topic filter without sending anything", [this]
+		{
+			Subscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0], 1);
+
+			FSubscribeFuture Later = Subscribe({TEXT("shared")});
+			TestTrue(TEXT("Granted right away"), Later.IsReady() && Later.Get().HasSucceeded());
+			TestEqual(TEXT("Nothing queued"), Fixture.Context->GetNumSubscriptionRequests(), 0);
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("shared")), 2);
+		});
+
+		It("Should subscribe again when a later subscriber asks for a higher QoS", [this]
+		{
+			Subscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0], 1);
+
+			FSubscribeFuture Later = Subscribe({TEXT("shared")}, EMqttifyQualityOfService::AtLeastOnce);
+			TestFalse(TEXT("Waits for the broker"), Later.IsReady());
+			TestEqual(TEXT("Packets queued"), Fixture.Context->FlushSubscriptionRequests(Fixture.Socket), 1);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (!TestEqual(TEXT("Packets sent"), Sent.Num(), 1))
+			{
+				return;
+			}
+			TestEqual(TEXT("Sent with QoS 1"), Sent[0].Last() & 0x03, 1);
+			AcknowledgeSubscribe(Sent[0], 1);
+
+			TestTrue(TEXT("Granted"), Later.IsReady() && Later.Get().HasSucceeded());
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("shared")), 2);
+
+			FSubscribeFuture Lower = Subscribe({TEXT("shared")});
+			TestTrue(TEXT("A lower QoS shares the subscription"), Lower.IsReady() && Lower.Get().HasSucceeded());
+			TestEqual(TEXT("Nothing queued"), Fixture.Context->GetNumSubscriptionRequests(), 0);
+		});
+
+		It("Should answer the earlier callers of an upgraded topic filter with the later SUBACK", [this]
+		{
+			FSubscribeFuture First = Subscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			const TArray<TArray<uint8>> FirstSent = TakeSentPackets();
+			FSubscribeFuture Second = Subscribe({TEXT("shared")}, EMqttifyQualityOfService::AtLeastOnce);
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			const TArray<TArray<uint8>> SecondSent = TakeSentPackets();
+			if (!TestEqual(TEXT("Both sent"), FirstSent.Num() + SecondSent.Num(), 2))
+			{
+				return;
+			}
+
+			AcknowledgeSubscribe(FirstSent[0], 1);
+			TestFalse(TEXT("First waits for the subscription that replaced it"), First.IsReady());
+			AcknowledgeSubscribe(SecondSent[0], 1);
+			TestTrue(TEXT("First granted"), First.IsReady() && First.Get().HasSucceeded());
+			TestTrue(TEXT("Second granted"), Second.IsReady() && Second.Get().HasSucceeded());
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("shared")), 2);
+		});
+
+		It("Should only unsubscribe from the broker when the last subscriber lets go", [this]
+		{
+			Subscribe({TEXT("shared")});
+			Subscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0], 1);
+
+			const TSharedRef<FOnMessage> Delegate = Fixture.Context->GetMessageDelegate(TEXT("shared"));
+			Delegate->AddLambda([](const FMqttifyMessage&) {});
+
+			FUnsubscribeFuture First = Unsubscribe({TEXT("shared")});
+			TestTrue(TEXT("First completes right away"), First.IsReady() && First.Get().HasSucceeded());
+			TestEqual(TEXT("Nothing queued"), Fixture.Context->GetNumSubscriptionRequests(), 0);
+			TestTrue(TEXT("Delegate is kept for the other subscriber"), Delegate->IsBound());
+
+			FUnsubscribeFuture Last = Unsubscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (!TestEqual(TEXT("Packets sent"), Sent.Num(), 1) || !TestEqual(TEXT("UNSUBSCRIBE"), Sent[0][0], 0xA2))
+			{
+				return;
+			}
+			AcknowledgeUnsubscribe(Sent[0], 1);
+
+			TestTrue(TEXT("Last completes on the UNSUBACK"), Last.IsReady() && Last.Get().HasSucceeded());
+			TestFalse(TEXT("Delegate is cleared"), Delegate->IsBound());
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("shared")), 0);
+		});
+
+		It("Should fail every caller of a refused topic filter and forget them", [this]
+		{
+			FSubscribeFuture First = Subscribe({TEXT("refused")});
+			FSubscribeFuture Second = Subscribe({TEXT("refused")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0], 1, false);
+
+			TestTrue(TEXT("First refused"), First.IsReady() && !(*First.Get().GetResult())[0].WasSuccessful());
+			TestTrue(TEXT("Second refused"), Second.IsReady() && !(*Second.Get().GetResult())[0].WasSuccessful());
+			TestEqual(TEXT("Subscribers"), Fixture.Context->GetNumSubscribers(TEXT("refused")), 0);
+
+			Subscribe({TEXT("refused")});
+			TestEqual(
+				TEXT("Next subscriber is sent again"),
+				Fixture.Context->FlushSubscriptionRequests(Fixture.Socket),
+				1);
+		});
+
+		It("Should fail every caller of a SUBSCRIBE that was never acknowledged", [this]
+		{
+			FSubscribeFuture First = Subscribe({TEXT("abandoned")});
+			FSubscribeFuture Second = Subscribe({TEXT("abandoned")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			TakeSentPackets();
+			Fixture.Context->AbandonCommands();
+
+			TestTrue(TEXT("First failed"), First.IsReady() && !First.Get().HasSucceeded());
+			TestTrue(TEXT("Second failed"), Second.IsReady() && !Second.Get().HasSucceeded());
+		});
+
+		It("Should keep the delegate of a topic filter subscribed again before the UNSUBACK", [this]
+		{
+			Subscribe({TEXT("shared")});
+			Fixture.Context->FlushSubscriptionRequests(Fixture.Socket);
+			AcknowledgeSubscribe(TakeSentPackets()[0], 1);
+
+			Unsubscribe({TEXT("shared")});
+			Subscribe({TEXT("shared")});
+			const TSharedRef<FOnMessage> Delegate = Fixture.Context->GetMessageDelegate(TEXT("shared"));
+			Delegate->AddLambda([](const FMqttifyMessage&) {});
+
+			TestEqual(
+				TEXT("Unsubscribe and subscribe are sent"),
+				Fixture.Context->FlushSubscriptionRequests(Fixture.Socket),
+				2);
+			const TArray<TArray<uint8>> Sent = TakeSentPackets();
+			if (TestEqual(TEXT("Packets sent"), Sent.Num(), 2))
+			{
+				AcknowledgeUnsubscribe(Sent[0], 1);
+				TestTrue(TEXT("Delegate is kept"), Delegate->IsBound());
+			}
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,142 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyTimerWheel.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyTimerWheelSpec,
+	"Mqttify.Automation.TimerWheel",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static uint64 CyclesFromNow(const double InSeconds)
+	{
+		return FPlatformTime::Cycles64() + static_cast<uint64>(InSeconds / FPlatformTime::GetSecondsPerCycle64());
+	}
+
+END_DEFINE_SPEC(FMqttifyTimerWheelSpec)
+
+void FMqttifyTimerWheelSpec::Define()
+{
+	Describe("FMqttifyTimerWheel", [this]
+	{
+		It("Should only fire timers that are due", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			TArray<int32> Fired;
+			Wheel.Schedule(0.5, [&Fired] { Fired.Add(1); });
+			Wheel.Schedule(2.0, [&Fired] { Fired.Add(2); });
+
+			TestEqual(TEXT("Nothing due"), Wheel.AdvanceTo(CyclesFromNow(0.1)), 0);
+			TestEqual(TEXT("First timer"), Wheel.AdvanceTo(CyclesFromNow(1.0)), 1);
+			TestEqual(TEXT("Second timer"), Wheel.AdvanceTo(CyclesFromNow(3.0)), 1);
+			TestEqual(TEXT("Fire order"), Fired, TArray<int32>{1, 2});
+			TestEqual(TEXT("No timers left"), Wheel.Num(), 0);
+		});
+
+		It("Should cascade timers from the upper levels", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			int32 Fired = 0;
+			// Minutes and hours land in the upper levels, the last one beyond the range of the wheel
+			Wheel.Schedule(90.0, [&Fired] { ++Fired; });
+			Wheel.Schedule(3600.0, [&Fired] { ++Fired; });
+			Wheel.Schedule(6.0 * 3600.0, [&Fired] { ++Fired; });
+
+			Wheel.AdvanceTo(CyclesFromNow(89.0));
+			TestEqual(TEXT("Not due yet"), Fired, 0);
+			Wheel.AdvanceTo(CyclesFromNow(91.0));
+			TestEqual(TEXT("Minute timer"), Fired, 1);
+			Wheel.AdvanceTo(CyclesFromNow(3601.0));
+			TestEqual(TEXT("Hour timer"), Fired, 2);
+			Wheel.AdvanceTo(CyclesFromNow(5.0 * 3600.0));
+			TestEqual(TEXT("Timer beyond the range of the wheel is not early"), Fired, 2);
+			Wheel.AdvanceTo(CyclesFromNow(6.0 * 3600.0 + 1.0));
+			TestEqual(TEXT("Timer beyond the range of the wheel"), Fired, 3);
+		});
+
+		It("Should not fire cancelled timers", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			bool bFired = false;
+			FMqttifyTimerHandle Handle = Wheel.Schedule(0.01, [&bFired] { bFired = true; });
+			FMqttifyTimerHandle Copy = Handle;
+
+			TestTrue(TEXT("Cancel"), Wheel.Cancel(Handle));
+			TestFalse(TEXT("Handle invalidated"), Handle.IsValid());
+			TestFalse(TEXT("Cancel twice"), Wheel.Cancel(Copy));
+
+			Wheel.AdvanceTo(CyclesFromNow(1.0));
+			TestFalse(TEXT("Cancelled timer fired"), bFired);
+		});
+
+		It("Should not cancel a new timer through a stale handle", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			FMqttifyTimerHandle Stale = Wheel.Schedule(0.01, [] {});
+			Wheel.AdvanceTo(CyclesFromNow(1.0));
+
+			bool bFired = false;
+			Wheel.Schedule(0.01, [&bFired] { bFired = true; });
+			TestFalse(TEXT("Stale cancel"), Wheel.Cancel(Stale));
+
+			Wheel.AdvanceTo(CyclesFromNow(2.0));
+			TestTrue(TEXT("New timer fired"), bFired);
+		});
+
+		It("Should let callbacks schedule timers", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			int32 Fired = 0;
+			Wheel.Schedule(0.01, [&Wheel, &Fired]
+			{
+				++Fired;
+				Wheel.Schedule(0.01, [&Fired] { ++Fired; });
+			});
+
+			Wheel.AdvanceTo(CyclesFromNow(1.0));
+			Wheel.AdvanceTo(CyclesFromNow(2.0));
+			TestEqual(TEXT("Both timers fired"), Fired, 2);
+		});
+
+		It("Should report the time until the next timer", [this]
+		{
+			FMqttifyTimerWheel Wheel;
+			TestEqual(TEXT("Empty wheel"), Wheel.GetSecondsUntilNextTimer(1.0), 1.0);
+
+			Wheel.Schedule(0.25, [] {});
+			const double Seconds = Wheel.GetSecondsUntilNextTimer(1.0);
+			// Timers in the upper levels report when their slot cascades, which can be up to a slot early
+			TestTrue(TEXT("Next timer"), Seconds > 0.15 && Seconds <= 0.26);
+
+			Wheel.Schedule(0.05, [] {});
+			TestTrue(TEXT("Earlier timer"), Wheel.GetSecondsUntilNextTimer(1.0) <= 0.06);
+		});
+
+		It("Should not overstate the wait when an upper level timer is due before the lowest level ones", [this]
+		{
+			constexpr double kTickSeconds = FMqttifyTimerWheel::kTickSeconds;
+			constexpr uint64 kSlots = FMqttifyTimerWheel::kSlotsPerLevel;
+			const uint64 CyclesPerTick = FMath::Max<uint64>(
+				1,
+				static_cast<uint64>(kTickSeconds / FPlatformTime::GetSecondsPerCycle64()));
+			const uint64 NowTick = FPlatformTime::Cycles64() / CyclesPerTick;
+
+			// Filed in the second level, it only cascades at Boundary
+			FMqttifyTimerWheel Wheel;
+			const uint64 Boundary = (NowTick / kSlots + 2) * kSlots;
+			Wheel.Schedule((Boundary + 32 - NowTick) * kTickSeconds, [] {});
+
+			// Just short of the cascade, a timer due after the first one is filed in the lowest level
+			Wheel.AdvanceTo((Boundary - 10) * CyclesPerTick);
+			Wheel.Schedule((Boundary + 40 - NowTick) * kTickSeconds, [] {});
+
+			const double UntilFirst = (Boundary + 32 - FPlatformTime::Cycles64() / CyclesPerTick) * kTickSeconds;
+			TestTrue(TEXT("Lower bound"), Wheel.GetSecondsUntilNextTimer(10.0) <= UntilFirst);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,247 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyTopicTable.h"
+#include "Mqtt/State/MqttifyTopicAliases.h"
+#include "Packets/MqttifyPublishPacket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyTopicAliasesSpec,
+	"Mqttify.Automation.TopicAliases",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	/// @return A publish as the broker would send it, decoded.
+	static TSharedRef<FMqttifyPublishPacket5> Receive(const FString& InTopic,
+													const uint16 InTopicAlias,
+													const bool bInOmitTopicName)
+	{
+		FMqttifyPublishPacket5 Sent{
+			FMqttifyMessage{InTopic, TArray<uint8>{1}, false, EMqttifyQualityOfService::AtMostOnce},
+			0
+		};
+		Sent.SetTopicAlias(InTopicAlias, bInOmitTopicName);
+
+		FArrayReader Reader;
+		EncodePacket(Sent, Reader);
+		const FMqttifyFixedHeader Header = FMqttifyFixedHeader::Create(Reader);
+		return MakeShared<FMqttifyPublishPacket5>(Reader, Header);
+	}
+
+END_DEFINE_SPEC(FMqttifyTopicAliasesSpec)
+
+void FMqttifyTopicAliasesSpec::Define()
+{
+	Describe("FMqttifyOutboundTopicAliases", [this]
+	{
+		It("Should not alias before the broker allows it", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			bool bIsNew = true;
+			TestEqual(TEXT("No alias"), Aliases.Assign(TEXT("game/eu/match/players/1/state"), bIsNew), 0);
+			TestFalse(TEXT("Not new"), bIsNew);
+		});
+
+		It("Should keep its topics out of the topic table", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			const FString Topic = TEXT("game/eu/match/players/1/outbound");
+			bool bIsNew = false;
+			TestEqual(TEXT("Alias"), Aliases.Assign(Topic, bIsNew), 1);
+			TestFalse(TEXT("Not interned"), FMqttifyTopicTable::Get().Find(Topic).IsValid());
+		});
+
+		It("Should map a topic once and reuse its alias", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			const FString Topic = TEXT("game/eu/match/players/1/state");
+
+			bool bIsNew = false;
+			const uint16 Alias = Aliases.Assign(Topic, bIsNew);
+			TestEqual(TEXT("First alias"), Alias, 1);
+			TestTrue(TEXT("Mapped on first use"), bIsNew);
+
+			TestEqual(TEXT("Same alias"), Aliases.Assign(Topic, bIsNew), Alias);
+			TestFalse(TEXT("Reused"), bIsNew);
+
+			TestEqual(TEXT("Mappings"), Aliases.GetNumAliasMappings(), 1);
+			TestEqual(TEXT("Hits"), Aliases.GetNumAliasHits(), 1);
+			TestEqual(
+				TEXT("Bytes saved"),
+				Aliases.GetBytesSaved(),
+				static_cast<int64>(Topic.Len() - 2 * FMqttifyOutboundTopicAliases::kAliasPropertySize));
+		});
+
+		It("Should tell topics apart by case", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			bool bIsNew = false;
+			const uint16 Lower = Aliases.Assign(TEXT("a/b"), bIsNew);
+			const uint16 Upper = Aliases.Assign(TEXT("A/B"), bIsNew);
+			TestNotEqual(TEXT("Different aliases"), Lower, Upper);
+			TestTrue(TEXT("Upper case topic mapped"), bIsNew);
+		});
+
+		It("Should remap the least recently used alias when all are taken", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			Aliases.Reset(2);
+			bool bIsNew = false;
+			const uint16 First = Aliases.Assign(TEXT("a"), bIsNew);
+			const uint16 Second = Aliases.Assign(TEXT("b"), bIsNew);
+			Aliases.Assign(TEXT("a"), bIsNew);
+
+			TestEqual(TEXT("Least recently used alias remapped"), Aliases.Assign(TEXT("c"), bIsNew), Second);
+			TestTrue(TEXT("Remapped topic is new"), bIsNew);
+			TestEqual(TEXT("Recent topic kept"), Aliases.Assign(TEXT("a"), bIsNew), First);
+			TestFalse(TEXT("Recent topic not new"), bIsNew);
+			Aliases.Assign(TEXT("b"), bIsNew);
+			TestTrue(TEXT("Evicted topic mapped again"), bIsNew);
+		});
+
+		It("Should forget every alias on reset", [this]
+		{
+			FMqttifyOutboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			bool bIsNew = false;
+			Aliases.Assign(TEXT("a/b"), bIsNew);
+
+			Aliases.Reset(4);
+			TestEqual(TEXT("First alias again"), Aliases.Assign(TEXT("a/b"), bIsNew), 1);
+			TestTrue(TEXT("Mapped again"), bIsNew);
+
+			Aliases.Reset(0);
+			TestEqual(TEXT("Disabled"), Aliases.Assign(TEXT("a/b"), bIsNew), 0);
+		});
+	});
+
+	Describe("FMqttifyInboundTopicAliases", [this]
+	{
+		It("Should route a publish that only carries an alias to the aliased topic", [this]
+		{
+			FMqttifyInboundTopicAliases Aliases;
+			Aliases.Reset(8);
+			const FString Topic = TEXT("game/eu/match/players/1/state");
+
+			const TSharedRef<FMqttifyPublishPacket5> First = Receive(Topic, 2, false);
+			TestEqual(TEXT("Mapping resolved"), Aliases.Resolve(*First), EMqttifyReasonCode::Success);
+
+			const TSharedRef<FMqttifyPublishPacket5> Second = Receive(Topic, 2, true);
+			TestFalse(TEXT("Topic travelled as an alias"), Second->HasTopicName());
+			TestEqual(TEXT("Alias resolved"), Aliases.Resolve(*Second), EMqttifyReasonCode::Success);
+			TestEqual(TEXT("Topic"), Second->GetTopicName(), Topic);
+			TestTrue(TEXT("Interned topic"), Second->GetTopicHandle() == First->GetTopicHandle());
+		});
+
+		It("Should follow the broker remapping an alias", [this]
+		{
+			FMqttifyInboundTopicAliases Aliases;
+			Aliases.Reset(8);
+			Aliases.Resolve(*Receive(TEXT("a/b"), 1, false));
+			Aliases.Resolve(*Receive(TEXT("c/d"), 1, false));
+
+			const TSharedRef<FMqttifyPublishPacket5> Packet = Receive(TEXT("a/b"), 1, true);
+			TestEqual(TEXT("Alias resolved"), Aliases.Resolve(*Packet), EMqttifyReasonCode::Success);
+			TestEqual(TEXT("Remapped topic"), Packet->GetTopicName(), FString{TEXT("c/d")});
+		});
+
+		It("Should reject aliases it does not know", [this]
+		{
+			AddExpectedError(TEXT("is not mapped to a topic"), EAutomationExpectedErrorFlags::Contains, 2);
+			AddExpectedError(TEXT("exceeds the Topic Alias Maximum"), EAutomationExpectedErrorFlags::Contains, 1);
+			FMqttifyInboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			TestEqual(
+				TEXT("Unmapped alias"),
+				Aliases.Resolve(*Receive(TEXT("a/b"), 3, true)),
+				EMqttifyReasonCode::ProtocolError);
+			TestEqual(
+				TEXT("Alias above the maximum"),
+				Aliases.Resolve(*Receive(TEXT("a/b"), 5, false)),
+				EMqttifyReasonCode::TopicAliasInvalid);
+
+			Aliases.Resolve(*Receive(TEXT("a/b"), 1, false));
+			Aliases.Reset(4);
+			TestEqual(
+				TEXT("Alias forgotten on reset"),
+				Aliases.Resolve(*Receive(TEXT("a/b"), 1, true)),
+				EMqttifyReasonCode::ProtocolError);
+		});
+
+		It("Should reject a publish with neither a topic name nor an alias", [this]
+		{
+			AddExpectedError(
+				TEXT("neither a topic name nor a topic alias"),
+				EAutomationExpectedErrorFlags::Contains,
+				1);
+			FMqttifyInboundTopicAliases Aliases;
+			Aliases.Reset(4);
+			TestEqual(
+				TEXT("Protocol error"),
+				Aliases.Resolve(*Receive(TEXT(""), 0, false)),
+				EMqttifyReasonCode::ProtocolError);
+		});
+	});
+
+	Describe("MQTT 5 publish packet", [this]
+	{
+		It("Should send an empty topic name with the alias once it is mapped", [this]
+		{
+			const FString Topic = TEXT("game/eu/match/players/1/state");
+			FMqttifyPublishPacket5 Full{
+				FMqttifyMessage{Topic, TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				1
+			};
+			FMqttifyPublishPacket5 Aliased{
+				FMqttifyMessage{Topic, TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				1
+			};
+			TestTrue(TEXT("Takes alias"), Aliased.SetTopicAlias(7, true));
+
+			TArray<uint8> FullBytes;
+			TArray<uint8> AliasedBytes;
+			EncodePacket(Full, FullBytes);
+			EncodePacket(Aliased, AliasedBytes);
+			TestEqual(
+				TEXT("Shorter by the topic less the alias property"),
+				AliasedBytes.Num(),
+				FullBytes.Num() - Topic.Len() + FMqttifyOutboundTopicAliases::kAliasPropertySize);
+			TestEqual(TEXT("Empty topic name"), (AliasedBytes[2] << 8) | AliasedBytes[3], 0);
+			TestEqual(TEXT("Topic name kept for logging"), Aliased.GetTopicName(), Topic);
+
+			uint16 Alias = 0;
+			for (const FMqttifyProperty& Property : Aliased.GetProperties().GetProperties())
+			{
+				if (Property.GetIdentifier() == EMqttifyPropertyIdentifier::TopicAlias)
+				{
+					Property.TryGetValue(Alias);
+				}
+			}
+			TestEqual(TEXT("Alias property"), Alias, 7);
+		});
+
+		It("Should send the full topic again once the alias is cleared", [this]
+		{
+			FMqttifyPublishPacket5 Packet{
+				FMqttifyMessage{TEXT("a/b"), TArray<uint8>{1}, false, EMqttifyQualityOfService::AtMostOnce},
+				0
+			};
+			TArray<uint8> Before;
+			EncodePacket(Packet, Before);
+
+			Packet.SetTopicAlias(3, true);
+			Packet.SetTopicAlias(0, false);
+			TArray<uint8> After;
+			EncodePacket(Packet, After);
+			TestEqual(TEXT("Same bytes"), After, Before);
+			TestEqual(TEXT("No alias"), Packet.GetTopicAlias(), 0);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
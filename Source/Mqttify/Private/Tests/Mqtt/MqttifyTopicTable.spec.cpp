@@ -0,0 +1,101 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Mqtt/MqttifyTopicTable.h"
+#include "Packets/MqttifyPublishPacket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	FMqttifyTopicTableSpec,
+	"Mqttify.Automation.MqttifyTopicTable",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMqttifyTopicTableSpec)
+
+void FMqttifyTopicTableSpec::Define()
+{
+	Describe("FMqttifyTopicTable", [this]
+	{
+		It("Interning the same topic returns the same handle", [this]
+		{
+			FMqttifyTopicTable& Table = FMqttifyTopicTable::Get();
+			const FMqttifyTopicHandle First = Table.Intern(TEXT("spec/topic-table/same"));
+			const int32 NumAfterFirst = Table.Num();
+			const FMqttifyTopicHandle Second = Table.Intern(TEXT("spec/topic-table/same"));
+
+			TestTrue(TEXT("Handle should be valid"), First.IsValid());
+			TestEqual(TEXT("Handles should match"), First.GetId(), Second.GetId());
+			TestEqual(TEXT("Table should not grow"), Table.Num(), NumAfterFirst);
+		});
+
+		It("Different topics return different handles", [this]
+		{
+			FMqttifyTopicTable& Table = FMqttifyTopicTable::Get();
+			const FMqttifyTopicHandle A = Table.Intern(TEXT("spec/topic-table/a"));
+			const FMqttifyTopicHandle B = Table.Intern(TEXT("spec/topic-table/b"));
+			TestNotEqual(TEXT("Handles should differ"), A.GetId(), B.GetId());
+		});
+
+		It("Interning UTF-8 bytes and strings agree, including multi-byte characters", [this]
+		{
+			FMqttifyTopicTable& Table = FMqttifyTopicTable::Get();
+			const FString Topic = TEXT("spec/topic-table/caf\u00E9");
+			const auto Utf8 = StringCast<UTF8CHAR>(*Topic, Topic.Len());
+			const FMqttifyTopicHandle FromBytes = Table.Intern(Utf8.Get(), Utf8.Length());
+			const FMqttifyTopicHandle FromString = Table.Intern(Topic);
+
+			TestEqual(TEXT("Handles should match"), FromBytes.GetId(), FromString.GetId());
+			TestEqual(TEXT("Resolved topic should round trip"), FromBytes.ToString(), Topic);
+			TestEqual(TEXT("UTF-8 length should be in bytes"), Table.ResolveUtf8(FromBytes).Num(), Topic.Len() + 1);
+		});
+
+		It("Find does not intern unknown topics", [this]
+		{
+			FMqttifyTopicTable& Table = FMqttifyTopicTable::Get();
+			TestFalse(
+				TEXT("Unknown topic should not be found"),
+				Table.Find(TEXT("spec/topic-table/never-interned")).IsValid());
+		});
+	});
+
+	Describe("Interned publish topics", [this]
+	{
+		It("Decoded publish packets carry an interned topic through to the message", [this]
+		{
+			const FString Topic = TEXT("spec/topic-table/publish");
+			const TSharedRef<FMqttifyPublishPacket5> Outbound = MakeShared<FMqttifyPublishPacket5>(
+				FMqttifyMessage{Topic, TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+				1);
+
+			TArray<uint8> Bytes;
+			FMemoryWriter Writer(Bytes);
+			Outbound->Encode(Writer);
+
+			FArrayReader Reader;
+			Reader.Append(Bytes);
+			const FMqttifyFixedHeader Header = FMqttifyFixedHeader::Create(Reader);
+			TUniquePtr<FMqttifyPublishPacketBase> Inbound = MakeUnique<FMqttifyPublishPacket5>(Reader, Header);
+
+			TestTrue(TEXT("Packet should be valid"), Inbound->IsValid());
+			TestEqual(TEXT("Topic should be interned"), Inbound->GetTopicHandle().GetId(), FMqttifyTopicTable::Get().Find(Topic).GetId());
+			TestEqual(TEXT("Payload should be decoded"), Inbound->GetPayload().Num(), 3);
+
+			const FMqttifyMessage Message = FMqttifyPublishPacketBase::ToMqttifyMessage(MoveTemp(*Inbound));
+			TestTrue(TEXT("Message should carry the handle"), Message.GetTopicHandle().IsValid());
+			TestEqual(TEXT("Message topic should resolve"), Message.GetTopic(), Topic);
+
+			const FProperty* TopicProperty = FMqttifyMessage::StaticStruct()->FindPropertyByName(TEXT("Topic"));
+			if (TestNotNull(TEXT("Topic property"), TopicProperty))
+			{
+				TestEqual(
+					TEXT("Blueprints should read the topic"),
+					*TopicProperty->ContainerPtrToValuePtr<FString>(&Message),
+					Topic);
+			}
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
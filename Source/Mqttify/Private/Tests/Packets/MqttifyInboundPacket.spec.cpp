@@ -0,0 +1,87 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Packets/MqttifyInboundPacket.h"
+#include "Serialization/ArrayReader.h"
+
+using namespace Mqttify;
+BEGIN_DEFINE_SPEC(
+	MqttifyInboundPacket,
+	"Mqttify.Automation.MqttifyInboundPacket",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static void MakeReader(const TArray<uint8>& InBytes, FArrayReader& OutReader)
+	{
+		OutReader.Empty();
+		OutReader.Append(InBytes);
+		OutReader.Seek(0);
+	}
+
+END_DEFINE_SPEC(MqttifyInboundPacket)
+
+void MqttifyInboundPacket::Define()
+{
+	Describe("Decode", [this]
+	{
+		It("Should decode a PUBACK in place", [this]
+		{
+			FArrayReader Reader;
+			MakeReader({0x40, 0x02, 0x00, 0x2A}, Reader);
+
+			FMqttifyInboundPacket Packet;
+			TestTrue(TEXT("Decode should succeed"), Packet.Decode(Reader));
+			TestTrue(TEXT("Packet should be set"), Packet.IsSet());
+			TestTrue(TEXT("Packet should be valid"), Packet->IsValid());
+			TestEqual(TEXT("Packet type"), Packet->GetPacketType(), EMqttifyPacketType::PubAck);
+			TestEqual(TEXT("Packet id"), Packet->GetPacketId(), static_cast<uint16>(42));
+		});
+
+		It("Should decode a PINGRESP", [this]
+		{
+			FArrayReader Reader;
+			MakeReader({0xD0, 0x00}, Reader);
+
+			FMqttifyInboundPacket Packet;
+			TestTrue(TEXT("Decode should succeed"), Packet.Decode(Reader));
+			TestEqual(TEXT("Packet type"), Packet->GetPacketType(), EMqttifyPacketType::PingResp);
+		});
+
+		It("Should replace the previous packet when reused", [this]
+		{
+			FArrayReader Reader;
+			FMqttifyInboundPacket Packet;
+
+			MakeReader({0x40, 0x02, 0x00, 0x01}, Reader);
+			TestTrue(TEXT("First decode should succeed"), Packet.Decode(Reader));
+
+			if constexpr (GMqttifyProtocol == EMqttifyProtocolVersion::Mqtt_5)
+			{
+				MakeReader({0x30, 0x07, 0x00, 0x01, 'a', 0x00, 'x', 'y', 'z'}, Reader);
+			}
+			else
+			{
+				MakeReader({0x30, 0x06, 0x00, 0x01, 'a', 'x', 'y', 'z'}, Reader);
+			}
+			TestTrue(TEXT("Second decode should succeed"), Packet.Decode(Reader));
+			TestEqual(TEXT("Packet type"), Packet->GetPacketType(), EMqttifyPacketType::Publish);
+
+			const FMqttifyPublishPacketBase& Publish = Packet.As<FMqttifyPublishPacketBase>();
+			TestEqual(TEXT("Topic"), Publish.GetTopicName(), FString{TEXT("a")});
+			TestEqual(TEXT("Payload size"), Publish.GetPayload().Num(), 3);
+		});
+
+		It("Should reject packets only a client sends", [this]
+		{
+			FArrayReader Reader;
+			MakeReader({0xC0, 0x00}, Reader);
+
+			FMqttifyInboundPacket Packet;
+			AddExpectedError(TEXT("Unexpected packet type"), EAutomationExpectedErrorFlags::Contains, 1);
+			TestFalse(TEXT("Decode should fail"), Packet.Decode(Reader));
+			TestFalse(TEXT("Packet should not be set"), Packet.IsSet());
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
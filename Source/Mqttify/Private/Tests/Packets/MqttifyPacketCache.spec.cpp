@@ -0,0 +1,87 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Mqtt/MqttifyMessage.h"
+#include "Packets/MqttifyPacketCache.h"
+#include "Packets/MqttifyPublishPacket.h"
+
+using namespace Mqttify;
+
+BEGIN_DEFINE_SPEC(
+	MqttifyPacketCache,
+	"Mqttify.Automation.MqttifyPacketCache",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+	EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+	static FMqttifyEncodedPacketRef MakeBytes(const int32 InSize)
+	{
+		FMqttifyEncodedPacketRef Bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		Bytes->SetNumZeroed(InSize);
+		return Bytes;
+	}
+
+END_DEFINE_SPEC(MqttifyPacketCache)
+
+void MqttifyPacketCache::Define()
+{
+	Describe("FMqttifyPacketCache", [this]
+	{
+		It("Should evict the least recently used packets when over the byte budget", [this]
+		{
+			FMqttifyPacketCache Cache{100};
+			Cache.Add(1, MakeBytes(40));
+			Cache.Add(2, MakeBytes(40));
+
+			// Touch 1 so 2 becomes the least recently used
+			TestTrue(TEXT("1 should be cached"), Cache.Find(1).IsValid());
+
+			Cache.Add(3, MakeBytes(40));
+			TestTrue(TEXT("1 should be kept"), Cache.Find(1).IsValid());
+			TestFalse(TEXT("2 should be evicted"), Cache.Find(2).IsValid());
+			TestTrue(TEXT("3 should be cached"), Cache.Find(3).IsValid());
+			TestEqual(TEXT("Byte count"), Cache.GetNumBytes(), static_cast<int64>(80));
+		});
+
+		It("Should not cache packets larger than the budget", [this]
+		{
+			FMqttifyPacketCache Cache{100};
+			Cache.Add(1, MakeBytes(40));
+			TestFalse(TEXT("Oversized packet should not be cached"), Cache.Add(2, MakeBytes(101)));
+			TestTrue(TEXT("Existing entries should be kept"), Cache.Find(1).IsValid());
+		});
+
+		It("Should keep the byte count when packets are replaced and removed", [this]
+		{
+			FMqttifyPacketCache Cache{100};
+			Cache.Add(1, MakeBytes(10));
+			Cache.Add(1, MakeBytes(30));
+			TestEqual(TEXT("Replaced entry"), Cache.GetNumBytes(), static_cast<int64>(30));
+			TestEqual(TEXT("Entry count"), Cache.Num(), 1);
+
+			TestTrue(TEXT("Remove should succeed"), Cache.Remove(1));
+			TestFalse(TEXT("Second remove should fail"), Cache.Remove(1));
+			TestEqual(TEXT("Empty cache"), Cache.GetNumBytes(), static_cast<int64>(0));
+		});
+
+		It("Should mark a publish as a duplicate by patching the fixed header", [this]
+		{
+			TArray<uint8> Payload;
+			Payload.SetNumZeroed(1024);
+			TSharedRef<FMqttifyPublishPacket5> Packet = MakeShared<FMqttifyPublishPacket5>(
+				FMqttifyMessage{FString{TEXT("a/b")}, MoveTemp(Payload), false, EMqttifyQualityOfService::AtLeastOnce},
+				5);
+
+			TArray<uint8> Patched;
+			EncodePacket(*Packet, Patched);
+			FMqttifyPacketCache::SetDuplicateFlag(Patched);
+
+			Packet = FMqttifyPublishPacket5::GetDuplicate(MoveTemp(Packet));
+			TArray<uint8> Reencoded;
+			EncodePacket(*Packet, Reencoded);
+
+			TestEqual(TEXT("Patched bytes should match a re-encoded duplicate"), Patched, Reencoded);
+		});
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
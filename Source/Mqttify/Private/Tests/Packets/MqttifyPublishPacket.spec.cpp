@@ -281,6 +281,24 @@ void MqttifyPublishPacket::Define()
 						TestEqual(TEXT("Retain should be equal"), PublishPacket.GetShouldRetain(), bShouldRetain);
 					});
 			}
+
+			It(
+				"Should reject a topic name that is not well formed UTF-8 as malformed",
+				[this]
+				{
+					AddExpectedError(TEXT("not well formed UTF-8"), EAutomationExpectedErrorFlags::Contains, 2);
+					for (const uint8 Byte : {static_cast<uint8>(0x00), static_cast<uint8>(0xC0)})
+					{
+						FArrayReader Reader;
+						Reader.Append(TArray<uint8>{0x30, 0x05, 0x00, 0x03, 'a', Byte, 'b'});
+
+						const FMqttifyFixedHeader Header = FMqttifyFixedHeader::Create(Reader);
+						const FMqttifyPublishPacket3 PublishPacket(Reader, Header);
+
+						TestFalse(TEXT("Packet should be invalid"), PublishPacket.IsValid());
+						TestTrue(TEXT("Reader should be in error"), Reader.IsError());
+					}
+				});
 		});
 }
 
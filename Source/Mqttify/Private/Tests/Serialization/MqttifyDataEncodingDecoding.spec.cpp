@@ -58,6 +58,62 @@ namespace Mqttify
 						TestEqual("Decoded string should match original", DecodedString, OriginalString);
 					});
 
+				It(
+					"Should write the UTF-8 byte length and round trip multi-byte characters",
+					[this]
+					{
+						// 2, 3 and 4 byte sequences
+						const FString OriginalString = TEXT("caf\u00E9/\u6E29\u5EA6/\U0001F600");
+
+						FBufferArchive OutArchive;
+						Data::EncodeString(OriginalString, OutArchive);
+
+						constexpr int32 ExpectedUtf8Length = 5 + 1 + 6 + 1 + 4;
+						TestEqual("Utf8Length should count bytes", Data::Utf8Length(OriginalString), ExpectedUtf8Length);
+						TestEqual("Encoded size should be length field plus bytes", OutArchive.Num(), 2 + ExpectedUtf8Length);
+
+						FArrayReader InArchive;
+						InArchive.Append(OutArchive);
+						const FString DecodedString = Data::DecodeString(InArchive);
+
+						TestEqual("Decoded string should match original", DecodedString, OriginalString);
+						TestTrue("Archive should be fully consumed", InArchive.AtEnd());
+					});
+
+				It(
+					"Should reject malformed UTF-8",
+					[this]
+					{
+						FString Result;
+						const uint8 Overlong[] = {'a', 0xC0, 0xAF};
+						TestFalse("Overlong encoding should be rejected", Data::Utf8ToString(Overlong, 3, Result));
+						const uint8 Surrogate[] = {0xED, 0xA0, 0x80};
+						TestFalse("Encoded surrogate should be rejected", Data::Utf8ToString(Surrogate, 3, Result));
+						const uint8 Truncated[] = {'a', 'b', 0xE6, 0xB8};
+						TestFalse("Truncated sequence should be rejected", Data::Utf8ToString(Truncated, 4, Result));
+						const uint8 EmbeddedNull[] = {'a', 0x00, 'b'};
+						TestFalse("U+0000 should be rejected", Data::Utf8ToString(EmbeddedNull, 3, Result));
+						const uint8 Valid[] = {'a', 0xC3, 0xA9};
+						TestTrue("Valid sequence should be accepted", Data::Utf8ToString(Valid, 3, Result));
+						TestEqual("Valid sequence should decode", Result, FString(TEXT("a\u00E9")));
+
+						TestFalse("Overlong encoding should fail the check", Data::IsWellFormedUtf8(Overlong, 3));
+						TestFalse("U+0000 should fail the check", Data::IsWellFormedUtf8(EmbeddedNull, 3));
+						TestTrue("Valid sequence should pass the check", Data::IsWellFormedUtf8(Valid, 3));
+					});
+
+				It(
+					"Should set the archive error when decoding a malformed string",
+					[this]
+					{
+						FArrayReader InArchive;
+						InArchive.Append(TArray<uint8>{0x00, 0x03, 'a', 0x00, 'b'});
+
+						AddExpectedError(Data::InvalidUtf8String, EAutomationExpectedErrorFlags::Contains, 1);
+						Data::DecodeString(InArchive);
+						TestTrue("Archive should be in error", InArchive.IsError());
+					});
+
 				It(
 					"Should fail gracefully if archive is not in saving mode for EncodeString",
 					[this]
@@ -83,6 +139,46 @@ namespace Mqttify
 						Data::DecodeString(OutArchive);
 					});
 			});
+
+		// Testing EncodePayload and DecodePayload
+		Describe(
+			"PayloadEncodingDecoding",
+			[this]
+			{
+				It(
+					"Should encode and decode to the same payload",
+					[this]
+					{
+						TArray<uint8> OriginalPayload;
+						for (int32 Idx = 0; Idx < 1024; ++Idx)
+						{
+							OriginalPayload.Add(static_cast<uint8>(Idx * 31));
+						}
+
+						FBufferArchive OutArchive;
+						Data::EncodePayload(OriginalPayload, OutArchive);
+
+						FArrayReader InArchive;
+						InArchive.Append(OutArchive);
+						const TArray<uint8> DecodedPayload = Data::DecodePayload(InArchive, OriginalPayload.Num());
+
+						TestEqual("Decoded payload should match original", DecodedPayload, OriginalPayload);
+						TestTrue("Archive should be fully consumed", InArchive.AtEnd());
+					});
+
+				It(
+					"Should fail gracefully if the payload is larger than the archive",
+					[this]
+					{
+						FArrayReader InArchive;
+						InArchive.Append(TArray<uint8>{1, 2, 3});
+
+						AddExpectedError(Data::PayloadExceedsArchive, EAutomationExpectedErrorFlags::Contains, 1);
+						const TArray<uint8> DecodedPayload = Data::DecodePayload(InArchive, 4);
+						TestEqual("Decoded payload should be empty", DecodedPayload.Num(), 0);
+						TestTrue("Archive should be in error", InArchive.IsError());
+					});
+			});
 	}
 } // namespace Mqttify
 #endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,163 @@
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Packets/MqttifyPubAckPacket.h"
+#include "Packets/MqttifyPublishPacket.h"
+#include "Serialization/MqttifyPacketWriter.h"
+
+namespace Mqttify
+{
+	BEGIN_DEFINE_SPEC(
+		MqttifyPacketWriterSpec,
+		"Mqttify.Automation.MqttifyPacketWriter",
+		EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+		| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext)
+	END_DEFINE_SPEC(MqttifyPacketWriterSpec)
+
+	void MqttifyPacketWriterSpec::Define()
+	{
+		Describe(
+			"FMqttifyPacketWriter",
+			[this]
+			{
+				It(
+					"Should write integers in network byte order",
+					[this]
+					{
+						TArray<uint8> Buffer;
+						FMqttifyPacketWriter Writer{Buffer, 7};
+						Writer.WriteUInt8(0x01);
+						Writer.WriteUInt16(0x0203);
+						Writer.WriteUInt32(0x04050607);
+
+						const TArray<uint8> Expected = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+						TestEqual("Bytes should be big endian", Buffer, Expected);
+					});
+
+				It(
+					"Should write variable byte integers",
+					[this]
+					{
+						TArray<uint8> Buffer;
+						FMqttifyPacketWriter Writer{Buffer};
+						Writer.WriteVariableByteInteger(321);
+
+						const TArray<uint8> Expected = {0xC1, 0x02};
+						TestEqual("Variable byte integer should match the spec example", Buffer, Expected);
+					});
+
+				It(
+					"Should write strings as length prefixed UTF-8",
+					[this]
+					{
+						TArray<uint8> Buffer;
+						FMqttifyPacketWriter Writer{Buffer};
+						Writer.WriteString(TEXT("a\u00E9"));
+
+						const TArray<uint8> Expected = {0x00, 0x03, 'a', 0xC3, 0xA9};
+						TestEqual("String should be UTF-8 with a byte length", Buffer, Expected);
+					});
+
+				It(
+					"Should refuse strings longer than MQTT allows",
+					[this]
+					{
+						AddExpectedError(Data::CharLimitExceeded, EAutomationExpectedErrorFlags::Contains, 1);
+						TArray<uint8> Buffer;
+						FMqttifyPacketWriter Writer{Buffer};
+						Writer.WriteString(FString::ChrN(Data::MaxStringLength + 1, TEXT('a')));
+
+						TestTrue("Writer should be in error", Writer.IsError());
+						TestEqual("Nothing should be written", Buffer.Num(), 0);
+					});
+			});
+
+		Describe(
+			"EncodePacket",
+			[this]
+			{
+				It(
+					"Should append exactly GetEncodedLength bytes for a publish",
+					[this]
+					{
+						TArray<FMqttifyProperty> Properties;
+						Properties.Add(FMqttifyProperty::Create<EMqttifyPropertyIdentifier::ContentType>(FString{TEXT("text")}));
+						FMqttifyPublishPacket5 Packet{
+							FMqttifyMessage{FString{TEXT("topic")}, TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtLeastOnce},
+							7,
+							FMqttifyProperties{Properties}
+						};
+
+						TArray<uint8> Buffer = {0xFF};
+						EncodePacket(Packet, Buffer);
+
+						TestEqual("Existing bytes should be kept", Buffer[0], static_cast<uint8>(0xFF));
+						TestEqual(
+							"Encoded size should match",
+							static_cast<uint32>(Buffer.Num() - 1),
+							Packet.GetEncodedLength());
+						TestEqual("Fixed header should be publish QoS 1", Buffer[1], static_cast<uint8>(0x32));
+					});
+
+				It(
+					"Should leave the buffer as it was for a publish whose topic is too long",
+					[this]
+					{
+						AddExpectedError(Data::CharLimitExceeded, EAutomationExpectedErrorFlags::Contains, 1);
+						AddExpectedError(TEXT("Failed to encode"), EAutomationExpectedErrorFlags::Contains, 1);
+						FMqttifyPublishPacket5 Packet{
+							FMqttifyMessage{
+								FString::ChrN(Data::MaxStringLength + 1, TEXT('a')),
+								TArray<uint8>{1, 2, 3},
+								false,
+								EMqttifyQualityOfService::AtMostOnce},
+							0
+						};
+
+						TArray<uint8> Buffer = {0xFF};
+						TestFalse("Encode should fail", EncodePacket(Packet, Buffer));
+						TestEqual("Existing bytes should be all that is left", Buffer.Num(), 1);
+					});
+
+				It(
+					"Should leave the buffer as it was for a publish whose properties fail to encode",
+					[this]
+					{
+						AddExpectedError(Data::CharLimitExceeded, EAutomationExpectedErrorFlags::Contains, 1);
+						AddExpectedError(TEXT("Failed to encode"), EAutomationExpectedErrorFlags::Contains, 1);
+						TArray<FMqttifyProperty> Properties;
+						Properties.Add(
+							FMqttifyProperty::Create<EMqttifyPropertyIdentifier::ContentType>(
+								FString::ChrN(Data::MaxStringLength + 1, TEXT('a'))));
+						FMqttifyPublishPacket5 Packet{
+							FMqttifyMessage{FString{TEXT("topic")}, TArray<uint8>{1, 2, 3}, false, EMqttifyQualityOfService::AtMostOnce},
+							0,
+							FMqttifyProperties{Properties}
+						};
+
+						TArray<uint8> Buffer = {0xFF};
+						TestFalse("Encode should fail", EncodePacket(Packet, Buffer));
+						TestEqual("Existing bytes should be all that is left", Buffer.Num(), 1);
+					});
+
+				It(
+					"Should encode acknowledgements the same through FMemoryWriter and EncodePacket",
+					[this]
+					{
+						FMqttifyPubAckPacket5 Packet{0x1234, EMqttifyReasonCode::NoMatchingSubscribers};
+
+						TArray<uint8> FromWriter;
+						FMemoryWriter Writer(FromWriter);
+						Packet.Encode(Writer);
+
+						TArray<uint8> FromEncodePacket;
+						EncodePacket(Packet, FromEncodePacket);
+
+						const TArray<uint8> Expected = {0x40, 0x04, 0x12, 0x34, 0x10, 0x00};
+						TestEqual("EncodePacket bytes", FromEncodePacket, Expected);
+						TestEqual("FMemoryWriter bytes", FromWriter, Expected);
+					});
+			});
+	}
+} // namespace Mqttify
+#endif // WITH_DEV_AUTOMATION_TESTS
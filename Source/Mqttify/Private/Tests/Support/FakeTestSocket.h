@@ -51,16 +51,45 @@ namespace Mqttify
 			FMemoryWriter Writer(LastSentBytes);
 			Writer.SetByteSwapping(true);
 			InPacket->Encode(Writer);
+			MarkSent();
 		}
 
 		const TArray<uint8>& GetLastSentBytes() const { return LastSentBytes; }
 
+		/// @return Every raw write made to the socket, oldest first.
+		const TArray<TArray<uint8>>& GetSentPackets() const { return SentPackets; }
+
+		/// @brief Forget the raw writes made so far.
+		void ResetSentPackets() { SentPackets.Reset(); }
+
+		/// @return The number of raw writes made to the socket.
+		int32 GetWriteCount() const { return WriteCount; }
+
+		/// @return The start of the send buffer packets are encoded into, the same while the buffer is reused.
+		const uint8* GetSendBufferData() const { return SendBuffer.GetData(); }
+
+		/// @brief Feed bytes as if they had been read from the network.
+		void Receive(const TArray<uint8>& InBytes)
+		{
+			DataBuffer.Append(InBytes);
+			ReadPacketsFromBuffer();
+		}
+
 	protected:
-		virtual void Send(const uint8* /*Data*/, uint32 /*Size*/) override {}
+		virtual void Send(const uint8* InData, const uint32 InSize) override
+		{
+			++WriteCount;
+			LastSentBytes.Reset();
+			LastSentBytes.Append(InData, InSize);
+			SentPackets.Add(LastSentBytes);
+			MarkSent();
+		}
 
 	private:
 		bool bConnected;
+		int32 WriteCount = 0;
 		TArray<uint8> LastSentBytes;
+		TArray<TArray<uint8>> SentPackets;
 	};
 }
 
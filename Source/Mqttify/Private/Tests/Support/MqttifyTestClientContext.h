@@ -0,0 +1,56 @@
+#pragma once
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Mqtt/MqttifyConnectionSettingsBuilder.h"
+#include "Mqtt/State/MqttifyClientContext.h"
+#include "Tests/Support/FakeTestSocket.h"
+
+namespace Mqttify
+{
+	/**
+	 * @brief A client context on its own timer wheel with a fake socket, for specs that drive the context directly.
+	 * Create it in BeforeEach and Reset it in AfterEach.
+	 */
+	struct FMqttifyTestClientContext
+	{
+		TSharedPtr<FMqttifyClientContext> Context;
+		TSharedPtr<FMqttifyTimerWheel> TimerWheel;
+		TSharedPtr<FFakeTestSocket> Socket;
+
+		/// @brief Create the context with the builder's default settings and connect the socket.
+		void Create()
+		{
+			Create(FMqttifyConnectionSettingsBuilder(TEXT("mqtt://localhost:1883")).Build().ToSharedRef());
+		}
+
+		/**
+		 * @brief Create the context.
+		 * @param InSettings The connection settings of the context and the socket.
+		 * @param bInConnect Whether to connect the socket.
+		 */
+		void Create(const FMqttifyConnectionSettingsRef& InSettings, const bool bInConnect = true)
+		{
+			TimerWheel = MakeShared<FMqttifyTimerWheel>();
+			Context = MakeShared<FMqttifyClientContext>(InSettings, TimerWheel.ToSharedRef());
+			Socket = MakeShared<FFakeTestSocket>(InSettings);
+			if (bInConnect)
+			{
+				Socket->Connect();
+			}
+		}
+
+		/// @brief Abandon the commands left in the context and release everything.
+		void Reset()
+		{
+			if (Context.IsValid())
+			{
+				Context->AbandonCommands();
+			}
+			Context.Reset();
+			TimerWheel.Reset();
+			Socket.Reset();
+		}
+	};
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,7 @@
+#pragma once
+#include "Mqtt/MqttifyBulkSubscribeProgress.h"
+
+namespace Mqttify
+{
+	DECLARE_DELEGATE_OneParam(FOnBulkSubscribeProgress, const FMqttifyBulkSubscribeProgress& /* Progress */);
+} // namespace Mqttify
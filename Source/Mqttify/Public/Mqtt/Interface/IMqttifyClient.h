@@ -50,6 +50,13 @@ public:
 	 */
 	virtual bool IsConnected() const = 0;
 
+	/**
+	 * @brief Round trip time of the last keep alive, from sending PINGREQ to receiving PINGRESP.
+	 * Busy connections don't ping, so the value can be as old as the last quiet period.
+	 * @return The round trip time in seconds, negative if no PINGRESP was received yet.
+	 */
+	virtual double GetPingRoundTripSeconds() const = 0;
+
 	/**
 	 * @warning May be unimplemented depending on implementation.
 	 * @sa IWebSocket::Close
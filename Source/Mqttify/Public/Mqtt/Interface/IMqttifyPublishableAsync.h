@@ -6,6 +6,7 @@ struct FMqttifyMessage;
 namespace Mqttify
 {
 	using FPublishFuture = TFuture<TMqttifyResult<void>>;
+	using FPublishesFuture = TFuture<TMqttifyResult<TArray<TMqttifyResult<void>>>>;
 	/**
 	 * @brief Interface for a client that can subscribe to topics
 	 */
@@ -21,5 +22,23 @@ namespace Mqttify
 		 */
 		virtual FPublishFuture PublishAsync(FMqttifyMessage&& InMessage) = 0;
 
+		/**
+		 * @brief Publish many messages at once. Packet identifiers are taken together and the messages are written
+		 * to the socket in one go, as far as the broker's Receive Maximum allows.
+		 * @param InMessages The messages to publish, in order.
+		 * @return A future that contains the result of each message in the order given, it succeeds if all
+		 * messages were published.
+		 */
+		virtual FPublishesFuture PublishBatchAsync(TArray<FMqttifyMessage>&& InMessages) = 0;
+
+		/**
+		 * @brief Publish a QoS 0 message without a future, for high rate streams such as positions. The message is
+		 * written to the socket on the calling thread, nothing is queued or dispatched and nothing is allocated
+		 * beyond the message itself. Topic aliases are not used.
+		 * @param InMessage The message to publish, its quality of service must be AtMostOnce.
+		 * @return True if the message was written. False if the client is not connected, the message is not QoS 0
+		 * or it is larger than the broker accepts. A message is never held for a later connection.
+		 */
+		virtual bool PublishFireAndForget(FMqttifyMessage&& InMessage) = 0;
 	};
 } // namespace Mqttify
@@ -1,5 +1,6 @@
 #pragma once
 #include "Mqtt/MqttifyResult.h"
+#include "Mqtt/Delegates/OnBulkSubscribeProgress.h"
 
 struct FMqttifyTopicFilter;
 struct FMqttifySubscribeResult;
@@ -47,5 +48,17 @@ namespace Mqttify
 		 * the result contains a result for this topic filter
 		 */
 		virtual FSubscribeFuture SubscribeAsync(const FString& InTopicFilter) = 0;
+
+		/**
+		 * @brief Subscribe to a large set of topics on the connected MQTT broker. The topics are sent in SUBSCRIBE
+		 * packets sized to the broker's Maximum Packet Size, a few at a time as earlier ones are acknowledged,
+		 * see FMqttifyConnectionSettingsBuilder::SetMaxOutstandingSubscribes.
+		 * @param InTopicFilters The topics to subscribe to
+		 * @param InOnProgress Called as the broker acknowledges each packet, with the throughput so far
+		 * @return A future that contains the result of the subscription, which can be checked for success.
+		 * the result contains a result for each topic filter
+		 */
+		virtual FSubscribesFuture SubscribeBulkAsync(TArray<FMqttifyTopicFilter>&& InTopicFilters,
+													const FOnBulkSubscribeProgress& InOnProgress = {}) = 0;
 	};
 } // namespace Mqttify
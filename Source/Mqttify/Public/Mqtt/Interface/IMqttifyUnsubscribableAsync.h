@@ -14,6 +14,11 @@ namespace Mqttify
 	public:
 		virtual ~IMqttifyUnsubscribableAsync() = default;
 		/**
+		 * @brief Unsubscribe from topics. Every subscribe call to a topic filter shares one OnMessage delegate and
+		 * the filter is only sent to the broker once the last of them unsubscribes. Until then an unsubscribe
+		 * succeeds straight away but does not stop delivery, the handlers bound to the shared delegate keep being
+		 * called. Remove your own bindings from the delegate of the subscribe result to stop receiving.
+		 * @param InTopicFilters The topic filters to unsubscribe from.
 		 * @return A future that contains the result of the connection, which can be checked for success.
 		 * the result contains a true or false for each topic filter
 		 */
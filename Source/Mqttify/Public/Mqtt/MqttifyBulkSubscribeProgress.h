@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Progress of a bulk subscribe, reported as the SUBACKs of its packets arrive.
+ */
+struct MQTTIFY_API FMqttifyBulkSubscribeProgress final
+{
+	explicit FMqttifyBulkSubscribeProgress(const int32 InNumTopicFilters,
+											const int32 InNumCompleted,
+											const double InElapsedSeconds)
+		: NumTopicFilters{ InNumTopicFilters }
+		, NumCompleted{ InNumCompleted }
+		, ElapsedSeconds{ InElapsedSeconds } {}
+
+	~FMqttifyBulkSubscribeProgress() = default;
+
+	/**
+	 * @brief Get the number of topic filters the bulk subscribe sends, those other calls already hold are not
+	 * counted.
+	 * @return The number of topic filters.
+	 */
+	int32 GetNumTopicFilters() const
+	{
+		return NumTopicFilters;
+	}
+
+	/**
+	 * @brief Get the number of topic filters whose SUBACK arrived so far, granted or not.
+	 * @return The number of topic filters with a result.
+	 */
+	int32 GetNumCompleted() const
+	{
+		return NumCompleted;
+	}
+
+	/**
+	 * @brief Get the time since the bulk subscribe was made.
+	 * @return The elapsed time in seconds.
+	 */
+	double GetElapsedSeconds() const
+	{
+		return ElapsedSeconds;
+	}
+
+	/**
+	 * @brief Get the throughput of the bulk subscribe so far.
+	 * @return The topic filters answered per second.
+	 */
+	double GetTopicFiltersPerSecond() const
+	{
+		return ElapsedSeconds > 0.0 ? NumCompleted / ElapsedSeconds : 0.0;
+	}
+
+private:
+	/**
+	 * @brief Number of topic filters of the bulk subscribe.
+	 */
+	int32 NumTopicFilters;
+
+	/**
+	 * @brief Number of topic filters with a result.
+	 */
+	int32 NumCompleted;
+
+	/**
+	 * @brief Seconds since the bulk subscribe was made.
+	 */
+	double ElapsedSeconds;
+};
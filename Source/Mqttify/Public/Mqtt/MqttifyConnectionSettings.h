@@ -3,6 +3,8 @@
 #include "Interface/IMqttifyCredentialsProvider.h"
 #include "Misc/Base64.h"
 #include "Mqtt/MqttifyConnectionProtocol.h"
+#include "Mqtt/MqttifyOfflineDropPolicy.h"
+#include "Mqtt/MqttifyRetryPolicy.h"
 
 enum class EMqttifyProtocolVersion : uint8;
 
@@ -67,6 +69,26 @@ private:
 	uint8 MaxPacketRetries;
 	/// @breif Verify the server certificate.
 	bool bShouldVerifyServerCertificate;
+	/// @brief How the time before sending an unacknowledged packet again is chosen.
+	EMqttifyRetryPolicy RetryPolicy;
+	/// @brief Receive Maximum advertised to the broker, the most inbound QoS 1 and 2 publishes in flight at once.
+	uint16 ReceiveMaximum;
+	/// @brief Topic Alias Maximum advertised to the broker, the most topic aliases it may use in publishes to the client.
+	uint16 TopicAliasMaximum;
+	/// @brief Seconds a QoS 1 or 2 publish may wait out a lost connection, 0 to wait until the session is lost.
+	uint32 PublishDeadlineSeconds;
+	/// @brief Most publishes held while the client has no session, 0 to fail publishes made while offline.
+	uint32 OfflineBufferMaxMessages;
+	/// @brief Most encoded bytes of publishes held while the client has no session.
+	uint32 OfflineBufferMaxBytes;
+	/// @brief Which publish is dropped when the offline publish buffer is over its budget.
+	EMqttifyOfflineDropPolicy OfflineDropPolicy;
+	/// @brief Directory of the log of unacknowledged QoS 1 and 2 publishes, empty to keep them in memory only.
+	FString SessionStoreDirectory;
+	/// @brief Most SUBSCRIBE packets of a bulk subscribe waiting for their SUBACK at once.
+	uint32 MaxOutstandingSubscribes;
+	/// @brief Most topic filters in one SUBSCRIBE packet of a bulk subscribe.
+	uint32 MaxTopicFiltersPerSubscribe;
 
 	/// @brief Session expiration interval (seconds) for reconnect.
 	uint32 SessionExpiryInterval = 0;
@@ -91,6 +113,16 @@ public:
 		MaxConnectionRetries = Other.MaxConnectionRetries;
 		MaxPacketRetries = Other.MaxPacketRetries;
 		bShouldVerifyServerCertificate = Other.bShouldVerifyServerCertificate;
+		RetryPolicy = Other.RetryPolicy;
+		ReceiveMaximum = Other.ReceiveMaximum;
+		TopicAliasMaximum = Other.TopicAliasMaximum;
+		PublishDeadlineSeconds = Other.PublishDeadlineSeconds;
+		OfflineBufferMaxMessages = Other.OfflineBufferMaxMessages;
+		OfflineBufferMaxBytes = Other.OfflineBufferMaxBytes;
+		OfflineDropPolicy = Other.OfflineDropPolicy;
+		SessionStoreDirectory = Other.SessionStoreDirectory;
+		MaxOutstandingSubscribes = Other.MaxOutstandingSubscribes;
+		MaxTopicFiltersPerSubscribe = Other.MaxTopicFiltersPerSubscribe;
 		SessionExpiryInterval = Other.SessionExpiryInterval;
 		MaxPacketSize = Other.MaxPacketSize;
 		MaxBufferSize = Other.MaxBufferSize;
@@ -150,6 +182,36 @@ public:
 	/// @brief Returns the Max Packet Retries.
 	uint8 GetMaxPacketRetries() const { return MaxPacketRetries; }
 
+	/// @brief Returns the packet retry policy.
+	EMqttifyRetryPolicy GetRetryPolicy() const { return RetryPolicy; }
+
+	/// @brief Returns the Receive Maximum advertised to the broker.
+	uint16 GetReceiveMaximum() const { return ReceiveMaximum; }
+
+	/// @brief Returns the Topic Alias Maximum advertised to the broker.
+	uint16 GetTopicAliasMaximum() const { return TopicAliasMaximum; }
+
+	/// @brief Returns the seconds a QoS 1 or 2 publish may wait for the connection to come back.
+	uint32 GetPublishDeadlineSeconds() const { return PublishDeadlineSeconds; }
+
+	/// @brief Returns the most publishes held while the client has no session.
+	uint32 GetOfflineBufferMaxMessages() const { return OfflineBufferMaxMessages; }
+
+	/// @brief Returns the most encoded bytes of publishes held while the client has no session.
+	uint32 GetOfflineBufferMaxBytes() const { return OfflineBufferMaxBytes; }
+
+	/// @brief Returns which publish is dropped when the offline publish buffer is over its budget.
+	EMqttifyOfflineDropPolicy GetOfflineDropPolicy() const { return OfflineDropPolicy; }
+
+	/// @brief Returns the directory of the log of unacknowledged QoS 1 and 2 publishes, empty if there is none.
+	const FString& GetSessionStoreDirectory() const { return SessionStoreDirectory; }
+
+	/// @brief Returns the most SUBSCRIBE packets of a bulk subscribe waiting for their SUBACK at once.
+	uint32 GetMaxOutstandingSubscribes() const { return MaxOutstandingSubscribes; }
+
+	/// @brief Returns the most topic filters in one SUBSCRIBE packet of a bulk subscribe.
+	uint32 GetMaxTopicFiltersPerSubscribe() const { return MaxTopicFiltersPerSubscribe; }
+
 	/// @brief Whether to verify the server certificate.
 	bool ShouldVerifyServerCertificate() const { return bShouldVerifyServerCertificate; }
 
@@ -177,7 +239,8 @@ public:
 	uint32 GetHashCode() const;
 
 	/**
-	 * @brief Parses the input string to populate the struct.
+	 * @brief Parses the input string to populate the struct. Settings added after the ClientId default to the
+	 * values of FMqttifyConnectionSettingsBuilder.
 	 * @return The connection settings.
 	 */
 	static TSharedPtr<FMqttifyConnectionSettings> CreateShared(
@@ -195,7 +258,17 @@ public:
 		uint8 InMaxPacketRetries,
 		bool bInShouldVerifyCertificate,
 		uint32 InSessionExpiryInterval,
-		FString&& InClientId = {}
+		FString&& InClientId = {},
+		EMqttifyRetryPolicy InRetryPolicy = EMqttifyRetryPolicy::ExponentialBackoff,
+		uint16 InReceiveMaximum = 1024,
+		uint16 InTopicAliasMaximum = 0,
+		uint32 InPublishDeadlineSeconds = 0,
+		uint32 InOfflineBufferMaxMessages = 1000,
+		uint32 InOfflineBufferMaxBytes = 4 * 1024 * 1024,
+		EMqttifyOfflineDropPolicy InOfflineDropPolicy = EMqttifyOfflineDropPolicy::DropOldest,
+		const FString& InSessionStoreDirectory = FString(),
+		uint32 InMaxOutstandingSubscribes = 4,
+		uint32 InMaxTopicFiltersPerSubscribe = 256
 		);
 
 	static TSharedPtr<FMqttifyConnectionSettings> CreateShared(
@@ -214,7 +287,17 @@ public:
 		uint8 InMaxPacketRetries,
 		bool bInShouldVerifyCertificate,
 		uint32 InSessionExpiryInterval,
-		FString&& InClientId = {}
+		FString&& InClientId = {},
+		EMqttifyRetryPolicy InRetryPolicy = EMqttifyRetryPolicy::ExponentialBackoff,
+		uint16 InReceiveMaximum = 1024,
+		uint16 InTopicAliasMaximum = 0,
+		uint32 InPublishDeadlineSeconds = 0,
+		uint32 InOfflineBufferMaxMessages = 1000,
+		uint32 InOfflineBufferMaxBytes = 4 * 1024 * 1024,
+		EMqttifyOfflineDropPolicy InOfflineDropPolicy = EMqttifyOfflineDropPolicy::DropOldest,
+		const FString& InSessionStoreDirectory = FString(),
+		uint32 InMaxOutstandingSubscribes = 4,
+		uint32 InMaxTopicFiltersPerSubscribe = 256
 		);
 
 	// Helper function to create FMqttifyConnectionSettings
@@ -237,7 +320,17 @@ public:
 		const uint8 InMaxPacketRetries,
 		const bool bInShouldVerifyServerCertificate,
 		const uint32 InSessionExpiryInterval,
-		FString&& InClientId
+		FString&& InClientId = {},
+		const EMqttifyRetryPolicy InRetryPolicy = EMqttifyRetryPolicy::ExponentialBackoff,
+		const uint16 InReceiveMaximum = 1024,
+		const uint16 InTopicAliasMaximum = 0,
+		const uint32 InPublishDeadlineSeconds = 0,
+		const uint32 InOfflineBufferMaxMessages = 1000,
+		const uint32 InOfflineBufferMaxBytes = 4 * 1024 * 1024,
+		const EMqttifyOfflineDropPolicy InOfflineDropPolicy = EMqttifyOfflineDropPolicy::DropOldest,
+		const FString& InSessionStoreDirectory = FString(),
+		const uint32 InMaxOutstandingSubscribes = 4,
+		const uint32 InMaxTopicFiltersPerSubscribe = 256
 		)
 	{
 		return MakeShareable(
@@ -260,7 +353,17 @@ public:
 				InMaxPacketRetries,
 				bInShouldVerifyServerCertificate,
 				InSessionExpiryInterval,
-				MoveTemp(InClientId)));
+				MoveTemp(InClientId),
+				InRetryPolicy,
+				InReceiveMaximum,
+				InTopicAliasMaximum,
+				InPublishDeadlineSeconds,
+				InOfflineBufferMaxMessages,
+				InOfflineBufferMaxBytes,
+				InOfflineDropPolicy,
+				InSessionStoreDirectory,
+				InMaxOutstandingSubscribes,
+				InMaxTopicFiltersPerSubscribe));
 	}
 
 	/**
@@ -293,6 +396,16 @@ private:
 	 * @param bInShouldVerifyCertificate Whether to verify the server certificate.
 	 * @param InSessionExpiryInterval The Session Expiry Interval
 	 * @param InClientId The ClientId to use for the connection.
+	 * @param InRetryPolicy How the time before sending an unacknowledged packet again is chosen.
+	 * @param InReceiveMaximum The Receive Maximum advertised to the broker.
+	 * @param InTopicAliasMaximum The Topic Alias Maximum advertised to the broker.
+	 * @param InPublishDeadlineSeconds How long a QoS 1 or 2 publish may wait for the connection to come back.
+	 * @param InOfflineBufferMaxMessages The most publishes held while the client has no session.
+	 * @param InOfflineBufferMaxBytes The most encoded bytes of publishes held while the client has no session.
+	 * @param InOfflineDropPolicy Which publish is dropped when the offline publish buffer is over its budget.
+	 * @param InSessionStoreDirectory The directory of the log of unacknowledged QoS 1 and 2 publishes, empty for none.
+	 * @param InMaxOutstandingSubscribes The most SUBSCRIBE packets of a bulk subscribe waiting for a SUBACK.
+	 * @param InMaxTopicFiltersPerSubscribe The most topic filters in one SUBSCRIBE packet of a bulk subscribe.
 	 */
 	explicit FMqttifyConnectionSettings(
 		FString&& InHost,
@@ -313,7 +426,17 @@ private:
 		uint8 InMaxPacketRetries,
 		bool bInShouldVerifyCertificate,
 		uint32 InSessionExpiryInterval,
-		FString&& InClientId = TEXT("")
+		FString&& InClientId = {},
+		EMqttifyRetryPolicy InRetryPolicy = EMqttifyRetryPolicy::ExponentialBackoff,
+		uint16 InReceiveMaximum = 1024,
+		uint16 InTopicAliasMaximum = 0,
+		uint32 InPublishDeadlineSeconds = 0,
+		uint32 InOfflineBufferMaxMessages = 1000,
+		uint32 InOfflineBufferMaxBytes = 4 * 1024 * 1024,
+		EMqttifyOfflineDropPolicy InOfflineDropPolicy = EMqttifyOfflineDropPolicy::DropOldest,
+		const FString& InSessionStoreDirectory = FString(),
+		uint32 InMaxOutstandingSubscribes = 4,
+		uint32 InMaxTopicFiltersPerSubscribe = 256
 		);
 
 	/// @brief Helper function to parse protocol
@@ -36,6 +36,16 @@ private:
 	uint16 InitialRetryIntervalSeconds = 3.0f;
 	bool bShouldVerifyCertificate = true;
 	uint32 SessionExpiryInterval = 0;
+	EMqttifyRetryPolicy RetryPolicy = EMqttifyRetryPolicy::ExponentialBackoff;
+	uint16 ReceiveMaximum = 1024;
+	uint16 TopicAliasMaximum = 0;
+	uint32 PublishDeadlineSeconds = 0;
+	uint32 OfflineBufferMaxMessages = 1000;
+	uint32 OfflineBufferMaxBytes = 4 * 1024 * 1024;
+	EMqttifyOfflineDropPolicy OfflineDropPolicy = EMqttifyOfflineDropPolicy::DropOldest;
+	FString SessionStoreDirectory = FString();
+	uint32 MaxOutstandingSubscribes = 4;
+	uint32 MaxTopicFiltersPerSubscribe = 256;
 	EMqttifyProtocolVersion MqttProtocolVersion = EMqttifyProtocolVersion::Mqtt_5;
 	EMqttifyThreadMode ThreadMode = EMqttifyThreadMode::BackgroundThreadWithCallbackMarshalling;
 
@@ -124,6 +134,17 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Sets how the time before sending an unacknowledged packet again is chosen.
+	 * @param InRetryPolicy The packet retry policy.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetRetryPolicy(const EMqttifyRetryPolicy InRetryPolicy)
+	{
+		RetryPolicy = InRetryPolicy;
+		return *this;
+	}
+
 	/**
 	 * @brief Sets the maximum number of packet retries.
 	 * @param InRetries The maximum number of packet retries.
@@ -176,6 +197,126 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Sets the Receive Maximum advertised to the broker (MQTT 5).
+	 * The broker keeps at most this many QoS 1 and 2 publishes to the client unacknowledged at once.
+	 * Default: 1024.
+	 * @param InReceiveMaximum The Receive Maximum, 0 is treated as 1.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetReceiveMaximum(const uint16 InReceiveMaximum)
+	{
+		ReceiveMaximum = FMath::Max<uint16>(InReceiveMaximum, 1);
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the Topic Alias Maximum advertised to the broker (MQTT 5).
+	 * The broker may then send publishes with a topic alias in place of the topic name.
+	 * Default: 0, the broker sends every topic name in full.
+	 * @param InTopicAliasMaximum The most topic aliases the broker may use.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetTopicAliasMaximum(const uint16 InTopicAliasMaximum)
+	{
+		TopicAliasMaximum = InTopicAliasMaximum;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets how long a QoS 1 or 2 publish may wait for the connection to come back.
+	 * Unacknowledged publishes are kept across reconnects and sent again when the broker still has the session,
+	 * while the connection is down they fail once they are older than this deadline.
+	 * Default: 0, publishes only fail when the session is lost.
+	 * @param InSeconds The deadline in seconds, measured from the call to PublishAsync.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetPublishDeadlineSeconds(const uint32 InSeconds)
+	{
+		PublishDeadlineSeconds = InSeconds;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the most publishes held while the client has no session.
+	 * Publishes made while disconnected or reconnecting wait in a buffer and are sent once the broker accepts the
+	 * connection. When the buffer is full a publish is dropped as SetOfflineDropPolicy says and its future fails.
+	 * Default: 1000.
+	 * @param InMaxMessages The most publishes held, 0 to fail publishes made while offline.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetOfflineBufferMaxMessages(const uint32 InMaxMessages)
+	{
+		OfflineBufferMaxMessages = InMaxMessages;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the most encoded bytes of publishes held while the client has no session.
+	 * Default: 4MB.
+	 * @param InMaxBytes The most bytes held.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetOfflineBufferMaxBytes(const uint32 InMaxBytes)
+	{
+		OfflineBufferMaxBytes = InMaxBytes;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets which publish is dropped when the offline publish buffer is over its budget.
+	 * Default: EMqttifyOfflineDropPolicy::DropOldest.
+	 * @param InDropPolicy The drop policy.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetOfflineDropPolicy(const EMqttifyOfflineDropPolicy InDropPolicy)
+	{
+		OfflineDropPolicy = InDropPolicy;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the directory of a log on disk of the unacknowledged QoS 1 and 2 publishes.
+	 * The publishes are written to the log before they are sent and read back when a client with the same ClientId
+	 * is created, so they are sent again after the process restarts or crashes. Needs a fixed ClientId.
+	 * Default: empty, publishes are kept in memory only.
+	 * @param InDirectory The directory of the log.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetSessionStoreDirectory(const FString& InDirectory)
+	{
+		SessionStoreDirectory = InDirectory;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the most SUBSCRIBE packets of a bulk subscribe waiting for their SUBACK at once.
+	 * A bulk subscribe sends its topic filters in packets sized to the broker's Maximum Packet Size, and sends the
+	 * next packet as the SUBACK of an earlier one arrives, so a large set does not flood the broker.
+	 * Default: 4.
+	 * @param InMaxOutstanding The most packets waiting for their SUBACK, at least 1.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetMaxOutstandingSubscribes(const uint32 InMaxOutstanding)
+	{
+		MaxOutstandingSubscribes = InMaxOutstanding;
+		return *this;
+	}
+
+	/**
+	 * @brief Sets the most topic filters in one SUBSCRIBE packet of a bulk subscribe.
+	 * The broker's Maximum Packet Size still caps each packet. A broker that sets no limit would otherwise get the
+	 * whole set in one packet, and the progress of the bulk subscribe would only be reported once.
+	 * Default: 256.
+	 * @param InMaxTopicFilters The most topic filters per packet, at least 1.
+	 * @return A reference to this builder.
+	 */
+	FMqttifyConnectionSettingsBuilder& SetMaxTopicFiltersPerSubscribe(const uint32 InMaxTopicFilters)
+	{
+		MaxTopicFiltersPerSubscribe = InMaxTopicFilters;
+		return *this;
+	}
+
 	FMqttifyConnectionSettingsBuilder& SetMaxPacketSize(const uint32 InMaxPacketSize)
 	{
 		MaxPacketSize = InMaxPacketSize;
@@ -221,7 +362,17 @@ public:
 				MaxPacketRetries,
 				bShouldVerifyCertificate,
 				SessionExpiryInterval,
-				FString{ClientId})
+				FString{ClientId},
+				RetryPolicy,
+				ReceiveMaximum,
+				TopicAliasMaximum,
+				PublishDeadlineSeconds,
+				OfflineBufferMaxMessages,
+				OfflineBufferMaxBytes,
+				OfflineDropPolicy,
+				SessionStoreDirectory,
+				MaxOutstandingSubscribes,
+				MaxTopicFiltersPerSubscribe)
 			: FMqttifyConnectionSettings::CreateShared(
 				Url,
 				CredentialsProvider.ToSharedRef(),
@@ -238,7 +389,17 @@ public:
 				MaxPacketRetries,
 				bShouldVerifyCertificate,
 				SessionExpiryInterval,
-				FString{ClientId});
+				FString{ClientId},
+				RetryPolicy,
+				ReceiveMaximum,
+				TopicAliasMaximum,
+				PublishDeadlineSeconds,
+				OfflineBufferMaxMessages,
+				OfflineBufferMaxBytes,
+				OfflineDropPolicy,
+				SessionStoreDirectory,
+				MaxOutstandingSubscribes,
+				MaxTopicFiltersPerSubscribe);
 
 		return Settings;
 	}
@@ -3,10 +3,12 @@
 #include "CoreMinimal.h"
 #include "Mqtt/MqttifyProtocolVersion.h"
 #include "Mqtt/MqttifyQualityOfService.h"
+#include "Mqtt/MqttifyTopicHandle.h"
 #include "MqttifyMessage.generated.h"
 
 namespace Mqttify
 {
+	struct FMqttifyPublishPacketBase;
 	template <EMqttifyProtocolVersion InProtocolVersion>
 	struct TMqttifyPublishPacket;
 }
@@ -50,6 +52,16 @@ public:
 		, bRetain{ bInRetain }
 		, QualityOfService(InQualityOfService) {}
 
+	FMqttifyMessage(const FMqttifyTopicHandle InTopicHandle,
+					TArray<uint8>&& InPayload,
+					const bool bInRetain,
+					const EMqttifyQualityOfService InQualityOfService)
+		: TimeStamp{ FDateTime::UtcNow() }
+		, Payload{ MoveTemp(InPayload) }
+		, bRetain{ bInRetain }
+		, QualityOfService(InQualityOfService)
+		, TopicHandle{ InTopicHandle } {}
+
 	/**
 	 * @brief Get the TimeStamp as UTC.
 	 * @return TimeStamp as UTC.
@@ -57,9 +69,15 @@ public:
 	const FORCEINLINE FDateTime& GetTimeStamp() const { return TimeStamp; }
 	/**
 	 * @brief Get the Topic.
-	 * @return Topic the message was sent to.
+	 * @return Topic the message was sent to. For received messages this resolves the interned topic,
+	 * which only allocates the first time a given topic is requested.
 	 */
-	const FORCEINLINE FString& GetTopic() const { return Topic; }
+	const FORCEINLINE FString& GetTopic() const { return TopicHandle.IsValid() ? TopicHandle.ToString() : Topic; }
+	/**
+	 * @brief Get the interned Topic.
+	 * @return Handle to the interned topic, invalid if the message was created from a string.
+	 */
+	FORCEINLINE FMqttifyTopicHandle GetTopicHandle() const { return TopicHandle; }
 	/**
 	 * @brief Get the Payload.
 	 * @return Payload the message contains.
@@ -81,7 +99,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MQTT", meta = (AllowPrivateAccess = true))
 	FDateTime TimeStamp;
 
-	/** Packet topic. */
+	/** Packet topic. Empty for a message created from an interned topic, use GetTopic. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MQTT", meta = (AllowPrivateAccess = true))
 	FString Topic;
 
@@ -102,6 +120,10 @@ private:
 		meta = (DisplayName = "Quality of Service", AllowPrivateAccess = true))
 	EMqttifyQualityOfService QualityOfService;
 
+	/** Interned topic, set for received messages and for messages created from a handle. */
+	FMqttifyTopicHandle TopicHandle;
+
+	friend struct Mqttify::FMqttifyPublishPacketBase;
 	friend struct Mqttify::TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_3_1_1>;
 	friend struct Mqttify::TMqttifyPublishPacket<EMqttifyProtocolVersion::Mqtt_5>;
 };
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MqttifyOfflineDropPolicy.generated.h"
+
+/**
+ * @enum EMqttifyOfflineDropPolicy
+ * @brief Enumerates which publish is dropped when the offline publish buffer is over its budget.
+ */
+UENUM(BlueprintType)
+enum class EMqttifyOfflineDropPolicy : uint8
+{
+	/**
+	 * @brief Drop the oldest buffered publish.
+	 * Keeps the most recent data, suited to telemetry where only the latest values matter.
+	 */
+	DropOldest = 0,
+
+	/**
+	 * @brief Drop the publish being made.
+	 * Keeps what was buffered first, the new publish fails straight away.
+	 */
+	DropNewest = 1,
+
+	/**
+	 * @brief Drop the oldest publish of the lowest quality of service.
+	 * QoS 0 publishes go first, then QoS 1, so the publishes that asked for the strongest delivery are kept longest.
+	 */
+	DropLowestQualityOfService = 2,
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Mqtt/MqttifyReasonCode.h"
 #include "Templates/SharedPointer.h"
 
 /**
@@ -51,14 +52,30 @@ class TMqttifyResult<void>
 {
 private:
 	bool bSuccess;
+	EMqttifyReasonCode ReasonCode;
 
 public:
 	explicit TMqttifyResult(const bool bInSuccess)
-		: bSuccess{ bInSuccess } {}
+		: bSuccess{ bInSuccess }
+		, ReasonCode{ bInSuccess ? EMqttifyReasonCode::Success : EMqttifyReasonCode::UnspecifiedError } {}
+
+	/**
+	 * @brief Construct a result with the reason it failed
+	 * @param bInSuccess Whether the operation was successful
+	 * @param InReasonCode Why the operation failed, or Success
+	 */
+	explicit TMqttifyResult(const bool bInSuccess, const EMqttifyReasonCode InReasonCode)
+		: bSuccess{ bInSuccess }
+		, ReasonCode{ InReasonCode } {}
 
 	/**
 	 * @brief Whether the operation was successful
 	 * @return True if the operation was successful
 	 */
 	bool HasSucceeded() const { return bSuccess; }
+	/**
+	 * @brief Why the operation failed, UnspecifiedError unless a more specific reason is known
+	 * @return The reason code
+	 */
+	EMqttifyReasonCode GetReasonCode() const { return ReasonCode; }
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MqttifyRetryPolicy.generated.h"
+
+/**
+ * @enum EMqttifyRetryPolicy
+ * @brief Enumerates how the time before an unacknowledged packet is sent again is chosen.
+ */
+UENUM(BlueprintType)
+enum class EMqttifyRetryPolicy : uint8
+{
+	/**
+	 * @brief Fixed exponential backoff.
+	 * The packet retry interval multiplied by the backoff multiplier for each try, plus up to a second of jitter.
+	 */
+	ExponentialBackoff = 0,
+
+	/**
+	 * @brief Retry timeout adapted to the round trip time of the connection.
+	 * The timeout is estimated from acknowledgement timings as TCP does (RFC 6298) and multiplied by the backoff
+	 * multiplier for each try.
+	 */
+	Adaptive = 1,
+};
@@ -36,7 +36,8 @@ struct MQTTIFY_API FMqttifySubscribeResult final
 	}
 
 	/**
-	 * @brief Get the delegate which is called when a message is received matching the subscription.
+	 * @brief Get the delegate which is called when a message is received matching the subscription. Every
+	 * subscriber of the topic filter gets the same delegate, unsubscribing does not remove the bindings made on it.
 	 * @return The delegate which is called when a message is received matching the subscription.
 	 */
 	TSharedPtr<Mqttify::FOnMessage> GetOnMessage() const
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Compact handle to a topic name stored in the process wide topic intern table.
+ *
+ * Inbound topics are interned from their raw UTF-8 bytes, so messages and delegate lookups
+ * can carry and hash a single integer instead of an FString. The string form is only built
+ * when it is first requested and is shared by every handle to the same topic.
+ */
+struct MQTTIFY_API FMqttifyTopicHandle
+{
+public:
+	FMqttifyTopicHandle()
+		: Id{0} {}
+
+	explicit FMqttifyTopicHandle(const uint32 InId)
+		: Id{InId} {}
+
+	/**
+	 * @brief Check if the handle refers to an interned topic.
+	 * @return True if the handle is valid.
+	 */
+	FORCEINLINE bool IsValid() const { return Id != 0; }
+
+	/**
+	 * @brief Get the raw identifier of the handle.
+	 * @return The identifier, 0 if the handle is invalid.
+	 */
+	FORCEINLINE uint32 GetId() const { return Id; }
+
+	/**
+	 * @brief Get the topic name this handle refers to.
+	 * @return The topic name, empty if the handle is invalid. The reference is stable for the
+	 * lifetime of the module.
+	 */
+	const FString& ToString() const;
+
+	FORCEINLINE bool operator==(const FMqttifyTopicHandle& Other) const { return Id == Other.Id; }
+	FORCEINLINE bool operator!=(const FMqttifyTopicHandle& Other) const { return Id != Other.Id; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FMqttifyTopicHandle& InHandle) { return InHandle.Id; }
+
+private:
+	uint32 Id;
+};